@@ -0,0 +1,441 @@
+#pragma once
+
+// Std. Includes
+#include <string>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "StreamingBuffer.h"
+
+// SSE2 para mezclar las poses (4 articulaciones a la vez)
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ANIMATION_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+// Cuadros por segundo a los que se remuestrean los clips al cargarlos
+const GLfloat ANIMATION_SAMPLE_RATE = 30.0f;
+
+// Unidad de textura de la paleta de huesos (0..3 las usan Mesh::Draw y el G-buffer)
+const GLuint SKINNING_TEXTURE_UNIT = 6;
+
+// Componentes de la pose de cada articulacion: traslacion, rotacion (cuaternion) y escala
+enum Joint_Channel
+{
+	JOINT_TX, JOINT_TY, JOINT_TZ,
+	JOINT_RX, JOINT_RY, JOINT_RZ, JOINT_RW,
+	JOINT_SX, JOINT_SY, JOINT_SZ,
+	JOINT_CHANNELS
+};
+
+// Pose local de todas las articulaciones, en estructura de arreglos (SoA):
+// cada componente es un arreglo de 'stride' floats, uno por articulacion.
+// El stride se redondea a multiplo de 4 para recorrerlo de 4 en 4 con SSE.
+struct JointPose
+{
+	GLuint count;
+	GLuint stride;
+	std::vector<GLfloat> data;
+
+	JointPose() : count(0), stride(0) {}
+
+	void Resize(GLuint jointCount)
+	{
+		if (jointCount == this->count)
+		{
+			return;
+		}
+		this->count = jointCount;
+		this->stride = (jointCount + 3) & ~3u;
+		this->data.assign(JOINT_CHANNELS * this->stride, 0.0f);
+	}
+
+	GLfloat* Channel(GLuint channel) { return &this->data[channel * this->stride]; }
+	const GLfloat* Channel(GLuint channel) const { return &this->data[channel * this->stride]; }
+};
+
+// Jerarquia de articulaciones: un nodo de la escena por articulacion, en preorden
+// (el padre siempre va antes que sus hijos, asi la pose global se calcula en una pasada)
+struct Skeleton
+{
+	std::vector<std::string> names;
+	std::vector<GLint> parents;
+	std::vector<glm::mat4> inverseBind;	// De espacio de la malla al del hueso (identidad si no es hueso)
+	std::vector<glm::vec3> bindTranslation;
+	std::vector<glm::quat> bindRotation;
+	std::vector<glm::vec3> bindScale;
+	glm::mat4 globalInverse;			// Inversa de la transformacion del nodo raiz
+	std::map<std::string, GLint> indices;
+
+	Skeleton() : globalInverse(1.0f) {}
+
+	GLuint Count() const { return (GLuint)this->names.size(); }
+
+	// Agrega una articulacion con su transformacion local de reposo; regresa su indice
+	GLint AddJoint(const std::string& name, GLint parent, const glm::mat4& local)
+	{
+		// Se separa la matriz en traslacion, rotacion y escala (sin sesgo)
+		glm::vec3 scale(glm::length(glm::vec3(local[0])), glm::length(glm::vec3(local[1])), glm::length(glm::vec3(local[2])));
+		glm::mat3 rotation(glm::vec3(local[0]) / scale.x, glm::vec3(local[1]) / scale.y, glm::vec3(local[2]) / scale.z);
+		if (glm::determinant(rotation) < 0.0f)
+		{
+			scale.x = -scale.x;
+			rotation[0] = -rotation[0];
+		}
+
+		GLint index = (GLint)this->names.size();
+		this->names.push_back(name);
+		this->parents.push_back(parent);
+		this->inverseBind.push_back(glm::mat4(1.0f));
+		this->bindTranslation.push_back(glm::vec3(local[3]));
+		this->bindRotation.push_back(glm::normalize(glm::quat_cast(rotation)));
+		this->bindScale.push_back(scale);
+		this->indices[name] = index;
+		return index;
+	}
+
+	// Indice de la articulacion con ese nombre (-1 si no existe)
+	GLint Find(const std::string& name) const
+	{
+		std::map<std::string, GLint>::const_iterator it = this->indices.find(name);
+		return it != this->indices.end() ? it->second : -1;
+	}
+};
+
+// Clip de animacion remuestreado a intervalos fijos: cada cuadro es una JointPose completa
+// (todas las articulaciones, las que no se animan con su pose de reposo), asi muestrear es
+// solo mezclar dos cuadros seguidos sin buscar llaves.
+struct AnimationClip
+{
+	std::string name;
+	GLfloat duration;	// Segundos
+	GLfloat frameRate;	// Cuadros por segundo reales (frameCount - 1 intervalos en duration)
+	GLuint frameCount;
+	GLuint jointCount;
+	GLuint stride;
+	std::vector<GLfloat> frames; // [cuadro][componente][articulacion]
+
+	AnimationClip() : duration(0.0f), frameRate(0.0f), frameCount(0), jointCount(0), stride(0) {}
+
+	void Resize(GLuint jointCount, GLfloat clipDuration)
+	{
+		this->duration = clipDuration;
+		this->frameCount = (GLuint)std::ceil(clipDuration * ANIMATION_SAMPLE_RATE) + 1;
+		if (this->frameCount < 2)
+		{
+			this->frameCount = 2;
+		}
+		this->frameRate = clipDuration > 0.0f ? (this->frameCount - 1) / clipDuration : 0.0f;
+		this->jointCount = jointCount;
+		this->stride = (jointCount + 3) & ~3u;
+		this->frames.assign(this->frameCount * JOINT_CHANNELS * this->stride, 0.0f);
+		// Las articulaciones de relleno quedan en identidad
+		for (GLuint f = 0; f < this->frameCount; f++)
+		{
+			for (GLuint j = jointCount; j < this->stride; j++)
+			{
+				this->SetJoint(f, j, glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+			}
+		}
+	}
+
+	// Tiempo (segundos) del cuadro f
+	GLfloat FrameTime(GLuint f) const
+	{
+		return this->frameRate > 0.0f ? f / this->frameRate : 0.0f;
+	}
+
+	void SetJoint(GLuint f, GLuint joint, const glm::vec3& t, const glm::quat& r, const glm::vec3& s)
+	{
+		GLfloat* frame = this->Frame(f);
+		frame[JOINT_TX * this->stride + joint] = t.x;
+		frame[JOINT_TY * this->stride + joint] = t.y;
+		frame[JOINT_TZ * this->stride + joint] = t.z;
+		frame[JOINT_RX * this->stride + joint] = r.x;
+		frame[JOINT_RY * this->stride + joint] = r.y;
+		frame[JOINT_RZ * this->stride + joint] = r.z;
+		frame[JOINT_RW * this->stride + joint] = r.w;
+		frame[JOINT_SX * this->stride + joint] = s.x;
+		frame[JOINT_SY * this->stride + joint] = s.y;
+		frame[JOINT_SZ * this->stride + joint] = s.z;
+	}
+
+	GLfloat* Frame(GLuint f) { return &this->frames[f * JOINT_CHANNELS * this->stride]; }
+	const GLfloat* Frame(GLuint f) const { return &this->frames[f * JOINT_CHANNELS * this->stride]; }
+};
+
+// Pose del clip en un tiempo (se repite en ciclo): interpolacion lineal de traslacion y escala,
+// y nlerp por el camino corto de las rotaciones. Cada componente es un recorrido seguido.
+inline void SampleClip(const AnimationClip& clip, GLfloat time, JointPose& pose)
+{
+	pose.Resize(clip.jointCount);
+	if (clip.frameCount == 0)
+	{
+		return;
+	}
+
+	GLfloat frame = 0.0f;
+	if (clip.duration > 0.0f)
+	{
+		time = std::fmod(time, clip.duration);
+		if (time < 0.0f)
+		{
+			time += clip.duration;
+		}
+		frame = time * clip.frameRate;
+	}
+	GLuint f0 = (GLuint)frame;
+	if (f0 > clip.frameCount - 2)
+	{
+		f0 = clip.frameCount - 2;
+	}
+	GLfloat t = frame - f0;
+	const GLfloat* a = clip.Frame(f0);
+	const GLfloat* b = clip.Frame(f0 + 1);
+	GLuint stride = clip.stride;
+
+	// Traslacion y escala
+	const GLuint linear[] = { JOINT_TX, JOINT_TY, JOINT_TZ, JOINT_SX, JOINT_SY, JOINT_SZ };
+	for (GLuint c = 0; c < 6; c++)
+	{
+		const GLfloat* pa = a + linear[c] * stride;
+		const GLfloat* pb = b + linear[c] * stride;
+		GLfloat* out = pose.Channel(linear[c]);
+#ifdef ANIMATION_USE_SSE2
+		const __m128 weight = _mm_set1_ps(t);
+		for (GLuint j = 0; j < stride; j += 4)
+		{
+			__m128 va = _mm_loadu_ps(pa + j);
+			_mm_storeu_ps(out + j, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(pb + j), va), weight)));
+		}
+#else
+		for (GLuint j = 0; j < stride; j++)
+		{
+			out[j] = pa[j] + (pb[j] - pa[j]) * t;
+		}
+#endif
+	}
+
+	// Rotacion
+	const GLfloat* ax = a + JOINT_RX * stride;
+	const GLfloat* ay = a + JOINT_RY * stride;
+	const GLfloat* az = a + JOINT_RZ * stride;
+	const GLfloat* aw = a + JOINT_RW * stride;
+	const GLfloat* bx = b + JOINT_RX * stride;
+	const GLfloat* by = b + JOINT_RY * stride;
+	const GLfloat* bz = b + JOINT_RZ * stride;
+	const GLfloat* bw = b + JOINT_RW * stride;
+	GLfloat* ox = pose.Channel(JOINT_RX);
+	GLfloat* oy = pose.Channel(JOINT_RY);
+	GLfloat* oz = pose.Channel(JOINT_RZ);
+	GLfloat* ow = pose.Channel(JOINT_RW);
+#ifdef ANIMATION_USE_SSE2
+	const __m128 weight = _mm_set1_ps(t);
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (GLuint j = 0; j < stride; j += 4)
+	{
+		__m128 qax = _mm_loadu_ps(ax + j), qay = _mm_loadu_ps(ay + j), qaz = _mm_loadu_ps(az + j), qaw = _mm_loadu_ps(aw + j);
+		__m128 qbx = _mm_loadu_ps(bx + j), qby = _mm_loadu_ps(by + j), qbz = _mm_loadu_ps(bz + j), qbw = _mm_loadu_ps(bw + j);
+
+		// Si el producto punto es negativo se voltea b (q y -q son la misma rotacion)
+		__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(qax, qbx), _mm_mul_ps(qay, qby)), _mm_add_ps(_mm_mul_ps(qaz, qbz), _mm_mul_ps(qaw, qbw)));
+		__m128 flip = _mm_and_ps(dot, signBit);
+		qbx = _mm_xor_ps(qbx, flip);
+		qby = _mm_xor_ps(qby, flip);
+		qbz = _mm_xor_ps(qbz, flip);
+		qbw = _mm_xor_ps(qbw, flip);
+
+		__m128 x = _mm_add_ps(qax, _mm_mul_ps(_mm_sub_ps(qbx, qax), weight));
+		__m128 y = _mm_add_ps(qay, _mm_mul_ps(_mm_sub_ps(qby, qay), weight));
+		__m128 z = _mm_add_ps(qaz, _mm_mul_ps(_mm_sub_ps(qbz, qaz), weight));
+		__m128 w = _mm_add_ps(qaw, _mm_mul_ps(_mm_sub_ps(qbw, qaw), weight));
+		__m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+		__m128 inverseLength = _mm_div_ps(one, _mm_sqrt_ps(length2));
+
+		_mm_storeu_ps(ox + j, _mm_mul_ps(x, inverseLength));
+		_mm_storeu_ps(oy + j, _mm_mul_ps(y, inverseLength));
+		_mm_storeu_ps(oz + j, _mm_mul_ps(z, inverseLength));
+		_mm_storeu_ps(ow + j, _mm_mul_ps(w, inverseLength));
+	}
+#else
+	for (GLuint j = 0; j < stride; j++)
+	{
+		GLfloat dot = ax[j] * bx[j] + ay[j] * by[j] + az[j] * bz[j] + aw[j] * bw[j];
+		GLfloat sign = dot < 0.0f ? -1.0f : 1.0f;
+		GLfloat x = ax[j] + (bx[j] * sign - ax[j]) * t;
+		GLfloat y = ay[j] + (by[j] * sign - ay[j]) * t;
+		GLfloat z = az[j] + (bz[j] * sign - az[j]) * t;
+		GLfloat w = aw[j] + (bw[j] * sign - aw[j]) * t;
+		GLfloat inverseLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+		ox[j] = x * inverseLength;
+		oy[j] = y * inverseLength;
+		oz[j] = z * inverseLength;
+		ow[j] = w * inverseLength;
+	}
+#endif
+}
+
+// Matrices de skinning de una pose (de espacio de la malla al de la pose), una por articulacion.
+// globals queda con la transformacion de cada articulacion, se reutiliza entre llamadas.
+inline void ComputeSkinMatrices(const Skeleton& skeleton, const JointPose& pose, std::vector<glm::mat4>& globals, std::vector<glm::mat4>& skin)
+{
+	GLuint count = skeleton.Count();
+	globals.resize(count);
+	skin.resize(count);
+
+	const GLfloat* tx = pose.Channel(JOINT_TX);
+	const GLfloat* ty = pose.Channel(JOINT_TY);
+	const GLfloat* tz = pose.Channel(JOINT_TZ);
+	const GLfloat* rx = pose.Channel(JOINT_RX);
+	const GLfloat* ry = pose.Channel(JOINT_RY);
+	const GLfloat* rz = pose.Channel(JOINT_RZ);
+	const GLfloat* rw = pose.Channel(JOINT_RW);
+	const GLfloat* sx = pose.Channel(JOINT_SX);
+	const GLfloat* sy = pose.Channel(JOINT_SY);
+	const GLfloat* sz = pose.Channel(JOINT_SZ);
+	for (GLuint j = 0; j < count; j++)
+	{
+		// Matriz local (rotacion * escala, con la traslacion en la ultima columna)
+		GLfloat x2 = rx[j] + rx[j], y2 = ry[j] + ry[j], z2 = rz[j] + rz[j];
+		GLfloat xx = rx[j] * x2, yy = ry[j] * y2, zz = rz[j] * z2;
+		GLfloat xy = rx[j] * y2, xz = rx[j] * z2, yz = ry[j] * z2;
+		GLfloat wx = rw[j] * x2, wy = rw[j] * y2, wz = rw[j] * z2;
+		glm::mat4 local;
+		local[0] = glm::vec4((1.0f - (yy + zz)) * sx[j], (xy + wz) * sx[j], (xz - wy) * sx[j], 0.0f);
+		local[1] = glm::vec4((xy - wz) * sy[j], (1.0f - (xx + zz)) * sy[j], (yz + wx) * sy[j], 0.0f);
+		local[2] = glm::vec4((xz + wy) * sz[j], (yz - wx) * sz[j], (1.0f - (xx + yy)) * sz[j], 0.0f);
+		local[3] = glm::vec4(tx[j], ty[j], tz[j], 1.0f);
+
+		// Los padres ya estan calculados (preorden); la inversa de la raiz va en la raiz
+		GLint parent = skeleton.parents[j];
+		globals[j] = (parent < 0 ? skeleton.globalInverse : globals[parent]) * local;
+		skin[j] = globals[j] * skeleton.inverseBind[j];
+	}
+}
+
+// Paleta de huesos de todas las criaturas animadas del cuadro.
+// Cada cuadro: Begin(), Add() por criatura (regresa su primer hueso), Upload() y luego
+// Bind() antes de dibujar cada una. Los huesos se copian al StreamingBuffer del cuadro y se
+// leen por su texture buffer RGBA32F, 3 texeles por hueso (las 3 primeras filas de la matriz
+// de skinning); el vertex shader (#define SKINNED) los lee en boneOffset + boneIds.
+class SkinningPalette
+{
+public:
+	// El buffer debe vivir mas que la paleta
+	SkinningPalette(StreamingBuffer& stream)
+		: stream(&stream), firstUploaded(-1), maxBones(0)
+	{
+		// Lo que cabe en la region de un cuadro; si el texture buffer no alcanza lo dice Upload()
+		this->maxBones = (GLuint)(stream.GetFrameSize() / (3 * sizeof(glm::vec4)));
+	}
+
+	void Begin()
+	{
+		this->rows.clear();
+	}
+
+	// Calcula las matrices de skinning de una pose y las agrega; regresa el primer hueso
+	GLint Add(const Skeleton& skeleton, const JointPose& pose)
+	{
+		if (pose.count < skeleton.Count())
+		{
+			std::cout << "ERROR::SKINNING::PALETTE_FULL" << std::endl;
+			return 0;
+		}
+		GLint first = this->Allocate(skeleton);
+		if (first < 0)
+		{
+			return 0;
+		}
+		this->Fill(first, skeleton, pose, this->globals, this->skins);
+		return first;
+	}
+
+	// Add() en dos partes para llenar la paleta desde varios hilos: Allocate() aparta los huesos
+	// (en un solo hilo) y Fill() los escribe con matrices temporales propias de cada hilo
+	GLint Allocate(const Skeleton& skeleton)
+	{
+		GLuint count = skeleton.Count();
+		GLuint first = (GLuint)(this->rows.size() / 3);
+		if (first + count > this->maxBones)
+		{
+			std::cout << "ERROR::SKINNING::PALETTE_FULL" << std::endl;
+			return -1;
+		}
+		this->rows.resize((first + count) * 3);
+		return (GLint)first;
+	}
+
+	void Fill(GLint first, const Skeleton& skeleton, const JointPose& pose, std::vector<glm::mat4>& globals, std::vector<glm::mat4>& skins)
+	{
+		GLuint count = skeleton.Count();
+		if (first < 0 || pose.count < count)
+		{
+			return;
+		}
+		ComputeSkinMatrices(skeleton, pose, globals, skins);
+		for (GLuint j = 0; j < count; j++)
+		{
+			// Solo las 3 primeras filas (la cuarta siempre es 0, 0, 0, 1)
+			const glm::mat4& skin = skins[j];
+			glm::vec4* row = &this->rows[(first + j) * 3];
+			row[0] = glm::vec4(skin[0][0], skin[1][0], skin[2][0], skin[3][0]);
+			row[1] = glm::vec4(skin[0][1], skin[1][1], skin[2][1], skin[3][1]);
+			row[2] = glm::vec4(skin[0][2], skin[1][2], skin[2][2], skin[3][2]);
+		}
+	}
+
+	// Copia los huesos del cuadro al buffer (un memcpy; el StreamingBuffer ya va en su BeginFrame()).
+	// Si no cupieron IsUploaded() es false y no se debe dibujar con ellos
+	void Upload()
+	{
+		this->firstUploaded = -1;
+		if (this->rows.empty())
+		{
+			return;
+		}
+		GLsizeiptr size = this->rows.size() * sizeof(glm::vec4);
+		StreamAllocation allocation = this->stream->Allocate(size, 3 * sizeof(glm::vec4), sizeof(glm::vec4));
+		if (allocation.data == NULL)
+		{
+			return;
+		}
+		memcpy(allocation.data, &this->rows[0], size);
+		this->firstUploaded = (GLint)(allocation.offset / (3 * sizeof(glm::vec4)));
+	}
+
+	// Enlaza la paleta para dibujar la criatura que empieza en ese hueso (programa activo)
+	void Bind(GLuint program, GLint firstBone)
+	{
+		glActiveTexture(GL_TEXTURE0 + SKINNING_TEXTURE_UNIT);
+		glBindTexture(GL_TEXTURE_BUFFER, this->stream->GetTexture(GL_RGBA32F));
+		glActiveTexture(GL_TEXTURE0);
+		glUniform1i(glGetUniformLocation(program, "bonePalette"), SKINNING_TEXTURE_UNIT);
+		glUniform1i(glGetUniformLocation(program, "boneOffset"), this->firstUploaded + firstBone);
+	}
+
+	bool IsUploaded() const { return this->firstUploaded >= 0; }
+
+	// Huesos subidos en el cuadro
+	GLuint GetBoneCount() const
+	{
+		return (GLuint)(this->rows.size() / 3);
+	}
+
+private:
+	StreamingBuffer* stream;
+	GLint firstUploaded;	// Primer hueso de la paleta dentro del buffer en el ultimo Upload() (-1 si fallo)
+	GLuint maxBones;
+	std::vector<glm::vec4> rows;
+	std::vector<glm::mat4> globals;
+	std::vector<glm::mat4> skins;
+};
@@ -0,0 +1,559 @@
+#pragma once
+
+// Std. Includes
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "Animation.h"
+
+// Error maximo que se acepta al quitar llaves (en el espacio local de cada articulacion)
+const GLfloat ANIMATION_TRANSLATION_TOLERANCE = 0.01f;	// Unidades del modelo
+const GLfloat ANIMATION_ROTATION_TOLERANCE = 0.001f;	// Radianes
+const GLfloat ANIMATION_SCALE_TOLERANCE = 0.0005f;
+
+// Componentes de cada articulacion que se guardan como pistas separadas
+enum Track_Type
+{
+	TRACK_TRANSLATION,
+	TRACK_ROTATION,
+	TRACK_SCALE,
+	TRACK_TYPES
+};
+
+// Llave comprimida: el cuadro del clip y 3 valores de 16 bits (8 bytes, 8 llaves por linea de cache).
+// Traslacion y escala: cada componente cuantizada en el rango de su pista.
+// Rotacion: "smallest three", las 3 componentes menores del cuaternion en 15 bits y el indice
+// de la mayor en los bits altos de las dos primeras (la mayor se reconstruye, |q| = 1).
+struct CompressedKey
+{
+	GLushort frame;
+	GLushort values[3];
+};
+
+// Pista de una componente de una articulacion: sus llaves van seguidas a partir de firstKey
+struct CompressedTrack
+{
+	GLuint firstKey;
+	GLuint keyCount;
+	glm::vec3 minimum;	// Rango de la cuantizacion (traslacion y escala)
+	glm::vec3 extent;
+};
+
+// Posicion de reproduccion de una instancia. Por cada pista guarda la llave actual y las dos
+// llaves que la rodean ya decodificadas (en from/to, por componente como JointPose), asi cada
+// cuadro solo se mezclan; se decodifica de nuevo unicamente al pasar a la siguiente llave.
+// Hacia adelante se avanza desde la llave actual (sin busqueda); si el tiempo regresa (el ciclo
+// volvio a empezar o se salto) se busca de nuevo con busqueda binaria.
+struct AnimationCursor
+{
+	GLfloat frame;
+	// Todo por [tipo][articulacion], como las componentes de JointPose
+	std::vector<GLuint> keys;		// Llave actual
+	std::vector<GLfloat> start;		// Cuadro de la llave actual
+	std::vector<GLfloat> end;		// Cuadro de la siguiente (o infinito si es la ultima)
+	std::vector<GLfloat> inverseSpan;	// 1 / (end - start)
+	std::vector<GLfloat> weights;	// Cuanto se mezcla to en este cuadro
+	JointPose from;
+	JointPose to;
+
+	AnimationCursor() : frame(-1.0f) {}
+};
+
+// Clip comprimido a partir de un AnimationClip ya remuestreado.
+// Cada pista se cuantiza y luego se quitan las llaves que se pueden reconstruir interpolando
+// sus vecinas sin pasar la tolerancia (el error se mide contra el clip original, ya con la
+// cuantizacion). Las pistas van por articulacion (traslacion, rotacion, escala) en el orden
+// del esqueleto, asi Sample recorre la memoria de corrido.
+class CompressedClip
+{
+public:
+	std::string name;
+	GLfloat duration;
+	GLfloat frameRate;
+	GLuint frameCount;
+	GLuint jointCount;
+
+	// Error maximo que quedo en todo el clip (para reportarlo)
+	GLfloat maxTranslationError;
+	GLfloat maxRotationError;
+	GLfloat maxScaleError;
+
+	CompressedClip(const AnimationClip& clip,
+		GLfloat translationTolerance = ANIMATION_TRANSLATION_TOLERANCE,
+		GLfloat rotationTolerance = ANIMATION_ROTATION_TOLERANCE,
+		GLfloat scaleTolerance = ANIMATION_SCALE_TOLERANCE)
+		: name(clip.name), duration(clip.duration), frameRate(clip.frameRate), frameCount(clip.frameCount), jointCount(clip.jointCount),
+		maxTranslationError(0.0f), maxRotationError(0.0f), maxScaleError(0.0f)
+	{
+		if (clip.frameCount > 65535)
+		{
+			std::cout << "ERROR::ANIMATION::CLIP_TOO_LONG " << clip.name << std::endl;
+			this->frameCount = 0;
+			return;
+		}
+		this->tracks.resize(this->jointCount * TRACK_TYPES);
+		for (GLuint j = 0; j < this->jointCount; j++)
+		{
+			this->compressVector(clip, j, TRACK_TRANSLATION, JOINT_TX, translationTolerance, this->maxTranslationError);
+			this->compressRotation(clip, j, rotationTolerance);
+			this->compressVector(clip, j, TRACK_SCALE, JOINT_SX, scaleTolerance, this->maxScaleError);
+		}
+	}
+
+	// Pose del clip en un tiempo (se repite en ciclo), avanzando el cursor de la instancia
+	void Sample(GLfloat time, AnimationCursor& cursor, JointPose& pose) const
+	{
+		pose.Resize(this->jointCount);
+		if (this->frameCount == 0)
+		{
+			return;
+		}
+
+		GLfloat frame = 0.0f;
+		if (this->duration > 0.0f)
+		{
+			time = std::fmod(time, this->duration);
+			if (time < 0.0f)
+			{
+				time += this->duration;
+			}
+			frame = std::min(time * this->frameRate, (GLfloat)(this->frameCount - 1));
+		}
+
+		// Solo hacia adelante se reutilizan las llaves del cursor
+		bool seek = cursor.from.count != this->jointCount || frame < cursor.frame;
+		if (cursor.from.count != this->jointCount)
+		{
+			this->resetCursor(cursor);
+		}
+		cursor.frame = frame;
+
+		GLuint stride = cursor.from.stride;
+		if (seek)
+		{
+			for (GLuint type = 0; type < TRACK_TYPES; type++)
+			{
+				for (GLuint j = 0; j < this->jointCount; j++)
+				{
+					this->seekKey(j, type, frame, cursor);
+				}
+			}
+		}
+
+		// Peso de cada pista; las que ya pasaron su siguiente llave avanzan (pocas en cada cuadro)
+		for (GLuint type = 0; type < TRACK_TYPES; type++)
+		{
+			GLuint base = type * stride;
+#ifdef ANIMATION_USE_SSE2
+			const __m128 current = _mm_set1_ps(frame);
+			const __m128 one = _mm_set1_ps(1.0f);
+			for (GLuint j = 0; j < stride; j += 4)
+			{
+				int passed = _mm_movemask_ps(_mm_cmpge_ps(current, _mm_loadu_ps(&cursor.end[base + j])));
+				for (GLuint lane = 0; passed; lane++, passed >>= 1)
+				{
+					if (passed & 1)
+					{
+						this->advanceKey(j + lane, type, frame, cursor);
+					}
+				}
+				__m128 weight = _mm_mul_ps(_mm_sub_ps(current, _mm_loadu_ps(&cursor.start[base + j])), _mm_loadu_ps(&cursor.inverseSpan[base + j]));
+				_mm_storeu_ps(&cursor.weights[base + j], _mm_min_ps(weight, one));
+			}
+#else
+			for (GLuint j = 0; j < this->jointCount; j++)
+			{
+				if (frame >= cursor.end[base + j])
+				{
+					this->advanceKey(j, type, frame, cursor);
+				}
+				cursor.weights[base + j] = std::min((frame - cursor.start[base + j]) * cursor.inverseSpan[base + j], 1.0f);
+			}
+#endif
+		}
+
+		BlendPoses(cursor.from, cursor.to, &cursor.weights[0], pose);
+	}
+
+	// Mezcla dos poses con un peso por articulacion y tipo de pista (weights[tipo][articulacion]).
+	// Las rotaciones de to ya vienen del lado corto de las de from.
+	static void BlendPoses(const JointPose& from, const JointPose& to, const GLfloat* weights, JointPose& pose)
+	{
+		GLuint stride = from.stride;
+		const GLuint weightOf[JOINT_CHANNELS] = {
+			TRACK_TRANSLATION, TRACK_TRANSLATION, TRACK_TRANSLATION,
+			TRACK_ROTATION, TRACK_ROTATION, TRACK_ROTATION, TRACK_ROTATION,
+			TRACK_SCALE, TRACK_SCALE, TRACK_SCALE };
+		for (GLuint c = 0; c < JOINT_CHANNELS; c++)
+		{
+			const GLfloat* a = from.Channel(c);
+			const GLfloat* b = to.Channel(c);
+			const GLfloat* w = weights + weightOf[c] * stride;
+			GLfloat* out = pose.Channel(c);
+#ifdef ANIMATION_USE_SSE2
+			for (GLuint j = 0; j < stride; j += 4)
+			{
+				__m128 va = _mm_loadu_ps(a + j);
+				_mm_storeu_ps(out + j, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b + j), va), _mm_loadu_ps(w + j))));
+			}
+#else
+			for (GLuint j = 0; j < stride; j++)
+			{
+				out[j] = a[j] + (b[j] - a[j]) * w[j];
+			}
+#endif
+		}
+
+		// nlerp: se normalizan las rotaciones mezcladas
+		GLfloat* x = pose.Channel(JOINT_RX);
+		GLfloat* y = pose.Channel(JOINT_RY);
+		GLfloat* z = pose.Channel(JOINT_RZ);
+		GLfloat* w = pose.Channel(JOINT_RW);
+#ifdef ANIMATION_USE_SSE2
+		const __m128 one = _mm_set1_ps(1.0f);
+		for (GLuint j = 0; j < stride; j += 4)
+		{
+			__m128 qx = _mm_loadu_ps(x + j), qy = _mm_loadu_ps(y + j), qz = _mm_loadu_ps(z + j), qw = _mm_loadu_ps(w + j);
+			__m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(qx, qx), _mm_mul_ps(qy, qy)), _mm_add_ps(_mm_mul_ps(qz, qz), _mm_mul_ps(qw, qw)));
+			__m128 inverseLength = _mm_div_ps(one, _mm_sqrt_ps(length2));
+			_mm_storeu_ps(x + j, _mm_mul_ps(qx, inverseLength));
+			_mm_storeu_ps(y + j, _mm_mul_ps(qy, inverseLength));
+			_mm_storeu_ps(z + j, _mm_mul_ps(qz, inverseLength));
+			_mm_storeu_ps(w + j, _mm_mul_ps(qw, inverseLength));
+		}
+#else
+		for (GLuint j = 0; j < stride; j++)
+		{
+			GLfloat inverseLength = 1.0f / std::sqrt(x[j] * x[j] + y[j] * y[j] + z[j] * z[j] + w[j] * w[j]);
+			x[j] *= inverseLength;
+			y[j] *= inverseLength;
+			z[j] *= inverseLength;
+			w[j] *= inverseLength;
+		}
+#endif
+	}
+
+	// Llaves que quedaron (de frameCount * jointCount * TRACK_TYPES)
+	GLuint GetKeyCount() const
+	{
+		return (GLuint)this->keys.size();
+	}
+
+	// Memoria de las llaves y las pistas
+	size_t GetMemoryBytes() const
+	{
+		return this->keys.size() * sizeof(CompressedKey) + this->tracks.size() * sizeof(CompressedTrack);
+	}
+
+	// Memoria del clip sin comprimir: 10 floats por articulacion por cuadro
+	static size_t GetRawMemoryBytes(const AnimationClip& clip)
+	{
+		return (size_t)clip.frameCount * clip.jointCount * JOINT_CHANNELS * sizeof(GLfloat);
+	}
+
+	static glm::quat Nlerp(const glm::quat& a, glm::quat b, GLfloat t)
+	{
+		if (glm::dot(a, b) < 0.0f)
+		{
+			b = -b;
+		}
+		return glm::normalize(glm::quat(a.w + (b.w - a.w) * t, a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t));
+	}
+
+	static CompressedKey EncodeRotation(glm::quat q)
+	{
+		GLfloat components[4] = { q.x, q.y, q.z, q.w };
+		GLuint largest = 0;
+		for (GLuint i = 1; i < 4; i++)
+		{
+			if (std::fabs(components[i]) > std::fabs(components[largest]))
+			{
+				largest = i;
+			}
+		}
+		// q y -q son la misma rotacion: se deja positiva la mayor para no guardar su signo
+		GLfloat sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+		CompressedKey key;
+		key.frame = 0;
+		for (GLuint i = 0, n = 0; i < 4; i++)
+		{
+			if (i == largest)
+			{
+				continue;
+			}
+			// Las menores estan en [-1/sqrt(2), 1/sqrt(2)]
+			GLfloat unit = glm::clamp(components[i] * sign * 0.70710678f + 0.5f, 0.0f, 1.0f);
+			key.values[n++] = (GLushort)(unit * 32767.0f + 0.5f);
+		}
+		key.values[0] |= (GLushort)((largest & 1) << 15);
+		key.values[1] |= (GLushort)((largest >> 1) << 15);
+		return key;
+	}
+
+	static glm::quat DecodeRotation(const CompressedKey& key)
+	{
+		GLuint largest = (key.values[0] >> 15) | ((key.values[1] >> 15) << 1);
+		GLfloat components[4];
+		GLfloat sum = 0.0f;
+		for (GLuint i = 0, n = 0; i < 4; i++)
+		{
+			if (i == largest)
+			{
+				continue;
+			}
+			components[i] = ((key.values[n++] & 0x7FFF) * (1.0f / 32767.0f) - 0.5f) * 1.41421356f;
+			sum += components[i] * components[i];
+		}
+		components[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+		return glm::quat(components[3], components[0], components[1], components[2]);
+	}
+
+private:
+	std::vector<CompressedTrack> tracks;	// [articulacion * TRACK_TYPES + tipo]
+	std::vector<CompressedKey> keys;
+
+	// Prepara el cursor para este clip (las articulaciones de relleno quedan en identidad y nunca avanzan)
+	void resetCursor(AnimationCursor& cursor) const
+	{
+		cursor.from.Resize(this->jointCount);
+		cursor.to.Resize(this->jointCount);
+		GLuint size = TRACK_TYPES * cursor.from.stride;
+		cursor.keys.assign(size, 0);
+		cursor.start.assign(size, 0.0f);
+		cursor.end.assign(size, 1e30f);
+		cursor.inverseSpan.assign(size, 0.0f);
+		cursor.weights.assign(size, 0.0f);
+		for (GLuint j = this->jointCount; j < cursor.from.stride; j++)
+		{
+			setVector(cursor.from, j, JOINT_TX, glm::vec3(0.0f));
+			setVector(cursor.to, j, JOINT_TX, glm::vec3(0.0f));
+			setRotation(cursor.from, j, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+			setRotation(cursor.to, j, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+			setVector(cursor.from, j, JOINT_SX, glm::vec3(1.0f));
+			setVector(cursor.to, j, JOINT_SX, glm::vec3(1.0f));
+		}
+	}
+
+	// Busca la llave del cuadro (primera llave despues de el, menos una)
+	void seekKey(GLuint joint, GLuint type, GLfloat frame, AnimationCursor& cursor) const
+	{
+		const CompressedTrack& info = this->tracks[joint * TRACK_TYPES + type];
+		const CompressedKey* begin = &this->keys[info.firstKey];
+		const CompressedKey* found = std::upper_bound(begin + 1, begin + info.keyCount, frame,
+			[](GLfloat value, const CompressedKey& k) { return value < (GLfloat)k.frame; });
+		this->loadKey(joint, type, info.firstKey + (GLuint)(found - begin) - 1, cursor);
+	}
+
+	// Avanza desde la llave actual hasta la del cuadro
+	void advanceKey(GLuint joint, GLuint type, GLfloat frame, AnimationCursor& cursor) const
+	{
+		const CompressedTrack& info = this->tracks[joint * TRACK_TYPES + type];
+		GLuint last = info.firstKey + info.keyCount - 1;
+		GLuint key = cursor.keys[type * cursor.from.stride + joint];
+		while (key < last && (GLfloat)this->keys[key + 1].frame <= frame)
+		{
+			key++;
+		}
+		this->loadKey(joint, type, key, cursor);
+	}
+
+	// Decodifica la llave y la siguiente en el cursor
+	void loadKey(GLuint joint, GLuint type, GLuint key, AnimationCursor& cursor) const
+	{
+		GLuint track = joint * TRACK_TYPES + type;
+		const CompressedTrack& info = this->tracks[track];
+		GLuint next = key + 1 < info.firstKey + info.keyCount ? key + 1 : key;
+		const CompressedKey& a = this->keys[key];
+		const CompressedKey& b = this->keys[next];
+		GLuint index = type * cursor.from.stride + joint;
+		cursor.keys[index] = key;
+		cursor.start[index] = a.frame;
+		cursor.end[index] = next != key ? (GLfloat)b.frame : 1e30f;
+		cursor.inverseSpan[index] = next != key ? 1.0f / (b.frame - a.frame) : 0.0f;
+
+		if (type == TRACK_ROTATION)
+		{
+			glm::quat qa = DecodeRotation(a);
+			glm::quat qb = DecodeRotation(b);
+			if (glm::dot(qa, qb) < 0.0f)
+			{
+				qb = -qb;
+			}
+			setRotation(cursor.from, joint, qa);
+			setRotation(cursor.to, joint, qb);
+		}
+		else
+		{
+			GLuint channel = type == TRACK_TRANSLATION ? JOINT_TX : JOINT_SX;
+			setVector(cursor.from, joint, channel, this->decodeVector(track, a));
+			setVector(cursor.to, joint, channel, this->decodeVector(track, b));
+		}
+	}
+
+	static void setVector(JointPose& pose, GLuint joint, GLuint channel, const glm::vec3& value)
+	{
+		pose.Channel(channel)[joint] = value.x;
+		pose.Channel(channel + 1)[joint] = value.y;
+		pose.Channel(channel + 2)[joint] = value.z;
+	}
+
+	static void setRotation(JointPose& pose, GLuint joint, const glm::quat& value)
+	{
+		pose.Channel(JOINT_RX)[joint] = value.x;
+		pose.Channel(JOINT_RY)[joint] = value.y;
+		pose.Channel(JOINT_RZ)[joint] = value.z;
+		pose.Channel(JOINT_RW)[joint] = value.w;
+	}
+
+	glm::vec3 decodeVector(GLuint track, const CompressedKey& key) const
+	{
+		const CompressedTrack& info = this->tracks[track];
+		return info.minimum + glm::vec3(key.values[0], key.values[1], key.values[2]) * (1.0f / 65535.0f) * info.extent;
+	}
+
+	static glm::vec3 readVector(const AnimationClip& clip, GLuint frame, GLuint joint, GLuint channel)
+	{
+		const GLfloat* data = clip.Frame(frame);
+		return glm::vec3(data[channel * clip.stride + joint], data[(channel + 1) * clip.stride + joint], data[(channel + 2) * clip.stride + joint]);
+	}
+
+	static glm::quat readRotation(const AnimationClip& clip, GLuint frame, GLuint joint)
+	{
+		const GLfloat* data = clip.Frame(frame);
+		return glm::quat(data[JOINT_RW * clip.stride + joint], data[JOINT_RX * clip.stride + joint], data[JOINT_RY * clip.stride + joint], data[JOINT_RZ * clip.stride + joint]);
+	}
+
+	static GLfloat angleBetween(const glm::quat& a, const glm::quat& b)
+	{
+		return 2.0f * std::acos(std::min(1.0f, std::fabs(glm::dot(a, b))));
+	}
+
+	// Quita las llaves que sobran de una pista ya cuantizada: de cada llave que se queda se avanza
+	// mientras la recta hasta el siguiente candidato explique todos los cuadros de en medio.
+	// error(i, a, b) es el error del cuadro i interpolando entre los cuadros a y b.
+	template <typename ErrorFunction>
+	static std::vector<GLuint> reduceKeys(GLuint frameCount, GLfloat tolerance, ErrorFunction error, GLfloat& maxError)
+	{
+		std::vector<GLuint> kept(1, 0);
+		GLuint start = 0;
+		for (GLuint end = 2; end < frameCount; end++)
+		{
+			for (GLuint i = start + 1; i < end; i++)
+			{
+				if (error(i, start, end) > tolerance)
+				{
+					start = end - 1;
+					kept.push_back(start);
+					break;
+				}
+			}
+		}
+		if (frameCount > 1)
+		{
+			kept.push_back(frameCount - 1);
+		}
+
+		// Pista constante: basta una llave
+		bool constant = true;
+		for (GLuint i = 0; i < frameCount && constant; i++)
+		{
+			constant = error(i, 0, 0) <= tolerance;
+		}
+		if (constant)
+		{
+			kept.resize(1);
+		}
+
+		// Error que quedo en cada cuadro
+		for (size_t k = 0; k < kept.size(); k++)
+		{
+			GLuint a = kept[k];
+			GLuint b = k + 1 < kept.size() ? kept[k + 1] : a;
+			GLuint until = k + 1 < kept.size() ? b : frameCount - 1;
+			for (GLuint i = a; i <= until; i++)
+			{
+				maxError = std::max(maxError, error(i, a, b));
+			}
+		}
+		return kept;
+	}
+
+	void compressVector(const AnimationClip& clip, GLuint joint, GLuint type, GLuint channel, GLfloat tolerance, GLfloat& maxError)
+	{
+		CompressedTrack& track = this->tracks[joint * TRACK_TYPES + type];
+		std::vector<glm::vec3> original(clip.frameCount);
+		track.minimum = glm::vec3(1e30f);
+		glm::vec3 maximum(-1e30f);
+		for (GLuint f = 0; f < clip.frameCount; f++)
+		{
+			original[f] = readVector(clip, f, joint, channel);
+			track.minimum = glm::min(track.minimum, original[f]);
+			maximum = glm::max(maximum, original[f]);
+		}
+		track.extent = maximum - track.minimum;
+
+		// Cuantiza todos los cuadros y quita los que no hacen falta
+		std::vector<CompressedKey> quantized(clip.frameCount);
+		std::vector<glm::vec3> decoded(clip.frameCount);
+		for (GLuint f = 0; f < clip.frameCount; f++)
+		{
+			quantized[f].frame = (GLushort)f;
+			for (GLuint c = 0; c < 3; c++)
+			{
+				GLfloat unit = track.extent[c] > 0.0f ? (original[f][c] - track.minimum[c]) / track.extent[c] : 0.0f;
+				quantized[f].values[c] = (GLushort)(glm::clamp(unit, 0.0f, 1.0f) * 65535.0f + 0.5f);
+			}
+			decoded[f] = track.minimum + glm::vec3(quantized[f].values[0], quantized[f].values[1], quantized[f].values[2]) * (1.0f / 65535.0f) * track.extent;
+		}
+		std::vector<GLuint> kept = reduceKeys(clip.frameCount, tolerance, [&](GLuint i, GLuint a, GLuint b)
+		{
+			GLfloat t = b > a ? (GLfloat)(i - a) / (b - a) : 0.0f;
+			return glm::length(glm::mix(decoded[a], decoded[b], t) - original[i]);
+		}, maxError);
+
+		track.firstKey = (GLuint)this->keys.size();
+		track.keyCount = (GLuint)kept.size();
+		for (size_t k = 0; k < kept.size(); k++)
+		{
+			this->keys.push_back(quantized[kept[k]]);
+		}
+	}
+
+	void compressRotation(const AnimationClip& clip, GLuint joint, GLfloat tolerance)
+	{
+		CompressedTrack& track = this->tracks[joint * TRACK_TYPES + TRACK_ROTATION];
+		track.minimum = glm::vec3(0.0f);
+		track.extent = glm::vec3(0.0f);
+
+		std::vector<glm::quat> original(clip.frameCount);
+		std::vector<CompressedKey> quantized(clip.frameCount);
+		std::vector<glm::quat> decoded(clip.frameCount);
+		for (GLuint f = 0; f < clip.frameCount; f++)
+		{
+			original[f] = readRotation(clip, f, joint);
+			quantized[f] = EncodeRotation(original[f]);
+			quantized[f].frame = (GLushort)f;
+			decoded[f] = DecodeRotation(quantized[f]);
+		}
+		std::vector<GLuint> kept = reduceKeys(clip.frameCount, tolerance, [&](GLuint i, GLuint a, GLuint b)
+		{
+			GLfloat t = b > a ? (GLfloat)(i - a) / (b - a) : 0.0f;
+			return angleBetween(Nlerp(decoded[a], decoded[b], t), original[i]);
+		}, this->maxRotationError);
+
+		track.firstKey = (GLuint)this->keys.size();
+		track.keyCount = (GLuint)kept.size();
+		for (size_t k = 0; k < kept.size(); k++)
+		{
+			this->keys.push_back(quantized[kept[k]]);
+		}
+	}
+};
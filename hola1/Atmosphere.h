@@ -0,0 +1,422 @@
+#pragma once
+
+// Std. Includes
+#include <string>
+#include <iostream>
+#include <cmath>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader.h"
+
+// Tamano de las tablas: transmitancia (altura x angulo), dispersion multiple (altura x sol)
+// y vista del cielo (azimut respecto al sol x elevacion)
+const GLint ATMOSPHERE_TRANSMITTANCE_WIDTH = 256;
+const GLint ATMOSPHERE_TRANSMITTANCE_HEIGHT = 64;
+const GLint ATMOSPHERE_MULTI_SCATTERING_SIZE = 32;
+const GLint ATMOSPHERE_SKY_VIEW_WIDTH = 192;
+const GLint ATMOSPHERE_SKY_VIEW_HEIGHT = 108;
+
+// Unidad de textura de la primera tabla (7..9; ver SHADOW_TEXTURE_UNIT)
+const GLuint ATMOSPHERE_TEXTURE_UNIT = 7;
+
+// La tabla del cielo se rehace cuando el sol se mueve mas de este angulo (radianes)
+const GLfloat ATMOSPHERE_SUN_EPSILON = 0.002f;
+
+// Planeta y atmosfera, en km (valores de la Tierra)
+const GLfloat ATMOSPHERE_GROUND_RADIUS = 6360.0f;
+const GLfloat ATMOSPHERE_TOP_RADIUS = 6460.0f;
+const glm::vec3 ATMOSPHERE_RAYLEIGH_SCATTERING(5.802e-3f, 13.558e-3f, 33.1e-3f);
+const GLfloat ATMOSPHERE_RAYLEIGH_HEIGHT = 8.0f;
+const GLfloat ATMOSPHERE_MIE_SCATTERING = 3.996e-3f;
+const GLfloat ATMOSPHERE_MIE_EXTINCTION = 4.440e-3f;
+const GLfloat ATMOSPHERE_MIE_HEIGHT = 1.2f;
+const GLfloat ATMOSPHERE_MIE_G = 0.8f;
+const glm::vec3 ATMOSPHERE_OZONE_ABSORPTION(0.650e-3f, 1.881e-3f, 0.085e-3f);
+const GLfloat ATMOSPHERE_OZONE_CENTER = 25.0f;
+const GLfloat ATMOSPHERE_OZONE_WIDTH = 15.0f;
+const glm::vec3 ATMOSPHERE_GROUND_ALBEDO(0.3f, 0.3f, 0.3f);
+
+// Altura de la escena sobre el nivel del mar (km) y km por unidad de la escena
+const GLfloat ATMOSPHERE_SCENE_ALTITUDE = 0.2f;
+const GLfloat ATMOSPHERE_SCENE_SCALE = 0.001f;
+
+// Luz del sol fuera de la atmosfera, en la escala de dirLight (a 45 grados llega ~0.8)
+const GLfloat ATMOSPHERE_SUN_ILLUMINANCE = 1.0f;
+
+// Exposicion del cielo y escala de la luz ambiente: compensa la dispersion multiple, que en
+// CPU no se calcula (de dia queda en ~0.2, como antes)
+const GLfloat ATMOSPHERE_SKY_EXPOSURE = 30.0f;
+const GLfloat ATMOSPHERE_AMBIENT_SCALE = 1.7f;
+
+// Tamano aparente del sol y la luna (radio en radianes, mas grandes que los reales para que se vean)
+const GLfloat ATMOSPHERE_SUN_RADIUS = 0.03f;
+const GLfloat ATMOSPHERE_MOON_RADIUS = 0.025f;
+
+// De noche alumbra la luna: luz fija y un cielo oscuro azulado
+const glm::vec3 ATMOSPHERE_MOON_DIFFUSE(0.25f, 0.28f, 0.35f);
+const glm::vec3 ATMOSPHERE_MOON_AMBIENT(0.06f, 0.07f, 0.1f);
+const glm::vec3 ATMOSPHERE_NIGHT_SKY(0.098f, 0.098f, 0.137f);
+
+// El sol se apaga entre estas alturas (grados) y la luna se prende mientras el sol baja
+const GLfloat ATMOSPHERE_SUN_FADE = 5.0f;
+const GLfloat ATMOSPHERE_MOON_FADE = -10.0f;
+
+// Cielo fisico: dispersion de Rayleigh y Mie con absorcion del ozono, precalculada en tablas.
+// La transmitancia y la dispersion multiple no dependen del sol y se calculan una vez; la vista
+// del cielo solo se rehace cuando el sol se mueve (una transicion de N o M). Cada pixel del
+// cielo es una lectura de la tabla, asi el costo por pixel no cambia con la hora.
+// La luz direccional de la escena (direccion y color del sol, o de la luna de noche) y la luz
+// ambiente salen del mismo modelo, calculadas en CPU con el sol de cada cuadro.
+// Los cuatro pasos viven en Shader/atmosphere.frag, uno por #define.
+class Atmosphere
+{
+public:
+	// Constructor, crea las tablas y compila los shaders; las tablas se llenan en el primer Draw
+	Atmosphere()
+		: sunDirection(0.0f, 1.0f, 0.0f), moonDirection(0.0f, 1.0f, 0.0f), tablesDirty(true), skyViewDirty(true), skyViewUpdates(0)
+	{
+		const GLchar* defines[ATMOSPHERE_PASS_COUNT] = { "#define TRANSMITTANCE_LUT\n", "#define MULTI_SCATTERING_LUT\n", "#define SKY_VIEW_LUT\n", "" };
+		for (GLuint i = 0; i < ATMOSPHERE_PASS_COUNT; i++)
+		{
+			this->shaders[i] = new Shader("Shader/atmosphere.vs", "Shader/atmosphere.frag", defines[i]);
+		}
+
+		const GLint widths[ATMOSPHERE_TABLE_COUNT] = { ATMOSPHERE_TRANSMITTANCE_WIDTH, ATMOSPHERE_MULTI_SCATTERING_SIZE, ATMOSPHERE_SKY_VIEW_WIDTH };
+		const GLint heights[ATMOSPHERE_TABLE_COUNT] = { ATMOSPHERE_TRANSMITTANCE_HEIGHT, ATMOSPHERE_MULTI_SCATTERING_SIZE, ATMOSPHERE_SKY_VIEW_HEIGHT };
+		glGenTextures(ATMOSPHERE_TABLE_COUNT, this->tables);
+		glGenFramebuffers(ATMOSPHERE_TABLE_COUNT, this->fbos);
+		for (GLuint i = 0; i < ATMOSPHERE_TABLE_COUNT; i++)
+		{
+			this->widths[i] = widths[i];
+			this->heights[i] = heights[i];
+			glBindTexture(GL_TEXTURE_2D, this->tables[i]);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, widths[i], heights[i], 0, GL_RGB, GL_FLOAT, NULL);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, this->fbos[i]);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->tables[i], 0);
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			{
+				std::cout << "ERROR::ATMOSPHERE::FRAMEBUFFER_NOT_COMPLETE " << i << std::endl;
+			}
+		}
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		// Triangulo de pantalla completa: los vertices salen de gl_VertexID
+		glGenVertexArrays(1, &this->vao);
+
+		this->Update(this->sunDirection, this->moonDirection);
+	}
+
+	~Atmosphere()
+	{
+		std::cout << "ATMOSFERA: tabla del cielo rehecha " << this->skyViewUpdates << " veces" << std::endl;
+		for (GLuint i = 0; i < ATMOSPHERE_PASS_COUNT; i++)
+		{
+			glDeleteProgram(this->shaders[i]->Program);
+			delete this->shaders[i];
+		}
+		glDeleteTextures(ATMOSPHERE_TABLE_COUNT, this->tables);
+		glDeleteFramebuffers(ATMOSPHERE_TABLE_COUNT, this->fbos);
+		glDeleteVertexArrays(1, &this->vao);
+	}
+
+	// Direccion hacia el sol con esa altura sobre el horizonte (grados); sale por +X
+	static glm::vec3 SunDirection(GLfloat elevation)
+	{
+		GLfloat radians = glm::radians(elevation);
+		return glm::vec3(std::cos(radians), std::sin(radians), 0.0f);
+	}
+
+	// Mueve el sol y la luna (direcciones hacia ellos) y calcula la luz de la escena.
+	// La tabla del cielo se marca para rehacerse solo si el sol se movio.
+	void Update(const glm::vec3& sunDirection, const glm::vec3& moonDirection)
+	{
+		glm::vec3 sun = glm::normalize(sunDirection);
+		if (glm::dot(sun, this->sunDirection) < std::cos(ATMOSPHERE_SUN_EPSILON) || this->tablesDirty)
+		{
+			this->skyViewDirty = true;
+			this->sunDirection = sun;
+			this->skyIrradiance = this->irradiance(sun);
+		}
+		this->moonDirection = glm::normalize(moonDirection);
+
+		// El sol se apaga al llegar al horizonte y la luna se prende mientras baja;
+		// la luz cambia de uno a otro justo en el horizonte, donde las dos valen cero
+		this->sunFade = fade(std::sin(glm::radians(0.0f)), std::sin(glm::radians(ATMOSPHERE_SUN_FADE)), sun.y);
+		this->moonFade = fade(std::sin(glm::radians(0.0f)), std::sin(glm::radians(ATMOSPHERE_MOON_FADE)), sun.y);
+		this->lightDirection = sun.y > 0.0f ? -sun : -this->moonDirection;
+
+		glm::vec3 sunLight = this->transmittance(ATMOSPHERE_SCENE_ALTITUDE, sun.y) * ATMOSPHERE_SUN_ILLUMINANCE;
+		this->diffuse = sunLight * this->sunFade + ATMOSPHERE_MOON_DIFFUSE * this->moonFade;
+
+		// Una superficie promedio ve medio cielo y medio suelo (que refleja el sol y el cielo)
+		glm::vec3 groundLight = ATMOSPHERE_GROUND_ALBEDO * (sunLight * glm::max(sun.y, 0.0f) + this->skyIrradiance);
+		this->ambient = (this->skyIrradiance + groundLight) * 0.5f * ATMOSPHERE_AMBIENT_SCALE + ATMOSPHERE_MOON_AMBIENT * this->moonFade;
+	}
+
+	// Dibuja el cielo donde no hay nada (profundidad 1); antes rehace las tablas pendientes
+	void Draw(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPos)
+	{
+		GLfloat cameraHeight = ATMOSPHERE_SCENE_ALTITUDE + glm::max(viewPos.y, 0.0f) * ATMOSPHERE_SCENE_SCALE;
+		glBindVertexArray(this->vao);
+		if (this->tablesDirty || this->skyViewDirty)
+		{
+			this->updateTables(cameraHeight);
+		}
+
+		Shader* sky = this->shaders[ATMOSPHERE_SKY];
+		sky->Use();
+		this->bindTables(sky->Program, ATMOSPHERE_TABLE_COUNT);
+		glUniformMatrix4fv(glGetUniformLocation(sky->Program, "inverseViewProjection"), 1, GL_FALSE, glm::value_ptr(glm::inverse(projection * view)));
+		glUniform3fv(glGetUniformLocation(sky->Program, "viewPos"), 1, glm::value_ptr(viewPos));
+		glUniform1f(glGetUniformLocation(sky->Program, "cameraHeight"), cameraHeight);
+		glUniform3fv(glGetUniformLocation(sky->Program, "moonDirection"), 1, glm::value_ptr(this->moonDirection));
+		glUniform1f(glGetUniformLocation(sky->Program, "sunFade"), this->sunFade);
+		glUniform1f(glGetUniformLocation(sky->Program, "moonFade"), this->moonFade);
+
+		glDepthFunc(GL_LEQUAL);
+		glDepthMask(GL_FALSE);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		glDepthMask(GL_TRUE);
+		glDepthFunc(GL_LESS);
+		glBindVertexArray(0);
+		glActiveTexture(GL_TEXTURE0);
+	}
+
+	// Luz direccional del cuadro (hacia donde alumbra): el sol, o la luna de noche
+	const glm::vec3& GetLightDirection() const
+	{
+		return this->lightDirection;
+	}
+
+	const glm::vec3& GetDiffuse() const
+	{
+		return this->diffuse;
+	}
+
+	const glm::vec3& GetAmbient() const
+	{
+		return this->ambient;
+	}
+
+	// Recarga en vivo (ver ShaderWatcher.h); las tablas se rehacen con el shader nuevo
+	bool Reload(const std::string& path)
+	{
+		if (!this->shaders[0]->Uses(path))
+		{
+			return false;
+		}
+		for (GLuint i = 0; i < ATMOSPHERE_PASS_COUNT; i++)
+		{
+			this->shaders[i]->Reload();
+		}
+		return true;
+	}
+
+	void Poll()
+	{
+		for (GLuint i = 0; i < ATMOSPHERE_PASS_COUNT; i++)
+		{
+			if (this->shaders[i]->PollReload())
+			{
+				this->tablesDirty = true;
+			}
+		}
+	}
+
+private:
+	enum Atmosphere_Pass
+	{
+		ATMOSPHERE_TRANSMITTANCE,
+		ATMOSPHERE_MULTI_SCATTERING,
+		ATMOSPHERE_SKY_VIEW,
+		ATMOSPHERE_SKY,
+		ATMOSPHERE_PASS_COUNT,
+		ATMOSPHERE_TABLE_COUNT = ATMOSPHERE_SKY
+	};
+
+	Shader* shaders[ATMOSPHERE_PASS_COUNT];
+	GLuint tables[ATMOSPHERE_TABLE_COUNT];
+	GLuint fbos[ATMOSPHERE_TABLE_COUNT];
+	GLint widths[ATMOSPHERE_TABLE_COUNT];
+	GLint heights[ATMOSPHERE_TABLE_COUNT];
+	GLuint vao;
+
+	glm::vec3 sunDirection;
+	glm::vec3 moonDirection;
+	glm::vec3 lightDirection;
+	glm::vec3 diffuse;
+	glm::vec3 ambient;
+	glm::vec3 skyIrradiance;
+	GLfloat sunFade;
+	GLfloat moonFade;
+	bool tablesDirty;	// Transmitancia y dispersion multiple (al inicio o al recargar el shader)
+	bool skyViewDirty;	// Vista del cielo (cada vez que el sol se mueve)
+	GLuint skyViewUpdates;
+
+	static GLfloat fade(GLfloat edge0, GLfloat edge1, GLfloat x)
+	{
+		GLfloat t = glm::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+		return t * t * (3.0f - 2.0f * t);
+	}
+
+	// Rehace las tablas pendientes; la vista del cielo depende de la altura de la camara,
+	// pero en la escena cambia unos metros y no vale la pena rehacerla por eso
+	void updateTables(GLfloat cameraHeight)
+	{
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		glDepthMask(GL_FALSE);
+		glDisable(GL_DEPTH_TEST);
+
+		GLuint first = this->tablesDirty ? ATMOSPHERE_TRANSMITTANCE : ATMOSPHERE_SKY_VIEW;
+		for (GLuint i = first; i < ATMOSPHERE_TABLE_COUNT; i++)
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, this->fbos[i]);
+			glViewport(0, 0, this->widths[i], this->heights[i]);
+			this->shaders[i]->Use();
+			this->bindTables(this->shaders[i]->Program, i);
+			glUniform1f(glGetUniformLocation(this->shaders[i]->Program, "cameraHeight"), cameraHeight);
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+		}
+		this->tablesDirty = false;
+		this->skyViewDirty = false;
+		this->skyViewUpdates++;
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+		glEnable(GL_DEPTH_TEST);
+		glDepthMask(GL_TRUE);
+	}
+
+	// Enlaza las primeras tablas y pone los parametros del modelo en el programa (que debe estar
+	// activo). Cada paso solo lee las tablas anteriores, nunca la que esta escribiendo.
+	void bindTables(GLuint program, GLuint tableCount)
+	{
+		const GLchar* names[ATMOSPHERE_TABLE_COUNT] = { "transmittanceLut", "multiScatteringLut", "skyViewLut" };
+		for (GLuint i = 0; i < tableCount; i++)
+		{
+			glActiveTexture(GL_TEXTURE0 + ATMOSPHERE_TEXTURE_UNIT + i);
+			glBindTexture(GL_TEXTURE_2D, this->tables[i]);
+			glUniform1i(glGetUniformLocation(program, names[i]), ATMOSPHERE_TEXTURE_UNIT + i);
+		}
+		glUniform1f(glGetUniformLocation(program, "groundRadius"), ATMOSPHERE_GROUND_RADIUS);
+		glUniform1f(glGetUniformLocation(program, "topRadius"), ATMOSPHERE_TOP_RADIUS);
+		glUniform3fv(glGetUniformLocation(program, "rayleighScattering"), 1, glm::value_ptr(ATMOSPHERE_RAYLEIGH_SCATTERING));
+		glUniform1f(glGetUniformLocation(program, "rayleighHeight"), ATMOSPHERE_RAYLEIGH_HEIGHT);
+		glUniform1f(glGetUniformLocation(program, "mieScattering"), ATMOSPHERE_MIE_SCATTERING);
+		glUniform1f(glGetUniformLocation(program, "mieExtinction"), ATMOSPHERE_MIE_EXTINCTION);
+		glUniform1f(glGetUniformLocation(program, "mieHeight"), ATMOSPHERE_MIE_HEIGHT);
+		glUniform1f(glGetUniformLocation(program, "mieG"), ATMOSPHERE_MIE_G);
+		glUniform3fv(glGetUniformLocation(program, "ozoneAbsorption"), 1, glm::value_ptr(ATMOSPHERE_OZONE_ABSORPTION));
+		glUniform1f(glGetUniformLocation(program, "ozoneCenter"), ATMOSPHERE_OZONE_CENTER);
+		glUniform1f(glGetUniformLocation(program, "ozoneWidth"), ATMOSPHERE_OZONE_WIDTH);
+		glUniform3fv(glGetUniformLocation(program, "groundAlbedo"), 1, glm::value_ptr(ATMOSPHERE_GROUND_ALBEDO));
+		glUniform3fv(glGetUniformLocation(program, "sunDirection"), 1, glm::value_ptr(this->sunDirection));
+		glUniform1f(glGetUniformLocation(program, "sunIlluminance"), ATMOSPHERE_SUN_ILLUMINANCE);
+		glUniform1f(glGetUniformLocation(program, "sunRadius"), ATMOSPHERE_SUN_RADIUS);
+		glUniform1f(glGetUniformLocation(program, "moonRadius"), ATMOSPHERE_MOON_RADIUS);
+		glUniform3fv(glGetUniformLocation(program, "moonColor"), 1, glm::value_ptr(ATMOSPHERE_MOON_DIFFUSE));
+		glUniform3fv(glGetUniformLocation(program, "nightSky"), 1, glm::value_ptr(ATMOSPHERE_NIGHT_SKY));
+		glUniform1f(glGetUniformLocation(program, "exposure"), ATMOSPHERE_SKY_EXPOSURE);
+	}
+
+	// --- El mismo modelo en CPU (para la luz de la escena, sin tablas) ---
+
+	// Coeficiente de extincion a esa altura (km sobre el suelo)
+	static glm::vec3 extinction(GLfloat height)
+	{
+		GLfloat ozone = glm::max(0.0f, 1.0f - std::fabs(height - ATMOSPHERE_OZONE_CENTER) / ATMOSPHERE_OZONE_WIDTH);
+		return ATMOSPHERE_RAYLEIGH_SCATTERING * std::exp(-height / ATMOSPHERE_RAYLEIGH_HEIGHT)
+			+ glm::vec3(ATMOSPHERE_MIE_EXTINCTION * std::exp(-height / ATMOSPHERE_MIE_HEIGHT))
+			+ ATMOSPHERE_OZONE_ABSORPTION * ozone;
+	}
+
+	// Distancia desde un punto a esa altura, con ese coseno respecto a la vertical, hasta el
+	// techo de la atmosfera; negativa si el rayo choca con el suelo
+	static GLfloat distanceToTop(GLfloat height, GLfloat cosZenith)
+	{
+		GLfloat r = ATMOSPHERE_GROUND_RADIUS + height;
+		GLfloat groundDiscriminant = r * r * (cosZenith * cosZenith - 1.0f) + ATMOSPHERE_GROUND_RADIUS * ATMOSPHERE_GROUND_RADIUS;
+		if (cosZenith < 0.0f && groundDiscriminant >= 0.0f)
+		{
+			return -1.0f;
+		}
+		return -r * cosZenith + std::sqrt(glm::max(r * r * (cosZenith * cosZenith - 1.0f) + ATMOSPHERE_TOP_RADIUS * ATMOSPHERE_TOP_RADIUS, 0.0f));
+	}
+
+	// Fraccion de la luz que llega desde el techo de la atmosfera (igual que la tabla de transmitancia)
+	static glm::vec3 transmittance(GLfloat height, GLfloat cosZenith)
+	{
+		const GLuint steps = 32;
+		GLfloat distance = distanceToTop(height, cosZenith);
+		if (distance < 0.0f)
+		{
+			return glm::vec3(0.0f);
+		}
+		GLfloat r = ATMOSPHERE_GROUND_RADIUS + height;
+		glm::vec3 depth(0.0f);
+		GLfloat step = distance / steps;
+		for (GLuint i = 0; i < steps; i++)
+		{
+			GLfloat t = (i + 0.5f) * step;
+			GLfloat sampleHeight = std::sqrt(r * r + t * t + 2.0f * r * t * cosZenith) - ATMOSPHERE_GROUND_RADIUS;
+			depth += extinction(sampleHeight) * step;
+		}
+		return glm::vec3(std::exp(-depth.x), std::exp(-depth.y), std::exp(-depth.z));
+	}
+
+	// Luz del cielo sobre una superficie horizontal en la escena (solo dispersion simple).
+	// Pocas muestras: solo corre cuando el sol se mueve.
+	glm::vec3 irradiance(const glm::vec3& sun) const
+	{
+		const GLuint rings = 6, sectors = 8, steps = 12;
+		const GLfloat pi = 3.14159265f;
+		GLfloat r = ATMOSPHERE_GROUND_RADIUS + ATMOSPHERE_SCENE_ALTITUDE;
+		glm::vec3 total(0.0f);
+		for (GLuint ring = 0; ring < rings; ring++)
+		{
+			for (GLuint sector = 0; sector < sectors; sector++)
+			{
+				// Direcciones repartidas por coseno: E = pi * promedio de la radiancia
+				GLfloat u = (ring + 0.5f) / rings;
+				GLfloat phi = 2.0f * pi * (sector + 0.5f) / sectors;
+				glm::vec3 dir(std::sqrt(u) * std::cos(phi), std::sqrt(1.0f - u), std::sqrt(u) * std::sin(phi));
+				GLfloat cosTheta = glm::dot(dir, sun);
+				GLfloat rayleighPhase = 3.0f / (16.0f * pi) * (1.0f + cosTheta * cosTheta);
+				GLfloat g = ATMOSPHERE_MIE_G;
+				GLfloat miePhase = 3.0f / (8.0f * pi) * ((1.0f - g * g) * (1.0f + cosTheta * cosTheta)) / ((2.0f + g * g) * std::pow(1.0f + g * g - 2.0f * g * cosTheta, 1.5f));
+
+				GLfloat distance = distanceToTop(ATMOSPHERE_SCENE_ALTITUDE, dir.y);
+				GLfloat step = distance / steps;
+				glm::vec3 viewTransmittance(1.0f);
+				glm::vec3 radiance(0.0f);
+				for (GLuint i = 0; i < steps; i++)
+				{
+					glm::vec3 position = glm::vec3(0.0f, r, 0.0f) + dir * ((i + 0.5f) * step);
+					GLfloat sampleRadius = glm::length(position);
+					GLfloat height = sampleRadius - ATMOSPHERE_GROUND_RADIUS;
+					glm::vec3 scattering = ATMOSPHERE_RAYLEIGH_SCATTERING * std::exp(-height / ATMOSPHERE_RAYLEIGH_HEIGHT) * rayleighPhase
+						+ glm::vec3(ATMOSPHERE_MIE_SCATTERING * std::exp(-height / ATMOSPHERE_MIE_HEIGHT) * miePhase);
+					glm::vec3 sampleExtinction = extinction(height);
+					glm::vec3 stepTransmittance(std::exp(-sampleExtinction.x * step), std::exp(-sampleExtinction.y * step), std::exp(-sampleExtinction.z * step));
+					glm::vec3 sunLight = transmittance(height, glm::dot(position / sampleRadius, sun));
+					// Integral exacta de la dispersion a lo largo del paso (extincion constante)
+					radiance += viewTransmittance * scattering * sunLight * (glm::vec3(1.0f) - stepTransmittance) / sampleExtinction;
+					viewTransmittance *= stepTransmittance;
+				}
+				total += radiance;
+			}
+		}
+		return total * (pi / (rings * sectors)) * ATMOSPHERE_SUN_ILLUMINANCE;
+	}
+};
@@ -0,0 +1,210 @@
+// Benchmark de los clips de animacion esqueletica (Animation.h y AnimationCompression.h)
+// Carga cada modelo con Model (igual que ProyectoFinal.cpp) y para cada clip compara el clip
+// remuestreado sin comprimir contra el comprimido: memoria, llaves que quedaron, error maximo
+// y tiempo de evaluacion por articulacion con varias instancias a la vez:
+//   sin_comprimir          SampleClip (mezcla de dos cuadros completos)
+//   comprimido_secuencial  CompressedClip::Sample avanzando el cursor de cada instancia
+//   comprimido_aleatorio   tiempos al azar, cada muestra busca sus llaves desde cero
+//
+// Uso: BenchmarkAnimacion [--csv archivo.csv] [--instancias N] [--cuadros N]
+//                         [--tolerancia-traslacion x] [--tolerancia-rotacion x] [modelo ...]
+// Model necesita un contexto GL para crear sus buffers (ventana oculta). Se enlaza con
+// assimp, glfw3, glew32 y opengl32 como el proyecto.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "Model.h"
+#include "Animation.h"
+#include "AnimationCompression.h"
+
+// Implementacion de stb_image para Model.h (despues de incluirlo, como en ProyectoFinal.cpp)
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Suma de la pose para que el compilador no se salte las evaluaciones
+GLfloat Checksum(const JointPose& pose)
+{
+	GLfloat sum = 0.0f;
+	for (size_t i = 0; i < pose.data.size(); i += 7)
+		sum += pose.data[i];
+	return sum;
+}
+
+struct BenchResult
+{
+	std::string model;
+	std::string clip;
+	std::string mode;
+	GLuint joints;
+	GLuint frames;
+	size_t bytes;
+	GLuint keys;
+	double nsPerJoint;
+};
+
+int main(int argc, char* argv[])
+{
+	std::string csvPath = "benchmark_animacion.csv";
+	GLuint instances = 64;
+	GLuint frames = 600;
+	GLfloat translationTolerance = ANIMATION_TRANSLATION_TOLERANCE;
+	GLfloat rotationTolerance = ANIMATION_ROTATION_TOLERANCE;
+	std::vector<std::string> models;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--csv" && i + 1 < argc)
+			csvPath = argv[++i];
+		else if (arg == "--instancias" && i + 1 < argc)
+			instances = std::max(1, atoi(argv[++i]));
+		else if (arg == "--cuadros" && i + 1 < argc)
+			frames = std::max(1, atoi(argv[++i]));
+		else if (arg == "--tolerancia-traslacion" && i + 1 < argc)
+			translationTolerance = (GLfloat)atof(argv[++i]);
+		else if (arg == "--tolerancia-rotacion" && i + 1 < argc)
+			rotationTolerance = (GLfloat)atof(argv[++i]);
+		else
+			models.push_back(arg);
+	}
+	if (models.empty())
+		models.push_back("Models/ho-oh1/source/Ho-Oh_fbx.glb");
+
+	// --- Contexto GL oculto (Model crea los buffers de sus mallas) ---
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+	glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+	GLFWwindow* window = glfwCreateWindow(64, 64, "Benchmark Animacion", nullptr, nullptr);
+	if (nullptr == window)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return EXIT_FAILURE;
+	}
+	glfwMakeContextCurrent(window);
+	glewExperimental = GL_TRUE;
+	if (GLEW_OK != glewInit())
+	{
+		std::cout << "Failed to initialise GLEW" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::vector<BenchResult> results;
+	GLfloat sink = 0.0f;
+	const GLfloat deltaTime = 1.0f / 60.0f;
+	std::cout << std::fixed << std::setprecision(3);
+
+	for (const std::string& path : models)
+	{
+		Model model(path);
+		if (model.GetClips().empty())
+		{
+			std::cout << path << ": sin clips de animacion" << std::endl;
+			continue;
+		}
+
+		for (const AnimationClip& clip : model.GetClips())
+		{
+			auto compressStart = std::chrono::high_resolution_clock::now();
+			CompressedClip compressed(clip, translationTolerance, rotationTolerance);
+			double compressMs = ElapsedMs(compressStart);
+
+			size_t rawBytes = CompressedClip::GetRawMemoryBytes(clip);
+			GLuint rawKeys = clip.frameCount * clip.jointCount * TRACK_TYPES;
+			std::cout << path << " '" << clip.name << "': " << clip.jointCount << " articulaciones, " << clip.frameCount << " cuadros ("
+				<< clip.duration << " s)" << std::endl;
+			std::cout << "  memoria " << rawBytes / 1024.0 << " KB -> " << compressed.GetMemoryBytes() / 1024.0 << " KB ("
+				<< (double)rawBytes / compressed.GetMemoryBytes() << "x), llaves " << compressed.GetKeyCount() << " de " << rawKeys
+				<< ", comprimido en " << compressMs << " ms" << std::endl;
+			std::cout << "  error maximo: traslacion " << compressed.maxTranslationError << ", rotacion "
+				<< glm::degrees(compressed.maxRotationError) << " grados, escala " << compressed.maxScaleError << std::endl;
+
+			// Cada instancia va en su propia fase del clip, como la bandada de ProyectoFinal.cpp
+			std::vector<JointPose> poses(instances);
+			std::vector<AnimationCursor> cursors(instances);
+			double evaluations = (double)frames * instances * clip.jointCount;
+
+			auto start = std::chrono::high_resolution_clock::now();
+			for (GLuint f = 0; f < frames; f++)
+			{
+				for (GLuint i = 0; i < instances; i++)
+				{
+					SampleClip(clip, f * deltaTime + i * 0.37f, poses[i]);
+					sink += Checksum(poses[i]);
+				}
+			}
+			double rawNs = ElapsedMs(start) * 1.0e6 / evaluations;
+
+			start = std::chrono::high_resolution_clock::now();
+			for (GLuint f = 0; f < frames; f++)
+			{
+				for (GLuint i = 0; i < instances; i++)
+				{
+					compressed.Sample(f * deltaTime + i * 0.37f, cursors[i], poses[i]);
+					sink += Checksum(poses[i]);
+				}
+			}
+			double sequentialNs = ElapsedMs(start) * 1.0e6 / evaluations;
+
+			srand(1234);
+			start = std::chrono::high_resolution_clock::now();
+			for (GLuint f = 0; f < frames; f++)
+			{
+				for (GLuint i = 0; i < instances; i++)
+				{
+					cursors[i].frame = 1e30f; // Obliga a buscar
+					compressed.Sample(clip.duration * rand() / RAND_MAX, cursors[i], poses[i]);
+					sink += Checksum(poses[i]);
+				}
+			}
+			double randomNs = ElapsedMs(start) * 1.0e6 / evaluations;
+
+			BenchResult r = { path, clip.name, "", clip.jointCount, clip.frameCount, rawBytes, rawKeys, rawNs };
+			r.mode = "sin_comprimir";
+			results.push_back(r);
+			r.bytes = compressed.GetMemoryBytes();
+			r.keys = compressed.GetKeyCount();
+			r.mode = "comprimido_secuencial";
+			r.nsPerJoint = sequentialNs;
+			results.push_back(r);
+			r.mode = "comprimido_aleatorio";
+			r.nsPerJoint = randomNs;
+			results.push_back(r);
+		}
+	}
+
+	// --- Salida ---
+	std::ofstream csv(csvPath);
+	csv << "modelo,clip,modo,articulaciones,cuadros,bytes,llaves,ns_por_articulacion\n";
+	for (const BenchResult& r : results)
+	{
+		std::ostringstream line;
+		line << std::fixed << std::setprecision(3) << r.model << "," << r.clip << "," << r.mode << "," << r.joints << ","
+			<< r.frames << "," << r.bytes << "," << r.keys << "," << r.nsPerJoint;
+		csv << line.str() << "\n";
+		std::cout << line.str() << std::endl;
+	}
+	std::cout << "Resultados en " << csvPath << " (" << instances << " instancias, " << frames << " cuadros, suma " << sink << ")" << std::endl;
+
+	glfwDestroyWindow(window);
+	glfwTerminate();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,195 @@
+// Benchmark de la bandada (Boids.h)
+// Suelta N aves en una esfera (densidad fija: unas 8 por celda de la rejilla) siguiendo a un lider
+// que da vueltas y mide el costo por cuadro de:
+//   ingenuo         cada ave revisa a todas las demas (O(n^2), solo hasta --max-ingenuo aves)
+//   rejilla         BoidFlock::Update en un hilo (counting sort + 27 celdas)
+//   rejilla_hilos   lo mismo repartido en varios hilos
+// Tambien reporta cuantas vecinas ve cada ave en promedio y la distancia minima entre aves.
+//
+// Uso: BenchmarkBoids [--csv archivo.csv] [--cuadros N] [--hilos N] [--max-ingenuo N] [aves ...]
+// No necesita contexto GL (solo los tipos de GLEW).
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include "Boids.h"
+
+double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+GLfloat Random(GLfloat low, GLfloat high)
+{
+	return low + (high - low) * rand() / (GLfloat)RAND_MAX;
+}
+
+// Las mismas reglas revisando todas las parejas, para comparar
+void UpdateNaive(std::vector<glm::vec3>& positions, std::vector<glm::vec3>& velocities, const BoidSettings& s, const glm::vec3& goal, GLfloat deltaTime)
+{
+	size_t count = positions.size();
+	std::vector<glm::vec3> newVelocities(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		glm::vec3 center(0.0f), heading(0.0f), push(0.0f);
+		GLuint neighbors = 0;
+		for (size_t j = 0; j < count && neighbors < s.maxNeighbors; j++)
+		{
+			glm::vec3 offset = positions[j] - positions[i];
+			GLfloat distance2 = glm::dot(offset, offset);
+			if (j == i || distance2 >= s.neighborRadius * s.neighborRadius)
+				continue;
+			center += offset;
+			heading += velocities[j];
+			if (distance2 < s.separationRadius * s.separationRadius)
+				push -= offset / std::max(distance2, 1e-4f);
+			neighbors++;
+		}
+		glm::vec3 acceleration = push * s.separationWeight;
+		if (neighbors > 0)
+			acceleration += (heading / (GLfloat)neighbors - velocities[i]) * s.alignmentWeight + center / (GLfloat)neighbors * s.cohesionWeight;
+		glm::vec3 toGoal = goal - positions[i];
+		if (glm::length(toGoal) > s.goalRadius)
+			acceleration += (glm::normalize(toGoal) * s.maxSpeed - velocities[i]) * s.goalWeight;
+		if (glm::length(acceleration) > s.maxAcceleration)
+			acceleration = glm::normalize(acceleration) * s.maxAcceleration;
+		glm::vec3 velocity = velocities[i] + acceleration * deltaTime;
+		newVelocities[i] = glm::normalize(velocity) * glm::clamp(glm::length(velocity), s.minSpeed, s.maxSpeed);
+	}
+	for (size_t i = 0; i < count; i++)
+	{
+		velocities[i] = newVelocities[i];
+		positions[i] += velocities[i] * deltaTime;
+	}
+}
+
+struct BenchResult
+{
+	std::string mode;
+	GLuint boids;
+	GLuint threads;
+	double msPerFrame;
+	double nsPerBoid;
+};
+
+int main(int argc, char* argv[])
+{
+	std::string csvPath = "benchmark_boids.csv";
+	GLuint frames = 60;
+	GLuint threadCount = std::max(1u, std::thread::hardware_concurrency());
+	GLuint maxNaive = 10000;
+	std::vector<GLuint> counts;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--csv" && i + 1 < argc)
+			csvPath = argv[++i];
+		else if (arg == "--cuadros" && i + 1 < argc)
+			frames = std::max(1, atoi(argv[++i]));
+		else if (arg == "--hilos" && i + 1 < argc)
+			threadCount = std::max(1, atoi(argv[++i]));
+		else if (arg == "--max-ingenuo" && i + 1 < argc)
+			maxNaive = atoi(argv[++i]);
+		else
+			counts.push_back(std::max(1, atoi(arg.c_str())));
+	}
+	if (counts.empty())
+		counts = { 1000, 10000, 100000 };
+
+	std::vector<BenchResult> results;
+	std::cout << std::fixed << std::setprecision(3);
+	const GLfloat deltaTime = 1.0f / 60.0f;
+	BoidSettings settings;
+
+	for (GLuint count : counts)
+	{
+		// Radio de la esfera para unas 8 aves por celda
+		GLfloat cell = settings.neighborRadius;
+		GLfloat radius = std::cbrt(count * cell * cell * cell / 8.0f * 3.0f / (4.0f * 3.14159265f));
+		srand(1234);
+		std::vector<glm::vec3> positions(count), velocities(count);
+		for (GLuint i = 0; i < count; i++)
+		{
+			glm::vec3 p;
+			do
+				p = glm::vec3(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f));
+			while (glm::dot(p, p) > 1.0f);
+			positions[i] = p * radius;
+			velocities[i] = glm::normalize(glm::vec3(Random(-1.0f, 1.0f), Random(-0.2f, 0.2f), Random(-1.0f, 1.0f))) * settings.minSpeed;
+		}
+
+		auto leader = [radius](GLuint frame) {
+			GLfloat angle = frame * (1.0f / 60.0f) * 0.3f;
+			return glm::vec3(cos(angle), 0.0f, sin(angle)) * radius * 0.5f;
+		};
+
+		if (count <= maxNaive)
+		{
+			std::vector<glm::vec3> p = positions, v = velocities;
+			auto start = std::chrono::high_resolution_clock::now();
+			for (GLuint f = 0; f < frames; f++)
+				UpdateNaive(p, v, settings, leader(f), deltaTime);
+			double ms = ElapsedMs(start) / frames;
+			results.push_back({ "ingenuo", count, 1, ms, ms * 1.0e6 / count });
+		}
+
+		GLuint threadModes[] = { 1, threadCount };
+		for (GLuint threads : threadModes)
+		{
+			BoidFlock flock(settings);
+			for (GLuint i = 0; i < count; i++)
+				flock.Add(positions[i], velocities[i]);
+			auto start = std::chrono::high_resolution_clock::now();
+			for (GLuint f = 0; f < frames; f++)
+			{
+				flock.SetGoal(leader(f));
+				flock.Update(deltaTime, threads);
+			}
+			double ms = ElapsedMs(start) / frames;
+			results.push_back({ threads == 1 ? "rejilla" : "rejilla_hilos", count, threads, ms, ms * 1.0e6 / count });
+
+			// Vecinas promedio y distancia minima (con la misma rejilla de tamano neighborRadius, sobre una muestra)
+			if (threads == 1)
+			{
+				double neighborSum = 0.0;
+				GLfloat minimum = 1e30f;
+				GLuint sample = std::min(count, 2000u);
+				for (GLuint i = 0; i < sample; i++)
+				{
+					glm::vec3 p = flock.GetPosition(i * (count / sample));
+					for (GLuint j = 0; j < count; j++)
+					{
+						GLfloat distance = glm::distance(p, flock.GetPosition(j));
+						if (j != i * (count / sample) && distance < settings.neighborRadius)
+						{
+							neighborSum += 1.0;
+							minimum = std::min(minimum, distance);
+						}
+					}
+				}
+				std::cout << count << " aves: " << neighborSum / sample << " vecinas en promedio, distancia minima " << minimum << std::endl;
+			}
+		}
+	}
+
+	// --- Salida ---
+	std::ofstream csv(csvPath);
+	csv << "modo,aves,hilos,ms_por_cuadro,ns_por_ave\n";
+	for (const BenchResult& r : results)
+	{
+		std::ostringstream line;
+		line << std::fixed << std::setprecision(3) << r.mode << "," << r.boids << "," << r.threads << "," << r.msPerFrame << "," << r.nsPerBoid;
+		csv << line.str() << "\n";
+		std::cout << line.str() << std::endl;
+	}
+	std::cout << "Resultados en " << csvPath << " (" << frames << " cuadros)" << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+// Benchmark del codificador ETC1 (SOIL2/etc1_utils.c)
+// Compara el modo de alta calidad (busqueda exhaustiva) contra el modo rapido,
+// con uno y varios hilos, y reporta tiempo, megapixeles por segundo y PSNR.
+//
+// Uso: BenchmarkETC1 [imagen ...]
+// Sin argumentos usa las texturas de images/. Se enlaza con soil2 (o se compila
+// junto con SOIL2/etc1_utils.c).
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cmath>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "SOIL2/etc1_utils.h"
+
+// Resultado de una corrida del codificador
+struct EncodeResult
+{
+	double seconds;
+	double psnr;
+};
+
+// PSNR en RGB entre la imagen original y la decodificada
+double CalcPSNR(const std::vector<unsigned char>& a, const std::vector<unsigned char>& b)
+{
+	double error = 0.0;
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		double d = (double)a[i] - (double)b[i];
+		error += d * d;
+	}
+	double mse = error / (double)a.size();
+	if (mse <= 0.0)
+		return 99.0;
+	return 10.0 * log10(255.0 * 255.0 / mse);
+}
+
+EncodeResult RunEncoder(const std::vector<unsigned char>& rgb, int width, int height, int quality, int threads, int repeats)
+{
+	std::vector<unsigned char> encoded(etc1_get_encoded_data_size(width, height));
+	std::vector<unsigned char> decoded(rgb.size());
+
+	// La mejor de varias corridas, para quitar ruido del sistema
+	double best = 1e30;
+	for (int r = 0; r < repeats; r++)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		etc1_encode_image_ex(&rgb[0], width, height, 3, width * 3, &encoded[0], quality, threads);
+		auto end = std::chrono::high_resolution_clock::now();
+		double seconds = std::chrono::duration<double>(end - start).count();
+		if (seconds < best)
+			best = seconds;
+	}
+
+	etc1_decode_image(&encoded[0], &decoded[0], width, height, 3, width * 3);
+
+	EncodeResult result;
+	result.seconds = best;
+	result.psnr = CalcPSNR(rgb, decoded);
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> files;
+	for (int i = 1; i < argc; i++)
+		files.push_back(argv[i]);
+
+	if (files.empty())
+	{
+		const char* defaults[] = { "images/pasto.png", "images/agua.png", "images/agua2.png", "images/hojas.jpg",
+			"images/tejado.png", "images/checker_Tex.png", "images/window.png", "Models/Texture_albedo.jpg" };
+		for (const char* f : defaults)
+			files.push_back(f);
+	}
+
+	int cores = (int)std::thread::hardware_concurrency();
+	if (cores < 1)
+		cores = 1;
+
+	std::cout << "archivo,pixeles,modo,hilos,ms,MPix/s,PSNR" << std::endl;
+	std::cout << std::fixed;
+
+	for (const std::string& file : files)
+	{
+		int width, height, nrChannels;
+		unsigned char* image = stbi_load(file.c_str(), &width, &height, &nrChannels, 3);
+		if (!image)
+		{
+			std::cout << "Failed to load texture: " << file << std::endl;
+			continue;
+		}
+		std::vector<unsigned char> rgb(image, image + width * height * 3);
+		stbi_image_free(image);
+
+		// Menos repeticiones en imagenes grandes para que el modo exhaustivo no tarde demasiado
+		double megapixels = (double)width * height / 1.0e6;
+		int repeats = megapixels > 1.0 ? 1 : 3;
+
+		struct { const char* name; int quality; int threads; } modes[] = {
+			{ "alta", ETC1_ENCODE_QUALITY_HIGH, 1 },
+			{ "alta", ETC1_ENCODE_QUALITY_HIGH, cores },
+			{ "rapido", ETC1_ENCODE_QUALITY_FAST, 1 },
+			{ "rapido", ETC1_ENCODE_QUALITY_FAST, cores }
+		};
+
+		for (auto& mode : modes)
+		{
+			EncodeResult r = RunEncoder(rgb, width, height, mode.quality, mode.threads, repeats);
+			std::cout << file << "," << width << "x" << height << "," << mode.name << "," << mode.threads << ","
+				<< std::setprecision(2) << r.seconds * 1000.0 << ","
+				<< std::setprecision(2) << megapixels / r.seconds << ","
+				<< std::setprecision(2) << r.psnr << std::endl;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
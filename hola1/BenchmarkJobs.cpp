@@ -0,0 +1,186 @@
+// Benchmark del sistema de trabajos (JobSystem.h)
+// Mide lo que cuesta repartir trabajo, no el trabajo:
+//   vacios          N trabajos vacios con Run() y un Wait() (costo por trabajo)
+//   dependencias    cadena de N trabajos, cada uno espera al anterior (latencia por trabajo)
+//   main_thread     N trabajos que encolan otro para el hilo principal (como las subidas a GL)
+//   serial          un ciclo sobre M elementos con poco trabajo cada uno
+//   hilos_std       el mismo ciclo con un std::thread por bloque, como Boids.h y Wanderers.h
+//   parallel_for    el mismo ciclo con ParallelFor y varios tamanos de lote
+// Con un solo nucleo los hilos no ganan nada, pero el costo de repartir se sigue viendo.
+//
+// Uso: BenchmarkJobs [--csv archivo.csv] [--repeticiones N] [--hilos N] [--trabajos N] [--elementos M]
+// No necesita contexto GL (solo los tipos de GLEW).
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+
+#include "JobSystem.h"
+
+double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// El trabajo por elemento del ciclo: unas cuantas operaciones, para que pese el reparto
+void Work(std::vector<GLfloat>& values, GLuint begin, GLuint end)
+{
+	for (GLuint i = begin; i < end; i++)
+	{
+		values[i] = std::sqrt(values[i] * 0.5f + 1.0f);
+	}
+}
+
+struct BenchResult
+{
+	std::string mode;
+	GLuint jobs;
+	GLuint threads;
+	GLuint batch;
+	double ms;
+	double nsPerJob;
+};
+
+int main(int argc, char* argv[])
+{
+	std::string csvPath = "benchmark_jobs.csv";
+	GLuint repetitions = 20;
+	GLint workerCount = -1;
+	GLuint jobCount = 100000;
+	GLuint elementCount = 1000000;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--csv" && i + 1 < argc)
+			csvPath = argv[++i];
+		else if (arg == "--repeticiones" && i + 1 < argc)
+			repetitions = std::max(1, atoi(argv[++i]));
+		else if (arg == "--hilos" && i + 1 < argc)
+			workerCount = std::max(1, atoi(argv[++i])) - 1;
+		else if (arg == "--trabajos" && i + 1 < argc)
+			jobCount = std::max(1, atoi(argv[++i]));
+		else if (arg == "--elementos" && i + 1 < argc)
+			elementCount = std::max(1, atoi(argv[++i]));
+	}
+
+	JobSystem jobs(workerCount);
+	GLuint threads = jobs.GetThreadCount();
+	std::vector<BenchResult> results;
+	std::cout << std::fixed << std::setprecision(3);
+
+	// --- Costo de encolar y correr ---
+	{
+		std::atomic<GLuint> done(0);
+		auto start = std::chrono::high_resolution_clock::now();
+		for (GLuint r = 0; r < repetitions; r++)
+		{
+			JobCounter counter;
+			for (GLuint i = 0; i < jobCount; i++)
+				jobs.Run([&done]() { done++; }, &counter);
+			jobs.Wait(counter);
+		}
+		double ms = ElapsedMs(start) / repetitions;
+		results.push_back({ "vacios", jobCount, threads, 1, ms, ms * 1.0e6 / jobCount });
+		if (done != jobCount * repetitions)
+			std::cout << "ERROR::JOBS::VACIOS " << done << " de " << jobCount * repetitions << std::endl;
+	}
+
+	{
+		GLuint chain = std::max(1u, jobCount / 10);
+		GLuint order = 0;
+		bool ordered = true;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (GLuint r = 0; r < repetitions; r++)
+		{
+			std::vector<JobCounter> counters(chain);
+			order = 0;
+			for (GLuint i = 0; i < chain; i++)
+			{
+				jobs.Run([&order, &ordered, i]() { ordered = ordered && order == i; order++; }, &counters[i], i > 0 ? &counters[i - 1] : nullptr);
+			}
+			jobs.Wait(counters[chain - 1]);
+			for (GLuint i = 0; i < chain; i++)
+				jobs.Wait(counters[i]);
+		}
+		double ms = ElapsedMs(start) / repetitions;
+		results.push_back({ "dependencias", chain, threads, 1, ms, ms * 1.0e6 / chain });
+		if (!ordered)
+			std::cout << "ERROR::JOBS::DEPENDENCIAS fuera de orden" << std::endl;
+	}
+
+	{
+		GLuint count = std::max(1u, jobCount / 10);
+		std::atomic<GLuint> uploads(0);
+		auto start = std::chrono::high_resolution_clock::now();
+		for (GLuint r = 0; r < repetitions; r++)
+		{
+			JobCounter counter;
+			for (GLuint i = 0; i < count; i++)
+			{
+				jobs.Run([&jobs, &uploads, &counter]() { jobs.RunOnMainThread([&uploads]() { uploads++; }, &counter); }, &counter);
+			}
+			jobs.Wait(counter);
+		}
+		double ms = ElapsedMs(start) / repetitions;
+		results.push_back({ "main_thread", count, threads, 1, ms, ms * 1.0e6 / count });
+		if (uploads != count * repetitions)
+			std::cout << "ERROR::JOBS::MAIN_THREAD " << uploads << " de " << count * repetitions << std::endl;
+	}
+
+	// --- Un ciclo repartido de tres maneras ---
+	std::vector<GLfloat> values(elementCount, 1.0f);
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		for (GLuint r = 0; r < repetitions; r++)
+			Work(values, 0, elementCount);
+		double ms = ElapsedMs(start) / repetitions;
+		results.push_back({ "serial", elementCount, 1, elementCount, ms, ms * 1.0e6 / elementCount });
+	}
+
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		GLuint block = (elementCount + threads - 1) / threads;
+		for (GLuint r = 0; r < repetitions; r++)
+		{
+			std::vector<std::thread> workers;
+			for (GLuint t = 0; t + 1 < threads; t++)
+				workers.push_back(std::thread(Work, std::ref(values), t * block, std::min((t + 1) * block, elementCount)));
+			Work(values, std::min((threads - 1) * block, elementCount), elementCount);
+			for (size_t t = 0; t < workers.size(); t++)
+				workers[t].join();
+		}
+		double ms = ElapsedMs(start) / repetitions;
+		results.push_back({ "hilos_std", elementCount, threads, block, ms, ms * 1.0e6 / elementCount });
+	}
+
+	GLuint batches[] = { 256, 4096, 65536 };
+	for (GLuint batch : batches)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		for (GLuint r = 0; r < repetitions; r++)
+			jobs.ParallelFor(elementCount, batch, [&values](GLuint begin, GLuint end) { Work(values, begin, end); });
+		double ms = ElapsedMs(start) / repetitions;
+		results.push_back({ "parallel_for", elementCount, threads, batch, ms, ms * 1.0e6 / elementCount });
+	}
+	std::cout << "Trabajos corridos: " << jobs.GetExecutedCount() << ", robados: " << jobs.GetStealCount() << std::endl;
+
+	// --- Salida ---
+	std::ofstream csv(csvPath);
+	csv << "modo,trabajos,hilos,lote,ms,ns_por_trabajo\n";
+	for (const BenchResult& r : results)
+	{
+		std::ostringstream line;
+		line << std::fixed << std::setprecision(3) << r.mode << "," << r.jobs << "," << r.threads << "," << r.batch << "," << r.ms << "," << r.nsPerJob;
+		csv << line.str() << "\n";
+		std::cout << line.str() << std::endl;
+	}
+	std::cout << "Resultados en " << csvPath << " (" << repetitions << " repeticiones)" << std::endl;
+	return EXIT_SUCCESS;
+}
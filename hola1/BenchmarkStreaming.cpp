@@ -0,0 +1,182 @@
+// Benchmark de las subidas de datos por cuadro (StreamingBuffer.h)
+// Cada cuadro sube P pedazos de B bytes (como huesos, instancias y clusters) y la GPU los lee
+// (se copian a otro buffer), asi el driver tiene que cuidar que no se pisen con lo que aun lee:
+//   sub_data            glBufferSubData sobre el mismo buffer (el driver espera o copia aparte)
+//   huerfano            glBufferData(NULL) y glBufferSubData, como se subia antes
+//   mapeo_por_cuadro    StreamingBuffer sin almacenamiento persistente (GL_MAP_UNSYNCHRONIZED_BIT)
+//   persistente         StreamingBuffer mapeado persistente y coherente (si hay GL_ARB_buffer_storage)
+// Se mide el tiempo de CPU por cuadro, con un glFinish al final de cada corrida.
+//
+// Uso: BenchmarkStreaming [--csv archivo.csv] [--cuadros N] [--pedazos P] [--bytes B]
+// Necesita un contexto GL (ventana oculta). Se enlaza con glfw3, glew32 y opengl32 como el proyecto.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "StreamingBuffer.h"
+
+double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+struct BenchResult
+{
+	std::string mode;
+	GLuint frames;
+	GLuint pieces;
+	GLsizeiptr bytes;
+	double msPerFrame;
+	double mbPerSecond;
+};
+
+int main(int argc, char* argv[])
+{
+	std::string csvPath = "benchmark_streaming.csv";
+	GLuint frames = 300;
+	GLuint pieces = 64;
+	GLsizeiptr bytes = 4096;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--csv" && i + 1 < argc)
+			csvPath = argv[++i];
+		else if (arg == "--cuadros" && i + 1 < argc)
+			frames = std::max(1, atoi(argv[++i]));
+		else if (arg == "--pedazos" && i + 1 < argc)
+			pieces = std::max(1, atoi(argv[++i]));
+		else if (arg == "--bytes" && i + 1 < argc)
+			bytes = std::max(16, atoi(argv[++i]));
+	}
+
+	// --- Contexto GL oculto ---
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+	glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+	GLFWwindow* window = glfwCreateWindow(64, 64, "Benchmark Streaming", nullptr, nullptr);
+	if (nullptr == window)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return EXIT_FAILURE;
+	}
+	glfwMakeContextCurrent(window);
+	glewExperimental = GL_TRUE;
+	if (GLEW_OK != glewInit())
+	{
+		std::cout << "Failed to initialise GLEW" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// Los datos de un pedazo y el buffer al que la GPU los copia (su "lectura")
+	GLsizeiptr frameBytes = pieces * bytes;
+	std::vector<GLubyte> data(bytes);
+	for (GLsizeiptr i = 0; i < bytes; i++)
+		data[i] = (GLubyte)i;
+	GLuint target;
+	glGenBuffers(1, &target);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, target);
+	glBufferData(GL_COPY_WRITE_BUFFER, bytes, NULL, GL_STATIC_DRAW);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	std::vector<BenchResult> results;
+	std::cout << std::fixed << std::setprecision(3);
+	auto addResult = [&](const char* mode, double ms)
+	{
+		double msPerFrame = ms / frames;
+		results.push_back({ mode, frames, pieces, bytes, msPerFrame, frameBytes / (msPerFrame * 1000.0) });
+	};
+
+	// --- Un buffer de glBufferSubData, con y sin huerfano ---
+	for (GLuint orphan = 0; orphan < 2; orphan++)
+	{
+		GLuint buffer;
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+		glBufferData(GL_COPY_READ_BUFFER, frameBytes, NULL, GL_STREAM_DRAW);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, target);
+		glFinish();
+		auto start = std::chrono::high_resolution_clock::now();
+		for (GLuint f = 0; f < frames; f++)
+		{
+			if (orphan)
+				glBufferData(GL_COPY_READ_BUFFER, frameBytes, NULL, GL_STREAM_DRAW);
+			for (GLuint p = 0; p < pieces; p++)
+			{
+				glBufferSubData(GL_COPY_READ_BUFFER, p * bytes, bytes, &data[0]);
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, p * bytes, 0, bytes);
+			}
+		}
+		glFinish();
+		addResult(orphan ? "huerfano" : "sub_data", ElapsedMs(start));
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		glDeleteBuffers(1, &buffer);
+	}
+
+	// --- StreamingBuffer: mapeado por cuadro y persistente ---
+	for (GLuint persistent = 0; persistent < 2; persistent++)
+	{
+		StreamingBuffer stream(frameBytes + pieces * 16, persistent == 1);	// Con lugar para la alineacion
+		if (persistent && !stream.IsPersistent())
+		{
+			std::cout << "persistente: no hay GL_ARB_buffer_storage" << std::endl;
+			continue;
+		}
+		std::vector<GLintptr> offsets(pieces);
+		glFinish();
+		auto start = std::chrono::high_resolution_clock::now();
+		for (GLuint f = 0; f < frames; f++)
+		{
+			stream.BeginFrame();
+			for (GLuint p = 0; p < pieces; p++)
+			{
+				StreamAllocation allocation = stream.Allocate(bytes);
+				memcpy(allocation.data, &data[0], bytes);
+				offsets[p] = allocation.offset;
+			}
+			stream.Flush();
+			glBindBuffer(GL_COPY_READ_BUFFER, stream.GetBuffer());
+			glBindBuffer(GL_COPY_WRITE_BUFFER, target);
+			for (GLuint p = 0; p < pieces; p++)
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offsets[p], 0, bytes);
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+			stream.EndFrame();
+		}
+		glFinish();
+		addResult(persistent ? "persistente" : "mapeo_por_cuadro", ElapsedMs(start));
+	}
+	glDeleteBuffers(1, &target);
+
+	// --- Salida ---
+	std::ofstream csv(csvPath);
+	csv << "modo,cuadros,pedazos,bytes,ms_por_cuadro,mb_por_segundo\n";
+	for (const BenchResult& r : results)
+	{
+		std::ostringstream line;
+		line << std::fixed << std::setprecision(3) << r.mode << "," << r.frames << "," << r.pieces << "," << r.bytes << ","
+			<< r.msPerFrame << "," << r.mbPerSecond;
+		csv << line.str() << "\n";
+		std::cout << line.str() << std::endl;
+	}
+	std::cout << "Resultados en " << csvPath << " (" << frameBytes / 1024 << " KB por cuadro)" << std::endl;
+
+	glfwDestroyWindow(window);
+	glfwTerminate();
+	return EXIT_SUCCESS;
+}
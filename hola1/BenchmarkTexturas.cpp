@@ -0,0 +1,388 @@
+// Benchmark de carga de texturas sobre los assets del proyecto
+// Recorre images/ y Models/ y pasa cada archivo por todos los caminos de decodificacion
+// disponibles: stb_image (el que usa ProyectoFinal.cpp y Model.h), SOIL_load_image de SOIL2
+// y los cargadores directos de SOIL2 para DDS/PVR/PKM. Para cada uno reporta tiempo de
+// decodificacion, throughput, pico de memoria y tiempo de subida a un contexto GL (ventana oculta;
+// con Mesa sin pantalla tambien funciona, o se puede omitir con --sin-gl).
+//
+// pico_KB es exacto para stb_image (sus reservas se cuentan); SOIL2 esta precompilado, asi
+// que para sus caminos se reporta el pico de memoria del proceso.
+//
+// Uso: BenchmarkTexturas [--csv archivo.csv] [--json archivo.json] [--repeticiones N] [--sin-gl] [carpeta ...]
+// Requiere C++17 (std::filesystem). Se enlaza con soil2, glfw3, glew32 y opengl32 como el proyecto.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <cstdlib>
+#include <cstring>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// --- Conteo de memoria de stb_image ---
+// stb_image se compila aqui en modo static (no choca con la copia que trae soil2) y todas
+// sus reservas pasan por estas funciones para medir el pico de memoria de cada decodificacion.
+static size_t stbCurrentBytes = 0;
+static size_t stbPeakBytes = 0;
+
+static void* CountingMalloc(size_t size)
+{
+	size_t* block = (size_t*)malloc(size + sizeof(size_t) * 2);
+	if (!block)
+		return NULL;
+	block[0] = size;
+	stbCurrentBytes += size;
+	stbPeakBytes = std::max(stbPeakBytes, stbCurrentBytes);
+	return block + 2;
+}
+
+static void CountingFree(void* p)
+{
+	if (!p)
+		return;
+	size_t* block = (size_t*)p - 2;
+	stbCurrentBytes -= block[0];
+	free(block);
+}
+
+static void* CountingRealloc(void* p, size_t size)
+{
+	if (!p)
+		return CountingMalloc(size);
+	size_t* block = (size_t*)p - 2;
+	size_t oldSize = block[0];
+	size_t* resized = (size_t*)realloc(block, size + sizeof(size_t) * 2);
+	if (!resized)
+		return NULL;
+	resized[0] = size;
+	stbCurrentBytes += size - oldSize;
+	stbPeakBytes = std::max(stbPeakBytes, stbCurrentBytes);
+	return resized + 2;
+}
+
+#define STB_IMAGE_STATIC
+#define STBI_MALLOC(sz) CountingMalloc(sz)
+#define STBI_REALLOC(p, newsz) CountingRealloc(p, newsz)
+#define STBI_FREE(p) CountingFree(p)
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "SOIL2/SOIL2.h"
+
+namespace fs = std::filesystem;
+
+// Un resultado por archivo y camino de decodificacion
+struct BenchResult
+{
+	std::string file;
+	std::string path;		// stb_image, SOIL_load_image, SOIL_direct_*
+	bool ok;
+	int width;
+	int height;
+	int channels;
+	size_t fileBytes;
+	double decodeMs;
+	double uploadMs;		// -1 si no hubo contexto GL
+	size_t peakKB;
+};
+
+// Pico de memoria del proceso (para los caminos que no podemos instrumentar)
+size_t ProcessPeakKB()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize / 1024;
+	return 0;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return (size_t)usage.ru_maxrss;	// Linux ya lo da en KB
+#endif
+}
+
+double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Sube los pixeles como lo hace TextureFromFile (glTexImage2D + mipmaps) y espera a la GPU
+double UploadTexture(const unsigned char* pixels, int width, int height, int channels)
+{
+	GLenum format = GL_RGB;
+	if (channels == 1)
+		format = GL_RED;
+	else if (channels == 2)
+		format = GL_RG;
+	else if (channels == 4)
+		format = GL_RGBA;
+
+	GLuint textureID;
+	glGenTextures(1, &textureID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	glFinish();
+	auto start = std::chrono::high_resolution_clock::now();
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glFinish();
+	double ms = ElapsedMs(start);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glDeleteTextures(1, &textureID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	return ms;
+}
+
+BenchResult BenchStb(const std::string& file, size_t fileBytes, int repeats, bool useGL)
+{
+	BenchResult r = { file, "stb_image", false, 0, 0, 0, fileBytes, 0.0, -1.0, 0 };
+	double best = 1e30;
+	unsigned char* image = NULL;
+
+	for (int i = 0; i < repeats; i++)
+	{
+		if (image)
+			stbi_image_free(image);
+		stbPeakBytes = stbCurrentBytes;
+		auto start = std::chrono::high_resolution_clock::now();
+		image = stbi_load(file.c_str(), &r.width, &r.height, &r.channels, 0);
+		best = std::min(best, ElapsedMs(start));
+	}
+
+	if (!image)
+		return r;
+
+	r.ok = true;
+	r.decodeMs = best;
+	r.peakKB = stbPeakBytes / 1024;
+	if (useGL)
+		r.uploadMs = UploadTexture(image, r.width, r.height, r.channels);
+	stbi_image_free(image);
+	return r;
+}
+
+BenchResult BenchSoil(const std::string& file, size_t fileBytes, int repeats, bool useGL)
+{
+	BenchResult r = { file, "SOIL_load_image", false, 0, 0, 0, fileBytes, 0.0, -1.0, 0 };
+	double best = 1e30;
+	unsigned char* image = NULL;
+
+	for (int i = 0; i < repeats; i++)
+	{
+		if (image)
+			SOIL_free_image_data(image);
+		auto start = std::chrono::high_resolution_clock::now();
+		image = SOIL_load_image(file.c_str(), &r.width, &r.height, &r.channels, SOIL_LOAD_AUTO);
+		best = std::min(best, ElapsedMs(start));
+	}
+
+	if (!image)
+		return r;
+
+	r.ok = true;
+	r.decodeMs = best;
+	r.peakKB = ProcessPeakKB();
+	if (useGL)
+		r.uploadMs = UploadTexture(image, r.width, r.height, r.channels);
+	SOIL_free_image_data(image);
+	return r;
+}
+
+// Formatos ya comprimidos: SOIL2 los sube directo a la GPU, asi que decodificar y subir es un solo paso
+BenchResult BenchDirect(const std::string& file, const std::string& extension, size_t fileBytes, int repeats)
+{
+	BenchResult r = { file, "SOIL_direct_" + extension, false, 0, 0, 0, fileBytes, 0.0, 0.0, 0 };
+	double best = 1e30;
+
+	for (int i = 0; i < repeats; i++)
+	{
+		glFinish();
+		auto start = std::chrono::high_resolution_clock::now();
+		GLuint textureID = 0;
+		if (extension == "dds")
+			textureID = SOIL_direct_load_DDS(file.c_str(), SOIL_CREATE_NEW_ID, 0, 0);
+		else if (extension == "pvr")
+			textureID = SOIL_direct_load_PVR(file.c_str(), SOIL_CREATE_NEW_ID, 0, 0);
+		else if (extension == "pkm")
+			textureID = SOIL_direct_load_ETC1(file.c_str(), SOIL_CREATE_NEW_ID, 0);
+		glFinish();
+		best = std::min(best, ElapsedMs(start));
+
+		if (!textureID)
+			return r;
+
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &r.width);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &r.height);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glDeleteTextures(1, &textureID);
+	}
+
+	r.ok = true;
+	r.decodeMs = best;
+	r.peakKB = ProcessPeakKB();
+	return r;
+}
+
+std::string JsonEscape(const std::string& s)
+{
+	std::string out;
+	for (char c : s)
+	{
+		if (c == '"' || c == '\\')
+			out += '\\';
+		out += c;
+	}
+	return out;
+}
+
+int main(int argc, char* argv[])
+{
+	std::string csvPath = "benchmark_texturas.csv";
+	std::string jsonPath = "benchmark_texturas.json";
+	int repeats = 3;
+	bool useGL = true;
+	std::vector<std::string> folders;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--csv" && i + 1 < argc)
+			csvPath = argv[++i];
+		else if (arg == "--json" && i + 1 < argc)
+			jsonPath = argv[++i];
+		else if (arg == "--repeticiones" && i + 1 < argc)
+			repeats = std::max(1, atoi(argv[++i]));
+		else if (arg == "--sin-gl")
+			useGL = false;
+		else
+			folders.push_back(arg);
+	}
+	if (folders.empty())
+	{
+		folders.push_back("images");
+		folders.push_back("Models");
+	}
+
+	// --- Contexto GL oculto para medir la subida ---
+	GLFWwindow* window = nullptr;
+	if (useGL)
+	{
+		glfwInit();
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+		glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+		window = glfwCreateWindow(64, 64, "Benchmark Texturas", nullptr, nullptr);
+		if (nullptr == window)
+		{
+			std::cout << "Failed to create GLFW window, se omite la subida a GL" << std::endl;
+			useGL = false;
+		}
+		else
+		{
+			glfwMakeContextCurrent(window);
+			glewExperimental = GL_TRUE;
+			if (GLEW_OK != glewInit())
+			{
+				std::cout << "Failed to initialise GLEW, se omite la subida a GL" << std::endl;
+				useGL = false;
+			}
+		}
+	}
+
+	// --- Lista de archivos (orden estable para comparar corridas) ---
+	std::vector<fs::path> files;
+	for (const std::string& folder : folders)
+	{
+		std::error_code error;
+		for (fs::recursive_directory_iterator it(folder, error), end; !error && it != end; it.increment(error))
+		{
+			if (it->is_regular_file())
+				files.push_back(it->path());
+		}
+	}
+	std::sort(files.begin(), files.end());
+
+	std::vector<BenchResult> results;
+	for (const fs::path& path : files)
+	{
+		std::string file = path.generic_string();
+		std::string extension = path.extension().string();
+		if (!extension.empty())
+			extension = extension.substr(1);
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		size_t fileBytes = (size_t)fs::file_size(path);
+
+		if (extension == "dds" || extension == "pvr" || extension == "pkm")
+		{
+			if (useGL)
+				results.push_back(BenchDirect(file, extension, fileBytes, repeats));
+		}
+
+		// stb_image y SOIL2 intentan todo; los que no son imagen (.mtl, .dae...) salen como fallidos
+		BenchResult stb = BenchStb(file, fileBytes, repeats, useGL);
+		BenchResult soil = BenchSoil(file, fileBytes, repeats, useGL);
+		if (!stb.ok && !soil.ok)
+			continue;
+		results.push_back(stb);
+		results.push_back(soil);
+	}
+
+	// --- Salida ---
+	std::ofstream csv(csvPath);
+	std::ofstream json(jsonPath);
+	csv << "archivo,decodificador,ok,ancho,alto,canales,bytes_archivo,decode_ms,MB_s,MPix_s,pico_KB,upload_ms\n";
+	json << "[\n";
+
+	std::cout << std::fixed << std::setprecision(3);
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchResult& r = results[i];
+		double seconds = r.decodeMs / 1000.0;
+		double mbPerSecond = (r.ok && seconds > 0.0) ? (r.fileBytes / 1.0e6) / seconds : 0.0;
+		double mpixPerSecond = (r.ok && seconds > 0.0) ? ((double)r.width * r.height / 1.0e6) / seconds : 0.0;
+
+		std::ostringstream line;
+		line << std::fixed << std::setprecision(3) << r.file << "," << r.path << "," << (r.ok ? 1 : 0) << ","
+			<< r.width << "," << r.height << "," << r.channels << "," << r.fileBytes << ","
+			<< r.decodeMs << "," << mbPerSecond << "," << mpixPerSecond << "," << r.peakKB << "," << r.uploadMs;
+		csv << line.str() << "\n";
+		std::cout << line.str() << std::endl;
+
+		json << std::fixed << std::setprecision(3)
+			<< "  {\"archivo\": \"" << JsonEscape(r.file) << "\", \"decodificador\": \"" << r.path << "\", \"ok\": " << (r.ok ? "true" : "false")
+			<< ", \"ancho\": " << r.width << ", \"alto\": " << r.height << ", \"canales\": " << r.channels
+			<< ", \"bytes_archivo\": " << r.fileBytes << ", \"decode_ms\": " << r.decodeMs
+			<< ", \"MB_s\": " << mbPerSecond << ", \"MPix_s\": " << mpixPerSecond
+			<< ", \"pico_KB\": " << r.peakKB << ", \"upload_ms\": " << r.uploadMs << "}"
+			<< (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	json << "]\n";
+
+	std::cout << "Resultados en " << csvPath << " y " << jsonPath << std::endl;
+
+	if (window)
+	{
+		glfwDestroyWindow(window);
+		glfwTerminate();
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+// Benchmark de la linea de tiempo (Timeline.h)
+// Arma una linea de tiempo con muchas pistas al azar (un tercio float, vec3 y quat; mitad en ciclo),
+// la guarda en texto y en binario y mide:
+//   carga_texto / carga_binario   tiempo de Load de cada formato
+//   secuencial                    Evaluate + Apply avanzando 1/60 s por cuadro (cursores)
+//   aleatorio                     Evaluate en tiempos al azar (busqueda binaria en cada pista)
+//
+// Uso: BenchmarkTimeline [--csv archivo.csv] [--pistas N] [--llaves N] [--cuadros N]
+// No necesita contexto GL (solo los tipos de GLEW). Se enlaza con glew32 como el proyecto.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+
+#include "Timeline.h"
+
+double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+GLfloat Random(GLfloat low, GLfloat high)
+{
+	return low + (high - low) * rand() / (GLfloat)RAND_MAX;
+}
+
+struct BenchResult
+{
+	std::string mode;
+	GLuint tracks;
+	GLuint keys;
+	double microseconds;	// Por carga o por cuadro
+	double nsPerTrack;
+};
+
+int main(int argc, char* argv[])
+{
+	std::string csvPath = "benchmark_timeline.csv";
+	GLuint trackCount = 10000;
+	GLuint keysPerTrack = 16;
+	GLuint frames = 2000;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--csv" && i + 1 < argc)
+			csvPath = argv[++i];
+		else if (arg == "--pistas" && i + 1 < argc)
+			trackCount = std::max(1, atoi(argv[++i]));
+		else if (arg == "--llaves" && i + 1 < argc)
+			keysPerTrack = std::max(2, atoi(argv[++i]));
+		else if (arg == "--cuadros" && i + 1 < argc)
+			frames = std::max(1, atoi(argv[++i]));
+	}
+
+	// --- Pistas al azar ---
+	srand(1234);
+	Timeline timeline;
+	std::vector<GLfloat> floats(trackCount);
+	std::vector<glm::vec3> vectors(trackCount);
+	std::vector<glm::quat> rotations(trackCount);
+	std::vector<GLfloat> keyTimes, keyValues;
+	for (GLuint t = 0; t < trackCount; t++)
+	{
+		Timeline_Value type = t % 3 == 0 ? TIMELINE_FLOAT : t % 3 == 1 ? TIMELINE_VEC3 : TIMELINE_QUAT;
+		Timeline_Interpolation interpolation = (Timeline_Interpolation)(t % 7 == 0 ? TIMELINE_STEP : t % 2 == 0 ? TIMELINE_LINEAR : TIMELINE_SMOOTH);
+		keyTimes.clear();
+		keyValues.clear();
+		GLfloat time = 0.0f;
+		for (GLuint k = 0; k < keysPerTrack; k++)
+		{
+			keyTimes.push_back(time);
+			time += Random(0.05f, 1.0f);
+			if (type == TIMELINE_QUAT)
+			{
+				glm::quat q = glm::angleAxis(Random(-3.14f, 3.14f), glm::normalize(glm::vec3(Random(-1, 1), Random(-1, 1), Random(0.1f, 1))));
+				keyValues.insert(keyValues.end(), { q.x, q.y, q.z, q.w });
+			}
+			else
+			{
+				for (GLuint c = 0; c < (GLuint)type; c++)
+					keyValues.push_back(Random(-10.0f, 10.0f));
+			}
+		}
+		std::ostringstream name;
+		name << "pista" << t;
+		timeline.AddTrack(name.str(), type, interpolation, t % 2 == 0, keyTimes, keyValues);
+		if (type == TIMELINE_FLOAT)
+			timeline.Bind(name.str(), &floats[t]);
+		else if (type == TIMELINE_VEC3)
+			timeline.Bind(name.str(), &vectors[t]);
+		else
+			timeline.Bind(name.str(), &rotations[t]);
+	}
+
+	std::vector<BenchResult> results;
+	std::cout << std::fixed << std::setprecision(3);
+
+	// --- Carga de cada formato ---
+	const std::string textPath = "benchmark_timeline.txt";
+	const std::string binaryPath = "benchmark_timeline.bin";
+	timeline.SaveText(textPath);
+	timeline.SaveBinary(binaryPath);
+	Timeline loaded;
+	auto start = std::chrono::high_resolution_clock::now();
+	bool textLoaded = loaded.Load(textPath);
+	double textMs = ElapsedMs(start);
+	start = std::chrono::high_resolution_clock::now();
+	bool binaryLoaded = loaded.Load(binaryPath);
+	double binaryMs = ElapsedMs(start);
+	if (!textLoaded || !binaryLoaded || loaded.GetKeyCount() != timeline.GetKeyCount())
+	{
+		std::cout << "ERROR: no se pudo volver a cargar la linea de tiempo" << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::ifstream textFile(textPath.c_str(), std::ios::binary | std::ios::ate);
+	std::ifstream binaryFile(binaryPath.c_str(), std::ios::binary | std::ios::ate);
+	std::cout << trackCount << " pistas, " << timeline.GetKeyCount() << " llaves: texto " << textFile.tellg() / 1024 << " KB, binario "
+		<< binaryFile.tellg() / 1024 << " KB" << std::endl;
+	results.push_back({ "carga_texto", trackCount, timeline.GetKeyCount(), textMs * 1000.0, textMs * 1.0e6 / trackCount });
+	results.push_back({ "carga_binario", trackCount, timeline.GetKeyCount(), binaryMs * 1000.0, binaryMs * 1.0e6 / trackCount });
+	textFile.close();
+	binaryFile.close();
+	remove(textPath.c_str());
+	remove(binaryPath.c_str());
+
+	// --- Evaluacion ---
+	GLfloat sink = 0.0f;
+	start = std::chrono::high_resolution_clock::now();
+	for (GLuint f = 0; f < frames; f++)
+	{
+		timeline.Evaluate(f / 60.0f);
+		timeline.Apply();
+		sink += floats[f % trackCount] + vectors[f % trackCount].x + rotations[f % trackCount].w;
+	}
+	double sequentialMs = ElapsedMs(start);
+	results.push_back({ "secuencial", trackCount, timeline.GetKeyCount(), sequentialMs * 1000.0 / frames, sequentialMs * 1.0e6 / ((double)frames * trackCount) });
+
+	start = std::chrono::high_resolution_clock::now();
+	for (GLuint f = 0; f < frames; f++)
+	{
+		timeline.Evaluate(Random(0.0f, keysPerTrack * 0.5f));
+		timeline.Apply();
+		sink += floats[f % trackCount] + vectors[f % trackCount].x + rotations[f % trackCount].w;
+	}
+	double randomMs = ElapsedMs(start);
+	results.push_back({ "aleatorio", trackCount, timeline.GetKeyCount(), randomMs * 1000.0 / frames, randomMs * 1.0e6 / ((double)frames * trackCount) });
+
+	// --- Salida ---
+	std::ofstream csv(csvPath);
+	csv << "modo,pistas,llaves,microsegundos,ns_por_pista\n";
+	for (const BenchResult& r : results)
+	{
+		std::ostringstream line;
+		line << std::fixed << std::setprecision(3) << r.mode << "," << r.tracks << "," << r.keys << "," << r.microseconds << "," << r.nsPerTrack;
+		csv << line.str() << "\n";
+		std::cout << line.str() << std::endl;
+	}
+	std::cout << "Resultados en " << csvPath << " (" << frames << " cuadros, suma " << sink << ")" << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+// Benchmark de las criaturas que vagan (Wanderers.h)
+// Mueve N criaturas durante varios cuadros con la misma logica que tenian Ho-oh y Mew en
+// Animacion() y compara:
+//   aos_glm          un struct por criatura con glm::normalize/cross y rand(), como el codigo original
+//   soa_escalar      WandererSimulation sin SSE (una criatura a la vez sobre los arreglos)
+//   soa_sse2         WandererSimulation con SSE2 (4 criaturas a la vez), un hilo
+//   soa_sse2_hilos   lo mismo repartido en varios hilos
+//
+// Uso: BenchmarkWanderers [--csv archivo.csv] [--cuadros N] [--hilos N] [criaturas ...]
+// No necesita contexto GL (solo los tipos de GLEW).
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include "Wanderers.h"
+
+double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// La criatura del codigo original: todo junto y el objetivo nuevo con rand()
+struct Creature
+{
+	glm::vec3 position;
+	glm::vec3 target;
+	glm::vec3 direction;
+	GLfloat speed;
+	GLfloat curveSpeed;
+	GLfloat curveAmount;
+};
+
+void UpdateCreatures(std::vector<Creature>& creatures, GLfloat time, GLfloat deltaTime)
+{
+	for (Creature& c : creatures)
+	{
+		if (glm::distance(c.position, c.target) < 2.0f)
+		{
+			c.target = glm::vec3((rand() % 120) - 60.0f, (rand() % 20) + 60.0f, (rand() % 120) - 60.0f);
+		}
+		glm::vec3 linearDirection = glm::normalize(c.target - c.position);
+		glm::vec3 rightVector = glm::normalize(glm::cross(linearDirection, glm::vec3(0.0f, 1.0f, 0.0f)));
+		GLfloat curveFactor = sin(time * c.curveSpeed);
+		c.direction = glm::normalize(linearDirection + (rightVector * curveFactor * c.curveAmount));
+		c.position += c.direction * c.speed * deltaTime;
+	}
+}
+
+struct BenchResult
+{
+	std::string mode;
+	GLuint creatures;
+	GLuint threads;
+	double msPerFrame;
+	double nsPerCreature;
+};
+
+int main(int argc, char* argv[])
+{
+	std::string csvPath = "benchmark_wanderers.csv";
+	GLuint frames = 100;
+	GLuint threadCount = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<GLuint> counts;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--csv" && i + 1 < argc)
+			csvPath = argv[++i];
+		else if (arg == "--cuadros" && i + 1 < argc)
+			frames = std::max(1, atoi(argv[++i]));
+		else if (arg == "--hilos" && i + 1 < argc)
+			threadCount = std::max(1, atoi(argv[++i]));
+		else
+			counts.push_back(std::max(1, atoi(arg.c_str())));
+	}
+	if (counts.empty())
+		counts = { 10000, 100000, 1000000 };
+
+	std::vector<BenchResult> results;
+	std::cout << std::fixed << std::setprecision(3);
+	const GLfloat deltaTime = 1.0f / 60.0f;
+	const glm::vec3 regionMin(-60.0f, 60.0f, -60.0f);
+	const glm::vec3 regionMax(60.0f, 80.0f, 60.0f);
+
+	for (GLuint count : counts)
+	{
+		srand(1234);
+		std::vector<Creature> creatures(count);
+		WandererSimulation simulation;
+		for (GLuint i = 0; i < count; i++)
+		{
+			glm::vec3 position((rand() % 120) - 60.0f, (rand() % 20) + 60.0f, (rand() % 120) - 60.0f);
+			GLfloat speed = 8.0f + (rand() % 40) * 0.1f;
+			creatures[i] = { position, position, glm::vec3(0.0f, 0.0f, 1.0f), speed, 0.5f, 1.0f };
+			simulation.Add(position, regionMin, regionMax, speed, 0.5f, 1.0f, 2.0f);
+		}
+
+		// Un cuadro de calentamiento para que todos tengan objetivo
+		UpdateCreatures(creatures, 0.0f, deltaTime);
+		auto start = std::chrono::high_resolution_clock::now();
+		for (GLuint f = 1; f <= frames; f++)
+			UpdateCreatures(creatures, f * deltaTime, deltaTime);
+		double aosMs = ElapsedMs(start) / frames;
+
+		struct SoaMode { const char* name; GLuint threads; bool simd; };
+		SoaMode modes[] = { { "soa_escalar", 1, false }, { "soa_sse2", 1, true }, { "soa_sse2_hilos", threadCount, true } };
+		results.push_back({ "aos_glm", count, 1, aosMs, aosMs * 1.0e6 / count });
+		for (const SoaMode& mode : modes)
+		{
+			simulation.Update(0.0f, deltaTime, mode.threads, mode.simd);
+			start = std::chrono::high_resolution_clock::now();
+			for (GLuint f = 1; f <= frames; f++)
+				simulation.Update(f * deltaTime, deltaTime, mode.threads, mode.simd);
+			double ms = ElapsedMs(start) / frames;
+			results.push_back({ mode.name, count, mode.threads, ms, ms * 1.0e6 / count });
+		}
+
+		// Comprobacion: todas siguen dentro de su region (con margen por la curva)
+		GLuint outside = 0;
+		for (GLuint i = 0; i < count; i++)
+		{
+			glm::vec3 p = simulation.GetPosition(i);
+			if (p.x < regionMin.x - 20.0f || p.x > regionMax.x + 20.0f || p.z < regionMin.z - 20.0f || p.z > regionMax.z + 20.0f)
+				outside++;
+		}
+		std::cout << count << " criaturas: " << outside << " fuera de su region" << std::endl;
+	}
+
+	// --- Salida ---
+	std::ofstream csv(csvPath);
+	csv << "modo,criaturas,hilos,ms_por_cuadro,ns_por_criatura\n";
+	for (const BenchResult& r : results)
+	{
+		std::ostringstream line;
+		line << std::fixed << std::setprecision(3) << r.mode << "," << r.creatures << "," << r.threads << "," << r.msPerFrame << "," << r.nsPerCreature;
+		csv << line.str() << "\n";
+		std::cout << line.str() << std::endl;
+	}
+	std::cout << "Resultados en " << csvPath << " (" << frames << " cuadros)" << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,310 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// Menos aves por hilo que esto no compensa lanzar hilos
+const GLuint BOIDS_MIN_PER_THREAD = 4096;
+
+// Celdas vecinas ordenadas por cercania: la propia, 6 caras, 12 aristas y 8 esquinas
+const GLint BOID_CELL_OFFSETS[27][3] =
+{
+	{ 0, 0, 0 },
+	{ -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }, { 0, 0, -1 }, { 0, 0, 1 },
+	{ -1, -1, 0 }, { 1, -1, 0 }, { -1, 1, 0 }, { 1, 1, 0 }, { -1, 0, -1 }, { 1, 0, -1 },
+	{ -1, 0, 1 }, { 1, 0, 1 }, { 0, -1, -1 }, { 0, 1, -1 }, { 0, -1, 1 }, { 0, 1, 1 },
+	{ -1, -1, -1 }, { 1, -1, -1 }, { -1, 1, -1 }, { 1, 1, -1 }, { -1, -1, 1 }, { 1, -1, 1 }, { -1, 1, 1 }, { 1, 1, 1 }
+};
+
+// Parametros de la bandada (distancias en unidades del mundo, tiempos en segundos)
+struct BoidSettings
+{
+	GLfloat neighborRadius;		// Hasta donde ve a sus vecinas (tambien es el tamano de celda de la rejilla)
+	GLfloat separationRadius;	// Mas cerca que esto se empujan
+	GLfloat separationWeight;
+	GLfloat alignmentWeight;
+	GLfloat cohesionWeight;
+	GLfloat goalWeight;			// Atraccion hacia el lider (SetGoal)
+	GLfloat goalRadius;			// Dentro de este radio el lider ya no jala
+	GLfloat minSpeed;
+	GLfloat maxSpeed;
+	GLfloat maxAcceleration;
+	GLuint maxNeighbors;		// Con mas vecinas que esto deja de buscar (bandadas muy densas)
+
+	BoidSettings()
+		: neighborRadius(5.0f), separationRadius(2.0f), separationWeight(8.0f), alignmentWeight(1.0f), cohesionWeight(0.5f),
+		goalWeight(1.0f), goalRadius(15.0f), minSpeed(6.0f), maxSpeed(14.0f), maxAcceleration(30.0f), maxNeighbors(24)
+	{
+	}
+};
+
+// Bandada con separacion, alineacion y cohesion (boids).
+// Cada cuadro las aves se ordenan por celda de una rejilla uniforme con counting sort (tabla hash
+// de celdas, asi el espacio no tiene limites): posiciones y velocidades se copian en ese orden,
+// de modo que las vecinas de una celda quedan seguidas en memoria y cada ave solo revisa las
+// 27 celdas que la rodean en lugar de toda la bandada. Se lee de la copia ordenada y se escribe
+// en el estado de cada ave por su indice, asi el indice de cada una no cambia entre cuadros y
+// los hilos no se pisan.
+// GetPosition/GetDirection dan lo mismo que Animacion() para hoohPos/hoohDirection.
+class BoidFlock
+{
+public:
+	BoidFlock(const BoidSettings& settings = BoidSettings())
+		: settings(settings), goal(0.0f), goalWeight(0.0f), tableMask(0)
+	{
+	}
+
+	void Clear()
+	{
+		this->px.clear(); this->py.clear(); this->pz.clear();
+		this->vx.clear(); this->vy.clear(); this->vz.clear();
+	}
+
+	// Agrega un ave; regresa su indice
+	GLuint Add(const glm::vec3& position, const glm::vec3& velocity)
+	{
+		this->px.push_back(position.x);
+		this->py.push_back(position.y);
+		this->pz.push_back(position.z);
+		this->vx.push_back(velocity.x);
+		this->vy.push_back(velocity.y);
+		this->vz.push_back(velocity.z);
+		return (GLuint)this->px.size() - 1;
+	}
+
+	// Punto que sigue la bandada (el lider); con peso 0 vuelan libres
+	void SetGoal(const glm::vec3& position, GLfloat weight = 1.0f)
+	{
+		this->goal = position;
+		this->goalWeight = weight;
+	}
+
+	// Reconstruye la rejilla y avanza todas las aves
+	void Update(GLfloat deltaTime, GLuint threadCount = 1)
+	{
+		GLuint count = this->GetCount();
+		if (count == 0)
+		{
+			return;
+		}
+		this->buildGrid();
+
+		GLuint threads = std::max(1u, std::min(threadCount, count / BOIDS_MIN_PER_THREAD));
+		GLuint block = (count + threads - 1) / threads;
+		std::vector<std::thread> workers;
+		for (GLuint t = 0; t + 1 < threads; t++)
+		{
+			workers.push_back(std::thread(&BoidFlock::updateRange, this, t * block, std::min((t + 1) * block, count), deltaTime));
+		}
+		this->updateRange(std::min((threads - 1) * block, count), count, deltaTime);
+		for (size_t t = 0; t < workers.size(); t++)
+		{
+			workers[t].join();
+		}
+	}
+
+	GLuint GetCount() const { return (GLuint)this->px.size(); }
+	glm::vec3 GetPosition(GLuint i) const { return glm::vec3(this->px[i], this->py[i], this->pz[i]); }
+	glm::vec3 GetVelocity(GLuint i) const { return glm::vec3(this->vx[i], this->vy[i], this->vz[i]); }
+	glm::vec3 GetDirection(GLuint i) const
+	{
+		glm::vec3 velocity = this->GetVelocity(i);
+		GLfloat speed = glm::length(velocity);
+		return speed > 1e-6f ? velocity / speed : glm::vec3(0.0f, 0.0f, 1.0f);
+	}
+	BoidSettings& GetSettings() { return this->settings; }
+
+private:
+	BoidSettings settings;
+	glm::vec3 goal;
+	GLfloat goalWeight;
+
+	// Estado por ave, en el orden en que se agregaron
+	std::vector<GLfloat> px, py, pz;
+	std::vector<GLfloat> vx, vy, vz;
+
+	// Rejilla del cuadro: copia ordenada por celda y el inicio de cada celda en ella
+	std::vector<GLfloat> sx, sy, sz;
+	std::vector<GLfloat> svx, svy, svz;
+	std::vector<GLuint> sortedIds;		// Indice original de cada ave ordenada
+	std::vector<GLuint> sortedKeys;		// Celda de cada ave ordenada (cellKey)
+	std::vector<GLuint> cells;			// Cubeta de la tabla de cada ave, en orden original
+	std::vector<GLuint> keys;			// Celda de cada ave, en orden original
+	std::vector<GLuint> cellStart;		// Ave ordenada donde empieza cada cubeta (tamano tabla + 1)
+	std::vector<GLuint> cellCursor;		// Siguiente lugar libre de cada cubeta al repartir
+	GLuint tableMask;
+	GLfloat inverseCellSize;
+
+	// Coordenadas de la celda en 10 bits por eje (dos celdas vecinas nunca se confunden)
+	static GLuint cellKey(GLint x, GLint y, GLint z)
+	{
+		return ((GLuint)x & 1023u) | (((GLuint)y & 1023u) << 10) | (((GLuint)z & 1023u) << 20);
+	}
+
+	GLuint hashCell(GLint x, GLint y, GLint z) const
+	{
+		return (((GLuint)x * 73856093u) ^ ((GLuint)y * 19349663u) ^ ((GLuint)z * 83492791u)) & this->tableMask;
+	}
+
+	// Counting sort por cubeta: contar, sumar prefijos y repartir
+	void buildGrid()
+	{
+		GLuint count = this->GetCount();
+		GLuint tableSize = 1;
+		while (tableSize < count * 2)
+		{
+			tableSize <<= 1;
+		}
+		this->tableMask = tableSize - 1;
+		this->inverseCellSize = 1.0f / this->settings.neighborRadius;
+
+		this->cells.resize(count);
+		this->keys.resize(count);
+		this->cellStart.assign(tableSize + 1, 0);
+		for (GLuint i = 0; i < count; i++)
+		{
+			GLint x = (GLint)std::floor(this->px[i] * this->inverseCellSize);
+			GLint y = (GLint)std::floor(this->py[i] * this->inverseCellSize);
+			GLint z = (GLint)std::floor(this->pz[i] * this->inverseCellSize);
+			GLuint cell = this->hashCell(x, y, z);
+			this->cells[i] = cell;
+			this->keys[i] = cellKey(x, y, z);
+			this->cellStart[cell + 1]++;
+		}
+		for (GLuint c = 0; c < tableSize; c++)
+		{
+			this->cellStart[c + 1] += this->cellStart[c];
+		}
+
+		this->sx.resize(count); this->sy.resize(count); this->sz.resize(count);
+		this->svx.resize(count); this->svy.resize(count); this->svz.resize(count);
+		this->sortedIds.resize(count);
+		this->sortedKeys.resize(count);
+		this->cellCursor.assign(this->cellStart.begin(), this->cellStart.end() - 1);
+		for (GLuint i = 0; i < count; i++)
+		{
+			GLuint slot = this->cellCursor[this->cells[i]]++;
+			this->sx[slot] = this->px[i];
+			this->sy[slot] = this->py[i];
+			this->sz[slot] = this->pz[i];
+			this->svx[slot] = this->vx[i];
+			this->svy[slot] = this->vy[i];
+			this->svz[slot] = this->vz[i];
+			this->sortedIds[slot] = i;
+			this->sortedKeys[slot] = this->keys[i];
+		}
+	}
+
+	// Avanza las aves ordenadas [begin, end): lee la copia ordenada y escribe el estado de cada una
+	void updateRange(GLuint begin, GLuint end, GLfloat deltaTime)
+	{
+		const BoidSettings& s = this->settings;
+		GLfloat neighborRadius2 = s.neighborRadius * s.neighborRadius;
+		GLfloat separationRadius2 = s.separationRadius * s.separationRadius;
+
+		for (GLuint i = begin; i < end; i++)
+		{
+			GLfloat x = this->sx[i], y = this->sy[i], z = this->sz[i];
+			GLfloat velocityX = this->svx[i], velocityY = this->svy[i], velocityZ = this->svz[i];
+			GLint cellX = (GLint)std::floor(x * this->inverseCellSize);
+			GLint cellY = (GLint)std::floor(y * this->inverseCellSize);
+			GLint cellZ = (GLint)std::floor(z * this->inverseCellSize);
+
+			// 1. Vecinas en las 27 celdas de alrededor, de la propia a las esquinas para que al llegar
+			// a maxNeighbors ya se tengan las mas cercanas. Dos celdas pueden caer en la misma cubeta:
+			// de cada cubeta solo se toman las aves de la celda que se esta visitando
+			GLuint neighbors = 0;
+			GLfloat centerX = 0.0f, centerY = 0.0f, centerZ = 0.0f;
+			GLfloat headingX = 0.0f, headingY = 0.0f, headingZ = 0.0f;
+			GLfloat pushX = 0.0f, pushY = 0.0f, pushZ = 0.0f;
+			for (GLuint n = 0; n < 27 && neighbors < s.maxNeighbors; n++)
+			{
+				GLint neighborX = cellX + BOID_CELL_OFFSETS[n][0];
+				GLint neighborY = cellY + BOID_CELL_OFFSETS[n][1];
+				GLint neighborZ = cellZ + BOID_CELL_OFFSETS[n][2];
+				GLuint cell = this->hashCell(neighborX, neighborY, neighborZ);
+				GLuint key = cellKey(neighborX, neighborY, neighborZ);
+				for (GLuint j = this->cellStart[cell], last = this->cellStart[cell + 1]; j < last; j++)
+				{
+					GLfloat offsetX = this->sx[j] - x, offsetY = this->sy[j] - y, offsetZ = this->sz[j] - z;
+					GLfloat distance2 = offsetX * offsetX + offsetY * offsetY + offsetZ * offsetZ;
+					if (j == i || distance2 >= neighborRadius2 || this->sortedKeys[j] != key)
+					{
+						continue;
+					}
+					centerX += offsetX; centerY += offsetY; centerZ += offsetZ;
+					headingX += this->svx[j]; headingY += this->svy[j]; headingZ += this->svz[j];
+					if (distance2 < separationRadius2)
+					{
+						// Empuje mas fuerte entre mas cerca (1 / distancia)
+						GLfloat inverse = 1.0f / std::max(distance2, 1e-4f);
+						pushX -= offsetX * inverse; pushY -= offsetY * inverse; pushZ -= offsetZ * inverse;
+					}
+					if (++neighbors >= s.maxNeighbors)
+					{
+						break;
+					}
+				}
+			}
+
+			// 2. Separacion, alineacion y cohesion
+			GLfloat accelerationX = pushX * s.separationWeight;
+			GLfloat accelerationY = pushY * s.separationWeight;
+			GLfloat accelerationZ = pushZ * s.separationWeight;
+			if (neighbors > 0)
+			{
+				GLfloat inverseCount = 1.0f / neighbors;
+				accelerationX += (headingX * inverseCount - velocityX) * s.alignmentWeight + centerX * inverseCount * s.cohesionWeight;
+				accelerationY += (headingY * inverseCount - velocityY) * s.alignmentWeight + centerY * inverseCount * s.cohesionWeight;
+				accelerationZ += (headingZ * inverseCount - velocityZ) * s.alignmentWeight + centerZ * inverseCount * s.cohesionWeight;
+			}
+
+			// 3. Hacia el lider cuando se alejan de el
+			GLfloat toGoalX = this->goal.x - x, toGoalY = this->goal.y - y, toGoalZ = this->goal.z - z;
+			GLfloat goalDistance = std::sqrt(toGoalX * toGoalX + toGoalY * toGoalY + toGoalZ * toGoalZ);
+			if (this->goalWeight > 0.0f && goalDistance > s.goalRadius)
+			{
+				GLfloat seek = s.maxSpeed / goalDistance;
+				accelerationX += (toGoalX * seek - velocityX) * this->goalWeight * s.goalWeight;
+				accelerationY += (toGoalY * seek - velocityY) * this->goalWeight * s.goalWeight;
+				accelerationZ += (toGoalZ * seek - velocityZ) * this->goalWeight * s.goalWeight;
+			}
+
+			// 4. Integrar con la aceleracion y la velocidad acotadas
+			GLfloat acceleration = std::sqrt(accelerationX * accelerationX + accelerationY * accelerationY + accelerationZ * accelerationZ);
+			if (acceleration > s.maxAcceleration)
+			{
+				GLfloat scale = s.maxAcceleration / acceleration;
+				accelerationX *= scale; accelerationY *= scale; accelerationZ *= scale;
+			}
+			velocityX += accelerationX * deltaTime;
+			velocityY += accelerationY * deltaTime;
+			velocityZ += accelerationZ * deltaTime;
+			GLfloat speed = std::sqrt(velocityX * velocityX + velocityY * velocityY + velocityZ * velocityZ);
+			if (speed > 1e-6f)
+			{
+				GLfloat scale = glm::clamp(speed, s.minSpeed, s.maxSpeed) / speed;
+				velocityX *= scale; velocityY *= scale; velocityZ *= scale;
+			}
+			else
+			{
+				velocityZ = s.minSpeed;
+			}
+
+			GLuint id = this->sortedIds[i];
+			this->vx[id] = velocityX;
+			this->vy[id] = velocityY;
+			this->vz[id] = velocityZ;
+			this->px[id] = x + velocityX * deltaTime;
+			this->py[id] = y + velocityY * deltaTime;
+			this->pz[id] = z + velocityZ * deltaTime;
+		}
+	}
+};
@@ -0,0 +1,374 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <cmath>
+#include <cstring>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "StreamingBuffer.h"
+
+// SSE2 para las pruebas esfera/AABB (4 luces a la vez)
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define CLUSTER_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+// Tamano de la rejilla de clusters (x, y en pantalla, z en profundidad exponencial)
+const GLuint CLUSTER_DIM_X = 16;
+const GLuint CLUSTER_DIM_Y = 9;
+const GLuint CLUSTER_DIM_Z = 24;
+
+// Primera unidad de textura usada por los buffers de luces (0..n las usa Mesh::Draw)
+const GLuint CLUSTER_TEXTURE_UNIT = 10;
+
+// Intensidad minima que se considera visible (para calcular el radio de cada luz)
+const GLfloat CLUSTER_LIGHT_THRESHOLD = 5.0f / 256.0f;
+
+// Luz de punto, con el mismo formato que el struct PointLight del shader
+struct ClusterLight
+{
+	glm::vec3 position;
+	GLfloat radius;
+	glm::vec3 ambient;
+	GLfloat constant;
+	glm::vec3 diffuse;
+	GLfloat linear;
+	glm::vec3 specular;
+	GLfloat quadratic;
+};
+
+// Iluminacion "clustered forward".
+// El frustum de la camara se divide en CLUSTER_DIM_X * CLUSTER_DIM_Y * CLUSTER_DIM_Z celdas;
+// cada cuadro se asignan en CPU las luces a las celdas que tocan (esfera contra AABB en espacio de vista)
+// y el fragment shader solo recorre la lista de su celda.
+// Los datos viven en texture buffers (GL 3.3 core no tiene SSBOs):
+//   lightData    RGBA32F, 4 texeles por luz (posicion+radio, ambiente, difusa, especular + atenuacion)
+//   clusterGrid  RG32UI, (inicio, cantidad) de cada celda dentro de lightIndices, desde clusterGridOffset
+//   lightIndices R32UI, indices de luz de todas las celdas seguidas
+// La rejilla y los indices cambian cada cuadro y se copian al StreamingBuffer del cuadro.
+class ClusteredLights
+{
+public:
+	// Constructor, crea el buffer de luces vacio (la rejilla va en stream, que debe vivir mas)
+	ClusteredLights(StreamingBuffer& stream)
+		: lightCount(0), stream(&stream), gridOffset(-1), projection(1.0f), zNear(0.0f), zFar(0.0f), width(0), height(0), maxLightsPerCluster(0)
+	{
+		this->grid.resize(CLUSTER_DIM_X * CLUSTER_DIM_Y * CLUSTER_DIM_Z * 2, 0);
+		this->clusterMin.resize(CLUSTER_DIM_X * CLUSTER_DIM_Y * CLUSTER_DIM_Z);
+		this->clusterMax.resize(CLUSTER_DIM_X * CLUSTER_DIM_Y * CLUSTER_DIM_Z);
+
+		// Un buffer nunca puede quedar vacio, empezamos con un elemento
+		glGenBuffers(1, &this->lightBuffer);
+		glGenTextures(1, &this->lightTexture);
+		glBindBuffer(GL_TEXTURE_BUFFER, this->lightBuffer);
+		glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STATIC_DRAW);
+		glBindTexture(GL_TEXTURE_BUFFER, this->lightTexture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, this->lightBuffer);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+	}
+
+	~ClusteredLights()
+	{
+		glDeleteTextures(1, &this->lightTexture);
+		glDeleteBuffers(1, &this->lightBuffer);
+	}
+
+	// Distancia a la que la luz cae por debajo de CLUSTER_LIGHT_THRESHOLD
+	static GLfloat CalcRadius(GLfloat constant, GLfloat linear, GLfloat quadratic, GLfloat maxIntensity)
+	{
+		GLfloat c = constant - maxIntensity / CLUSTER_LIGHT_THRESHOLD;
+		if (quadratic <= 0.0f)
+		{
+			return (linear > 0.0f) ? -c / linear : 1000.0f;
+		}
+		return (-linear + sqrt(linear * linear - 4.0f * quadratic * c)) / (2.0f * quadratic);
+	}
+
+	// Reemplaza la lista de luces (se sube a la GPU una sola vez, no cada cuadro)
+	void SetLights(const std::vector<ClusterLight>& lights)
+	{
+		this->lights = lights;
+		this->lightCount = (GLuint)lights.size();
+
+		glBindBuffer(GL_TEXTURE_BUFFER, this->lightBuffer);
+		if (this->lightCount > 0)
+		{
+			glBufferData(GL_TEXTURE_BUFFER, this->lightCount * sizeof(ClusterLight), &this->lights[0], GL_STATIC_DRAW);
+		}
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+		// Posiciones en espacio de vista (SoA), con relleno a multiplo de 4 para SSE
+		GLuint padded = (this->lightCount + 3) & ~3u;
+		this->viewX.resize(padded);
+		this->viewY.resize(padded);
+		this->viewZ.resize(padded);
+		this->radius2.resize(padded);
+		this->sliceLights.reserve(padded);
+	}
+
+	// Asigna las luces a los clusters para la camara de este cuadro y copia la rejilla al buffer del cuadro
+	void Update(const glm::mat4& view, const glm::mat4& projection, GLfloat zNear, GLfloat zFar, GLint width, GLint height)
+	{
+		if (projection != this->projection || zNear != this->zNear || zFar != this->zFar)
+		{
+			this->projection = projection;
+			this->zNear = zNear;
+			this->zFar = zFar;
+			this->buildClusters();
+		}
+		this->width = width;
+		this->height = height;
+
+		this->assignLights(view);
+
+		// Los indices van primero: los inicios de la rejilla se corren a donde quedaron
+		this->gridOffset = -1;
+		GLuint indexBase = 0;
+		if (!this->indices.empty())
+		{
+			StreamAllocation allocation = this->stream->Allocate(this->indices.size() * sizeof(GLuint), sizeof(GLuint), sizeof(GLuint));
+			if (allocation.data == NULL)
+			{
+				return;
+			}
+			memcpy(allocation.data, &this->indices[0], this->indices.size() * sizeof(GLuint));
+			indexBase = (GLuint)(allocation.offset / sizeof(GLuint));
+		}
+		StreamAllocation allocation = this->stream->Allocate(this->grid.size() * sizeof(GLuint), 2 * sizeof(GLuint), 2 * sizeof(GLuint));
+		if (allocation.data == NULL)
+		{
+			return;
+		}
+		GLuint* grid = (GLuint*)allocation.data;
+		for (size_t c = 0; c < this->grid.size(); c += 2)
+		{
+			grid[c] = this->grid[c] + indexBase;
+			grid[c + 1] = this->grid[c + 1];
+		}
+		this->gridOffset = (GLint)(allocation.offset / (2 * sizeof(GLuint)));
+	}
+
+	// Enlaza los buffers y pone los uniforms en el programa (que debe estar activo)
+	// Sin el #define CLUSTERED_LIGHTS el shader ignora la rejilla y recorre todas las luces
+	void Bind(GLuint program)
+	{
+		const GLchar* names[3] = { "lightData", "clusterGrid", "lightIndices" };
+		GLuint textures[3] = { this->lightTexture, this->stream->GetTexture(GL_RG32UI), this->stream->GetTexture(GL_R32UI) };
+		for (GLuint i = 0; i < 3; i++)
+		{
+			glActiveTexture(GL_TEXTURE0 + CLUSTER_TEXTURE_UNIT + i);
+			glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+			glUniform1i(glGetUniformLocation(program, names[i]), CLUSTER_TEXTURE_UNIT + i);
+		}
+		glActiveTexture(GL_TEXTURE0);
+		glUniform1i(glGetUniformLocation(program, "clusterGridOffset"), this->gridOffset);
+
+		GLfloat logRatio = log(this->zFar / this->zNear);
+		glUniform3ui(glGetUniformLocation(program, "clusterDims"), CLUSTER_DIM_X, CLUSTER_DIM_Y, CLUSTER_DIM_Z);
+		glUniform2f(glGetUniformLocation(program, "clusterTileSize"), (GLfloat)this->width / CLUSTER_DIM_X, (GLfloat)this->height / CLUSTER_DIM_Y);
+		glUniform1f(glGetUniformLocation(program, "clusterScale"), CLUSTER_DIM_Z / logRatio);
+		glUniform1f(glGetUniformLocation(program, "clusterBias"), CLUSTER_DIM_Z * log(this->zNear) / logRatio);
+		glUniform1i(glGetUniformLocation(program, "lightCount"), this->lightCount);
+	}
+
+	GLuint GetLightCount()
+	{
+		return this->lightCount;
+	}
+
+	// Luces en la celda mas llena del ultimo cuadro
+	GLuint GetMaxLightsPerCluster()
+	{
+		return this->maxLightsPerCluster;
+	}
+
+	// Total de indices asignados en el ultimo cuadro
+	GLuint GetIndexCount()
+	{
+		return (GLuint)this->indices.size();
+	}
+
+	// La rejilla del ultimo Update() se subio; si no, hay que recorrer todas las luces (sin CLUSTERED_LIGHTS)
+	bool HasGrid() const
+	{
+		return this->gridOffset >= 0;
+	}
+
+private:
+	// Luces
+	std::vector<ClusterLight> lights;
+	GLuint lightCount;
+
+	// lightData es fijo; clusterGrid y lightIndices se ven en el buffer del cuadro
+	GLuint lightBuffer;
+	GLuint lightTexture;
+	StreamingBuffer* stream;
+	GLint gridOffset;	// Primera celda dentro del buffer en el ultimo Update() (-1 si no se subio)
+
+	// Rejilla
+	glm::mat4 projection;
+	GLfloat zNear;
+	GLfloat zFar;
+	GLint width;
+	GLint height;
+	std::vector<glm::vec3> clusterMin;
+	std::vector<glm::vec3> clusterMax;
+	std::vector<GLuint> grid;
+	std::vector<GLuint> indices;
+	GLuint maxLightsPerCluster;
+
+	// Datos temporales de la asignacion
+	std::vector<GLfloat> viewX, viewY, viewZ, radius2;
+	std::vector<GLuint> sliceLights;
+	GLfloat sliceX[4], sliceY[4], sliceZ[4], sliceR2[4];
+
+	// Cajas de cada cluster en espacio de vista; solo cambian con la proyeccion
+	void buildClusters()
+	{
+		glm::mat4 invProjection = glm::inverse(this->projection);
+
+		for (GLuint z = 0; z < CLUSTER_DIM_Z; z++)
+		{
+			// Rebanadas exponenciales: mas finas cerca de la camara
+			GLfloat sliceNear = this->zNear * pow(this->zFar / this->zNear, (GLfloat)z / CLUSTER_DIM_Z);
+			GLfloat sliceFar = this->zNear * pow(this->zFar / this->zNear, (GLfloat)(z + 1) / CLUSTER_DIM_Z);
+
+			for (GLuint y = 0; y < CLUSTER_DIM_Y; y++)
+			{
+				for (GLuint x = 0; x < CLUSTER_DIM_X; x++)
+				{
+					glm::vec3 boxMin(1e30f), boxMax(-1e30f);
+					for (GLuint corner = 0; corner < 4; corner++)
+					{
+						GLfloat ndcX = -1.0f + 2.0f * (GLfloat)(x + (corner & 1)) / CLUSTER_DIM_X;
+						GLfloat ndcY = -1.0f + 2.0f * (GLfloat)(y + (corner >> 1)) / CLUSTER_DIM_Y;
+						glm::vec4 p = invProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+						glm::vec3 ray = glm::vec3(p) / p.w;
+
+						// El rayo de la esquina cortado en los dos planos de la rebanada
+						glm::vec3 pNear = ray * (sliceNear / -ray.z);
+						glm::vec3 pFar = ray * (sliceFar / -ray.z);
+						boxMin = glm::min(boxMin, glm::min(pNear, pFar));
+						boxMax = glm::max(boxMax, glm::max(pNear, pFar));
+					}
+
+					GLuint index = x + y * CLUSTER_DIM_X + z * CLUSTER_DIM_X * CLUSTER_DIM_Y;
+					this->clusterMin[index] = boxMin;
+					this->clusterMax[index] = boxMax;
+				}
+			}
+		}
+	}
+
+	void assignLights(const glm::mat4& view)
+	{
+		this->indices.clear();
+		this->maxLightsPerCluster = 0;
+
+		for (GLuint i = 0; i < this->lightCount; i++)
+		{
+			glm::vec4 p = view * glm::vec4(this->lights[i].position, 1.0f);
+			this->viewX[i] = p.x;
+			this->viewY[i] = p.y;
+			this->viewZ[i] = p.z;
+			this->radius2[i] = this->lights[i].radius * this->lights[i].radius;
+		}
+
+		for (GLuint z = 0; z < CLUSTER_DIM_Z; z++)
+		{
+			GLuint first = z * CLUSTER_DIM_X * CLUSTER_DIM_Y;
+			GLfloat sliceNear = -this->clusterMax[first].z;
+			GLfloat sliceFar = -this->clusterMin[first].z;
+
+			// Primero descartamos por profundidad: solo las luces que tocan esta rebanada
+			this->sliceLights.clear();
+			for (GLuint i = 0; i < this->lightCount; i++)
+			{
+				GLfloat depth = -this->viewZ[i];
+				GLfloat r = this->lights[i].radius;
+				if (depth + r >= sliceNear && depth - r <= sliceFar)
+				{
+					this->sliceLights.push_back(i);
+				}
+			}
+
+			for (GLuint c = first; c < first + CLUSTER_DIM_X * CLUSTER_DIM_Y; c++)
+			{
+				GLuint offset = (GLuint)this->indices.size();
+				this->testCluster(c);
+				GLuint count = (GLuint)this->indices.size() - offset;
+
+				this->grid[c * 2] = offset;
+				this->grid[c * 2 + 1] = count;
+				if (count > this->maxLightsPerCluster)
+				{
+					this->maxLightsPerCluster = count;
+				}
+			}
+		}
+	}
+
+	// Agrega a indices las luces de la rebanada que tocan el cluster c
+	void testCluster(GLuint c)
+	{
+		const glm::vec3& boxMin = this->clusterMin[c];
+		const glm::vec3& boxMax = this->clusterMax[c];
+		GLuint n = (GLuint)this->sliceLights.size();
+		GLuint i = 0;
+
+#ifdef CLUSTER_USE_SSE2
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 minX = _mm_set1_ps(boxMin.x), maxX = _mm_set1_ps(boxMax.x);
+		const __m128 minY = _mm_set1_ps(boxMin.y), maxY = _mm_set1_ps(boxMax.y);
+		const __m128 minZ = _mm_set1_ps(boxMin.z), maxZ = _mm_set1_ps(boxMax.z);
+
+		for (; i + 4 <= n; i += 4)
+		{
+			for (GLuint k = 0; k < 4; k++)
+			{
+				GLuint light = this->sliceLights[i + k];
+				this->sliceX[k] = this->viewX[light];
+				this->sliceY[k] = this->viewY[light];
+				this->sliceZ[k] = this->viewZ[light];
+				this->sliceR2[k] = this->radius2[light];
+			}
+			__m128 cx = _mm_loadu_ps(this->sliceX);
+			__m128 cy = _mm_loadu_ps(this->sliceY);
+			__m128 cz = _mm_loadu_ps(this->sliceZ);
+
+			// Distancia al cuadrado del centro a la caja: por eje max(min - c, c - max, 0)
+			__m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, cx), _mm_sub_ps(cx, maxX)), zero);
+			__m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, cy), _mm_sub_ps(cy, maxY)), zero);
+			__m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, cz), _mm_sub_ps(cz, maxZ)), zero);
+			__m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			int hits = _mm_movemask_ps(_mm_cmple_ps(d2, _mm_loadu_ps(this->sliceR2)));
+
+			for (GLuint k = 0; hits; k++, hits >>= 1)
+			{
+				if (hits & 1)
+				{
+					this->indices.push_back(this->sliceLights[i + k]);
+				}
+			}
+		}
+#endif
+
+		// Resto (o todo, sin SSE2)
+		for (; i < n; i++)
+		{
+			GLuint light = this->sliceLights[i];
+			glm::vec3 center(this->viewX[light], this->viewY[light], this->viewZ[light]);
+			glm::vec3 d = glm::max(glm::max(boxMin - center, center - boxMax), glm::vec3(0.0f));
+			if (glm::dot(d, d) <= this->radius2[light])
+			{
+				this->indices.push_back(light);
+			}
+		}
+	}
+};
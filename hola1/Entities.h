@@ -0,0 +1,369 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <algorithm>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// Other Includes
+#include "SplinePath.h"
+#include "FrameArena.h"
+
+// Una entidad es solo un numero: indice en el mundo en los 24 bits bajos y una generacion en los
+// altos, para que un numero viejo no apunte a la entidad que reuso su lugar
+typedef GLuint Entity;
+const Entity ENTITY_NONE = 0xFFFFFFFFu;
+const GLuint ENTITY_INDEX_BITS = 24;
+const GLuint ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+
+// ===============================================================
+//     COMPONENTES (solo datos)
+// ===============================================================
+
+// Donde esta y hacia donde ve; model es la matriz final que arma quien mueve la entidad
+struct Transform
+{
+	glm::vec3 position;
+	glm::vec3 direction;	// Las criaturas; lo estatico la deja en cero
+	glm::mat4 model;
+};
+
+// Que dibujar: un VAO de la escena (cubo, agua o triangulo del techo), todos dentro del cubo unitario
+struct RenderMesh
+{
+	GLuint vao;
+	GLsizei count;
+	GLuint surface;		// Superficie del lightmap (el orden de dibujo al grabarlo)
+};
+
+// Como se ve: la variante del shader, su color o textura y el brillo
+struct Material
+{
+	GLuint flags;				// Opciones de ShaderVariants (SHADER_TEXTURED...)
+	glm::vec3 diffuse;			// Sin SHADER_TEXTURED
+	GLuint texture;				// Con SHADER_TEXTURED
+	GLuint alternateTexture;	// Segundo cuadro de una textura animada (0 = sin animar)
+	GLfloat specular;
+	GLfloat shininess;
+};
+
+// Caja alineada a los ejes en el mundo
+struct Bounds
+{
+	glm::vec3 min;
+	glm::vec3 max;
+};
+
+// Criatura que recorre su camino a velocidad constante (Mew y Ho-oh)
+struct CreatureAI
+{
+	const SplinePath* path;
+	GLfloat speed;
+	GLfloat distance;		// Lo recorrido sobre el camino
+	glm::vec3 position;		// Resultado del ultimo paso
+	glm::vec3 direction;
+};
+
+// ===============================================================
+//     ALMACEN DE UN COMPONENTE (sparse set)
+// ===============================================================
+
+// Los componentes van juntos en un arreglo denso (sin huecos), en el orden que se quiera; el
+// arreglo disperso lleva de la entidad a su lugar. Recorrer es avanzar por el arreglo denso;
+// buscar una entidad es una indireccion. Quitar mueve el ultimo al hueco.
+template <typename T>
+class ComponentStore
+{
+public:
+	T& Add(Entity entity, const T& component)
+	{
+		GLuint index = entity & ENTITY_INDEX_MASK;
+		if (index >= this->sparse.size())
+		{
+			this->sparse.resize(index + 1, ENTITY_NONE);
+		}
+		if (this->sparse[index] != ENTITY_NONE)
+		{
+			this->entities[this->sparse[index]] = entity;
+			return this->components[this->sparse[index]] = component;
+		}
+		this->sparse[index] = (GLuint)this->entities.size();
+		this->entities.push_back(entity);
+		this->components.push_back(component);
+		return this->components.back();
+	}
+
+	void Remove(Entity entity)
+	{
+		if (!this->Has(entity))
+		{
+			return;
+		}
+		GLuint dense = this->sparse[entity & ENTITY_INDEX_MASK];
+		GLuint last = (GLuint)this->entities.size() - 1;
+		if (dense != last)
+		{
+			this->entities[dense] = this->entities[last];
+			this->components[dense] = this->components[last];
+			this->sparse[this->entities[dense] & ENTITY_INDEX_MASK] = dense;
+		}
+		this->entities.pop_back();
+		this->components.pop_back();
+		this->sparse[entity & ENTITY_INDEX_MASK] = ENTITY_NONE;
+	}
+
+	bool Has(Entity entity) const
+	{
+		GLuint index = entity & ENTITY_INDEX_MASK;
+		return index < this->sparse.size() && this->sparse[index] != ENTITY_NONE && this->entities[this->sparse[index]] == entity;
+	}
+
+	// La entidad debe tenerlo (ver Has)
+	T& Get(Entity entity) { return this->components[this->sparse[entity & ENTITY_INDEX_MASK]]; }
+	const T& Get(Entity entity) const { return this->components[this->sparse[entity & ENTITY_INDEX_MASK]]; }
+
+	// Acceso por lugar en el arreglo denso
+	GLuint Size() const { return (GLuint)this->components.size(); }
+	T& operator[](GLuint dense) { return this->components[dense]; }
+	const T& operator[](GLuint dense) const { return this->components[dense]; }
+	Entity GetEntity(GLuint dense) const { return this->entities[dense]; }
+
+	// Reordena el arreglo denso; compare recibe dos entidades
+	template <typename Compare>
+	void Sort(Compare compare)
+	{
+		std::vector<Entity> order(this->entities);
+		std::stable_sort(order.begin(), order.end(), compare);
+		this->arrange(order);
+	}
+
+	// Deja primero las entidades de other, en su orden: despues el lugar i de los dos almacenes es
+	// la misma entidad para las que tienen ambos componentes
+	template <typename U>
+	void SortAs(const ComponentStore<U>& other)
+	{
+		std::vector<Entity> order;
+		order.reserve(this->entities.size());
+		for (GLuint i = 0; i < other.Size(); i++)
+		{
+			if (this->Has(other.GetEntity(i)))
+			{
+				order.push_back(other.GetEntity(i));
+			}
+		}
+		for (GLuint i = 0; i < this->entities.size(); i++)
+		{
+			if (!other.Has(this->entities[i]))
+			{
+				order.push_back(this->entities[i]);
+			}
+		}
+		this->arrange(order);
+	}
+
+private:
+	std::vector<GLuint> sparse;		// Indice de entidad -> lugar en el denso (ENTITY_NONE si no tiene)
+	std::vector<Entity> entities;	// Denso: de quien es cada componente
+	std::vector<T> components;		// Denso
+
+	void arrange(const std::vector<Entity>& order)
+	{
+		std::vector<T> arranged;
+		arranged.reserve(order.size());
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			arranged.push_back(this->Get(order[i]));
+		}
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			this->sparse[order[i] & ENTITY_INDEX_MASK] = (GLuint)i;
+		}
+		this->entities = order;
+		this->components.swap(arranged);
+	}
+};
+
+// ===============================================================
+//     MUNDO: entidades, sus componentes y los sistemas que los recorren
+// ===============================================================
+
+// Las entidades de la escena. Cada componente tiene su almacen; los sistemas recorren los arreglos
+// densos. Lo estatico (Transform + RenderMesh + Material + Bounds) queda alineado en los cuatro
+// almacenes despues de SortForDrawing(), asi el dibujo avanza por el mismo indice en todos.
+// Los almacenes no se protegen entre hilos: UpdateCreatures() es de la simulacion y solo toca creatures.
+class EntityWorld
+{
+public:
+	ComponentStore<Transform> transforms;
+	ComponentStore<RenderMesh> meshes;
+	ComponentStore<Material> materials;
+	ComponentStore<Bounds> bounds;
+	ComponentStore<CreatureAI> creatures;
+
+	EntityWorld()
+		: count(0)
+	{
+	}
+
+	Entity Create()
+	{
+		GLuint index;
+		if (!this->freeIndices.empty())
+		{
+			index = this->freeIndices.back();
+			this->freeIndices.pop_back();
+		}
+		else
+		{
+			index = (GLuint)this->generations.size();
+			this->generations.push_back(0);
+		}
+		this->count++;
+		return index | (this->generations[index] << ENTITY_INDEX_BITS);
+	}
+
+	void Destroy(Entity entity)
+	{
+		if (!this->IsAlive(entity))
+		{
+			return;
+		}
+		this->transforms.Remove(entity);
+		this->meshes.Remove(entity);
+		this->materials.Remove(entity);
+		this->bounds.Remove(entity);
+		this->creatures.Remove(entity);
+		GLuint index = entity & ENTITY_INDEX_MASK;
+		this->generations[index] = (this->generations[index] + 1) & 0xFF;
+		this->freeIndices.push_back(index);
+		this->count--;
+	}
+
+	bool IsAlive(Entity entity) const
+	{
+		GLuint index = entity & ENTITY_INDEX_MASK;
+		return entity != ENTITY_NONE && index < this->generations.size() && this->generations[index] == (entity >> ENTITY_INDEX_BITS);
+	}
+
+	GLuint GetCount() const { return this->count; }
+
+	// Un objeto que no se mueve: matriz, VAO y material (la caja sale de la matriz)
+	Entity CreateStatic(const glm::mat4& model, GLuint vao, GLsizei count, const Material& material)
+	{
+		Entity entity = this->Create();
+		Transform transform = { glm::vec3(model[3]), glm::vec3(0.0f), model };
+		RenderMesh mesh = { vao, count, 0 };
+		this->transforms.Add(entity, transform);
+		this->meshes.Add(entity, mesh);
+		this->materials.Add(entity, material);
+		this->bounds.Add(entity, transformBounds(model));
+		return entity;
+	}
+
+	// Una criatura en su camino, con su Transform (la llena quien dibuja)
+	Entity CreateCreature(const SplinePath& path, GLfloat speed, const glm::vec3& position, const glm::vec3& direction)
+	{
+		Entity entity = this->Create();
+		Transform transform = { position, direction, glm::mat4(1.0f) };
+		CreatureAI creature = { &path, speed, 0.0f, position, direction };
+		this->transforms.Add(entity, transform);
+		this->creatures.Add(entity, creature);
+		return entity;
+	}
+
+	// --- Sistemas ---
+
+	// Ordena lo estatico por material (variante, textura, brillo) para cambiar de estado lo menos
+	// posible y alinea los cuatro almacenes. Cada RenderMesh toma su lugar como superficie del
+	// lightmap: grabarlo despues dibujando todo en orden da los mismos indices.
+	void SortForDrawing()
+	{
+		this->materials.Sort([this](Entity a, Entity b)
+		{
+			const Material& ma = this->materials.Get(a);
+			const Material& mb = this->materials.Get(b);
+			if (ma.flags != mb.flags) return ma.flags < mb.flags;
+			if (ma.texture != mb.texture) return ma.texture < mb.texture;
+			if (ma.specular != mb.specular) return ma.specular < mb.specular;
+			if (ma.shininess != mb.shininess) return ma.shininess < mb.shininess;
+			return this->meshes.Get(a).vao < this->meshes.Get(b).vao;
+		});
+		this->meshes.SortAs(this->materials);
+		this->bounds.SortAs(this->materials);
+		this->transforms.SortAs(this->materials);
+		for (GLuint i = 0; i < this->meshes.Size(); i++)
+		{
+			this->meshes[i].surface = i;
+		}
+	}
+
+	// Avanza las criaturas sobre sus caminos (la tabla por longitud de arco da posicion y direccion)
+	void UpdateCreatures(GLfloat step)
+	{
+		for (GLuint i = 0; i < this->creatures.Size(); i++)
+		{
+			CreatureAI& creature = this->creatures[i];
+			creature.distance = creature.path->Wrap(creature.distance + creature.speed * step);
+			SplinePoint point = creature.path->Evaluate(creature.distance);
+			creature.position = point.position;
+			creature.direction = point.tangent;
+		}
+	}
+
+	// Lugares (en el arreglo denso de bounds) de las cajas que tocan el frustum de viewProjection
+	void FindVisible(const glm::mat4& viewProjection, FrameVector<GLuint>& visible) const
+	{
+		// Planos del frustum de las filas de la matriz (Gribb y Hartmann), hacia adentro
+		glm::vec4 planes[6];
+		for (GLuint axis = 0; axis < 3; axis++)
+		{
+			for (GLuint side = 0; side < 2; side++)
+			{
+				glm::vec4& plane = planes[axis * 2 + side];
+				for (GLuint k = 0; k < 4; k++)
+				{
+					plane[k] = viewProjection[k][3] + (side == 0 ? 1.0f : -1.0f) * viewProjection[k][axis];
+				}
+			}
+		}
+		visible.reserve(this->bounds.Size());
+		for (GLuint i = 0; i < this->bounds.Size(); i++)
+		{
+			const Bounds& box = this->bounds[i];
+			bool inside = true;
+			for (GLuint p = 0; p < 6 && inside; p++)
+			{
+				// La esquina mas adentro del plano; si esa queda fuera, toda la caja queda fuera
+				glm::vec3 corner(planes[p].x > 0.0f ? box.max.x : box.min.x,
+					planes[p].y > 0.0f ? box.max.y : box.min.y,
+					planes[p].z > 0.0f ? box.max.z : box.min.z);
+				inside = glm::dot(glm::vec3(planes[p]), corner) + planes[p].w >= 0.0f;
+			}
+			if (inside)
+			{
+				visible.push_back(i);
+			}
+		}
+	}
+
+private:
+	std::vector<GLuint> generations;
+	std::vector<GLuint> freeIndices;
+	GLuint count;
+
+	// Caja del cubo unitario (-0.5 a 0.5) llevada al mundo por la matriz
+	static Bounds transformBounds(const glm::mat4& model)
+	{
+		glm::vec3 center(model[3]);
+		glm::vec3 extent(0.0f);
+		for (GLuint axis = 0; axis < 3; axis++)
+		{
+			extent += glm::abs(glm::vec3(model[axis])) * 0.5f;
+		}
+		Bounds box = { center - extent, center + extent };
+		return box;
+	}
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+// Std. Includes
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+// GL Includes
+#include <GL/glew.h>
+
+// Pasos de simulacion por segundo
+const GLfloat FIXED_TIMESTEP_RATE = 120.0f;
+
+// Si un cuadro tarda mas que esto en pasos, el resto se descarta (la simulacion va mas lenta
+// en lugar de quedarse atras cada vez mas)
+const GLuint FIXED_TIMESTEP_MAX_STEPS = 12;
+
+// Simulacion a paso fijo separada del dibujo.
+// El estado solo cambia en pasos de 1 / rate segundos, asi el resultado no depende de los cuadros
+// por segundo y se repite igual. Para dibujar se mezclan los dos ultimos pasos con alfa = cuanto
+// va del siguiente (se dibuja un paso atras, pero sin saltos aunque el cuadro y el paso no coincidan).
+// State debe poder copiarse; step avanza el estado y interpolate lo mezcla.
+// Con StartThread() los pasos se dan en un hilo propio con su reloj y Advance() solo toma los dos
+// ultimos publicados: lo que use step no debe tocarse desde el hilo que dibuja.
+template <typename State>
+class FixedTimestep
+{
+public:
+	typedef std::function<void(GLfloat step, State& state)> StepFunction;
+	typedef std::function<void(const State& previous, const State& current, GLfloat alpha, State& result)> InterpolateFunction;
+
+	FixedTimestep(const State& initial, StepFunction step, InterpolateFunction interpolate, GLfloat rate = FIXED_TIMESTEP_RATE)
+		: step(step), interpolate(interpolate), stepTime(1.0f / rate), accumulator(0.0f), alpha(0.0f),
+		previous(initial), current(initial), rendered(initial),
+		stepCount(0), droppedSteps(0), lastStepCount(0), running(false)
+	{
+	}
+
+	~FixedTimestep()
+	{
+		this->StopThread();
+	}
+
+	// Agrega el tiempo real del cuadro. En el mismo hilo da los pasos que tocan; con hilo propio
+	// solo toma los ultimos pasos. Regresa cuantos pasos se dieron desde la llamada anterior
+	GLuint Advance(GLfloat frameTime)
+	{
+		if (this->running)
+		{
+			return this->collect();
+		}
+
+		GLuint steps = 0;
+		this->accumulator += std::max(frameTime, 0.0f);
+		while (this->accumulator >= this->stepTime)
+		{
+			if (steps == FIXED_TIMESTEP_MAX_STEPS)
+			{
+				this->droppedSteps += (GLuint)(this->accumulator / this->stepTime);
+				this->accumulator -= this->stepTime * (GLuint)(this->accumulator / this->stepTime);
+				break;
+			}
+			this->previous = this->current;
+			this->step(this->stepTime, this->current);
+			this->accumulator -= this->stepTime;
+			steps++;
+		}
+		this->stepCount += steps;
+		this->alpha = this->accumulator / this->stepTime;
+		this->interpolate(this->previous, this->current, this->alpha, this->rendered);
+		return steps;
+	}
+
+	// Mueve los pasos a un hilo propio (el estado sigue desde donde iba)
+	void StartThread()
+	{
+		if (this->running)
+		{
+			return;
+		}
+		this->lastStepCount = this->stepCount;
+		this->publishedTime = std::chrono::steady_clock::now();
+		this->running = true;
+		this->worker = std::thread(&FixedTimestep::workerLoop, this);
+	}
+
+	// Regresa los pasos al hilo que llama a Advance
+	void StopThread()
+	{
+		if (!this->running)
+		{
+			return;
+		}
+		this->running = false;
+		this->worker.join();
+		this->accumulator = this->alpha * this->stepTime;
+	}
+
+	bool IsThreaded() const { return this->running; }
+	const State& GetState() const { return this->rendered; }	// Estado para dibujar este cuadro
+	GLfloat GetAlpha() const { return this->alpha; }
+	GLfloat GetStepTime() const { return this->stepTime; }
+	unsigned long long GetStepCount() const { return this->stepCount; }
+	GLuint GetDroppedSteps() const { return this->droppedSteps; }
+
+private:
+	StepFunction step;
+	InterpolateFunction interpolate;
+	GLfloat stepTime;
+	GLfloat accumulator;
+	GLfloat alpha;
+	State previous;
+	State current;
+	State rendered;
+	unsigned long long stepCount;
+	GLuint droppedSteps;
+	unsigned long long lastStepCount;
+
+	// Hilo de simulacion: publica sus dos ultimos pasos y cuando se dio el ultimo
+	std::thread worker;
+	std::atomic<bool> running;
+	std::mutex publishMutex;
+	std::chrono::steady_clock::time_point publishedTime;
+
+	void workerLoop()
+	{
+		typedef std::chrono::steady_clock Clock;
+		Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(this->stepTime));
+		State workerPrevious;
+		State workerCurrent;
+		{
+			std::lock_guard<std::mutex> lock(this->publishMutex);
+			workerCurrent = this->current;
+		}
+
+		Clock::time_point next = Clock::now();
+		while (this->running)
+		{
+			// Los pasos atrasados se dan seguidos (hasta el limite, como en Advance)
+			GLuint steps = 0;
+			GLuint dropped = 0;
+			while (Clock::now() >= next)
+			{
+				if (steps == FIXED_TIMESTEP_MAX_STEPS)
+				{
+					Clock::time_point now = Clock::now();
+					dropped = (GLuint)((now - next) / period);
+					next += period * dropped;
+					break;
+				}
+				workerPrevious = workerCurrent;
+				this->step(this->stepTime, workerCurrent);
+				next += period;
+				steps++;
+			}
+
+			if (steps > 0)
+			{
+				std::lock_guard<std::mutex> lock(this->publishMutex);
+				this->previous = workerPrevious;
+				this->current = workerCurrent;
+				this->publishedTime = Clock::now();
+				this->stepCount += steps;
+				this->droppedSteps += dropped;
+			}
+			std::this_thread::sleep_until(next);
+		}
+	}
+
+	// Mezcla lo ultimo que publico el hilo segun el tiempo que ha pasado desde entonces
+	GLuint collect()
+	{
+		std::lock_guard<std::mutex> lock(this->publishMutex);
+		GLfloat elapsed = std::chrono::duration<GLfloat>(std::chrono::steady_clock::now() - this->publishedTime).count();
+		this->alpha = std::min(elapsed / this->stepTime, 1.0f);
+		this->interpolate(this->previous, this->current, this->alpha, this->rendered);
+		GLuint steps = (GLuint)(this->stepCount - this->lastStepCount);
+		this->lastStepCount = this->stepCount;
+		return steps;
+	}
+};
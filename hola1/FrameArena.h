@@ -0,0 +1,354 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+
+// GL Includes
+#include <GL/glew.h>
+
+// En debug cada bloque lleva una cabecera y una guarda al final que se revisan en Reset()
+// (FRAME_ARENA_CHECKS las enciende tambien en release)
+#if defined(_DEBUG) || defined(FRAME_ARENA_CHECKS)
+#define FRAME_ARENA_DEBUG
+#endif
+
+// Bytes de cada arena (una por cuadro en vuelo)
+const size_t FRAME_ARENA_SIZE = 1024 * 1024;
+
+// Alineacion por omision (la de un glm::vec4 / mat4 con SSE)
+const size_t FRAME_ARENA_ALIGNMENT = 16;
+
+// Quien pidio la memoria, para llevar el pico de cada uno
+enum Frame_Arena_Tag
+{
+	ARENA_RENDER,		// Listas de dibujo y comandos del cuadro
+	ARENA_ANIMATION,	// Matrices y huesos de las criaturas
+	ARENA_PROFILER,		// Secciones medidas en el cuadro
+	ARENA_OTHER,
+	ARENA_TAG_COUNT
+};
+
+const GLchar* const FRAME_ARENA_TAG_NAMES[ARENA_TAG_COUNT] = { "render", "animacion", "perfil", "otros" };
+
+// Censo de new/delete globales: cuantas veces y cuantos bytes se han pedido al heap.
+// Solo cuenta si un .cpp del programa define FRAME_ARENA_CENSUS antes de incluir este archivo
+// (ahi se reemplazan los operadores globales, como STB_IMAGE_IMPLEMENTATION con stb_image.h).
+struct AllocationCensus
+{
+	std::atomic<unsigned long long> allocations;
+	std::atomic<unsigned long long> bytes;
+	std::atomic<unsigned long long> frees;
+
+	AllocationCensus()
+		: allocations(0), bytes(0), frees(0)
+	{
+	}
+
+	static AllocationCensus& Get()
+	{
+		static AllocationCensus census;
+		return census;
+	}
+
+	// Pedidas al heap desde la ultima llamada (para medir un cuadro)
+	unsigned long long TakeAllocations(unsigned long long& last) const
+	{
+		unsigned long long now = this->allocations.load();
+		unsigned long long count = now - last;
+		last = now;
+		return count;
+	}
+};
+
+#ifdef FRAME_ARENA_CENSUS
+void* operator new(size_t size)
+{
+	AllocationCensus& census = AllocationCensus::Get();
+	census.allocations++;
+	census.bytes += size;
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == NULL)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	if (memory != NULL)
+	{
+		AllocationCensus::Get().frees++;
+		free(memory);
+	}
+}
+
+void operator delete[](void* memory) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+#endif
+
+// Arena lineal para lo que solo vive un cuadro.
+// Apartar es mover un cursor (atomico: los trabajos de un ParallelFor pueden apartar a la vez)
+// y no se libera nada suelto: Reset() al empezar el cuadro la vacia completa. Si se llena, lo
+// que no cabe va al heap (lo marca el censo) y se libera en el siguiente Reset().
+// Se lleva el pico de bytes de cada Frame_Arena_Tag entre cuadros.
+class FrameArena
+{
+public:
+	FrameArena(size_t capacity = FRAME_ARENA_SIZE)
+		: capacity(capacity), cursor(0), overflowCount(0), frameCount(0)
+	{
+		this->memory = (GLubyte*)malloc(capacity);
+		for (GLuint i = 0; i < ARENA_TAG_COUNT; i++)
+		{
+			this->tagBytes[i] = 0;
+			this->tagPeaks[i] = 0;
+		}
+	}
+
+	~FrameArena()
+	{
+		this->Reset();
+		free(this->memory);
+	}
+
+	// Aparta size bytes alineados a alignment (potencia de dos)
+	void* Allocate(size_t size, size_t alignment = FRAME_ARENA_ALIGNMENT, GLuint tag = ARENA_OTHER)
+	{
+		alignment = alignment < FRAME_ARENA_ALIGNMENT ? FRAME_ARENA_ALIGNMENT : alignment;
+		size_t start = this->cursor.load();
+		size_t data, end;
+		do
+		{
+#ifdef FRAME_ARENA_DEBUG
+			data = alignUp(start + sizeof(BlockHeader), alignment);
+			end = alignUp(data + size + FRAME_ARENA_GUARD_SIZE, FRAME_ARENA_ALIGNMENT);
+#else
+			data = alignUp(start, alignment);
+			end = alignUp(data + size, FRAME_ARENA_ALIGNMENT);
+#endif
+			if (end > this->capacity)
+			{
+				return this->overflow(size, alignment, tag);
+			}
+		} while (!this->cursor.compare_exchange_weak(start, end));
+		this->tagBytes[clampTag(tag)] += end - start;
+
+#ifdef FRAME_ARENA_DEBUG
+		BlockHeader header = { FRAME_ARENA_MAGIC, tag, size, data - start, end - start };
+		memcpy(this->memory + start, &header, sizeof(BlockHeader));
+		memset(this->memory + data + size, FRAME_ARENA_GUARD_BYTE, end - data - size);
+#endif
+		return this->memory + data;
+	}
+
+	// Arreglo sin inicializar de count elementos
+	template <typename T>
+	T* AllocateArray(size_t count, GLuint tag = ARENA_OTHER)
+	{
+		return (T*)this->Allocate(count * sizeof(T), alignof(T), tag);
+	}
+
+	// Al empezar el cuadro (nadie debe seguir usando lo de antes): revisa las guardas en debug,
+	// anota los picos y vacia la arena
+	void Reset()
+	{
+#ifdef FRAME_ARENA_DEBUG
+		this->check(this->cursor.load());
+#endif
+		for (GLuint i = 0; i < ARENA_TAG_COUNT; i++)
+		{
+			size_t bytes = this->tagBytes[i].exchange(0);
+			this->tagPeaks[i] = bytes > this->tagPeaks[i] ? bytes : this->tagPeaks[i];
+		}
+		{
+			std::lock_guard<std::mutex> lock(this->overflowMutex);
+			for (size_t i = 0; i < this->overflowBlocks.size(); i++)
+			{
+				::operator delete(this->overflowBlocks[i]);
+			}
+			this->overflowBlocks.clear();
+		}
+		this->cursor = 0;
+		this->frameCount++;
+	}
+
+	size_t GetCapacity() const { return this->capacity; }
+	size_t GetUsed() const { return this->cursor.load(); }
+	size_t GetPeak(GLuint tag) const { return this->tagPeaks[tag]; }	// Bytes (con alineacion) del cuadro mas grande
+	GLuint GetOverflowCount() const { return this->overflowCount.load(); }	// Bloques que no cupieron desde el inicio
+
+	// Picos de cada tag
+	void PrintPeaks(const char* title) const
+	{
+		std::cout << title << ": " << this->capacity / 1024 << " KB, " << this->frameCount << " cuadros, " << this->overflowCount << " bloques al heap" << std::endl;
+		for (GLuint i = 0; i < ARENA_TAG_COUNT; i++)
+		{
+			std::cout << "  " << std::left << std::setw(12) << FRAME_ARENA_TAG_NAMES[i] << std::right << std::fixed << std::setprecision(1)
+				<< std::setw(8) << this->tagPeaks[i] / 1024.0 << " KB" << std::endl;
+		}
+	}
+
+private:
+#ifdef FRAME_ARENA_DEBUG
+	static const GLuint FRAME_ARENA_MAGIC = 0xA2E4A5u;
+	static const size_t FRAME_ARENA_GUARD_SIZE = 16;
+	static const GLubyte FRAME_ARENA_GUARD_BYTE = 0xFD;
+
+	// Al inicio de cada bloque: con blockSize se recorre la arena en orden
+	struct BlockHeader
+	{
+		GLuint magic;
+		GLuint tag;
+		size_t size;
+		size_t dataOffset;
+		size_t blockSize;
+	};
+
+	// Recorre los bloques: una cabecera rota o una guarda pisada es que alguien escribio de mas
+	void check(size_t used) const
+	{
+		size_t start = 0;
+		while (start < used)
+		{
+			BlockHeader header;
+			memcpy(&header, this->memory + start, sizeof(BlockHeader));
+			if (header.magic != FRAME_ARENA_MAGIC || header.blockSize == 0 || start + header.blockSize > used)
+			{
+				std::cout << "ERROR::FRAME_ARENA::CORRUPT_HEADER en el byte " << start << std::endl;
+				return;
+			}
+			const GLubyte* guard = this->memory + start + header.dataOffset + header.size;
+			const GLubyte* blockEnd = this->memory + start + header.blockSize;
+			for (; guard < blockEnd; guard++)
+			{
+				if (*guard != FRAME_ARENA_GUARD_BYTE)
+				{
+					std::cout << "ERROR::FRAME_ARENA::OVERRUN bloque de " << header.size << " bytes ("
+						<< FRAME_ARENA_TAG_NAMES[clampTag(header.tag)] << ")" << std::endl;
+					break;
+				}
+			}
+			start += header.blockSize;
+		}
+	}
+#endif
+
+	GLubyte* memory;
+	size_t capacity;
+	std::atomic<size_t> cursor;
+	std::atomic<size_t> tagBytes[ARENA_TAG_COUNT];
+	size_t tagPeaks[ARENA_TAG_COUNT];
+	std::atomic<GLuint> overflowCount;
+	GLuint frameCount;
+	std::mutex overflowMutex;
+	std::vector<void*> overflowBlocks;
+
+	static size_t alignUp(size_t value, size_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	// Un tag fuera de Frame_Arena_Tag cuenta como ARENA_OTHER
+	static GLuint clampTag(GLuint tag)
+	{
+		return tag < (GLuint)ARENA_TAG_COUNT ? tag : (GLuint)ARENA_OTHER;
+	}
+
+	// La arena se lleno: el bloque va al heap hasta el siguiente Reset(). Se pide alignment de mas
+	// para alinearlo igual que en la arena (new solo garantiza __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+	// overflowBlocks guarda el puntero original para liberarlo
+	void* overflow(size_t size, size_t alignment, GLuint tag)
+	{
+		if (this->overflowCount++ == 0)
+		{
+			std::cout << "ERROR::FRAME_ARENA::FULL " << size << " bytes (" << FRAME_ARENA_TAG_NAMES[clampTag(tag)]
+				<< "), se usa el heap" << std::endl;
+		}
+		void* block = ::operator new(size + alignment);
+		std::lock_guard<std::mutex> lock(this->overflowMutex);
+		this->overflowBlocks.push_back(block);
+		return (void*)alignUp((size_t)block, alignment);
+	}
+};
+
+// Adaptador para usar la arena en contenedores de la STL (FrameVector<T>).
+// deallocate() no hace nada: todo se libera junto en FrameArena::Reset(), asi que el contenedor
+// no debe vivir mas que el cuadro. Sin arena (construido por omision) usa el heap.
+template <typename T>
+class FrameAllocator
+{
+public:
+	typedef T value_type;
+	typedef std::true_type propagate_on_container_copy_assignment;
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::true_type propagate_on_container_swap;
+
+	FrameAllocator()
+		: arena(nullptr), tag(ARENA_OTHER)
+	{
+	}
+
+	FrameAllocator(FrameArena& arena, GLuint tag = ARENA_OTHER)
+		: arena(&arena), tag(tag)
+	{
+	}
+
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>& other)
+		: arena(other.arena), tag(other.tag)
+	{
+	}
+
+	T* allocate(size_t count)
+	{
+		if (this->arena == nullptr)
+		{
+			return (T*)::operator new(count * sizeof(T));
+		}
+		return (T*)this->arena->Allocate(count * sizeof(T), alignof(T), this->tag);
+	}
+
+	void deallocate(T* pointer, size_t)
+	{
+		if (this->arena == nullptr)
+		{
+			::operator delete(pointer);
+		}
+	}
+
+	template <typename U>
+	bool operator==(const FrameAllocator<U>& other) const { return this->arena == other.arena; }
+	template <typename U>
+	bool operator!=(const FrameAllocator<U>& other) const { return this->arena != other.arena; }
+
+	FrameArena* arena;
+	GLuint tag;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
@@ -0,0 +1,342 @@
+#pragma once
+
+// Std. Includes
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// GL Includes
+#include <GL/glew.h>
+
+// SOIL2 ya trae stb_image_write y jo_jpeg compilados (SOIL_save_image_quality)
+#include "SOIL2/SOIL2.h"
+
+// Formatos de salida de la captura
+enum Capture_Format
+{
+	CAPTURE_PNG,
+	CAPTURE_JPG,
+	CAPTURE_RAW	// Volcado RGBA crudo en un solo archivo (para codificar video despues)
+};
+
+// Numero de PBOs en el anillo y de cuadros pendientes de codificar
+const GLuint CAPTURE_RING_SIZE = 3;
+const GLuint CAPTURE_MAX_PENDING = 8;
+
+// Captura asincrona del framebuffer.
+// glReadPixels escribe en un anillo de Pixel Buffer Objects y cada lectura deja una fence;
+// el cuadro solo se mapea cuando la GPU ya termino, asi que el hilo de render nunca se bloquea.
+// La codificacion PNG/JPEG (o la escritura cruda) se hace en un hilo trabajador.
+// Si el anillo o la cola estan llenos el cuadro se descarta y se cuenta como perdido.
+class FrameCapture
+{
+public:
+	// Constructor, recibe el tamano del framebuffer y el prefijo de los archivos de salida
+	FrameCapture(GLint width, GLint height, std::string prefix = "captura", Capture_Format format = CAPTURE_PNG, GLint quality = 90)
+		: width(width), height(height), prefix(prefix), format(format), quality(quality),
+		capturing(false), writeIndex(0), frameNumber(0), capturedFrames(0), droppedFrames(0), busy(false), quitWorker(false), rawFile(NULL)
+	{
+		GLuint size = this->width * this->height * 4;
+
+		glGenBuffers(CAPTURE_RING_SIZE, this->pbos);
+		for (GLuint i = 0; i < CAPTURE_RING_SIZE; i++)
+		{
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, this->pbos[i]);
+			glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+			this->fences[i] = 0;
+			this->slotFrame[i] = 0;
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		this->worker = std::thread(&FrameCapture::workerLoop, this);
+	}
+
+	~FrameCapture()
+	{
+		this->Stop();
+
+		{
+			std::lock_guard<std::mutex> lock(this->queueMutex);
+			this->quitWorker = true;
+		}
+		this->queueCondition.notify_one();
+		this->worker.join();
+
+		for (GLuint i = 0; i < CAPTURE_RING_SIZE; i++)
+		{
+			if (this->fences[i])
+			{
+				glDeleteSync(this->fences[i]);
+			}
+		}
+		glDeleteBuffers(CAPTURE_RING_SIZE, this->pbos);
+	}
+
+	// Empieza a capturar una secuencia de cuadros; regresa false si no se pudo (no abrio el .raw)
+	bool Start()
+	{
+		if (this->capturing)
+		{
+			return true;
+		}
+
+		this->capturedFrames = 0;
+		this->droppedFrames = 0;
+
+		if (this->format == CAPTURE_RAW)
+		{
+			std::string filename = this->prefix + ".raw";
+			this->rawFile = fopen(filename.c_str(), "wb");
+			if (!this->rawFile)
+			{
+				std::cout << "ERROR::CAPTURE::RAW_FILE_NOT_OPENED " << filename << std::endl;
+				return false;
+			}
+		}
+
+		this->capturing = true;
+		return true;
+	}
+
+	// Detiene la captura, vacia el anillo y espera a que el trabajador escriba todo
+	void Stop()
+	{
+		if (!this->capturing)
+		{
+			return;
+		}
+
+		// Al terminar si podemos esperar a la GPU: recogemos los cuadros que queden en vuelo
+		this->collect(true);
+		this->capturing = false;
+
+		{
+			std::unique_lock<std::mutex> lock(this->queueMutex);
+			this->idleCondition.wait(lock, [this] { return this->jobs.empty() && !this->busy; });
+		}
+
+		if (this->rawFile)
+		{
+			fclose(this->rawFile);
+			this->rawFile = NULL;
+			std::cout << "CAPTURE::RAW " << this->width << "x" << this->height << " RGBA (invertido en Y) -> " << this->prefix << ".raw" << std::endl;
+		}
+
+		std::cout << "CAPTURE::FRAMES " << this->capturedFrames << " capturados, " << this->droppedFrames << " perdidos" << std::endl;
+	}
+
+	// Llamar una vez por cuadro, despues de dibujar y antes de glfwSwapBuffers
+	void Capture()
+	{
+		if (!this->capturing)
+		{
+			return;
+		}
+
+		// Recoge los PBOs que la GPU ya termino de llenar (sin esperar)
+		this->collect(false);
+
+		// Si el siguiente PBO sigue ocupado no bloqueamos: se pierde este cuadro
+		GLuint slot = this->writeIndex;
+		if (this->fences[slot])
+		{
+			this->droppedFrames++;
+			this->frameNumber++;
+			return;
+		}
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, this->pbos[slot]);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, this->width, this->height, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid *)0);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		this->fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		this->slotFrame[slot] = this->frameNumber++;
+		this->writeIndex = (this->writeIndex + 1) % CAPTURE_RING_SIZE;
+	}
+
+	bool IsCapturing()
+	{
+		return this->capturing;
+	}
+
+	GLuint GetCapturedFrames()
+	{
+		return this->capturedFrames;
+	}
+
+	GLuint GetDroppedFrames()
+	{
+		return this->droppedFrames;
+	}
+
+private:
+	// Un cuadro leido de la GPU esperando ser codificado
+	struct CaptureJob
+	{
+		GLuint frame;
+		std::vector<unsigned char> pixels;
+	};
+
+	// Atributos
+	GLint width;
+	GLint height;
+	std::string prefix;
+	Capture_Format format;
+	GLint quality;
+	bool capturing;
+
+	// Anillo de PBOs
+	GLuint pbos[CAPTURE_RING_SIZE];
+	GLsync fences[CAPTURE_RING_SIZE];
+	GLuint slotFrame[CAPTURE_RING_SIZE];
+	GLuint writeIndex;
+	GLuint frameNumber;
+	GLuint capturedFrames;
+	GLuint droppedFrames;
+
+	// Hilo trabajador
+	std::thread worker;
+	std::mutex queueMutex;
+	std::condition_variable queueCondition;
+	std::condition_variable idleCondition;
+	std::deque<CaptureJob> jobs;
+	std::vector<std::vector<unsigned char>> freeBuffers;	// Buffers reciclados para no pedir memoria cada cuadro
+	bool busy;
+	bool quitWorker;
+	FILE *rawFile;
+
+	// Revisa los PBOs en orden de antiguedad y manda al trabajador los que ya estan listos
+	void collect(bool wait)
+	{
+		for (GLuint n = 0; n < CAPTURE_RING_SIZE; n++)
+		{
+			GLuint slot = (this->writeIndex + n) % CAPTURE_RING_SIZE;
+			if (!this->fences[slot])
+			{
+				continue;
+			}
+
+			GLenum status = glClientWaitSync(this->fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, wait ? GL_TIMEOUT_IGNORED : 0);
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+			{
+				// Los siguientes son mas nuevos, tampoco estaran listos
+				break;
+			}
+
+			glDeleteSync(this->fences[slot]);
+			this->fences[slot] = 0;
+			this->enqueue(slot);
+		}
+	}
+
+	// Copia el PBO a un buffer propio y lo encola para el trabajador
+	void enqueue(GLuint slot)
+	{
+		size_t size = (size_t)this->width * this->height * 4;
+		CaptureJob job;
+		job.frame = this->slotFrame[slot];
+
+		{
+			std::lock_guard<std::mutex> lock(this->queueMutex);
+			if (this->jobs.size() >= CAPTURE_MAX_PENDING)
+			{
+				// El codificador va atrasado: descartamos en lugar de acumular memoria
+				this->droppedFrames++;
+				return;
+			}
+			if (!this->freeBuffers.empty())
+			{
+				job.pixels.swap(this->freeBuffers.back());
+				this->freeBuffers.pop_back();
+			}
+		}
+		job.pixels.resize(size);
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, this->pbos[slot]);
+		void *data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+		if (data)
+		{
+			memcpy(&job.pixels[0], data, size);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		if (!data)
+		{
+			this->droppedFrames++;
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(this->queueMutex);
+			this->jobs.push_back(std::move(job));
+		}
+		this->queueCondition.notify_one();
+		this->capturedFrames++;
+	}
+
+	// Codifica y escribe los cuadros fuera del hilo de render
+	void workerLoop()
+	{
+		std::vector<unsigned char> flipped;
+
+		for (;;)
+		{
+			CaptureJob job;
+			{
+				std::unique_lock<std::mutex> lock(this->queueMutex);
+				this->queueCondition.wait(lock, [this] { return this->quitWorker || !this->jobs.empty(); });
+				if (this->jobs.empty())
+				{
+					return;
+				}
+				job = std::move(this->jobs.front());
+				this->jobs.pop_front();
+				this->busy = true;
+			}
+
+			if (this->format == CAPTURE_RAW)
+			{
+				// El video se voltea al codificarlo (ej. ffmpeg -vf vflip), aqui solo copiamos
+				if (this->rawFile)
+				{
+					fwrite(&job.pixels[0], 1, job.pixels.size(), this->rawFile);
+				}
+			}
+			else
+			{
+				// OpenGL entrega las filas de abajo hacia arriba
+				GLint rowSize = this->width * 4;
+				flipped.resize(job.pixels.size());
+				for (GLint y = 0; y < this->height; y++)
+				{
+					memcpy(&flipped[y * rowSize], &job.pixels[(this->height - 1 - y) * rowSize], rowSize);
+				}
+
+				char filename[512];
+				const char *extension = (this->format == CAPTURE_JPG) ? "jpg" : "png";
+				snprintf(filename, sizeof(filename), "%s_%05u.%s", this->prefix.c_str(), job.frame, extension);
+
+				int imageType = (this->format == CAPTURE_JPG) ? SOIL_SAVE_TYPE_JPG : SOIL_SAVE_TYPE_PNG;
+				if (!SOIL_save_image_quality(filename, imageType, this->width, this->height, 4, &flipped[0], this->quality))
+				{
+					std::cout << "ERROR::CAPTURE::SAVE_FAILED " << filename << std::endl;
+				}
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(this->queueMutex);
+				this->freeBuffers.push_back(std::move(job.pixels));
+				this->busy = false;
+			}
+			this->idleCondition.notify_all();
+		}
+	}
+};
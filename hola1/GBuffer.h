@@ -0,0 +1,122 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+
+// GL Includes
+#include <GL/glew.h>
+
+// Texturas del G-buffer
+enum GBuffer_Texture
+{
+	GBUFFER_ALBEDO,		// RGBA8: color difuso
+	GBUFFER_NORMAL,		// RGBA16F: normal en espacio de mundo
+	GBUFFER_SPECULAR,	// RGBA8: color especular y brillo / 256
+	GBUFFER_DEPTH,		// DEPTH24_STENCIL8: la posicion se reconstruye desde aqui
+	GBUFFER_TEXTURE_COUNT
+};
+
+// Framebuffer con las superficies de la escena para el render deferred.
+// El paso de geometria escribe aqui (Shader/gbuffer.frag) y el paso de iluminacion
+// lee las cuatro texturas (Shader/deferredLighting.frag).
+class GBuffer
+{
+public:
+	// Constructor, recibe el tamano del framebuffer
+	GBuffer(GLint width, GLint height)
+		: width(width), height(height)
+	{
+		glGenFramebuffers(1, &this->fbo);
+		glBindFramebuffer(GL_FRAMEBUFFER, this->fbo);
+		glGenTextures(GBUFFER_TEXTURE_COUNT, this->textures);
+
+		GLenum internalFormats[3] = { GL_RGBA8, GL_RGBA16F, GL_RGBA8 };
+		GLenum types[3] = { GL_UNSIGNED_BYTE, GL_FLOAT, GL_UNSIGNED_BYTE };
+		for (GLuint i = 0; i < GBUFFER_DEPTH; i++)
+		{
+			glBindTexture(GL_TEXTURE_2D, this->textures[i]);
+			glTexImage2D(GL_TEXTURE_2D, 0, internalFormats[i], width, height, 0, GL_RGBA, types[i], NULL);
+			this->setNearest();
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, this->textures[i], 0);
+		}
+
+		// Mismo formato que el depth del framebuffer por defecto, para poder copiarlo con glBlitFramebuffer
+		glBindTexture(GL_TEXTURE_2D, this->textures[GBUFFER_DEPTH]);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, width, height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
+		this->setNearest();
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, this->textures[GBUFFER_DEPTH], 0);
+
+		GLenum drawBuffers[3] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+		glDrawBuffers(3, drawBuffers);
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cout << "ERROR::GBUFFER::FRAMEBUFFER_NOT_COMPLETE" << std::endl;
+		}
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	~GBuffer()
+	{
+		glDeleteTextures(GBUFFER_TEXTURE_COUNT, this->textures);
+		glDeleteFramebuffers(1, &this->fbo);
+	}
+
+	// Activa el G-buffer como destino del paso de geometria y lo limpia
+	void BindForWriting()
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, this->fbo);
+		glViewport(0, 0, this->width, this->height);
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	}
+
+	// Enlaza las texturas en las unidades 0..3 y pone los samplers del programa (que debe estar activo)
+	void BindForReading(GLuint program)
+	{
+		const GLchar* names[GBUFFER_TEXTURE_COUNT] = { "gAlbedo", "gNormal", "gSpecular", "gDepth" };
+		for (GLuint i = 0; i < GBUFFER_TEXTURE_COUNT; i++)
+		{
+			glActiveTexture(GL_TEXTURE0 + i);
+			glBindTexture(GL_TEXTURE_2D, this->textures[i]);
+			glUniform1i(glGetUniformLocation(program, names[i]), i);
+		}
+		glActiveTexture(GL_TEXTURE0);
+	}
+
+	// Desenlaza las texturas (para que el siguiente paso de geometria no lea lo que escribe)
+	void UnbindTextures()
+	{
+		for (GLuint i = 0; i < GBUFFER_TEXTURE_COUNT; i++)
+		{
+			glActiveTexture(GL_TEXTURE0 + i);
+			glBindTexture(GL_TEXTURE_2D, 0);
+		}
+		glActiveTexture(GL_TEXTURE0);
+	}
+
+	// Copia la profundidad a otro framebuffer (0 = pantalla) para dibujar en forward encima
+	void BlitDepth(GLuint target = 0)
+	{
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, this->fbo);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+		glBlitFramebuffer(0, 0, this->width, this->height, 0, 0, this->width, this->height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+		glBindFramebuffer(GL_FRAMEBUFFER, target);
+	}
+
+private:
+	GLint width;
+	GLint height;
+	GLuint fbo;
+	GLuint textures[GBUFFER_TEXTURE_COUNT];
+
+	void setNearest()
+	{
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+};
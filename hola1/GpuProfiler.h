@@ -0,0 +1,253 @@
+#pragma once
+
+// Std. Includes
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+
+// GL Includes
+#include <GL/glew.h>
+
+// Cuadros que se dejan en vuelo antes de leer las consultas (para no esperar a la GPU)
+const GLuint PROFILER_FRAMES = 4;
+
+// Perfilador de secciones del cuadro, en GPU (glQueryCounter con GL_TIMESTAMP) y en CPU.
+// Las marcas se pueden anidar o encimar, a diferencia de GL_TIME_ELAPSED.
+// Cada cierto tiempo imprime el promedio por seccion del ultimo intervalo,
+// y al destruirse el promedio de toda la corrida (para comparar modos, ej. forward contra deferred).
+// Los nombres se guardan como puntero hasta que se leen las consultas: deben ser literales.
+// Medir no pide memoria al heap una vez que cada seccion aparecio la primera vez.
+class GpuProfiler
+{
+public:
+	// Constructor, recibe cada cuantos segundos imprimir el reporte (0 = nunca)
+	GpuProfiler(GLfloat reportInterval = 2.0f)
+		: reportInterval(reportInterval), frameIndex(0), elapsed(0.0f)
+	{
+		for (GLuint i = 0; i < PROFILER_FRAMES; i++)
+		{
+			this->frames[i].used = 0;
+		}
+	}
+
+	~GpuProfiler()
+	{
+		this->printStats(this->totals, "PROFILER::TOTAL");
+		for (GLuint i = 0; i < PROFILER_FRAMES; i++)
+		{
+			if (!this->frames[i].queries.empty())
+			{
+				glDeleteQueries((GLsizei)this->frames[i].queries.size(), &this->frames[i].queries[0]);
+			}
+		}
+	}
+
+	// Llamar al inicio de cada cuadro: recoge los resultados del cuadro mas viejo del anillo
+	void BeginFrame(GLfloat deltaTime)
+	{
+		this->frameIndex = (this->frameIndex + 1) % PROFILER_FRAMES;
+		this->collect(this->frames[this->frameIndex]);
+
+		this->elapsed += deltaTime;
+		if (this->reportInterval > 0.0f && this->elapsed >= this->reportInterval)
+		{
+			this->printStats(this->interval, "PROFILER");
+			this->printCounts(this->intervalCounts);
+			this->clearStats(this->interval);
+			this->clearStats(this->intervalCounts);
+			this->elapsed = 0.0f;
+		}
+	}
+
+	// Marca el inicio de una seccion
+	void Begin(const char* name)
+	{
+		Frame& frame = this->frames[this->frameIndex];
+		Section section;
+		section.name = name;
+		section.startQuery = this->nextQuery(frame);
+		section.endQuery = 0;
+		section.cpuStart = std::chrono::high_resolution_clock::now();
+		glQueryCounter(section.startQuery, GL_TIMESTAMP);
+		frame.sections.push_back(section);
+	}
+
+	// Marca el final de la seccion abierta mas reciente con ese nombre
+	void End(const char* name)
+	{
+		Frame& frame = this->frames[this->frameIndex];
+		for (size_t i = frame.sections.size(); i > 0; i--)
+		{
+			Section& section = frame.sections[i - 1];
+			if (strcmp(section.name, name) == 0 && section.endQuery == 0)
+			{
+				section.endQuery = this->nextQuery(frame);
+				glQueryCounter(section.endQuery, GL_TIMESTAMP);
+				section.cpuEnd = std::chrono::high_resolution_clock::now();
+				return;
+			}
+		}
+		std::cout << "ERROR::PROFILER::SECTION_NOT_OPEN " << name << std::endl;
+	}
+
+	// Agrega una seccion que se midio en otro hilo (sin contexto GL): solo tiempo de CPU
+	void Record(const char* name, double cpuMs)
+	{
+		this->add(this->find(this->interval, name), 0.0, cpuMs);
+		this->add(this->find(this->totals, name), 0.0, cpuMs);
+	}
+
+	// Agrega un valor que no es tiempo (ej. bloques pedidos al heap); se reporta su promedio por cuadro
+	void RecordCount(const char* name, double value)
+	{
+		this->add(this->find(this->intervalCounts, name), 0.0, value);
+	}
+
+private:
+	// Tiempos acumulados de una seccion
+	struct Stats
+	{
+		double gpuMs;
+		double cpuMs;
+		GLuint count;
+	};
+
+	struct Section
+	{
+		const char* name;
+		GLuint startQuery;
+		GLuint endQuery;
+		std::chrono::high_resolution_clock::time_point cpuStart;
+		std::chrono::high_resolution_clock::time_point cpuEnd;
+	};
+
+	// Consultas de un cuadro; se reciclan cuando el cuadro vuelve a tocar en el anillo
+	struct Frame
+	{
+		std::vector<GLuint> queries;
+		GLuint used;
+		std::vector<Section> sections;
+	};
+
+	GLfloat reportInterval;
+	Frame frames[PROFILER_FRAMES];
+	GLuint frameIndex;
+	GLfloat elapsed;
+	// std::less<> deja buscar con const char* sin armar un std::string
+	typedef std::map<std::string, Stats, std::less<>> StatsMap;
+	StatsMap interval;
+	StatsMap totals;
+	StatsMap intervalCounts;
+
+	GLuint nextQuery(Frame& frame)
+	{
+		if (frame.used == frame.queries.size())
+		{
+			GLuint query;
+			glGenQueries(1, &query);
+			frame.queries.push_back(query);
+		}
+		return frame.queries[frame.used++];
+	}
+
+	void collect(Frame& frame)
+	{
+		for (size_t i = 0; i < frame.sections.size(); i++)
+		{
+			Section& section = frame.sections[i];
+			if (section.endQuery == 0)
+			{
+				continue;
+			}
+
+			// Si la GPU va mas de PROFILER_FRAMES cuadros atrasada se pierde la muestra, no esperamos
+			GLint available = 0;
+			glGetQueryObjectiv(section.endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+			{
+				continue;
+			}
+
+			GLuint64 start, end;
+			glGetQueryObjectui64v(section.startQuery, GL_QUERY_RESULT, &start);
+			glGetQueryObjectui64v(section.endQuery, GL_QUERY_RESULT, &end);
+			double gpuMs = (double)(end - start) / 1.0e6;
+			double cpuMs = std::chrono::duration<double, std::milli>(section.cpuEnd - section.cpuStart).count();
+
+			this->add(this->find(this->interval, section.name), gpuMs, cpuMs);
+			this->add(this->find(this->totals, section.name), gpuMs, cpuMs);
+		}
+		frame.sections.clear();
+		frame.used = 0;
+	}
+
+	// La entrada de la seccion; solo la primera vez se crea (en cero)
+	Stats& find(StatsMap& stats, const char* name)
+	{
+		StatsMap::iterator it = stats.find(name);
+		if (it == stats.end())
+		{
+			it = stats.insert(std::make_pair(std::string(name), Stats())).first;
+			it->second.gpuMs = 0.0;
+			it->second.cpuMs = 0.0;
+			it->second.count = 0;
+		}
+		return it->second;
+	}
+
+	// Al terminar el intervalo las entradas se dejan en cero en lugar de borrarlas (no se vuelven a crear)
+	void clearStats(StatsMap& stats)
+	{
+		for (StatsMap::iterator it = stats.begin(); it != stats.end(); ++it)
+		{
+			it->second.gpuMs = 0.0;
+			it->second.cpuMs = 0.0;
+			it->second.count = 0;
+		}
+	}
+
+	void add(Stats& stats, double gpuMs, double cpuMs)
+	{
+		stats.gpuMs += gpuMs;
+		stats.cpuMs += cpuMs;
+		stats.count++;
+	}
+
+	void printStats(const StatsMap& stats, const char* title)
+	{
+		if (stats.empty())
+		{
+			return;
+		}
+		std::cout << title << std::fixed << std::setprecision(2) << std::endl;
+		for (StatsMap::const_iterator it = stats.begin(); it != stats.end(); ++it)
+		{
+			const Stats& s = it->second;
+			if (s.count == 0)
+			{
+				continue;
+			}
+			std::cout << "  " << std::left << std::setw(24) << it->first << std::right
+				<< " GPU " << std::setw(7) << s.gpuMs / s.count << " ms"
+				<< "   CPU " << std::setw(7) << s.cpuMs / s.count << " ms"
+				<< "   (" << s.count << " cuadros)" << std::endl;
+		}
+	}
+
+	void printCounts(const StatsMap& counts)
+	{
+		for (StatsMap::const_iterator it = counts.begin(); it != counts.end(); ++it)
+		{
+			const Stats& s = it->second;
+			if (s.count > 0)
+			{
+				std::cout << "  " << std::left << std::setw(24) << it->first << std::right
+					<< " " << std::setw(11) << s.cpuMs / s.count << " por cuadro" << std::endl;
+			}
+		}
+	}
+};
@@ -0,0 +1,354 @@
+#pragma once
+
+// Std. Includes
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// GL Includes
+#include <GL/glew.h>
+
+// Tamano de lote de ParallelFor cuando no se pide otro
+const GLuint JOBS_DEFAULT_BATCH = 64;
+
+// Lugares de la cola de cada hilo (se apartan al crear el sistema para no pedir memoria al encolar)
+const GLuint JOBS_QUEUE_CAPACITY = 1024;
+
+class JobCounter;
+
+struct Job
+{
+	std::function<void()> function;
+	JobCounter* counter;	// Se descuenta al terminar (puede ser nullptr)
+};
+
+// Cuenta los trabajos pendientes de un grupo. Sirve para esperarlos con JobSystem::Wait() y como
+// dependencia: los trabajos que dependen de el se encolan hasta que llegue a cero.
+// Debe vivir hasta que Wait() regrese (los trabajos lo tocan al terminar).
+class JobCounter
+{
+public:
+	JobCounter()
+		: pending(0)
+	{
+	}
+
+	bool IsDone() const { return this->pending.load() == 0; }
+
+private:
+	friend class JobSystem;
+	std::atomic<GLint> pending;
+	std::mutex mutex;
+	std::vector<Job> waiting;
+};
+
+// Sistema de trabajos con robo de trabajo (work stealing).
+// Cada hilo tiene su cola: mete y saca por atras (lo ultimo que metio sigue en cache) y cuando se
+// queda sin nada le roba por el frente a otro. El hilo que crea el sistema (el del contexto GL)
+// tambien tiene cola y trabaja mientras espera en Wait() o ParallelFor().
+// Lo que llama a GL va con RunOnMainThread(): solo lo corre el hilo principal, dentro de Wait() o
+// en RunMainThreadJobs() (una vez por cuadro).
+class JobSystem
+{
+public:
+	// workerCount hilos ademas del principal; por omision uno menos que los nucleos
+	JobSystem(GLint workerCount = -1)
+		: mainThread(std::this_thread::get_id()), running(true), queued(0), sleeping(0), executed(0), steals(0)
+	{
+		if (workerCount < 0)
+		{
+			workerCount = (GLint)std::max(1u, std::thread::hardware_concurrency()) - 1;
+		}
+		for (GLint i = 0; i <= workerCount; i++)
+		{
+			this->queues.push_back(new WorkerQueue());
+		}
+		for (GLint i = 1; i <= workerCount; i++)
+		{
+			this->workers.push_back(std::thread(&JobSystem::workerLoop, this, i));
+		}
+	}
+
+	~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->sleepMutex);
+			this->running = false;
+		}
+		this->sleepCondition.notify_all();
+		for (size_t i = 0; i < this->workers.size(); i++)
+		{
+			this->workers[i].join();
+		}
+		for (size_t i = 0; i < this->queues.size(); i++)
+		{
+			delete this->queues[i];
+		}
+	}
+
+	// Encola un trabajo. Si hay counter se cuenta en el; si hay dependency no empieza hasta que
+	// esa cuenta llegue a cero
+	void Run(std::function<void()> function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr)
+	{
+		if (counter != nullptr)
+		{
+			counter->pending++;
+		}
+		Job job = { std::move(function), counter };
+		if (dependency != nullptr)
+		{
+			std::lock_guard<std::mutex> lock(dependency->mutex);
+			if (dependency->pending > 0)
+			{
+				dependency->waiting.push_back(std::move(job));
+				return;
+			}
+		}
+		this->push(std::move(job));
+	}
+
+	// Encola un trabajo que solo puede correr el hilo principal (llamadas a GL)
+	void RunOnMainThread(std::function<void()> function, JobCounter* counter = nullptr)
+	{
+		if (counter != nullptr)
+		{
+			counter->pending++;
+		}
+		std::lock_guard<std::mutex> lock(this->mainMutex);
+		this->mainJobs.push_back({ std::move(function), counter });
+	}
+
+	// El contexto GL cambio de hilo (ej. a un hilo de render): los trabajos de RunOnMainThread()
+	// pasan a correr en el que llama
+	void SetMainThread()
+	{
+		this->mainThread = std::this_thread::get_id();
+	}
+
+	// Corre los trabajos del hilo principal que haya (solo desde el hilo principal); regresa cuantos
+	GLuint RunMainThreadJobs()
+	{
+		std::vector<Job> jobs;
+		{
+			std::lock_guard<std::mutex> lock(this->mainMutex);
+			jobs.swap(this->mainJobs);
+		}
+		for (size_t i = 0; i < jobs.size(); i++)
+		{
+			this->execute(jobs[i]);
+		}
+		return (GLuint)jobs.size();
+	}
+
+	// Espera a que la cuenta llegue a cero corriendo otros trabajos mientras tanto
+	void Wait(JobCounter& counter)
+	{
+		bool main = std::this_thread::get_id() == this->mainThread;
+		while (!counter.IsDone())
+		{
+			Job job;
+			if (main && this->RunMainThreadJobs() > 0)
+			{
+				continue;
+			}
+			if (this->pop(job))
+			{
+				this->execute(job);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+		// El ultimo trabajo pudo seguir dentro de finish(); hasta que suelte el candado el contador no se puede destruir
+		std::lock_guard<std::mutex> lock(counter.mutex);
+	}
+
+	// Reparte [0, count) en lotes de batch; el que llama hace el primero y regresa cuando terminan todos.
+	// function es cualquier cosa que se llame con (begin, end); es plantilla para no envolverla en un
+	// std::function (pediria memoria cada cuadro): los lotes solo guardan un puntero a ella
+	template <typename Function>
+	void ParallelFor(GLuint count, GLuint batch, const Function& function)
+	{
+		batch = std::max(1u, batch);
+		if (count <= batch || this->workers.empty())
+		{
+			if (count > 0)
+			{
+				function(0, count);
+			}
+			return;
+		}
+		JobCounter counter;
+		for (GLuint begin = batch; begin < count; begin += batch)
+		{
+			GLuint end = std::min(begin + batch, count);
+			this->Run([&function, begin, end]() { function(begin, end); }, &counter);
+		}
+		function(0, batch);
+		this->Wait(counter);
+	}
+
+	GLuint GetWorkerCount() const { return (GLuint)this->workers.size(); }
+	GLuint GetThreadCount() const { return (GLuint)this->queues.size(); }
+	unsigned long long GetExecutedCount() const { return this->executed; }
+	unsigned long long GetStealCount() const { return this->steals; }
+
+private:
+	// Anillo de tamano fijo: el dueno saca por atras y los demas roban por el frente
+	struct WorkerQueue
+	{
+		std::mutex mutex;
+		std::vector<Job> jobs;
+		GLuint head;	// Primer trabajo (el siguiente que se roba)
+		GLuint count;
+
+		WorkerQueue()
+			: jobs(JOBS_QUEUE_CAPACITY), head(0), count(0)
+		{
+		}
+	};
+
+	std::atomic<std::thread::id> mainThread;
+	std::vector<WorkerQueue*> queues;	// 0 es del hilo principal (y de cualquier hilo que no sea trabajador)
+	std::vector<std::thread> workers;
+	std::atomic<bool> running;
+
+	// Los trabajadores sin nada que hacer duermen hasta que alguien encole
+	std::atomic<GLint> queued;
+	std::atomic<GLint> sleeping;
+	std::mutex sleepMutex;
+	std::condition_variable sleepCondition;
+
+	std::mutex mainMutex;
+	std::vector<Job> mainJobs;
+
+	std::atomic<unsigned long long> executed;
+	std::atomic<unsigned long long> steals;
+
+	// Cola del hilo que llama (los trabajadores guardan la suya al arrancar)
+	static const JobSystem*& threadSystem()
+	{
+		thread_local const JobSystem* system = nullptr;
+		return system;
+	}
+
+	static GLuint& threadQueue()
+	{
+		thread_local GLuint index = 0;
+		return index;
+	}
+
+	GLuint currentQueue() const
+	{
+		return threadSystem() == this ? threadQueue() : 0;
+	}
+
+	// Con la cola llena el trabajo corre aqui mismo (nunca debe pasar en un cuadro normal)
+	void push(Job job)
+	{
+		WorkerQueue* queue = this->queues[this->currentQueue()];
+		bool full;
+		{
+			std::lock_guard<std::mutex> lock(queue->mutex);
+			full = queue->count == JOBS_QUEUE_CAPACITY;
+			if (!full)
+			{
+				queue->jobs[(queue->head + queue->count) % JOBS_QUEUE_CAPACITY] = std::move(job);
+				queue->count++;
+			}
+		}
+		if (full)
+		{
+			this->execute(job);
+			return;
+		}
+		this->queued++;
+		if (this->sleeping > 0)
+		{
+			// Con el candado tomado el trabajador no puede estar entre revisar la cola y dormirse
+			std::lock_guard<std::mutex> lock(this->sleepMutex);
+			this->sleepCondition.notify_one();
+		}
+	}
+
+	// Saca de la cola propia por atras; si esta vacia roba por el frente de las demas
+	bool pop(Job& job)
+	{
+		GLuint own = this->currentQueue();
+		GLuint count = (GLuint)this->queues.size();
+		for (GLuint k = 0; k < count; k++)
+		{
+			WorkerQueue* queue = this->queues[(own + k) % count];
+			std::lock_guard<std::mutex> lock(queue->mutex);
+			if (queue->count == 0)
+			{
+				continue;
+			}
+			if (k == 0)
+			{
+				job = std::move(queue->jobs[(queue->head + queue->count - 1) % JOBS_QUEUE_CAPACITY]);
+			}
+			else
+			{
+				job = std::move(queue->jobs[queue->head]);
+				queue->head = (queue->head + 1) % JOBS_QUEUE_CAPACITY;
+				this->steals++;
+			}
+			queue->count--;
+			this->queued--;
+			return true;
+		}
+		return false;
+	}
+
+	void execute(Job& job)
+	{
+		job.function();
+		this->executed++;
+		if (job.counter != nullptr)
+		{
+			this->finish(job.counter);
+		}
+	}
+
+	// Descuenta el trabajo; el ultimo libera a los que dependian del contador
+	void finish(JobCounter* counter)
+	{
+		std::vector<Job> released;
+		{
+			std::lock_guard<std::mutex> lock(counter->mutex);
+			if (--counter->pending == 0)
+			{
+				released.swap(counter->waiting);
+			}
+		}
+		for (size_t i = 0; i < released.size(); i++)
+		{
+			this->push(std::move(released[i]));
+		}
+	}
+
+	void workerLoop(GLuint index)
+	{
+		threadSystem() = this;
+		threadQueue() = index;
+		while (this->running)
+		{
+			Job job;
+			if (this->pop(job))
+			{
+				this->execute(job);
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(this->sleepMutex);
+			this->sleeping++;
+			this->sleepCondition.wait(lock, [this]() { return this->queued > 0 || !this->running; });
+			this->sleeping--;
+		}
+	}
+};
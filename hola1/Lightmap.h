@@ -0,0 +1,611 @@
+#pragma once
+
+// Std. Includes
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "LightmapBaker.h"
+
+// Tamano del atlas (cada capa)
+const GLint LIGHTMAP_SIZE = 1024;
+
+// Densidad con la que se empieza; baja sola hasta que todas las caras caben en el atlas
+const GLfloat LIGHTMAP_TEXELS_PER_UNIT = 4.0f;
+
+// Direcciones del sol que se hornean (dia, atardecer, noche); igual que LIGHTMAP_SUN_LAYERS en el shader
+const GLuint LIGHTMAP_SUN_LAYERS = 3;
+
+// Rayos por texel para el rebote de luz
+const GLuint LIGHTMAP_BOUNCE_SAMPLES = 16;
+
+// Color del sol con el que se hornean sus capas; en el cuadro se escalan al de dirLight
+const glm::vec3 LIGHTMAP_SUN_DIFFUSE(0.8f, 0.8f, 0.8f);
+
+// Las capas se guardan en RGBM (RGBA8, 4 bytes por texel en lugar de 12 en flotante):
+// color = rgb * a * LIGHTMAP_RGBM_RANGE. Igual que en el shader.
+const GLfloat LIGHTMAP_RGBM_RANGE = 8.0f;
+
+// Unidad de textura del atlas; la siguiente es la de las coordenadas por vertice
+const GLuint LIGHTMAP_TEXTURE_UNIT = 14;
+
+// Luz horneada de la parte estatica de la escena.
+// 1. Se graban los dibujos de la escena estatica una vez (Surface antes de cada glDrawArrays):
+//    la matriz model, el color y los vertices del VAO enlazado.
+// 2. Se generan las coordenadas del lightmap: cada cara plana de cada dibujo es una region
+//    rectangular del atlas (se acomodan por filas) y cada vertice recibe su coordenada.
+// 3. LightmapBaker calcula la luz en CPU con todos los nucleos, o se carga del archivo si
+//    la escena y las luces no cambiaron.
+// En el shader (#define LIGHTMAP) las coordenadas salen de un texture buffer indexado con
+// lightmapOffset + gl_VertexID, asi los VAOs compartidos no cambian.
+// Capa 0: postes; capas 1..3: el sol en cada direccion (se mezclan segun la del cuadro).
+// El ambiente no se hornea, el shader suma el de dirLight.
+class Lightmap
+{
+public:
+	// Constructor, recibe el archivo donde se guarda el resultado
+	Lightmap(const std::string& path, GLint size = LIGHTMAP_SIZE)
+		: path(path), size(size), recording(false), ready(false), atlas(0), uvBuffer(0), uvTexture(0),
+		lastProgram(0), lastOffsetLocation(-1), density(0.0f)
+	{
+	}
+
+	~Lightmap()
+	{
+		if (this->ready)
+		{
+			glDeleteTextures(1, &this->atlas);
+			glDeleteTextures(1, &this->uvTexture);
+			glDeleteBuffers(1, &this->uvBuffer);
+		}
+	}
+
+	// Registra los vertices de un VAO (posicion, normal, coords. de textura: 8 floats por vertice)
+	void AddMesh(GLuint vao, const GLfloat* vertices, GLuint vertexCount)
+	{
+		this->meshes[vao].assign(vertices, vertices + vertexCount * 8);
+	}
+
+	void BeginRecording()
+	{
+		this->surfaces.clear();
+		this->recording = true;
+	}
+
+	void EndRecording()
+	{
+		this->recording = false;
+	}
+
+	// Llamar antes de cada glDrawArrays de la escena estatica, con el programa activo.
+	// Al grabar anota la superficie; despues pone en que vertice empiezan sus coordenadas.
+	void Surface(GLuint program, GLuint index, GLsizei count)
+	{
+		if (this->recording)
+		{
+			this->record(program, count);
+			return;
+		}
+		if (!this->ready || index >= this->surfaces.size())
+		{
+			return;
+		}
+		if (program != this->lastProgram)
+		{
+			this->lastProgram = program;
+			this->lastOffsetLocation = glGetUniformLocation(program, "lightmapOffset");
+		}
+		if (this->lastOffsetLocation >= 0)
+		{
+			glUniform1i(this->lastOffsetLocation, (GLint)this->surfaces[index].firstVertex);
+		}
+	}
+
+	// Genera las coordenadas y hornea (o carga del archivo) lo grabado
+	bool Build(const LightmapLighting& lighting)
+	{
+		if (this->surfaces.empty() || lighting.sunDirections.size() != LIGHTMAP_SUN_LAYERS)
+		{
+			std::cout << "ERROR::LIGHTMAP::NOTHING_TO_BAKE" << std::endl;
+			return false;
+		}
+		this->sunDirections = lighting.sunDirections;
+
+		std::vector<LightmapTriangle> triangles;
+		std::vector<LightmapChart> charts;
+		std::vector<glm::vec2> uvs;
+		this->generateCharts(triangles, charts, uvs);
+		GLuint layers = 1 + LIGHTMAP_SUN_LAYERS;
+
+		GLuint texelCount = 0;
+		for (size_t i = 0; i < charts.size(); i++)
+		{
+			texelCount += charts[i].width * charts[i].height;
+		}
+		std::cout << std::fixed << std::setprecision(2) << "LIGHTMAP: " << this->surfaces.size() << " superficies, "
+			<< charts.size() << " caras, " << triangles.size() << " triangulos, " << this->density << " texeles por unidad, "
+			<< 100.0 * texelCount / (this->size * this->size) << "% del atlas" << std::endl;
+
+		// La escena y las luces deciden si el archivo sigue sirviendo
+		unsigned long long key = this->hashScene(lighting);
+		std::vector<GLubyte> rgbm;
+		if (!this->load(key, layers, rgbm))
+		{
+			LightmapBaker baker(triangles, charts, this->size);
+			std::vector<glm::vec3> irradiance = baker.Bake(lighting, std::thread::hardware_concurrency());
+			const LightmapBakeStats& stats = baker.GetStats();
+			double totalMs = stats.directMs + stats.bounceMs;
+			std::cout << std::fixed << std::setprecision(1) << "LIGHTMAP::BAKE " << stats.texels << " texeles, "
+				<< stats.rays / 1000000.0 << " M rayos en " << totalMs << " ms (directa " << stats.directMs
+				<< " ms, rebote " << stats.bounceMs << " ms), " << stats.rays / (totalMs * 1000.0) << " M rayos/s, "
+				<< stats.texels * layers / (totalMs * 1000.0) << " M texeles/s, " << stats.threads << " hilos" << std::endl;
+
+			rgbm.resize(irradiance.size() * 4);
+			for (size_t i = 0; i < irradiance.size(); i++)
+			{
+				EncodeRGBM(irradiance[i], &rgbm[i * 4]);
+			}
+			this->save(key, layers, rgbm);
+		}
+
+		// Atlas: una capa por luz
+		glGenTextures(1, &this->atlas);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, this->atlas);
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, this->size, this->size, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, &rgbm[0]);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+		// Coordenadas de cada vertice grabado, en el orden de los dibujos
+		glGenBuffers(1, &this->uvBuffer);
+		glBindBuffer(GL_TEXTURE_BUFFER, this->uvBuffer);
+		glBufferData(GL_TEXTURE_BUFFER, uvs.size() * sizeof(glm::vec2), &uvs[0], GL_STATIC_DRAW);
+		glGenTextures(1, &this->uvTexture);
+		glBindTexture(GL_TEXTURE_BUFFER, this->uvTexture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, this->uvBuffer);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+		this->ready = true;
+		return true;
+	}
+
+	// Enlaza el atlas y las coordenadas y pone los uniforms en el programa (que debe estar activo).
+	// Las capas del sol se mezclan segun su direccion y se escalan a su color en este cuadro.
+	void Bind(GLuint program, const glm::vec3& lightDirection, const glm::vec3& sunDiffuse)
+	{
+		glActiveTexture(GL_TEXTURE0 + LIGHTMAP_TEXTURE_UNIT);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, this->atlas);
+		glUniform1i(glGetUniformLocation(program, "lightmap"), LIGHTMAP_TEXTURE_UNIT);
+		glActiveTexture(GL_TEXTURE0 + LIGHTMAP_TEXTURE_UNIT + 1);
+		glBindTexture(GL_TEXTURE_BUFFER, this->uvTexture);
+		glUniform1i(glGetUniformLocation(program, "lightmapUVs"), LIGHTMAP_TEXTURE_UNIT + 1);
+		glActiveTexture(GL_TEXTURE0);
+
+		GLfloat weights[LIGHTMAP_SUN_LAYERS];
+		this->sunWeights(lightDirection, weights);
+		glm::vec3 colors[LIGHTMAP_SUN_LAYERS];
+		for (GLuint i = 0; i < LIGHTMAP_SUN_LAYERS; i++)
+		{
+			colors[i] = weights[i] * sunDiffuse / LIGHTMAP_SUN_DIFFUSE;
+		}
+		glUniform3fv(glGetUniformLocation(program, "lightmapSunWeights"), LIGHTMAP_SUN_LAYERS, glm::value_ptr(colors[0]));
+		this->lastProgram = 0; // El programa pudo haberse recompilado
+	}
+
+	bool IsReady() const
+	{
+		return this->ready;
+	}
+
+	static void EncodeRGBM(const glm::vec3& color, GLubyte* out)
+	{
+		GLfloat maxValue = std::max(std::max(color.r, color.g), std::max(color.b, 1e-6f)) / LIGHTMAP_RGBM_RANGE;
+		GLfloat m = std::ceil(glm::clamp(maxValue, 1.0f / 255.0f, 1.0f) * 255.0f) / 255.0f;
+		glm::vec3 rgb = glm::clamp(color / (m * LIGHTMAP_RGBM_RANGE), 0.0f, 1.0f);
+		out[0] = (GLubyte)(rgb.r * 255.0f + 0.5f);
+		out[1] = (GLubyte)(rgb.g * 255.0f + 0.5f);
+		out[2] = (GLubyte)(rgb.b * 255.0f + 0.5f);
+		out[3] = (GLubyte)(m * 255.0f + 0.5f);
+	}
+
+private:
+	// Un dibujo grabado
+	struct SurfaceRecord
+	{
+		GLuint vao;
+		GLsizei count;
+		glm::mat4 model;
+		glm::vec3 albedo;
+		bool textured;
+		GLuint firstVertex; // Primer vertice en el buffer de coordenadas
+	};
+
+	// Cabecera del archivo
+	struct FileHeader
+	{
+		char magic[4];
+		GLint size;
+		GLuint layers;
+		unsigned long long key;
+	};
+
+	std::string path;
+	GLint size;
+	bool recording;
+	bool ready;
+	GLuint atlas;
+	GLuint uvBuffer;
+	GLuint uvTexture;
+	GLuint lastProgram;
+	GLint lastOffsetLocation;
+	GLfloat density;
+	std::map<GLuint, std::vector<GLfloat> > meshes;
+	std::vector<SurfaceRecord> surfaces;
+	std::map<GLuint, glm::vec3> textureAverages;
+	std::vector<glm::vec3> sunDirections;
+
+	void record(GLuint program, GLsizei count)
+	{
+		SurfaceRecord surface;
+		GLint vao = 0;
+		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vao);
+		surface.vao = (GLuint)vao;
+		surface.count = count;
+		surface.model = glm::mat4(1.0f);
+		surface.albedo = glm::vec3(1.0f);
+		surface.textured = false;
+		surface.firstVertex = 0;
+
+		GLint modelLoc = glGetUniformLocation(program, "model");
+		if (modelLoc >= 0)
+		{
+			glGetUniformfv(program, modelLoc, glm::value_ptr(surface.model));
+		}
+		// Sin #define TEXTURED el color es material.diffuse; con textura se usa su promedio
+		GLint diffuseLoc = glGetUniformLocation(program, "material.diffuse");
+		if (diffuseLoc >= 0)
+		{
+			glGetUniformfv(program, diffuseLoc, glm::value_ptr(surface.albedo));
+		}
+		else if (glGetUniformLocation(program, "texture_diffuse1") >= 0)
+		{
+			GLint texture = 0;
+			glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+			surface.albedo = this->textureAverage((GLuint)texture);
+			surface.textured = true;
+		}
+		this->surfaces.push_back(surface);
+	}
+
+	glm::vec3 textureAverage(GLuint texture)
+	{
+		std::map<GLuint, glm::vec3>::iterator it = this->textureAverages.find(texture);
+		if (it != this->textureAverages.end())
+		{
+			return it->second;
+		}
+		GLint width = 0, height = 0;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+		glm::vec3 average(0.5f);
+		if (width > 0 && height > 0)
+		{
+			std::vector<GLubyte> pixels(width * height * 4);
+			glPixelStorei(GL_PACK_ALIGNMENT, 1);
+			glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+			glm::dvec3 sum(0.0);
+			for (GLint i = 0; i < width * height; i++)
+			{
+				sum += glm::dvec3(pixels[i * 4], pixels[i * 4 + 1], pixels[i * 4 + 2]);
+			}
+			average = glm::vec3(sum / (255.0 * width * height));
+		}
+		this->textureAverages[texture] = average;
+		return average;
+	}
+
+	// Caras planas de un dibujo (triangulos con la misma normal y el mismo plano)
+	struct Face
+	{
+		glm::vec3 normal;
+		GLfloat distance;
+		std::vector<GLuint> triangles;
+	};
+
+	void generateCharts(std::vector<LightmapTriangle>& triangles, std::vector<LightmapChart>& charts, std::vector<glm::vec2>& uvs)
+	{
+		// Triangulos en espacio de mundo y sus caras
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec3> normals;
+		std::vector<Face> faces;
+		std::vector<GLuint> faceSurface;
+		GLuint vertexCount = 0;
+		for (size_t s = 0; s < this->surfaces.size(); s++)
+		{
+			SurfaceRecord& surface = this->surfaces[s];
+			surface.firstVertex = vertexCount;
+			vertexCount += surface.count;
+
+			std::map<GLuint, std::vector<GLfloat> >::iterator mesh = this->meshes.find(surface.vao);
+			bool known = mesh != this->meshes.end() && mesh->second.size() >= (size_t)surface.count * 8;
+			glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(surface.model)));
+			size_t firstFace = faces.size();
+			for (GLsizei v = 0; v < surface.count; v++)
+			{
+				glm::vec3 position(0.0f), normal(0.0f, 1.0f, 0.0f);
+				if (known)
+				{
+					const GLfloat* vertex = &mesh->second[v * 8];
+					position = glm::vec3(surface.model * glm::vec4(vertex[0], vertex[1], vertex[2], 1.0f));
+					normal = glm::normalize(normalMatrix * glm::vec3(vertex[3], vertex[4], vertex[5]));
+				}
+				positions.push_back(position);
+				normals.push_back(normal);
+			}
+			if (!known)
+			{
+				continue; // Sin vertices no hay caras: se queda con coordenadas (0, 0)
+			}
+
+			for (GLsizei t = 0; t + 2 < surface.count; t += 3)
+			{
+				GLuint first = surface.firstVertex + t;
+				glm::vec3 normal = normals[first];
+				GLfloat distance = glm::dot(normal, positions[first]);
+				size_t f = firstFace;
+				while (f < faces.size() && !(glm::dot(faces[f].normal, normal) > 0.999f && std::fabs(faces[f].distance - distance) < 1e-3f))
+				{
+					f++;
+				}
+				if (f == faces.size())
+				{
+					Face face;
+					face.normal = normal;
+					face.distance = distance;
+					faces.push_back(face);
+					faceSurface.push_back((GLuint)s);
+				}
+				faces[f].triangles.push_back(first);
+			}
+		}
+
+		// Cada cara es una region del rectangulo que la cubre en su plano
+		charts.resize(faces.size());
+		std::vector<glm::vec2> faceMin(faces.size()), faceMax(faces.size());
+		std::vector<glm::vec3> axisU(faces.size()), axisV(faces.size());
+		for (size_t f = 0; f < faces.size(); f++)
+		{
+			glm::vec3 n = faces[f].normal;
+			glm::vec3 helper = (std::fabs(n.y) < 0.99f) ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+			axisU[f] = glm::normalize(glm::cross(helper, n));
+			axisV[f] = glm::cross(n, axisU[f]);
+			faceMin[f] = glm::vec2(1e30f);
+			faceMax[f] = glm::vec2(-1e30f);
+			for (size_t t = 0; t < faces[f].triangles.size(); t++)
+			{
+				for (GLuint v = 0; v < 3; v++)
+				{
+					const glm::vec3& p = positions[faces[f].triangles[t] + v];
+					glm::vec2 projected(glm::dot(p, axisU[f]), glm::dot(p, axisV[f]));
+					faceMin[f] = glm::min(faceMin[f], projected);
+					faceMax[f] = glm::max(faceMax[f], projected);
+				}
+			}
+		}
+
+		// Se baja la densidad hasta que todo cabe
+		this->density = LIGHTMAP_TEXELS_PER_UNIT;
+		while (!this->pack(charts, faceMin, faceMax))
+		{
+			this->density *= 0.9f;
+		}
+
+		// Coordenadas de los vertices (en texeles para el horneado, normalizadas para el shader)
+		uvs.assign(vertexCount, glm::vec2(0.0f));
+		for (size_t f = 0; f < faces.size(); f++)
+		{
+			LightmapChart& chart = charts[f];
+			glm::vec2 extent = faceMax[f] - faceMin[f];
+			chart.normal = faces[f].normal;
+			chart.origin = axisU[f] * faceMin[f].x + axisV[f] * faceMin[f].y + faces[f].normal * faces[f].distance;
+			chart.axisU = axisU[f] * extent.x;
+			chart.axisV = axisV[f] * extent.y;
+
+			for (size_t t = 0; t < faces[f].triangles.size(); t++)
+			{
+				LightmapTriangle triangle;
+				GLuint first = faces[f].triangles[t];
+				for (GLuint v = 0; v < 3; v++)
+				{
+					const glm::vec3& p = positions[first + v];
+					glm::vec2 local = glm::vec2(glm::dot(p, axisU[f]), glm::dot(p, axisV[f])) - faceMin[f];
+					glm::vec2 s(extent.x > 0.0f ? local.x / extent.x : 0.5f, extent.y > 0.0f ? local.y / extent.y : 0.5f);
+					glm::vec2 texel(chart.x + 1 + s.x * (chart.width - 2), chart.y + 1 + s.y * (chart.height - 2));
+					triangle.positions[v] = p;
+					triangle.texels[v] = texel;
+					uvs[first + v] = texel / (GLfloat)this->size;
+				}
+				triangle.normal = faces[f].normal;
+				triangle.albedo = this->surfaces[faceSurface[f]].albedo;
+				triangles.push_back(triangle);
+			}
+		}
+	}
+
+	// Acomoda las regiones por filas, de la mas alta a la mas baja; false si no caben
+	bool pack(std::vector<LightmapChart>& charts, const std::vector<glm::vec2>& faceMin, const std::vector<glm::vec2>& faceMax)
+	{
+		std::vector<GLuint> order(charts.size());
+		for (size_t f = 0; f < charts.size(); f++)
+		{
+			// Un texel de borde por lado para el filtrado bilineal
+			glm::vec2 extent = faceMax[f] - faceMin[f];
+			charts[f].width = std::min(std::max((GLint)std::ceil(extent.x * this->density), 1), this->size - 2) + 2;
+			charts[f].height = std::min(std::max((GLint)std::ceil(extent.y * this->density), 1), this->size - 2) + 2;
+			order[f] = (GLuint)f;
+		}
+		std::sort(order.begin(), order.end(), [&charts](GLuint a, GLuint b)
+		{
+			return charts[a].height > charts[b].height || (charts[a].height == charts[b].height && a < b);
+		});
+
+		GLint x = 0, y = 0, rowHeight = 0;
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			LightmapChart& chart = charts[order[i]];
+			if (x + chart.width > this->size)
+			{
+				x = 0;
+				y += rowHeight;
+				rowHeight = 0;
+			}
+			if (y + chart.height > this->size)
+			{
+				return false;
+			}
+			chart.x = x;
+			chart.y = y;
+			x += chart.width;
+			rowHeight = std::max(rowHeight, chart.height);
+		}
+		return true;
+	}
+
+	// Reparte el peso entre las dos direcciones horneadas entre las que esta la del cuadro
+	// (las transiciones interpolan entre dos de ellas)
+	void sunWeights(const glm::vec3& lightDirection, GLfloat* weights)
+	{
+		glm::vec3 direction = glm::normalize(lightDirection);
+		GLfloat angles[LIGHTMAP_SUN_LAYERS];
+		for (GLuint i = 0; i < LIGHTMAP_SUN_LAYERS; i++)
+		{
+			weights[i] = 0.0f;
+			angles[i] = std::acos(glm::clamp(glm::dot(direction, glm::normalize(this->sunDirections[i])), -1.0f, 1.0f));
+		}
+
+		GLuint bestA = 0, bestB = 0;
+		GLfloat bestError = angles[0] * 2.0f;
+		for (GLuint a = 0; a < LIGHTMAP_SUN_LAYERS; a++)
+		{
+			if (angles[a] * 2.0f < bestError)
+			{
+				bestA = bestB = a;
+				bestError = angles[a] * 2.0f;
+			}
+			for (GLuint b = a + 1; b < LIGHTMAP_SUN_LAYERS; b++)
+			{
+				// En el arco entre a y b la suma de los angulos es el angulo entre ellas
+				GLfloat between = std::acos(glm::clamp(glm::dot(glm::normalize(this->sunDirections[a]), glm::normalize(this->sunDirections[b])), -1.0f, 1.0f));
+				GLfloat error = angles[a] + angles[b] - between;
+				if (error < bestError)
+				{
+					bestA = a;
+					bestB = b;
+					bestError = error;
+				}
+			}
+		}
+		if (bestA == bestB)
+		{
+			weights[bestA] = 1.0f;
+			return;
+		}
+		GLfloat t = angles[bestA] / std::max(angles[bestA] + angles[bestB], 1e-6f);
+		weights[bestA] = 1.0f - t;
+		weights[bestB] = t;
+	}
+
+	// 64-bit FNV-1a
+	static unsigned long long hash(unsigned long long value, const void* data, size_t length)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < length; i++)
+		{
+			value ^= bytes[i];
+			value *= 1099511628211ULL;
+		}
+		return value;
+	}
+
+	unsigned long long hashScene(const LightmapLighting& lighting)
+	{
+		unsigned long long key = 14695981039346656037ULL;
+		key = hash(key, &this->size, sizeof(this->size));
+		key = hash(key, &this->density, sizeof(this->density));
+		for (size_t i = 0; i < this->surfaces.size(); i++)
+		{
+			const SurfaceRecord& surface = this->surfaces[i];
+			key = hash(key, &surface.count, sizeof(surface.count));
+			key = hash(key, glm::value_ptr(surface.model), sizeof(glm::mat4));
+			// El promedio de las texturas no entra: el agua cambia de textura cada medio segundo
+			if (!surface.textured)
+				key = hash(key, glm::value_ptr(surface.albedo), sizeof(glm::vec3));
+			std::map<GLuint, std::vector<GLfloat> >::iterator mesh = this->meshes.find(surface.vao);
+			if (mesh != this->meshes.end())
+				key = hash(key, &mesh->second[0], mesh->second.size() * sizeof(GLfloat));
+		}
+		if (!lighting.lights.empty())
+			key = hash(key, &lighting.lights[0], lighting.lights.size() * sizeof(ClusterLight));
+		key = hash(key, &lighting.sunDirections[0], lighting.sunDirections.size() * sizeof(glm::vec3));
+		key = hash(key, glm::value_ptr(lighting.sunDiffuse), sizeof(glm::vec3));
+		key = hash(key, &lighting.bounceSamples, sizeof(lighting.bounceSamples));
+		return key;
+	}
+
+	bool load(unsigned long long key, GLuint layers, std::vector<GLubyte>& rgbm)
+	{
+		std::ifstream file(this->path.c_str(), std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+		FileHeader header;
+		file.read((char*)&header, sizeof(header));
+		if (!file || std::string(header.magic, 4) != "LMAP" || header.size != this->size || header.layers != layers)
+		{
+			std::cout << "ERROR::LIGHTMAP::CORRUPT " << this->path << std::endl;
+			return false;
+		}
+		if (header.key != key)
+		{
+			std::cout << "LIGHTMAP::STALE " << this->path << " (la escena cambio, se vuelve a hornear)" << std::endl;
+			return false;
+		}
+		rgbm.resize((size_t)this->size * this->size * layers * 4);
+		file.read((char*)&rgbm[0], rgbm.size());
+		if (!file)
+		{
+			std::cout << "ERROR::LIGHTMAP::CORRUPT " << this->path << std::endl;
+			return false;
+		}
+		std::cout << "LIGHTMAP: cargado de " << this->path << std::endl;
+		return true;
+	}
+
+	void save(unsigned long long key, GLuint layers, const std::vector<GLubyte>& rgbm)
+	{
+		std::ofstream file(this->path.c_str(), std::ios::binary);
+		if (!file)
+		{
+			std::cout << "ERROR::LIGHTMAP::NOT_WRITTEN " << this->path << std::endl;
+			return;
+		}
+		FileHeader header = { { 'L', 'M', 'A', 'P' }, this->size, layers, key };
+		file.write((const char*)&header, sizeof(header));
+		file.write((const char*)&rgbm[0], rgbm.size());
+	}
+};
@@ -0,0 +1,667 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "ClusteredLights.h"
+
+// Los rayos salen un poco por encima de la superficie para no chocar con ella misma
+const GLfloat LIGHTMAP_RAY_OFFSET = 0.02f;
+
+// Las luces de poste estan dentro de su bombilla: el rayo de sombra se detiene antes de llegar
+const GLfloat LIGHTMAP_LIGHT_CLEARANCE = 0.5f;
+
+// Triangulos por hoja del BVH y cajas en que se prueba cada corte (SAH)
+const GLuint LIGHTMAP_BVH_LEAF_SIZE = 4;
+const GLuint LIGHTMAP_BVH_BINS = 12;
+
+// Radio del filtro que quita el ruido del rebote (en texeles, dentro de cada region)
+const GLint LIGHTMAP_BOUNCE_FILTER = 2;
+
+// Triangulo de la escena estatica, ya en espacio de mundo
+struct LightmapTriangle
+{
+	glm::vec3 positions[3];
+	glm::vec3 normal;
+	glm::vec2 texels[3];	// Coordenadas en el atlas, en texeles
+	glm::vec3 albedo;		// Color difuso (promedio de la textura si tiene)
+};
+
+// Region rectangular del atlas que cubre una cara plana.
+// El texel (x, y) de la region (con un texel de borde) cae en
+// origin + s * axisU + t * axisV, s = (x - 0.5) / (width - 2), t = (y - 0.5) / (height - 2)
+struct LightmapChart
+{
+	GLint x, y;
+	GLint width, height;
+	glm::vec3 origin;
+	glm::vec3 axisU;
+	glm::vec3 axisV;
+	glm::vec3 normal;
+};
+
+// Luces que se hornean
+struct LightmapLighting
+{
+	std::vector<ClusterLight> lights;		// Postes (capa 0)
+	std::vector<glm::vec3> sunDirections;	// Una capa por direccion del sol (capas 1..n)
+	glm::vec3 sunDiffuse;					// El ambiente no se hornea: lo suma el shader (cambia con la hora)
+	GLuint bounceSamples;					// Rayos por texel para el rebote (0 = solo luz directa)
+};
+
+// Resultado del ultimo horneado
+struct LightmapBakeStats
+{
+	GLuint threads;
+	GLuint texels;
+	unsigned long long rays;
+	double directMs;
+	double bounceMs;
+};
+
+// Trazador de rayos en CPU para hornear lightmaps.
+// Los triangulos van en un BVH; cada hilo toma regiones del atlas de una cola comun (un contador atomico)
+// y calcula la luz en cada texel: directa con rayos de sombra hacia el sol y las luces,
+// y opcionalmente un rebote juntando la luz directa de lo que ven rayos en el hemisferio.
+// La salida es la irradiancia por capa (el shader la multiplica por el color de la superficie).
+class LightmapBaker
+{
+public:
+	// Constructor, construye el BVH de la escena
+	LightmapBaker(const std::vector<LightmapTriangle>& triangles, const std::vector<LightmapChart>& charts, GLint size)
+		: triangles(triangles), charts(charts), size(size), layerCount(0)
+	{
+		this->stats.threads = 0;
+		this->stats.texels = 0;
+		this->stats.rays = 0;
+		this->stats.directMs = 0.0;
+		this->stats.bounceMs = 0.0;
+
+		this->tris.resize(triangles.size());
+		std::vector<GLuint> order(triangles.size());
+		for (size_t i = 0; i < triangles.size(); i++)
+		{
+			Tri& tri = this->tris[i];
+			tri.v0 = triangles[i].positions[0];
+			tri.edge1 = triangles[i].positions[1] - tri.v0;
+			tri.edge2 = triangles[i].positions[2] - tri.v0;
+			tri.normal = triangles[i].normal;
+			order[i] = (GLuint)i;
+		}
+		if (!order.empty())
+		{
+			this->nodes.reserve(triangles.size() * 2);
+			this->build(order, 0, (GLuint)order.size());
+		}
+		// Los triangulos quedan en el orden de las hojas
+		std::vector<Tri> sorted(order.size());
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			sorted[i] = this->tris[order[i]];
+			sorted[i].source = order[i];
+		}
+		this->tris.swap(sorted);
+	}
+
+	// Hornea todas las capas; la salida es RGB flotante, capa tras capa (size * size texeles cada una)
+	std::vector<glm::vec3> Bake(const LightmapLighting& lighting, GLuint threadCount)
+	{
+		this->lighting = lighting;
+		this->layerCount = 1 + (GLuint)lighting.sunDirections.size();
+		GLuint layerTexels = (GLuint)(this->size * this->size);
+		this->direct.assign(layerTexels * this->layerCount, glm::vec3(0.0f));
+		this->result.assign(layerTexels * this->layerCount, glm::vec3(0.0f));
+
+		this->stats.threads = std::max(threadCount, 1u);
+		this->stats.texels = 0;
+		for (size_t i = 0; i < this->charts.size(); i++)
+		{
+			this->stats.texels += this->charts[i].width * this->charts[i].height;
+		}
+
+		// 1. Luz directa (el rebote la necesita completa, por eso va en otro paso)
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		unsigned long long rays = this->run(&LightmapBaker::bakeDirect);
+		std::chrono::high_resolution_clock::time_point middle = std::chrono::high_resolution_clock::now();
+
+		// 2. Rebote, filtrado y sumado a la directa
+		rays += this->run(&LightmapBaker::bakeBounce);
+		this->run(&LightmapBaker::resolve);
+		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+		this->stats.rays = rays;
+		this->stats.directMs = std::chrono::duration<double, std::milli>(middle - start).count();
+		this->stats.bounceMs = std::chrono::duration<double, std::milli>(end - middle).count();
+
+		this->direct.clear();
+		std::vector<glm::vec3> output;
+		output.swap(this->result);
+		return output;
+	}
+
+	const LightmapBakeStats& GetStats() const
+	{
+		return this->stats;
+	}
+
+private:
+	struct Tri
+	{
+		glm::vec3 v0;
+		glm::vec3 edge1;
+		glm::vec3 edge2;
+		glm::vec3 normal;
+		GLuint source; // Indice en triangles
+	};
+
+	// Nodo del BVH: si count > 0 es hoja (triangulos first..first+count), si no, hijos first y first + 1
+	struct Node
+	{
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+		GLuint first;
+		GLuint count;
+	};
+
+	typedef unsigned long long (LightmapBaker::*ChartFunction)(const LightmapChart& chart);
+
+	const std::vector<LightmapTriangle>& triangles;
+	const std::vector<LightmapChart>& charts;
+	GLint size;
+	GLuint layerCount;
+	std::vector<Tri> tris;
+	std::vector<Node> nodes;
+	LightmapLighting lighting;
+	std::vector<glm::vec3> direct;
+	std::vector<glm::vec3> result;
+	LightmapBakeStats stats;
+
+	// Reparte las regiones entre los hilos; regresa cuantos rayos se lanzaron
+	unsigned long long run(ChartFunction function)
+	{
+		std::atomic<GLuint> nextChart(0);
+		std::atomic<unsigned long long> rays(0);
+		std::vector<std::thread> workers;
+		for (GLuint t = 0; t < this->stats.threads; t++)
+		{
+			workers.push_back(std::thread([this, function, &nextChart, &rays]()
+			{
+				unsigned long long localRays = 0;
+				for (GLuint i = nextChart++; i < this->charts.size(); i = nextChart++)
+				{
+					localRays += (this->*function)(this->charts[i]);
+				}
+				rays += localRays;
+			}));
+		}
+		for (size_t t = 0; t < workers.size(); t++)
+		{
+			workers[t].join();
+		}
+		return rays;
+	}
+
+	// Punto de la superficie que le toca al texel (los del borde se pegan a la orilla de la cara)
+	glm::vec3 texelPosition(const LightmapChart& chart, GLint x, GLint y)
+	{
+		GLfloat innerWidth = (GLfloat)(chart.width - 2);
+		GLfloat innerHeight = (GLfloat)(chart.height - 2);
+		GLfloat s = glm::clamp((x - 0.5f) / innerWidth, 0.5f / innerWidth, 1.0f - 0.5f / innerWidth);
+		GLfloat t = glm::clamp((y - 0.5f) / innerHeight, 0.5f / innerHeight, 1.0f - 0.5f / innerHeight);
+		return chart.origin + s * chart.axisU + t * chart.axisV + chart.normal * LIGHTMAP_RAY_OFFSET;
+	}
+
+	unsigned long long bakeDirect(const LightmapChart& chart)
+	{
+		unsigned long long rays = 0;
+		GLuint layerTexels = (GLuint)(this->size * this->size);
+		for (GLint y = 0; y < chart.height; y++)
+		{
+			for (GLint x = 0; x < chart.width; x++)
+			{
+				glm::vec3 position = this->texelPosition(chart, x, y);
+				GLuint texel = (GLuint)((chart.y + y) * this->size + chart.x + x);
+
+				// Capa 0: postes (misma atenuacion que CalcPointLight, pero con sombra)
+				glm::vec3 lights(0.0f);
+				for (size_t i = 0; i < this->lighting.lights.size(); i++)
+				{
+					const ClusterLight& light = this->lighting.lights[i];
+					glm::vec3 toLight = light.position - position;
+					GLfloat distance = glm::length(toLight);
+					if (distance >= light.radius)
+					{
+						continue;
+					}
+					GLfloat attenuation = 1.0f / (light.constant + light.linear * distance + light.quadratic * distance * distance);
+					GLfloat falloff = glm::clamp(1.0f - std::pow(distance / light.radius, 4.0f), 0.0f, 1.0f);
+					attenuation *= falloff * falloff;
+
+					glm::vec3 contribution = light.ambient;
+					glm::vec3 lightDir = toLight / distance;
+					GLfloat diff = glm::dot(chart.normal, lightDir);
+					if (diff > 0.0f)
+					{
+						rays++;
+						if (!this->occluded(position, lightDir, distance - LIGHTMAP_LIGHT_CLEARANCE))
+						{
+							contribution += light.diffuse * diff;
+						}
+					}
+					lights += contribution * attenuation;
+				}
+				this->direct[texel] = lights;
+
+				// Capas 1..n: el sol en cada direccion
+				for (GLuint s = 0; s < this->lighting.sunDirections.size(); s++)
+				{
+					glm::vec3 lightDir = -glm::normalize(this->lighting.sunDirections[s]);
+					GLfloat diff = glm::dot(chart.normal, lightDir);
+					glm::vec3 sun(0.0f);
+					if (diff > 0.0f)
+					{
+						rays++;
+						if (!this->occluded(position, lightDir, FLT_MAX))
+						{
+							sun = this->lighting.sunDiffuse * diff;
+						}
+					}
+					this->direct[(s + 1) * layerTexels + texel] = sun;
+				}
+			}
+		}
+		return rays;
+	}
+
+	unsigned long long bakeBounce(const LightmapChart& chart)
+	{
+		unsigned long long rays = 0;
+		GLuint layerTexels = (GLuint)(this->size * this->size);
+		glm::vec3 tangent = glm::normalize(chart.axisU);
+		glm::vec3 bitangent = glm::cross(chart.normal, tangent);
+		std::vector<glm::vec3> gathered(this->layerCount);
+
+		for (GLint y = 0; y < chart.height; y++)
+		{
+			for (GLint x = 0; x < chart.width; x++)
+			{
+				GLuint texel = (GLuint)((chart.y + y) * this->size + chart.x + x);
+				std::fill(gathered.begin(), gathered.end(), glm::vec3(0.0f));
+
+				if (this->lighting.bounceSamples > 0)
+				{
+					glm::vec3 position = this->texelPosition(chart, x, y);
+					GLuint seed = texel * 9781u + 6271u;
+					for (GLuint i = 0; i < this->lighting.bounceSamples; i++)
+					{
+						// Direccion con distribucion coseno: el promedio ya es la irradiancia
+						GLfloat u1 = random(seed);
+						GLfloat u2 = random(seed);
+						GLfloat r = std::sqrt(u1);
+						GLfloat phi = 6.2831853f * u2;
+						glm::vec3 dir = tangent * (r * std::cos(phi)) + bitangent * (r * std::sin(phi)) + chart.normal * std::sqrt(1.0f - u1);
+
+						rays++;
+						GLuint hitTexel;
+						glm::vec3 albedo;
+						if (this->trace(position, dir, hitTexel, albedo))
+						{
+							for (GLuint layer = 0; layer < this->layerCount; layer++)
+							{
+								gathered[layer] += albedo * this->direct[layer * layerTexels + hitTexel];
+							}
+						}
+					}
+					for (GLuint layer = 0; layer < this->layerCount; layer++)
+					{
+						gathered[layer] /= (GLfloat)this->lighting.bounceSamples;
+					}
+				}
+
+				for (GLuint layer = 0; layer < this->layerCount; layer++)
+				{
+					this->result[layer * layerTexels + texel] = gathered[layer];
+				}
+			}
+		}
+		return rays;
+	}
+
+	// Con pocos rayos el rebote sale granulado: se promedia con sus vecinos de la misma region
+	// (la luz indirecta cambia despacio) y se suma a la directa
+	unsigned long long resolve(const LightmapChart& chart)
+	{
+		GLuint layerTexels = (GLuint)(this->size * this->size);
+		std::vector<glm::vec3> filtered(chart.width * chart.height);
+		for (GLuint layer = 0; layer < this->layerCount; layer++)
+		{
+			glm::vec3* indirect = &this->result[layer * layerTexels];
+			for (GLint y = 0; y < chart.height; y++)
+			{
+				for (GLint x = 0; x < chart.width; x++)
+				{
+					glm::vec3 sum(0.0f);
+					GLint count = 0;
+					for (GLint dy = std::max(y - LIGHTMAP_BOUNCE_FILTER, 0); dy <= std::min(y + LIGHTMAP_BOUNCE_FILTER, chart.height - 1); dy++)
+					{
+						for (GLint dx = std::max(x - LIGHTMAP_BOUNCE_FILTER, 0); dx <= std::min(x + LIGHTMAP_BOUNCE_FILTER, chart.width - 1); dx++)
+						{
+							sum += indirect[(chart.y + dy) * this->size + chart.x + dx];
+							count++;
+						}
+					}
+					filtered[y * chart.width + x] = sum / (GLfloat)count;
+				}
+			}
+			for (GLint y = 0; y < chart.height; y++)
+			{
+				for (GLint x = 0; x < chart.width; x++)
+				{
+					GLuint texel = layer * layerTexels + (chart.y + y) * this->size + chart.x + x;
+					this->result[texel] = this->direct[texel] + filtered[y * chart.width + x];
+				}
+			}
+		}
+		return 0;
+	}
+
+	// xorshift, cada texel tiene su semilla para que el resultado no dependa de los hilos
+	static GLfloat random(GLuint& state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return (state & 0xFFFFFF) / 16777216.0f;
+	}
+
+	// --- BVH ---
+
+	void build(std::vector<GLuint>& order, GLuint first, GLuint count)
+	{
+		GLuint nodeIndex = (GLuint)this->nodes.size();
+		this->nodes.push_back(Node());
+		this->buildNode(order, nodeIndex, first, count);
+	}
+
+	void buildNode(std::vector<GLuint>& order, GLuint nodeIndex, GLuint first, GLuint count)
+	{
+		glm::vec3 boundsMin(FLT_MAX), boundsMax(-FLT_MAX);
+		glm::vec3 centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+		for (GLuint i = first; i < first + count; i++)
+		{
+			const LightmapTriangle& tri = this->triangles[order[i]];
+			for (GLuint v = 0; v < 3; v++)
+			{
+				boundsMin = glm::min(boundsMin, tri.positions[v]);
+				boundsMax = glm::max(boundsMax, tri.positions[v]);
+			}
+			centroidMin = glm::min(centroidMin, this->centroid(order[i]));
+			centroidMax = glm::max(centroidMax, this->centroid(order[i]));
+		}
+		this->nodes[nodeIndex].boundsMin = boundsMin;
+		this->nodes[nodeIndex].boundsMax = boundsMax;
+
+		if (count <= LIGHTMAP_BVH_LEAF_SIZE)
+		{
+			this->nodes[nodeIndex].first = first;
+			this->nodes[nodeIndex].count = count;
+			return;
+		}
+
+		// Corte con el menor costo de superficie (SAH), probando LIGHTMAP_BVH_BINS cajas por eje
+		GLuint middle = this->splitSAH(order, first, count, centroidMin, centroidMax);
+		if (middle == first || middle == first + count)
+		{
+			middle = first + count / 2;
+		}
+
+		// Los dos hijos van juntos
+		GLuint left = (GLuint)this->nodes.size();
+		this->nodes.push_back(Node());
+		this->nodes.push_back(Node());
+		this->nodes[nodeIndex].first = left;
+		this->nodes[nodeIndex].count = 0;
+		this->buildNode(order, left, first, middle - first);
+		this->buildNode(order, left + 1, middle, first + count - middle);
+	}
+
+	glm::vec3 centroid(GLuint triangle) const
+	{
+		const LightmapTriangle& tri = this->triangles[triangle];
+		return (tri.positions[0] + tri.positions[1] + tri.positions[2]) / 3.0f;
+	}
+
+	static GLfloat area(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+	{
+		glm::vec3 extent = glm::max(boundsMax - boundsMin, glm::vec3(0.0f));
+		return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+	}
+
+	// Acomoda order[first..first+count) y regresa donde empieza el hijo derecho
+	GLuint splitSAH(std::vector<GLuint>& order, GLuint first, GLuint count, const glm::vec3& centroidMin, const glm::vec3& centroidMax)
+	{
+		GLfloat bestCost = FLT_MAX;
+		int bestAxis = -1;
+		GLuint bestBin = 0;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			GLfloat extent = centroidMax[axis] - centroidMin[axis];
+			if (extent <= 1e-6f)
+			{
+				continue;
+			}
+			glm::vec3 binMin[LIGHTMAP_BVH_BINS], binMax[LIGHTMAP_BVH_BINS];
+			GLuint binCount[LIGHTMAP_BVH_BINS];
+			for (GLuint b = 0; b < LIGHTMAP_BVH_BINS; b++)
+			{
+				binMin[b] = glm::vec3(FLT_MAX);
+				binMax[b] = glm::vec3(-FLT_MAX);
+				binCount[b] = 0;
+			}
+			for (GLuint i = first; i < first + count; i++)
+			{
+				GLuint b = std::min((GLuint)((this->centroid(order[i])[axis] - centroidMin[axis]) / extent * LIGHTMAP_BVH_BINS), LIGHTMAP_BVH_BINS - 1);
+				const LightmapTriangle& tri = this->triangles[order[i]];
+				for (GLuint v = 0; v < 3; v++)
+				{
+					binMin[b] = glm::min(binMin[b], tri.positions[v]);
+					binMax[b] = glm::max(binMax[b], tri.positions[v]);
+				}
+				binCount[b]++;
+			}
+
+			// Costo de cortar despues de cada caja: area de cada lado por sus triangulos
+			GLfloat rightArea[LIGHTMAP_BVH_BINS];
+			GLuint rightCount[LIGHTMAP_BVH_BINS];
+			glm::vec3 boxMin(FLT_MAX), boxMax(-FLT_MAX);
+			GLuint total = 0;
+			for (GLuint b = LIGHTMAP_BVH_BINS - 1; b > 0; b--)
+			{
+				boxMin = glm::min(boxMin, binMin[b]);
+				boxMax = glm::max(boxMax, binMax[b]);
+				total += binCount[b];
+				rightArea[b] = area(boxMin, boxMax);
+				rightCount[b] = total;
+			}
+			boxMin = glm::vec3(FLT_MAX);
+			boxMax = glm::vec3(-FLT_MAX);
+			total = 0;
+			for (GLuint b = 0; b + 1 < LIGHTMAP_BVH_BINS; b++)
+			{
+				boxMin = glm::min(boxMin, binMin[b]);
+				boxMax = glm::max(boxMax, binMax[b]);
+				total += binCount[b];
+				if (total == 0 || rightCount[b + 1] == 0)
+				{
+					continue;
+				}
+				GLfloat cost = area(boxMin, boxMax) * total + rightArea[b + 1] * rightCount[b + 1];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = b;
+				}
+			}
+		}
+		if (bestAxis < 0)
+		{
+			return first;
+		}
+
+		GLfloat extent = centroidMax[bestAxis] - centroidMin[bestAxis];
+		std::vector<GLuint>::iterator middle = std::partition(order.begin() + first, order.begin() + first + count,
+			[this, bestAxis, bestBin, &centroidMin, extent](GLuint triangle)
+			{
+				GLuint b = std::min((GLuint)((this->centroid(triangle)[bestAxis] - centroidMin[bestAxis]) / extent * LIGHTMAP_BVH_BINS), LIGHTMAP_BVH_BINS - 1);
+				return b <= bestBin;
+			});
+		return (GLuint)(middle - order.begin());
+	}
+
+	static bool hitBox(const Node& node, const glm::vec3& origin, const glm::vec3& invDir, GLfloat maxDistance)
+	{
+		glm::vec3 t0 = (node.boundsMin - origin) * invDir;
+		glm::vec3 t1 = (node.boundsMax - origin) * invDir;
+		glm::vec3 tNear = glm::min(t0, t1);
+		glm::vec3 tFar = glm::max(t0, t1);
+		GLfloat enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+		GLfloat exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+		return enter <= exit;
+	}
+
+	// Moller-Trumbore; regresa la distancia (o -1) y las coordenadas baricentricas
+	static GLfloat hitTriangle(const Tri& tri, const glm::vec3& origin, const glm::vec3& dir, GLfloat& u, GLfloat& v)
+	{
+		glm::vec3 p = glm::cross(dir, tri.edge2);
+		GLfloat det = glm::dot(tri.edge1, p);
+		if (std::fabs(det) < 1e-9f)
+		{
+			return -1.0f;
+		}
+		GLfloat invDet = 1.0f / det;
+		glm::vec3 s = origin - tri.v0;
+		u = glm::dot(s, p) * invDet;
+		if (u < 0.0f || u > 1.0f)
+		{
+			return -1.0f;
+		}
+		glm::vec3 q = glm::cross(s, tri.edge1);
+		v = glm::dot(dir, q) * invDet;
+		if (v < 0.0f || u + v > 1.0f)
+		{
+			return -1.0f;
+		}
+		return glm::dot(tri.edge2, q) * invDet;
+	}
+
+	// Rayo de sombra: basta con cualquier choque antes de maxDistance
+	bool occluded(const glm::vec3& origin, const glm::vec3& dir, GLfloat maxDistance)
+	{
+		if (this->nodes.empty() || maxDistance <= 0.0f)
+		{
+			return false;
+		}
+		glm::vec3 invDir = 1.0f / dir;
+		GLuint stack[64];
+		GLuint top = 0;
+		stack[top++] = 0;
+		while (top > 0)
+		{
+			const Node& node = this->nodes[stack[--top]];
+			if (!hitBox(node, origin, invDir, maxDistance))
+			{
+				continue;
+			}
+			if (node.count > 0)
+			{
+				for (GLuint i = node.first; i < node.first + node.count; i++)
+				{
+					GLfloat u, v;
+					GLfloat t = hitTriangle(this->tris[i], origin, dir, u, v);
+					if (t > 0.0f && t < maxDistance)
+					{
+						return true;
+					}
+				}
+			}
+			else
+			{
+				stack[top++] = node.first;
+				stack[top++] = node.first + 1;
+			}
+		}
+		return false;
+	}
+
+	// Choque mas cercano; regresa el texel del atlas donde pego y el color de la superficie.
+	// Si pega por detras (dentro de un objeto) no cuenta.
+	bool trace(const glm::vec3& origin, const glm::vec3& dir, GLuint& texel, glm::vec3& albedo)
+	{
+		if (this->nodes.empty())
+		{
+			return false;
+		}
+		glm::vec3 invDir = 1.0f / dir;
+		GLfloat closest = FLT_MAX;
+		GLint hit = -1;
+		GLfloat hitU = 0.0f, hitV = 0.0f;
+		GLuint stack[64];
+		GLuint top = 0;
+		stack[top++] = 0;
+		while (top > 0)
+		{
+			const Node& node = this->nodes[stack[--top]];
+			if (!hitBox(node, origin, invDir, closest))
+			{
+				continue;
+			}
+			if (node.count > 0)
+			{
+				for (GLuint i = node.first; i < node.first + node.count; i++)
+				{
+					GLfloat u, v;
+					GLfloat t = hitTriangle(this->tris[i], origin, dir, u, v);
+					if (t > 0.0f && t < closest)
+					{
+						closest = t;
+						hit = (GLint)i;
+						hitU = u;
+						hitV = v;
+					}
+				}
+			}
+			else
+			{
+				// El hijo mas cercano se revisa primero, asi el choque acota antes al otro
+				const Node& left = this->nodes[node.first];
+				const Node& right = this->nodes[node.first + 1];
+				bool leftFirst = glm::dot(left.boundsMin + left.boundsMax - right.boundsMin - right.boundsMax, dir) < 0.0f;
+				stack[top++] = leftFirst ? node.first + 1 : node.first;
+				stack[top++] = leftFirst ? node.first : node.first + 1;
+			}
+		}
+		if (hit < 0 || glm::dot(this->tris[hit].normal, dir) > 0.0f)
+		{
+			return false;
+		}
+
+		const LightmapTriangle& tri = this->triangles[this->tris[hit].source];
+		glm::vec2 coords = tri.texels[0] * (1.0f - hitU - hitV) + tri.texels[1] * hitU + tri.texels[2] * hitV;
+		GLint x = glm::clamp((GLint)coords.x, 0, this->size - 1);
+		GLint y = glm::clamp((GLint)coords.y, 0, this->size - 1);
+		texel = (GLuint)(y * this->size + x);
+		albedo = tri.albedo;
+		return true;
+	}
+};
@@ -29,6 +29,17 @@ struct Vertex
 	glm::vec2 TexCoords;
 };
 
+// Maximum number of bones that can move a single vertex (matches ivec4/vec4 in the skinned shaders)
+const GLuint MAX_BONE_INFLUENCE = 4;
+
+struct VertexBoneData
+{
+	// Skeleton joints that move this vertex
+	GLint IDs[MAX_BONE_INFLUENCE];
+	// Weight of each joint (they add up to 1, unused slots are 0)
+	GLfloat Weights[MAX_BONE_INFLUENCE];
+};
+
 struct Texture
 {
 	GLuint id;
@@ -43,46 +54,33 @@ public:
 	vector<Vertex> vertices;
 	vector<GLuint> indices;
 	vector<Texture> textures;
+	vector<VertexBoneData> bones;	// Empty unless the mesh is skinned
 
 	/*  Functions  */
 	// Constructor
-	Mesh(vector<Vertex> vertices, vector<GLuint> indices, vector<Texture> textures)
+	Mesh(vector<Vertex> vertices, vector<GLuint> indices, vector<Texture> textures, vector<VertexBoneData> bones = vector<VertexBoneData>())
 	{
 		this->vertices = vertices;
 		this->indices = indices;
 		this->textures = textures;
+		this->bones = bones;
+
+		// Sampler names only depend on the textures, so build them once instead of every draw
+		this->setupSamplerNames();
 
 		// Now that we have all the required data, set the vertex buffers and its attribute pointers.
 		this->setupMesh();
 	}
 
-	// Render the mesh
-	void Draw(Shader shader)
+	// Render the mesh (instanceCount copies; the shader tells them apart with gl_InstanceID)
+	void Draw(Shader &shader, GLsizei instanceCount = 1)
 	{
 		// Bind appropriate textures
-		GLuint diffuseNr = 1;
-		GLuint specularNr = 1;
-
 		for (GLuint i = 0; i < this->textures.size(); i++)
 		{
 			glActiveTexture(GL_TEXTURE0 + i); // Active proper texture unit before binding
-											  // Retrieve texture number (the N in diffuse_textureN)
-			stringstream ss;
-			string number;
-			string name = this->textures[i].type;
-
-			if (name == "texture_diffuse")
-			{
-				ss << diffuseNr++; // Transfer GLuint to stream
-			}
-			else if (name == "texture_specular")
-			{
-				ss << specularNr++; // Transfer GLuint to stream
-			}
-
-			number = ss.str();
 			// Now set the sampler to the correct texture unit
-			glUniform1i(glGetUniformLocation(shader.Program, (name + number).c_str()), i);
+			glUniform1i(glGetUniformLocation(shader.Program, this->samplerNames[i].c_str()), i);
 			// And finally bind the texture
 			glBindTexture(GL_TEXTURE_2D, this->textures[i].id);
 		}
@@ -92,7 +90,14 @@ public:
 
 		// Draw mesh
 		glBindVertexArray(this->VAO);
-		glDrawElements(GL_TRIANGLES, this->indices.size(), GL_UNSIGNED_INT, 0);
+		if (instanceCount == 1)
+		{
+			glDrawElements(GL_TRIANGLES, this->indices.size(), GL_UNSIGNED_INT, 0);
+		}
+		else
+		{
+			glDrawElementsInstanced(GL_TRIANGLES, this->indices.size(), GL_UNSIGNED_INT, 0, instanceCount);
+		}
 		glBindVertexArray(0);
 
 		// Always good practice to set everything back to defaults once configured.
@@ -106,8 +111,34 @@ public:
 private:
 	/*  Render data  */
 	GLuint VAO, VBO, EBO;
+	GLuint BoneVBO;	// Bone ids and weights, in their own buffer so the Vertex layout stays the same
+	vector<string> samplerNames;	// Uniform name of each texture (texture_diffuseN, texture_specularN)
 
 	/*  Functions    */
+	// Names each texture's sampler: its type plus the N of that type (the N in texture_diffuseN)
+	void setupSamplerNames()
+	{
+		GLuint diffuseNr = 1;
+		GLuint specularNr = 1;
+
+		for (GLuint i = 0; i < this->textures.size(); i++)
+		{
+			stringstream ss;
+			string name = this->textures[i].type;
+
+			if (name == "texture_diffuse")
+			{
+				ss << diffuseNr++; // Transfer GLuint to stream
+			}
+			else if (name == "texture_specular")
+			{
+				ss << specularNr++; // Transfer GLuint to stream
+			}
+
+			this->samplerNames.push_back(name + ss.str());
+		}
+	}
+
 	// Initializes all the buffer objects/arrays
 	void setupMesh()
 	{
@@ -138,6 +169,21 @@ private:
 		glEnableVertexAttribArray(2);
 		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid *)offsetof(Vertex, TexCoords));
 
+		// Bone data (only skinned meshes, read by the SKINNED shader variants)
+		this->BoneVBO = 0;
+		if (!this->bones.empty())
+		{
+			glGenBuffers(1, &this->BoneVBO);
+			glBindBuffer(GL_ARRAY_BUFFER, this->BoneVBO);
+			glBufferData(GL_ARRAY_BUFFER, this->bones.size() * sizeof(VertexBoneData), &this->bones[0], GL_STATIC_DRAW);
+			// Bone ids (integer attribute)
+			glEnableVertexAttribArray(3);
+			glVertexAttribIPointer(3, MAX_BONE_INFLUENCE, GL_INT, sizeof(VertexBoneData), (GLvoid *)offsetof(VertexBoneData, IDs));
+			// Bone weights
+			glEnableVertexAttribArray(4);
+			glVertexAttribPointer(4, MAX_BONE_INFLUENCE, GL_FLOAT, GL_FALSE, sizeof(VertexBoneData), (GLvoid *)offsetof(VertexBoneData, Weights));
+		}
+
 		glBindVertexArray(0);
 	}
 };
\ No newline at end of file
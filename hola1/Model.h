@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -10,6 +11,7 @@
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
 
 // --- CORRECCIONES ---
 // #include "SOIL2/SOIL2.h" // <--- ELIMINADO
@@ -22,11 +24,14 @@
 
 #include "Mesh.h"
 #include "Shader.h"
+#include "Animation.h"
 
 using namespace std;
 
 // Prototipo de la funcin (movido arriba para que la clase Model la vea)
 GLint TextureFromFile(const char* path, string directory);
+GLint TextureFromEmbedded(const aiTexture* texture);
+GLint TextureFromPixels(unsigned char* image, int width, int height, int nrChannels);
 
 class Model
 {
@@ -35,24 +40,61 @@ public:
 	// Constructor, expects a filepath to a 3D model.
 	// --- CORRECCIN --- (Cambiado GLchar* a string para que sea ms fcil de usar)
 	Model(string path)
+		: skinned(false)
 	{
 		this->loadModel(path);
 	}
 
 	// Draws the model, and thus all its meshes
-	void Draw(Shader shader)
+	void Draw(Shader &shader, GLsizei instanceCount = 1)
 	{
 		for (GLuint i = 0; i < this->meshes.size(); i++)
 		{
-			this->meshes[i].Draw(shader);
+			this->meshes[i].Draw(shader, instanceCount);
 		}
 	}
 
+	GLuint GetMeshCount() const
+	{
+		return (GLuint)this->meshes.size();
+	}
+
+	// Meshes in the order they are drawn (e.g. to bake their vertices, see VertexAnimation.h)
+	Mesh& GetMesh(GLuint index)
+	{
+		return this->meshes[index];
+	}
+
+	const Mesh& GetMesh(GLuint index) const
+	{
+		return this->meshes[index];
+	}
+
+	// True if any mesh is skinned; its SKINNED shader variant needs a bone palette (see Animation.h)
+	bool HasSkeleton() const
+	{
+		return this->skinned;
+	}
+
+	const Skeleton& GetSkeleton() const
+	{
+		return this->skeleton;
+	}
+
+	// Animations of the model, resampled at load time
+	const vector<AnimationClip>& GetClips() const
+	{
+		return this->clips;
+	}
+
 private:
 	/* Model Data  */
 	vector<Mesh> meshes;
 	string directory;
 	vector<Texture> textures_loaded;	// Stores all the textures loaded so far, optimization to make sure textures aren't loaded more than once.
+	Skeleton skeleton;					// One joint per node of the scene
+	vector<AnimationClip> clips;
+	bool skinned;
 
 	/* Functions   */
 	// Loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
@@ -60,7 +102,7 @@ private:
 	{
 		// Read file via ASSIMP
 		Assimp::Importer importer;
-		const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+		const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_LimitBoneWeights);
 
 		// Check for errors
 		if (!scene || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
@@ -71,8 +113,131 @@ private:
 		// Retrieve the directory path of the filepath
 		this->directory = path.substr(0, path.find_last_of('/'));
 
+		// Every node can be a joint: build the skeleton first so the meshes can find their bones
+		this->buildSkeleton(scene->mRootNode, -1);
+		this->skeleton.globalInverse = glm::inverse(toGlm(scene->mRootNode->mTransformation));
+
 		// Process ASSIMP's root node recursively
 		this->processNode(scene->mRootNode, scene);
+
+		if (this->skinned)
+		{
+			this->loadAnimations(scene);
+		}
+		else
+		{
+			this->skeleton = Skeleton();
+		}
+	}
+
+	// Adds the node and its children to the skeleton (preorder, so parents come before their children)
+	void buildSkeleton(aiNode* node, GLint parent)
+	{
+		GLint joint = this->skeleton.AddJoint(node->mName.C_Str(), parent, toGlm(node->mTransformation));
+
+		for (GLuint i = 0; i < node->mNumChildren; i++)
+		{
+			this->buildSkeleton(node->mChildren[i], joint);
+		}
+	}
+
+	// Resamples every animation of the scene at ANIMATION_SAMPLE_RATE, so playing it back is just
+	// blending two consecutive frames (see AnimationClip)
+	void loadAnimations(const aiScene* scene)
+	{
+		GLuint jointCount = this->skeleton.Count();
+
+		for (GLuint i = 0; i < scene->mNumAnimations; i++)
+		{
+			aiAnimation* animation = scene->mAnimations[i];
+			double ticksPerSecond = animation->mTicksPerSecond != 0.0 ? animation->mTicksPerSecond : 25.0;
+
+			AnimationClip clip;
+			clip.name = animation->mName.C_Str();
+			clip.Resize(jointCount, (GLfloat)(animation->mDuration / ticksPerSecond));
+
+			// Channel that moves each joint (joints without one keep their bind pose)
+			vector<aiNodeAnim*> channels(jointCount, (aiNodeAnim*)0);
+			for (GLuint c = 0; c < animation->mNumChannels; c++)
+			{
+				GLint joint = this->skeleton.Find(animation->mChannels[c]->mNodeName.C_Str());
+				if (joint >= 0)
+				{
+					channels[joint] = animation->mChannels[c];
+				}
+			}
+
+			for (GLuint f = 0; f < clip.frameCount; f++)
+			{
+				double time = clip.FrameTime(f) * ticksPerSecond;
+				for (GLuint j = 0; j < jointCount; j++)
+				{
+					glm::vec3 translation = this->skeleton.bindTranslation[j];
+					glm::quat rotation = this->skeleton.bindRotation[j];
+					glm::vec3 scale = this->skeleton.bindScale[j];
+					aiNodeAnim* channel = channels[j];
+					if (channel)
+					{
+						translation = sampleKeys(channel->mPositionKeys, channel->mNumPositionKeys, time, translation);
+						rotation = sampleKeys(channel->mRotationKeys, channel->mNumRotationKeys, time, rotation);
+						scale = sampleKeys(channel->mScalingKeys, channel->mNumScalingKeys, time, scale);
+					}
+					clip.SetJoint(f, j, translation, rotation, scale);
+				}
+			}
+
+			this->clips.push_back(clip);
+		}
+	}
+
+	// Interpolates the position/scale keys at a given time (in ticks)
+	static glm::vec3 sampleKeys(const aiVectorKey* keys, GLuint count, double time, const glm::vec3& fallback)
+	{
+		if (count == 0)
+		{
+			return fallback;
+		}
+		GLuint i = 0;
+		while (i + 1 < count && keys[i + 1].mTime <= time)
+		{
+			i++;
+		}
+		glm::vec3 a(keys[i].mValue.x, keys[i].mValue.y, keys[i].mValue.z);
+		if (i + 1 >= count || time <= keys[i].mTime)
+		{
+			return a;
+		}
+		glm::vec3 b(keys[i + 1].mValue.x, keys[i + 1].mValue.y, keys[i + 1].mValue.z);
+		GLfloat t = (GLfloat)((time - keys[i].mTime) / (keys[i + 1].mTime - keys[i].mTime));
+		return glm::mix(a, b, t);
+	}
+
+	// Interpolates the rotation keys at a given time (in ticks)
+	static glm::quat sampleKeys(const aiQuatKey* keys, GLuint count, double time, const glm::quat& fallback)
+	{
+		if (count == 0)
+		{
+			return fallback;
+		}
+		GLuint i = 0;
+		while (i + 1 < count && keys[i + 1].mTime <= time)
+		{
+			i++;
+		}
+		glm::quat a(keys[i].mValue.w, keys[i].mValue.x, keys[i].mValue.y, keys[i].mValue.z);
+		if (i + 1 >= count || time <= keys[i].mTime)
+		{
+			return glm::normalize(a);
+		}
+		glm::quat b(keys[i + 1].mValue.w, keys[i + 1].mValue.x, keys[i + 1].mValue.y, keys[i + 1].mValue.z);
+		GLfloat t = (GLfloat)((time - keys[i].mTime) / (keys[i + 1].mTime - keys[i].mTime));
+		return glm::normalize(glm::slerp(a, b, t));
+	}
+
+	// ASSIMP matrices are row-major, glm's are column-major
+	static glm::mat4 toGlm(const aiMatrix4x4& matrix)
+	{
+		return glm::transpose(glm::make_mat4(&matrix.a1));
 	}
 
 	// Processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
@@ -161,21 +326,75 @@ private:
 			// Normal: texture_normalN
 
 			// 1. Diffuse maps
-			vector<Texture> diffuseMaps = this->loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
+			vector<Texture> diffuseMaps = this->loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", scene);
 			textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
 
 			// 2. Specular maps
-			vector<Texture> specularMaps = this->loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
+			vector<Texture> specularMaps = this->loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", scene);
 			textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
 		}
 
+		// Bone weights: keep the MAX_BONE_INFLUENCE strongest bones of each vertex and normalize them
+		vector<VertexBoneData> bones;
+		if (mesh->HasBones())
+		{
+			VertexBoneData none = {};
+			bones.assign(mesh->mNumVertices, none);
+
+			for (GLuint i = 0; i < mesh->mNumBones; i++)
+			{
+				aiBone* bone = mesh->mBones[i];
+				GLint joint = this->skeleton.Find(bone->mName.C_Str());
+				if (joint < 0)
+				{
+					continue;
+				}
+				this->skeleton.inverseBind[joint] = toGlm(bone->mOffsetMatrix);
+
+				for (GLuint j = 0; j < bone->mNumWeights; j++)
+				{
+					VertexBoneData& data = bones[bone->mWeights[j].mVertexId];
+					// Replace the weakest slot
+					GLuint slot = 0;
+					for (GLuint k = 1; k < MAX_BONE_INFLUENCE; k++)
+					{
+						if (data.Weights[k] < data.Weights[slot])
+						{
+							slot = k;
+						}
+					}
+					if (bone->mWeights[j].mWeight > data.Weights[slot])
+					{
+						data.IDs[slot] = joint;
+						data.Weights[slot] = bone->mWeights[j].mWeight;
+					}
+				}
+			}
+
+			for (GLuint i = 0; i < bones.size(); i++)
+			{
+				GLfloat sum = 0.0f;
+				for (GLuint k = 0; k < MAX_BONE_INFLUENCE; k++)
+				{
+					sum += bones[i].Weights[k];
+				}
+				for (GLuint k = 0; sum > 0.0f && k < MAX_BONE_INFLUENCE; k++)
+				{
+					bones[i].Weights[k] /= sum;
+				}
+			}
+
+			this->skinned = true;
+		}
+
 		// Return a mesh object created from the extracted mesh data
-		return Mesh(vertices, indices, textures);
+		return Mesh(vertices, indices, textures, bones);
 	}
 
 	// Checks all material textures of a given type and loads the textures if they're not loaded yet.
 	// The required info is returned as a Texture struct.
-	vector<Texture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, string typeName)
+	// Embedded textures (glb) come as "*N", the index in the scene's texture array.
+	vector<Texture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, string typeName, const aiScene* scene)
 	{
 		vector<Texture> textures;
 
@@ -201,7 +420,15 @@ private:
 			if (!skip)
 			{   // If texture hasn't been loaded already, load it
 				Texture texture;
-				texture.id = TextureFromFile(str.C_Str(), this->directory);
+				GLuint embedded = (GLuint)atoi(str.C_Str() + 1);
+				if (str.C_Str()[0] == '*' && embedded < scene->mNumTextures)
+				{
+					texture.id = TextureFromEmbedded(scene->mTextures[embedded]);
+				}
+				else
+				{
+					texture.id = TextureFromFile(str.C_Str(), this->directory);
+				}
 				texture.type = typeName;
 				texture.path = str;
 				textures.push_back(texture);
@@ -219,13 +446,63 @@ GLint TextureFromFile(const char* path, string directory)
 	//Generate texture ID and load texture data
 	string filename = string(path);
 	filename = directory + '/' + filename;
-	GLuint textureID;
-	glGenTextures(1, &textureID);
 
 	// --- CORRECCIN: Usando stb_image en lugar de SOIL ---
 	int width, height, nrChannels;
 	unsigned char* image = stbi_load(filename.c_str(), &width, &height, &nrChannels, 0);
 
+	if (!image)
+	{
+		std::cout << "Failed to load texture at path: " << filename << std::endl;
+	}
+
+	GLint textureID = TextureFromPixels(image, width, height, nrChannels);
+	stbi_image_free(image);
+
+	return textureID;
+}
+
+GLint TextureFromEmbedded(const aiTexture* texture)
+{
+	int width, height, nrChannels;
+	unsigned char* image;
+
+	if (texture->mHeight == 0)
+	{
+		// Compressed file (png, jpg...) kept in memory, mWidth is its size in bytes
+		image = stbi_load_from_memory((const unsigned char*)texture->pcData, (int)texture->mWidth, &width, &height, &nrChannels, 0);
+		if (!image)
+		{
+			std::cout << "Failed to load embedded texture" << std::endl;
+		}
+	}
+	else
+	{
+		// Raw BGRA texels
+		width = (int)texture->mWidth;
+		height = (int)texture->mHeight;
+		nrChannels = 4;
+		image = (unsigned char*)malloc(width * height * 4);
+		for (int i = 0; i < width * height; i++)
+		{
+			image[i * 4 + 0] = texture->pcData[i].r;
+			image[i * 4 + 1] = texture->pcData[i].g;
+			image[i * 4 + 2] = texture->pcData[i].b;
+			image[i * 4 + 3] = texture->pcData[i].a;
+		}
+	}
+
+	GLint textureID = TextureFromPixels(image, width, height, nrChannels);
+	stbi_image_free(image);
+
+	return textureID;
+}
+
+GLint TextureFromPixels(unsigned char* image, int width, int height, int nrChannels)
+{
+	GLuint textureID;
+	glGenTextures(1, &textureID);
+
 	// Assign texture to ID
 	glBindTexture(GL_TEXTURE_2D, textureID);
 
@@ -249,10 +526,6 @@ GLint TextureFromFile(const char* path, string directory)
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	}
-	else
-	{
-		std::cout << "Failed to load texture at path: " << filename << std::endl;
-	}
 
 	glBindTexture(GL_TEXTURE_2D, 0);
 	
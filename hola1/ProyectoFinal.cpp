@@ -1,5 +1,6 @@
 #include <iostream>
 #include <string>
+#include <vector>
 #include <cstdlib> // Para rand()
 #include <ctime>   // Para time()
 
@@ -10,9 +11,37 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Arena del cuadro (va primero: en debug este archivo reemplaza new/delete globales para contar
+// cuánta memoria se pide al heap en cada cuadro; en release se enciende definiendo FRAME_ARENA_CENSUS)
+#if defined(_DEBUG) && !defined(FRAME_ARENA_CENSUS)
+#define FRAME_ARENA_CENSUS
+#endif
+#include "FrameArena.h"
+
 // Shaders, Modelos y Texturas
 #include "Shader.h"
 #include "Model.h"
+#include "FrameCapture.h"
+#include "ClusteredLights.h"
+#include "GBuffer.h"
+#include "GpuProfiler.h"
+#include "ShadowCascades.h"
+#include "ShaderVariants.h"
+#include "ShaderWatcher.h"
+#include "Lightmap.h"
+#include "Atmosphere.h"
+#include "Animation.h"
+#include "AnimationCompression.h"
+#include "VertexAnimation.h"
+#include "Timeline.h"
+#include "SplinePath.h"
+#include "Wanderers.h"
+#include "Boids.h"
+#include "FixedTimestep.h"
+#include "JobSystem.h"
+#include "RenderThread.h"
+#include "StreamingBuffer.h"
+#include "Entities.h"
 
 // Implementación de STB_IMAGE para cargar texturas
 // Se define aquí para que se compile en este archivo .cpp
@@ -23,8 +52,8 @@
 // Prototipos de funciones
 void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mode);
 void MouseCallback(GLFWwindow* window, double xPos, double yPos);
-void DoMovement();
-void Animacion();
+void DoMovement(GLfloat step);
+struct CreatureState;
 
 
 // --- Definición de la Clase Camera ---
@@ -144,6 +173,10 @@ private:
 const GLint WIDTH = 1200, HEIGHT = 800;
 int screenWidth, screenHeight; // Se obtendrán del framebuffer
 
+// Planos de recorte de la proyección (también los usa la rejilla de clusters)
+const GLfloat NEAR_PLANE = 0.1f;
+const GLfloat FAR_PLANE = 200.0f;
+
 // Cámara
 Camera camera(glm::vec3(0.0f, 15.0f, 55.0f)); // Posición inicial
 bool keys[1024];
@@ -155,37 +188,149 @@ bool firstMouse = true;
 GLfloat deltaTime = 0.0f;
 GLfloat lastFrame = 0.0f;
 
-// Ciclo Día/Tarde/Noche
-glm::vec3 dayColor(0.5f, 0.8f, 1.0f);
-glm::vec3 nightColor(0.196f, 0.196f, 0.274f);
-glm::vec3 sunsetColor(1.0f, 0.686f, 0.0f);
-glm::vec3 currentColor = dayColor;
-glm::vec3 targetColor = dayColor;
-glm::vec3 startTransitionColor = dayColor;
+// Ciclo Día/Tarde/Noche: la altura del sol sobre el horizonte (grados) cambia con la transición.
+// El cielo, el color de la luz y su dirección salen de la atmósfera (Atmosphere.h)
+float daySunElevation = 45.0f;
+float sunsetSunElevation = 20.0f;  // Sol bajo: sombras largas
+float nightSunElevation = -20.0f;  // Debajo del horizonte: alumbra la luna
+float sunElevation = daySunElevation;
+float targetSunElevation = daySunElevation;
+float startTransitionSunElevation = daySunElevation;
 bool isTransitioning = false;
 bool isNight = false;
 bool isSunset = false;
 float transitionFactor = 0.0f;
 float transitionSpeed = 0.5f; // Velocidad de la transición
 
-// Animación de Ho-oh
-glm::vec3 hoohPos = glm::vec3(40.0f, 30.0f, 0.0f);
-glm::vec3 hoohTargetPos = glm::vec3(40.0f, 30.0f, 0.0f);
-float hoohSpeed = 10.0f;
+// Dirección de la luz del sol (o de la luna) en cada momento del día; con estas se hornea el lightmap
+glm::vec3 dayLightDirection = -Atmosphere::SunDirection(daySunElevation);
+glm::vec3 sunsetLightDirection = -Atmosphere::SunDirection(sunsetSunElevation);
+glm::vec3 nightLightDirection(0.520f, -0.780f, -0.347f); // La luna, del otro lado
+glm::vec3 lightDirection = dayLightDirection;
+
+// Captura de cuadros (Tecla F12 inicia/detiene la secuencia; el render la apaga si no pudo empezar)
+std::atomic<bool> captureRequested(false);
+
+// Iluminación por clusters (Tecla L alterna contra recorrer todas las luces)
+bool clusteredLighting = true;
+
+// Render deferred en lugar de forward (Tecla G)
+bool deferredShading = false;
+
+// Sombras del sol con cascadas (Tecla K)
+bool shadowsEnabled = true;
+
+// Luz horneada en la parte estática (Tecla B)
+bool lightmapsEnabled = true;
+
+// Animación de Ho-oh: recorre un camino cerrado a velocidad constante (su entidad lleva
+// la posición y lo recorrido, ver Entities.h)
 float hoohMinY = 60.0f; // Altura mínima de vuelo (aumentada)
-glm::vec3 hoohDirection = glm::vec3(0.0f, 0.0f, 1.0f);
-float hoohCurveSpeed = 0.5f;
-float hoohCurveAmount = 1.0f;
+SplinePath hoohPath;    // Vuelta por todo el mapa entre hoohMinY y hoohMinY + 20
 
+// Bandada de Ho-oh (Tecla H): escoltas con el mismo esqueleto, cada una en otra fase del aleteo
+bool hoohFlockEnabled = false;
+const GLuint HOOH_FLOCK_SIZE = 24;
 
-// --- Variables de Animación de MEW ---
-glm::vec3 mewPos = glm::vec3(0.0f, 2.0f, 0.0f); // Posición inicial de Mew
-glm::vec3 mewTargetPos = glm::vec3(0.0f, 2.0f, 0.0f); // Objetivo actual de Mew
-glm::vec3 mewDirection = glm::vec3(0.0f, 0.0f, 0.0f); // Dirección actual de Mew
+// Multitud de Ho-oh (Tecla V): cientos volando en círculos con el aleteo horneado en una
+// textura de vértices, una llamada instanciada por malla
+std::atomic<bool> hoohCrowdEnabled(false); // La lee el hilo de simulación
+const GLuint HOOH_CROWD_SIZE = 300;
+
+// Cómo vuela la multitud (Tecla J): en sus anillos, vagando de un objetivo al azar a otro
+// o en bandada alrededor de Ho-oh
+enum Crowd_Mode
+{
+    CROWD_RINGS,
+    CROWD_WANDER,
+    CROWD_FLOCK,
+    CROWD_MODES
+};
+std::atomic<GLuint> hoohCrowdMode(CROWD_RINGS);
+
+// Simulación a paso fijo (FixedTimestep.h): la cámara y el ciclo de día siempre avanzan en el hilo
+// principal (ahí llega la entrada); las criaturas pueden ir en su propio hilo (Tecla T)
+bool simulationThreadRequested = false;
+
+// Hilo de render (Tecla R): el hilo principal graba cada cuadro y otro hilo, dueño del contexto GL,
+// lo dibuja mientras se graba el siguiente. Arranca activado si hay más de un núcleo
+bool renderThreadRequested = false;
+
+// Lo que se dibuja de las criaturas en cada paso; el render mezcla los dos últimos
+struct CreatureState
+{
+    GLfloat time;
+    glm::vec3 hoohPos, hoohDirection;
+    glm::vec3 mewPos, mewDirection;
+    std::vector<glm::vec3> crowdPositions;
+    std::vector<glm::vec3> crowdDirections;
+    GLfloat crowdScale;
+};
+
+// Vista en cada paso: la cámara se mueve y el sol sube o baja a paso fijo
+struct ViewState
+{
+    glm::vec3 cameraPosition;
+    GLfloat sunElevation;
+};
+
+// Uniforms de la cámara y el sol, iguales en todos los dibujos del cuadro: el bloque FrameData de
+// modelLoading y deferredLighting (layout std140, cada vec3 ocupa un vec4). Se copian una vez al
+// StreamingBuffer y cada variante solo enlaza su bloque, en lugar de un glUniform por valor.
+struct FrameUniforms
+{
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::mat4 inverseViewProjection;
+    glm::vec4 viewPos;
+    glm::vec4 sunDirection;  // dirLight
+    glm::vec4 sunAmbient;
+    glm::vec4 sunDiffuse;
+    glm::vec4 sunSpecular;
+};
+const GLuint FRAME_UNIFORMS_BINDING = 0;
+
+// Objetos dinámicos que se piden en la lista de comandos del cuadro
+enum Scene_Object
+{
+    OBJECT_MEW,
+    OBJECT_HOOH,
+    OBJECT_HOOH_CROWD
+};
+
+// Un cuadro para el hilo de render (RenderThread.h): lo que decidió el hilo principal, sin llamadas
+// a GL. Hay dos; mientras uno se dibuja el otro se graba
+struct FrameCommands
+{
+    GLfloat time;
+    GLfloat deltaTime;
+    Camera camera;                    // La cámara de este cuadro
+    GLfloat sunElevation;
+    bool deferredShading;
+    bool shadowsEnabled;
+    bool clusteredLighting;
+    bool lightmapsEnabled;
+    bool captureRequested;
+    GLfloat waterFrame;
+    RenderCommandList dynamicScene;   // Mew, Ho-oh y la multitud
+    SkinningPalette* palette;         // Huesos del cuadro: se llenan al grabar y se suben al dibujar
+    VertexAnimationInstances* crowd;  // Instancias de la multitud (igual)
+    FrameVector<std::pair<const char*, double>> cpuSections; // Lo que midió el hilo principal (ms)
+    FrameArena* arena;                // Lo que solo vive este cuadro; se vacía al empezar a grabarlo
+#ifdef FRAME_ARENA_CENSUS
+    unsigned long long heapAllocations; // new globales (todos los hilos) desde el cuadro anterior
+#endif
+};
+
+// Propiedades animadas por la línea de tiempo de la escena (Animations/escena.timeline)
+float waterFrame = 0.0f;                                 // Textura del estanque (0 o 1)
+glm::vec3 mewHover = glm::vec3(0.0f);                    // Desplazamiento de Mew sobre su camino
+glm::quat mewSway = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);   // Balanceo de Mew
+float hoohFlapAngle = 0.0f;                              // Aleteo del Ho-oh rígido (grados)
 
-GLfloat mewSpeed = 2.70f; // Velocidad de movimiento de Mew
-GLfloat mewCurveSpeed = 2.70f; // Velocidad de la curva (más alto = más errático)
-GLfloat mewCurveAmount = 2.70f; // Cantidad de la curva (más alto = curvas más cerradas)
+
+// --- Variables de Animación de MEW ---
+SplinePath mewPath; // Camino de Mew (más cerrado y cerca del centro)
 GLfloat mewMinY = 0.5f; // Altura mínima de vuelo
 
 int main() {
@@ -230,190 +375,127 @@ int main() {
     // Inicializar la semilla para números aleatorios
     srand(static_cast<unsigned int>(time(NULL)));
 
+    // Caminos de vuelo de Ho-oh y Mew: distintos en cada corrida, igual que antes los objetivos al azar
+    hoohPath.Generate((GLuint)rand(), glm::vec3(0.0f), 42.0f, 0.3f, hoohMinY, 20.0f, 7);
+    mewPath.Generate((GLuint)rand(), glm::vec3(0.0f), 13.0f, 0.45f, mewMinY, 3.0f, 9);
+
+    // --- Entidades de la escena (ver Entities.h) ---
+    // Ho-oh y Mew: su IA avanza sobre el camino en la simulación y su Transform es lo que se dibuja
+    EntityWorld* scene = new EntityWorld();
+    Entity hooh = scene->CreateCreature(hoohPath, 10.0f, glm::vec3(40.0f, 30.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    Entity mew = scene->CreateCreature(mewPath, 2.70f, glm::vec3(0.0f, 2.0f, 0.0f), glm::vec3(0.0f)); // Velocidad de Mew
+
     // --- Compilar Shaders ---
+    // Los programas ya enlazados se guardan en ShaderCache/ (binarios del driver);
+    // en las siguientes corridas se cargan de ahí en lugar de compilar
+    double shaderStartTime = glfwGetTime();
     Shader ourShader("Shader/core.vs", "Shader/core.frag");
     Shader lampShader("Shader/lamp1.vs", "Shader/lamp1.frag");
-    Shader modelShader("Shader/modelLoading.vs", "Shader/modelLoading.frag");
-
 
-    // --- Cargar Textura de Césped (grassTextureID) ---
+    // --- Shaders con variantes (#define), se compilan según se van pidiendo ---
+    // Cada dibujo elige la más barata: sin textura, con textura, o con recorte por transparencia
+    ShaderVariants* modelShaders = new ShaderVariants("Shader/modelLoading.vs", "Shader/modelLoading.frag", SHADER_TEXTURED | SHADER_ALPHA_TEST | SHADER_SHADOWS | SHADER_CLUSTERED | SHADER_LIGHTMAP | SHADER_SKINNED | SHADER_VERTEX_ANIMATION);
+    ShaderVariants* gBufferShaders = new ShaderVariants("Shader/modelLoading.vs", "Shader/gbuffer.frag", SHADER_TEXTURED | SHADER_ALPHA_TEST | SHADER_SKINNED | SHADER_VERTEX_ANIMATION);
+    ShaderVariants* deferredShaders = new ShaderVariants("Shader/deferredLighting.vs", "Shader/deferredLighting.frag", SHADER_SHADOWS | SHADER_CLUSTERED);
+    ShaderVariants* shadowShaders = new ShaderVariants("Shader/shadowDepth.vs", "Shader/shadowDepth.frag", SHADER_ALPHA_TEST | SHADER_SKINNED | SHADER_VERTEX_ANIMATION);
+
+    std::cout << "SHADERS: " << (glfwGetTime() - shaderStartTime) * 1000.0 << " ms al inicio" << std::endl;
+    Shader::PrintCacheStats();
+
+    // --- Recarga en vivo: al guardar un archivo de Shader/ se recompila sin reiniciar ---
+    // Se sigue dibujando con el programa anterior hasta que el nuevo termina de enlazar
+    ShaderWatcher* shaderWatcher = new ShaderWatcher("Shader");
+    Shader* watchedShaders[] = { &ourShader, &lampShader };
+    ShaderVariants* watchedVariants[] = { modelShaders, gBufferShaders, deferredShaders, shadowShaders };
+
+    // --- Línea de tiempo de la escena ---
+    // Las animaciones por llaves (agua, balanceo de Mew, aleteo del Ho-oh rígido) se leen de un
+    // archivo y se evalúan juntas cada cuadro; al guardarlo se recarga igual que los shaders
+    const std::string sceneTimelinePath = "Animations/escena.timeline";
+    Timeline* sceneTimeline = new Timeline();
+    sceneTimeline->Bind("agua.cuadro", &waterFrame);
+    sceneTimeline->Bind("mew.flotar", &mewHover);
+    sceneTimeline->Bind("mew.balanceo", &mewSway);
+    sceneTimeline->Bind("hooh.aleteo", &hoohFlapAngle);
+    sceneTimeline->Load(sceneTimelinePath);
+    ShaderWatcher* timelineWatcher = new ShaderWatcher("Animations");
+
+    // --- Captura asíncrona de cuadros (anillo de PBOs) ---
+    FrameCapture* frameCapture = new FrameCapture(screenWidth, screenHeight, "captura", CAPTURE_PNG);
+
+    // --- Render Deferred (Tecla G) y Perfilador ---
+    GBuffer* gBuffer = new GBuffer(screenWidth, screenHeight);
+    GpuProfiler* profiler = new GpuProfiler();
+
+    // --- Sombras del sol (Tecla K) ---
+    // La caja cubre el piso y el vuelo de Ho-oh (hasta 60 en X/Z y hoohMinY + 20 de alto)
+    ShadowCascades* shadowCascades = new ShadowCascades(glm::vec3(-65.0f, -1.5f, -65.0f), glm::vec3(65.0f, hoohMinY + 25.0f, 65.0f));
+
+    // --- Cielo (atmósfera precalculada en tablas; también da la luz del sol y de la luna) ---
+    Atmosphere* atmosphere = new Atmosphere();
+
+
+    // --- Sistema de trabajos (un hilo por núcleo, el principal incluido) ---
+    // Lo que llama a GL se encola con RunOnMainThread() y corre aquí, en Wait() o al inicio de cada cuadro
+    JobSystem* jobs = new JobSystem();
+    std::cout << "TRABAJOS: " << jobs->GetThreadCount() << " hilos" << std::endl;
+
+    // --- Texturas de la escena: césped, agua (2 cuadros), hojas y tejado ---
+    // Se decodifican en paralelo; cada una se sube en el hilo principal apenas termina.
+    // Todas repiten y se ven pixeladas
     GLuint grassTextureID;
-    glGenTextures(1, &grassTextureID);
-    glBindTexture(GL_TEXTURE_2D, grassTextureID);
-
-    // Configurar wrapping (repetir)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // Configurar filtrado (pixelado)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    // Cargar la imagen
-    int textureWidth, textureHeight, nrChannels;
-    unsigned char* image = stbi_load("images/pasto.png", &textureWidth, &textureHeight, &nrChannels, 0);
-
-    if (image)
-    {
-        // Detectar formato (RGB o RGBA)
-        GLenum format;
-        if (nrChannels == 3)
-            format = GL_RGB;
-        else if (nrChannels == 4)
-            format = GL_RGBA; // Soporta transparencia
-        else
-            format = GL_RGB; // Por defecto
-
-        glTexImage2D(GL_TEXTURE_2D, 0, format, textureWidth, textureHeight, 0, format, GL_UNSIGNED_BYTE, image);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture: images/pasto.png" << std::endl;
-    }
-    stbi_image_free(image); // Liberar memoria de la imagen
-    glBindTexture(GL_TEXTURE_2D, 0); // Desenlazar
-
-
-    // --- Cargar Textura de Agua (waterTextureID) ---
     GLuint waterTextureID;
     GLuint waterTextureID_2;
     GLuint hojasTextureID;
     GLuint tejadoTextureID;
-    glGenTextures(1, &waterTextureID);
-    glBindTexture(GL_TEXTURE_2D, waterTextureID);
-
-    // --- Cargar Textura de Agua 2 (waterTextureID_2) ---
-    glGenTextures(1, &waterTextureID_2); // <- CAMBIO AQUÍ
-    glBindTexture(GL_TEXTURE_2D, waterTextureID_2); // <- CAMBIO AQUÍ
-
-    // Configurar wrapping (repetir)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // Configurar filtrado (pixelado)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    // Cargar la imagen
-    unsigned char* agua2 = stbi_load("images/agua2.png", &textureWidth, &textureHeight, &nrChannels, 0); // <- CAMBIO AQUÍ
-
-    if (agua2) // <- CAMBIO AQUÍ
-    {
-        // Detectar formato
-        GLenum format;
-        if (nrChannels == 3)
-            format = GL_RGB;
-        else if (nrChannels == 4)
-            format = GL_RGBA;
-        else
-            format = GL_RGB;
-
-        glTexImage2D(GL_TEXTURE_2D, 0, format, textureWidth, textureHeight, 0, format, GL_UNSIGNED_BYTE, agua2); // <- CAMBIO AQUÍ
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture: images/agua2.png" << std::endl; // <- CAMBIO AQUÍ
-    }
-    stbi_image_free(agua2); // <- CAMBIO AQUÍ
-    glBindTexture(GL_TEXTURE_2D, 0); // Desenlazar
-
-    glBindTexture(GL_TEXTURE_2D, waterTextureID);
-    // Configurar wrapping (repetir)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // Configurar filtrado (pixelado)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    // Cargar la imagen
-    unsigned char* agua = stbi_load("images/agua.png", &textureWidth, &textureHeight, &nrChannels, 0);
-
-    if (agua)
-    {
-        // Detectar formato
-        GLenum format;
-        if (nrChannels == 3)
-            format = GL_RGB;
-        else if (nrChannels == 4)
-            format = GL_RGBA;
-        else
-            format = GL_RGB;
-
-        glTexImage2D(GL_TEXTURE_2D, 0, format, textureWidth, textureHeight, 0, format, GL_UNSIGNED_BYTE, agua);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture: images/agua.png" << std::endl;
-    }
-    stbi_image_free(agua); // Liberar memoria de la imagen
-    glBindTexture(GL_TEXTURE_2D, 0); // Desenlazar
-
-    // --- Cargar Textura de Hojas (hojasTextureID) ---
-    glGenTextures(1, &hojasTextureID);
-    glBindTexture(GL_TEXTURE_2D, hojasTextureID);
-    // Configurar wrapping (repetir)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // Configurar filtrado (pixelado)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    // Cargar la imagen
-    image = stbi_load("images/hojas.jpg", &textureWidth, &textureHeight, &nrChannels, 0);
-    if (image)
-    {
-        // Detectar formato
-        GLenum format;
-        if (nrChannels == 3)
-            format = GL_RGB;
-        else if (nrChannels == 4)
-            format = GL_RGBA;
-        else
-            format = GL_RGB;
-
-        glTexImage2D(GL_TEXTURE_2D, 0, format, textureWidth, textureHeight, 0, format, GL_UNSIGNED_BYTE, image);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
+    struct SceneTexture
     {
-        std::cout << "Failed to load texture: images/hojas.jpg" << std::endl;
-    }
-    stbi_image_free(image); // Liberar memoria de la imagen
-    glBindTexture(GL_TEXTURE_2D, 0); // Desenlazar
-
-    // --- Cargar Textura de Tejado (tejadoTextureID) ---
-    glGenTextures(1, &tejadoTextureID);
-    glBindTexture(GL_TEXTURE_2D, tejadoTextureID);
-    // Configurar wrapping (repetir)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // Configurar filtrado (pixelado)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    // Cargar la imagen
-    image = stbi_load("images/tejado.png", &textureWidth, &textureHeight, &nrChannels, 0);
-    if (image)
-    {
-        // Detectar formato
-        GLenum format;
-        if (nrChannels == 3)
-            format = GL_RGB;
-        else if (nrChannels == 4)
-            format = GL_RGBA;
-        else
-            format = GL_RGB;
-
-        glTexImage2D(GL_TEXTURE_2D, 0, format, textureWidth, textureHeight, 0, format, GL_UNSIGNED_BYTE, image);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
+        const char* path;
+        GLuint* id;
+    };
+    SceneTexture sceneTextures[] = {
+        { "images/pasto.png", &grassTextureID },
+        { "images/agua2.png", &waterTextureID_2 },
+        { "images/agua.png", &waterTextureID },
+        { "images/hojas.jpg", &hojasTextureID },
+        { "images/tejado.png", &tejadoTextureID },
+    };
+    double textureStartTime = glfwGetTime();
+    JobCounter textureJobs;
+    for (const SceneTexture& texture : sceneTextures)
     {
-        std::cout << "Failed to load texture: images/tejado.png" << std::endl;
+        glGenTextures(1, texture.id);
+        jobs->Run([&jobs, &textureJobs, texture]()
+        {
+            int textureWidth, textureHeight, nrChannels;
+            unsigned char* image = stbi_load(texture.path, &textureWidth, &textureHeight, &nrChannels, 0);
+            jobs->RunOnMainThread([=]()
+            {
+                glBindTexture(GL_TEXTURE_2D, *texture.id);
+                // Configurar wrapping (repetir)
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+                // Configurar filtrado (pixelado)
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                if (image)
+                {
+                    // Detectar formato (RGB o RGBA)
+                    GLenum format = nrChannels == 4 ? GL_RGBA : GL_RGB; // Soporta transparencia
+                    glTexImage2D(GL_TEXTURE_2D, 0, format, textureWidth, textureHeight, 0, format, GL_UNSIGNED_BYTE, image);
+                    glGenerateMipmap(GL_TEXTURE_2D);
+                }
+                else
+                {
+                    std::cout << "Failed to load texture: " << texture.path << std::endl;
+                }
+                stbi_image_free(image); // Liberar memoria de la imagen
+                glBindTexture(GL_TEXTURE_2D, 0); // Desenlazar
+            }, &textureJobs);
+        }, &textureJobs);
     }
-    stbi_image_free(image); // Liberar memoria de la imagen
-    glBindTexture(GL_TEXTURE_2D, 0); // Desenlazar
+    jobs->Wait(textureJobs);
+    std::cout << "TEXTURAS: " << (glfwGetTime() - textureStartTime) * 1000.0 << " ms" << std::endl;
 
     // --- Definición de Vértices ---
 
@@ -554,9 +636,222 @@ int main() {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 
+    // --- VAO vacío para el triángulo de pantalla completa (paso de iluminación deferred) ---
+    // Los vértices salen de gl_VertexID, pero el perfil core exige un VAO enlazado
+    GLuint VAO_fullscreen;
+    glGenVertexArrays(1, &VAO_fullscreen);
+
     // --- Cargar Modelos 3D ---
     Model mewModel((char*)"Models/Mew.obj");
-    Model hoohModel("Models/ho-oh/Ho-Oh/hooh.dae");
+    // Ho-oh con esqueleto (el glb trae los huesos y el clip de vuelo); si no se pudo importar
+    // se usa el .dae rígido de antes, que aletea girando todo el modelo
+    Model* hoohModel = new Model("Models/ho-oh1/source/Ho-Oh_fbx.glb");
+    bool hoohSkinned = hoohModel->HasSkeleton() && !hoohModel->GetClips().empty();
+    if (!hoohSkinned)
+    {
+        delete hoohModel;
+        hoohModel = new Model("Models/ho-oh/Ho-Oh/hooh.dae");
+    }
+
+    // El clip de vuelo se comprime (quita llaves que no cambian la pose y cuantiza) y cada Ho-oh
+    // lo reproduce con su propio cursor, sin buscar llaves mientras avanza
+    CompressedClip* hoohFlightClip = nullptr;
+    std::vector<AnimationCursor> hoohCursors;
+    if (hoohSkinned)
+    {
+        const AnimationClip& clip = hoohModel->GetClips()[0];
+        hoohFlightClip = new CompressedClip(clip);
+        std::cout << "ANIMACION: '" << clip.name << "' " << CompressedClip::GetRawMemoryBytes(clip) / 1024 << " KB -> "
+                  << hoohFlightClip->GetMemoryBytes() / 1024 << " KB (" << hoohFlightClip->GetKeyCount() << " llaves), error máximo "
+                  << std::to_string(hoohFlightClip->maxTranslationError) << " / " << std::to_string(glm::degrees(hoohFlightClip->maxRotationError)) << " grados" << std::endl;
+    }
+
+    // El mismo clip horneado a textura de vértices para la multitud (Tecla V)
+    VertexAnimationTexture* hoohVertexAnimation = nullptr;
+
+    // Un camino por anillo de la multitud; sus integrantes se reparten a lo largo de él
+    const GLuint HOOH_CROWD_PATHS = 12;
+    std::vector<SplinePath> crowdPaths(HOOH_CROWD_PATHS);
+    for (GLuint p = 0; p < HOOH_CROWD_PATHS; p++)
+        crowdPaths[p].Generate(100 + p, glm::vec3(0.0f), 25.0f + p * 3.0f, 0.08f, hoohMinY + 2.0f + (GLfloat)((p * 7) % 30), 4.0f, 6);
+    std::vector<GLfloat> crowdDistances;
+    std::vector<SplinePoint> crowdPoints;
+
+    // Las mismas como criaturas que vagan por el cielo (Tecla J): arrancan donde empiezan sus anillos
+    WandererSimulation* crowdWanderers = new WandererSimulation();
+    for (GLuint i = 0; i < HOOH_CROWD_SIZE; i++)
+    {
+        const SplinePath& path = crowdPaths[i % HOOH_CROWD_PATHS];
+        glm::vec3 start = path.Evaluate(glm::fract(i * 0.618034f) * path.GetLength()).position;
+        crowdWanderers->Add(start, glm::vec3(-60.0f, hoohMinY, -60.0f), glm::vec3(60.0f, hoohMinY + 30.0f, 60.0f),
+                            6.0f + 3.0f * glm::fract(i * 0.754877f), 0.3f + 0.4f * glm::fract(i * 0.569840f), 1.0f, 2.0f, i + 1);
+    }
+
+    // Y como bandada que escolta a Ho-oh (Tecla J): salen de donde está él en todas direcciones
+    BoidSettings crowdFlockSettings;
+    crowdFlockSettings.neighborRadius = 10.0f;
+    crowdFlockSettings.separationRadius = 5.0f;
+    crowdFlockSettings.separationWeight = 25.0f;
+    crowdFlockSettings.cohesionWeight = 0.2f;
+    crowdFlockSettings.goalRadius = 25.0f;
+    crowdFlockSettings.minSpeed = 8.0f;
+    crowdFlockSettings.maxSpeed = 16.0f;
+    BoidFlock* crowdFlock = new BoidFlock(crowdFlockSettings);
+    for (GLuint i = 0; i < HOOH_CROWD_SIZE; i++)
+    {
+        GLfloat angle = i * 2.39996f;
+        GLfloat height = (glm::fract(i * 0.618034f) - 0.5f) * 10.0f;
+        glm::vec3 outward(cos(angle), 0.0f, sin(angle));
+        crowdFlock->Add(scene->transforms.Get(hooh).position + outward * (5.0f + (i % 10)) + glm::vec3(0.0f, height, 0.0f), outward * crowdFlockSettings.minSpeed);
+    }
+    GLuint simulationThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    // --- Simulación a paso fijo ---
+    // Criaturas: caminos de Ho-oh y Mew y la multitud (anillos, vagando o en bandada). Lo que usa
+    // este paso solo lo toca la simulación, así puede ir en otro hilo; el render lee su estado.
+    auto stepCreatures = [&](GLfloat step, CreatureState& state)
+    {
+        state.time += step;
+
+        // Ho-oh y Mew avanzan a velocidad constante sobre sus caminos (sistema de criaturas)
+        scene->UpdateCreatures(step);
+        state.hoohPos = scene->creatures.Get(hooh).position;
+        state.hoohDirection = scene->creatures.Get(hooh).direction;
+        state.mewPos = scene->creatures.Get(mew).position;
+        state.mewDirection = scene->creatures.Get(mew).direction;
+
+        if (!hoohCrowdEnabled)
+        {
+            state.crowdPositions.clear();
+            state.crowdDirections.clear();
+            return;
+        }
+        state.crowdPositions.resize(HOOH_CROWD_SIZE);
+        state.crowdDirections.resize(HOOH_CROWD_SIZE);
+        state.crowdScale = 0.02f;
+        GLuint mode = hoohCrowdMode;
+        if (mode == CROWD_WANDER)
+        {
+            // Con cientos caben en un hilo; las simulaciones solo reparten cuando hay miles
+            crowdWanderers->Update(state.time, step, simulationThreads);
+            for (GLuint i = 0; i < HOOH_CROWD_SIZE; i++)
+            {
+                state.crowdPositions[i] = crowdWanderers->GetPosition(i);
+                state.crowdDirections[i] = crowdWanderers->GetDirection(i);
+            }
+        }
+        else if (mode == CROWD_FLOCK)
+        {
+            // La bandada sigue a Ho-oh; son escoltas más chicas
+            crowdFlock->SetGoal(state.hoohPos);
+            crowdFlock->Update(step, simulationThreads);
+            for (GLuint i = 0; i < HOOH_CROWD_SIZE; i++)
+            {
+                state.crowdPositions[i] = crowdFlock->GetPosition(i);
+                state.crowdDirections[i] = crowdFlock->GetDirection(i);
+            }
+            state.crowdScale = 0.01f;
+        }
+        else
+        {
+            for (GLuint p = 0; p < HOOH_CROWD_PATHS; p++)
+            {
+                // Los integrantes del camino (i % HOOH_CROWD_PATHS == p) se evalúan juntos;
+                // todas a la misma velocidad, repartidas por la proporción áurea
+                const SplinePath& path = crowdPaths[p];
+                crowdDistances.clear();
+                for (GLuint i = p; i < HOOH_CROWD_SIZE; i += HOOH_CROWD_PATHS)
+                    crowdDistances.push_back(glm::fract(i * 0.618034f) * path.GetLength() + state.time * 6.0f);
+                crowdPoints.resize(crowdDistances.size());
+                path.Evaluate(crowdDistances.data(), (GLuint)crowdDistances.size(), crowdPoints.data());
+                for (GLuint k = 0; k < crowdPoints.size(); k++)
+                {
+                    state.crowdPositions[p + k * HOOH_CROWD_PATHS] = crowdPoints[k].position;
+                    state.crowdDirections[p + k * HOOH_CROWD_PATHS] = crowdPoints[k].tangent;
+                }
+            }
+        }
+    };
+
+    // Mezcla de direcciones (normalizada; si se anulan se queda con la nueva)
+    auto mixDirection = [](const glm::vec3& a, const glm::vec3& b, GLfloat alpha)
+    {
+        glm::vec3 direction = glm::mix(a, b, alpha);
+        GLfloat length = glm::length(direction);
+        return length > 1e-4f ? direction / length : b;
+    };
+    auto interpolateCreatures = [&](const CreatureState& previous, const CreatureState& current, GLfloat alpha, CreatureState& result)
+    {
+        result.time = glm::mix(previous.time, current.time, alpha);
+        result.hoohPos = glm::mix(previous.hoohPos, current.hoohPos, alpha);
+        result.hoohDirection = mixDirection(previous.hoohDirection, current.hoohDirection, alpha);
+        result.mewPos = glm::mix(previous.mewPos, current.mewPos, alpha);
+        result.mewDirection = mixDirection(previous.mewDirection, current.mewDirection, alpha);
+        result.crowdScale = current.crowdScale;
+        result.crowdPositions.resize(current.crowdPositions.size());
+        result.crowdDirections.resize(current.crowdDirections.size());
+        bool matching = previous.crowdPositions.size() == current.crowdPositions.size();
+        for (size_t i = 0; i < current.crowdPositions.size(); i++)
+        {
+            // La multitud recién encendida no tiene paso anterior
+            result.crowdPositions[i] = matching ? glm::mix(previous.crowdPositions[i], current.crowdPositions[i], alpha) : current.crowdPositions[i];
+            result.crowdDirections[i] = matching ? mixDirection(previous.crowdDirections[i], current.crowdDirections[i], alpha) : current.crowdDirections[i];
+        }
+    };
+    const Transform& hoohStart = scene->transforms.Get(hooh);
+    const Transform& mewStart = scene->transforms.Get(mew);
+    CreatureState initialCreatures = { 0.0f, hoohStart.position, hoohStart.direction, mewStart.position, mewStart.direction, {}, {}, 0.02f };
+    FixedTimestep<CreatureState>* creatureSimulation = new FixedTimestep<CreatureState>(initialCreatures, stepCreatures, interpolateCreatures);
+
+    // Vista: movimiento de la cámara con el teclado y transición del sol
+    auto stepView = [&](GLfloat step, ViewState& state)
+    {
+        camera.Position = state.cameraPosition;
+        DoMovement(step);
+        state.cameraPosition = camera.Position;
+
+        // --- Lógica de transición de color (Día/Noche) ---
+        if (isTransitioning)
+        {
+            transitionFactor += transitionSpeed * step;
+            transitionFactor = glm::clamp(transitionFactor, 0.0f, 1.0f);
+            state.sunElevation = glm::mix(startTransitionSunElevation, targetSunElevation, transitionFactor);
+
+            if (transitionFactor >= 1.0f)
+            {
+                isTransitioning = false;
+                // Actualiza el estado actual
+                if (targetSunElevation == daySunElevation) {
+                    isNight = false;
+                    isSunset = false;
+                }
+                else if (targetSunElevation == nightSunElevation) {
+                    isNight = true;
+                    isSunset = false;
+                }
+                else if (targetSunElevation == sunsetSunElevation) {
+                    isNight = false;
+                    isSunset = true;
+                }
+            }
+        }
+    };
+    auto interpolateView = [](const ViewState& previous, const ViewState& current, GLfloat alpha, ViewState& result)
+    {
+        result.cameraPosition = glm::mix(previous.cameraPosition, current.cameraPosition, alpha);
+        result.sunElevation = glm::mix(previous.sunElevation, current.sunElevation, alpha);
+    };
+    ViewState initialView = { camera.Position, sunElevation };
+    FixedTimestep<ViewState>* viewSimulation = new FixedTimestep<ViewState>(initialView, stepView, interpolateView);
+    if (hoohSkinned)
+    {
+        double bakeStartTime = glfwGetTime();
+        hoohVertexAnimation = new VertexAnimationTexture(*hoohModel, hoohModel->GetClips()[0]);
+        std::cout << "ANIMACION: textura de vértices '" << hoohVertexAnimation->GetName() << "' " << hoohVertexAnimation->GetVertexCount()
+                  << " vértices x " << hoohVertexAnimation->GetFrameCount() << " cuadros = " << hoohVertexAnimation->GetMemoryBytes() / 1024
+                  << " KB, horneada en " << (glfwGetTime() - bakeStartTime) * 1000.0 << " ms" << std::endl;
+    }
+
 
     // --- Paleta de Colores ---
     glm::vec3 floorColor(0.85f, 0.75f, 0.5f);
@@ -592,106 +887,118 @@ int main() {
     glm::vec3 postColor(0.2f, 0.2f, 0.2f);
     glm::vec3 lightColor(1.0f, 1.0f, 0.7f);
 
-    // --- Bucle principal de renderizado ---
-    while (!glfwWindowShouldClose(window))
+    // --- Postes de Luz de la Calle ---
+    // Los dos postes originales más una avenida iluminada: las dos banquetas de la calle
+    // (z = 2 y z = 14) y el camino que rodea el terreno por dentro de la fila de árboles.
+    std::vector<glm::vec3> postPositions;
+    postPositions.push_back(glm::vec3(30.0f, 0.0f, 2.0f));  // Poste derecha
+    postPositions.push_back(glm::vec3(-9.5f, 0.0f, 2.0f));  // Poste izquierda
+    for (float x = -46.0f; x <= 46.0f; x += 2.0f)
     {
-        // Calcular delta time (tiempo entre frames)
-        GLfloat currentFrame = (GLfloat)glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-
-        // Revisar eventos (teclado, mouse)
-        glfwPollEvents();
-        DoMovement(); // Procesar movimiento de teclado
-        Animacion();  // Actualizar animación de Ho-oh
-
-        // ===============================================================
-        //     PASO 1: CONFIGURAR LA ILUMINACIÓN GLOBAL
-        // ===============================================================
-
-        // Activa el shader de iluminación principal (modelShader)
-        modelShader.Use();
-
-        // --- Matrices de Cámara ---
-        glm::mat4 projection = glm::perspective(camera.GetZoom(), (GLfloat)screenWidth / (GLfloat)screenHeight, 0.1f, 200.0f);
-        glm::mat4 view = camera.GetViewMatrix();
-        glUniformMatrix4fv(glGetUniformLocation(modelShader.Program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glUniformMatrix4fv(glGetUniformLocation(modelShader.Program, "view"), 1, GL_FALSE, glm::value_ptr(view));
-
-        // --- Posición del Espectador (Cámara) ---
-        glUniform3fv(glGetUniformLocation(modelShader.Program, "viewPos"), 1, &camera.Position[0]);
-
-        // --- ☀️ EL SOL (Luz Direccional) ---
-        glUniform3f(glGetUniformLocation(modelShader.Program, "dirLight.direction"), -0.707f, -0.707f, 0.0f);
-        glUniform3f(glGetUniformLocation(modelShader.Program, "dirLight.ambient"), 0.2f, 0.2f, 0.2f);
-        glUniform3f(glGetUniformLocation(modelShader.Program, "dirLight.diffuse"), 0.8f, 0.8f, 0.8f);
-        glUniform3f(glGetUniformLocation(modelShader.Program, "dirLight.specular"), 1.0f, 1.0f, 1.0f);
-
-        // --- 💡 LUCES DE POSTE (Punto) ---
-        // Poste 1 (Derecha)
-        glUniform3f(glGetUniformLocation(modelShader.Program, "pointLights[0].position"), 30.0f, 6.5f, 2.9f);
-        glUniform3f(glGetUniformLocation(modelShader.Program, "pointLights[0].ambient"), 0.05f, 0.05f, 0.0f);
-        glUniform3f(glGetUniformLocation(modelShader.Program, "pointLights[0].diffuse"), 0.8f, 0.8f, 0.6f); // Luz amarilla
-        glUniform3f(glGetUniformLocation(modelShader.Program, "pointLights[0].specular"), 1.0f, 1.0f, 0.8f);
-        glUniform1f(glGetUniformLocation(modelShader.Program, "pointLights[0].constant"), 1.0f);
-        glUniform1f(glGetUniformLocation(modelShader.Program, "pointLights[0].linear"), 0.09f);
-        glUniform1f(glGetUniformLocation(modelShader.Program, "pointLights[0].quadratic"), 0.032f);
-
-        // Poste 2 (Izquierda)
-        glUniform3f(glGetUniformLocation(modelShader.Program, "pointLights[1].position"), -9.5f, 6.5f, 2.9f);
-        glUniform3f(glGetUniformLocation(modelShader.Program, "pointLights[1].ambient"), 0.05f, 0.05f, 0.0f);
-        glUniform3f(glGetUniformLocation(modelShader.Program, "pointLights[1].diffuse"), 0.8f, 0.8f, 0.6f); // Luz amarilla
-        glUniform3f(glGetUniformLocation(modelShader.Program, "pointLights[1].specular"), 1.0f, 1.0f, 0.8f);
-        glUniform1f(glGetUniformLocation(modelShader.Program, "pointLights[1].constant"), 1.0f);
-        glUniform1f(glGetUniformLocation(modelShader.Program, "pointLights[1].linear"), 0.09f);
-        glUniform1f(glGetUniformLocation(modelShader.Program, "pointLights[1].quadratic"), 0.032f);
-
+        if (fabs(x - 30.0f) > 1.0f && fabs(x + 9.5f) > 1.0f) // No encimar a los originales
+            postPositions.push_back(glm::vec3(x, 0.0f, 2.0f));
+        postPositions.push_back(glm::vec3(x, 0.0f, 14.0f));
+    }
+    for (float t = -42.0f; t <= 42.0f; t += 3.0f)
+    {
+        postPositions.push_back(glm::vec3(t, 0.0f, -44.0f));
+        if (t < -38.0f || t > -22.0f) // Omitir zona estanque
+            postPositions.push_back(glm::vec3(t, 0.0f, 44.0f));
+        postPositions.push_back(glm::vec3(-44.0f, 0.0f, t));
+        postPositions.push_back(glm::vec3(44.0f, 0.0f, t));
+    }
 
-        // --- Lógica de transición de color (Día/Noche) ---
-        if (isTransitioning)
+    // Una luz de punto por poste, a la altura de la bombilla
+    std::vector<ClusterLight> postLights;
+    for (size_t i = 0; i < postPositions.size(); i++)
+    {
+        ClusterLight light;
+        light.position = postPositions[i] + glm::vec3(0.0f, 6.5f, 0.9f);
+        light.ambient = glm::vec3(0.05f, 0.05f, 0.0f);
+        light.diffuse = glm::vec3(0.8f, 0.8f, 0.6f); // Luz amarilla
+        light.specular = glm::vec3(1.0f, 1.0f, 0.8f);
+        light.constant = 1.0f;
+        if (i < 2)
         {
-            transitionFactor += transitionSpeed * deltaTime;
-            transitionFactor = glm::clamp(transitionFactor, 0.0f, 1.0f);
-            currentColor = glm::mix(startTransitionColor, targetColor, transitionFactor);
-
-            if (transitionFactor >= 1.0f)
-            {
-                isTransitioning = false;
-                // Actualiza el estado actual
-                if (targetColor == dayColor) {
-                    isNight = false;
-                    isSunset = false;
-                }
-                else if (targetColor == nightColor) {
-                    isNight = true;
-                    isSunset = false;
-                }
-                else if (targetColor == sunsetColor) {
-                    isNight = false;
-                    isSunset = true;
-                }
-            }
+            // Los postes originales conservan su alcance
+            light.linear = 0.09f;
+            light.quadratic = 0.032f;
         }
+        else
+        {
+            // Los de la avenida alumbran solo su tramo de calle
+            light.linear = 0.35f;
+            light.quadratic = 0.44f;
+        }
+        light.radius = ClusteredLights::CalcRadius(light.constant, light.linear, light.quadratic, 1.0f);
+        postLights.push_back(light);
+    }
 
-        // --- Limpiar pantalla ---
-        glClearColor(currentColor.r, currentColor.g, currentColor.b, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
+    // --- Datos que cambian cada cuadro (huesos, instancias, clusters y uniforms del cuadro) ---
+    // Un buffer mapeado con tres regiones: subir es copiar y nadie espera a la GPU (ver StreamingBuffer.h)
+    StreamingBuffer* frameStream = new StreamingBuffer();
+    std::cout << "BUFFER DEL CUADRO: " << STREAMING_BUFFER_FRAMES << " x " << STREAMING_BUFFER_FRAME_SIZE / 1024 << " KB, "
+              << (frameStream->IsPersistent() ? "mapeado persistente" : "mapeo sin sincronizar por cuadro") << std::endl;
+
+    ClusteredLights* clusteredLights = new ClusteredLights(*frameStream);
+    clusteredLights->SetLights(postLights);
+    std::cout << "POSTES DE LUZ: " << clusteredLights->GetLightCount() << " luces" << std::endl;
+
+    // --- Lightmaps de la parte estática (Tecla B) ---
+    // Se graban los vértices de los VAOs que usa la escena estática (ver Lightmap.h)
+    Lightmap* lightmap = new Lightmap("escena.lightmap");
+    lightmap->AddMesh(VAO, vertices, 36);
+    lightmap->AddMesh(VAO_water, vertices_water, 36);
+    lightmap->AddMesh(VAO_gap, roof_gap_vertices, 3);
+
+    // --- Dibujo de la Escena ---
+    // Todo lo que recibe iluminación, con las variantes que se pasen: modelShaders en forward,
+    // gBufferShaders en deferred o shadowShaders para las sombras (mismos uniforms).
+    // Se separa en la parte estática (casas, árboles, postes, césped y agua), cuyas sombras
+    // se guardan en caché, y la dinámica (Mew y Ho-oh), que se mueve cada cuadro.
+
+    // Activa la variante para lo que sigue. Cada programa guarda sus propios uniforms,
+    // así que el brillo del material se vuelve a poner al cambiar.
+    auto useVariant = [](ShaderVariants& shaders, GLuint flags, GLfloat specular, GLfloat shininess) -> Shader&
+    {
+        Shader& shader = shaders.Use(flags);
+        glUniform3f(glGetUniformLocation(shader.Program, "material.specular"), specular, specular, specular);
+        glUniform1f(glGetUniformLocation(shader.Program, "material.shininess"), shininess);
+        return shader;
+    };
 
+    // --- Escena estática como entidades ---
+    // Las casas, árboles, postes, césped y agua se describen aquí una vez: cada objeto es una
+    // entidad con su matriz, su VAO, su material y su caja. Cada cuadro solo se recorren sus
+    // arreglos (drawStaticScene), en orden de material y sin lo que quede fuera de la cámara.
+    {
         // ===============================================================
-        //     INICIO DEL DIBUJO DE OBJETOS SÓLIDOS (CASAS, ÁRBOLES, ETC.)
+        //     INICIO DE LOS OBJETOS SÓLIDOS (CASAS, ÁRBOLES, ETC.)
         // ===============================================================
 
-        // Declaramos 'model' y 'modelLoc' UNA SOLA VEZ para todo el bucle de dibujo
+        // Material del siguiente objeto (variante SIN textura, brillo estándar). Cada objeto
+        // toma lo que esté puesto, como antes tomaba los uniforms del shader
+        Material material = { 0, glm::vec3(1.0f), 0, 0, 0.5f, 32.0f };
+        auto useMaterial = [&](GLuint flags, GLfloat specular, GLfloat shininess)
+        {
+            material.flags = flags;
+            material.specular = specular;
+            material.shininess = shininess;
+            material.texture = 0;
+            material.alternateTexture = 0;
+        };
+
+        // Declaramos 'model' UNA SOLA VEZ para toda la escena
         glm::mat4 model;
-        GLint modelLoc = glGetUniformLocation(modelShader.Program, "model");
+        GLuint vao = VAO;
 
-        // Configura el shader para objetos sólidos (SIN textura)
-        glUniform1i(glGetUniformLocation(modelShader.Program, "useTexture"), 0); // 0 = NO usar textura
-        glUniform3f(glGetUniformLocation(modelShader.Program, "material.specular"), 0.5f, 0.5f, 0.5f); // Brillo estándar
-        glUniform1f(glGetUniformLocation(modelShader.Program, "material.shininess"), 32.0f);
+        // Agrega un objeto con el VAO puesto (cubo, agua o triángulo del techo)
+        auto addStatic = [&](GLsizei count)
+        {
+            scene->CreateStatic(model, vao, count, material);
+        };
 
-        glBindVertexArray(VAO); // Enlaza el VAO del Cubo
+        vao = VAO; // Enlaza el VAO del Cubo
 
         // ===============================================================
                 //						ESCENARIO EXTERIOR (SIN CÉSPED)
@@ -712,26 +1019,22 @@ int main() {
                     // Tronco
                     model = glm::translate(treeModel, glm::vec3(0.0f, 0.5f, 0.0f));
                     model = glm::scale(model, glm::vec3(1.0f, 3.0f, 1.0f));
-                    glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(treeTrunkColor));
-                    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                    glDrawArrays(GL_TRIANGLES, 0, 36);
+                    material.diffuse = treeTrunkColor;
+                    addStatic(36);
                     // --- Hojas (AHORA CON TEXTURA) ---
-                    // 1. Activar modo textura
-                    glUniform1i(glGetUniformLocation(modelShader.Program, "useTexture"), 1);
+                    // 1. Activar la variante con textura (opaca: no necesita recorte)
+                    useMaterial(SHADER_TEXTURED, 0.5f, 32.0f);
                     // 2. Vincular la textura de hojas
-                    glActiveTexture(GL_TEXTURE0);
-                    glBindTexture(GL_TEXTURE_2D, hojasTextureID);
-                    glUniform1i(glGetUniformLocation(modelShader.Program, "texture_diffuse1"), 0);
+                    material.texture = hojasTextureID;
 
                     // 3. Dibujar
                     model = glm::translate(treeModel, glm::vec3(0.0f, 4.0f, 0.0f));
                     model = glm::scale(model, glm::vec3(4.0f, 4.0f, 4.0f));
                     // (Ya no se usa glUniform3fv... para el color)
-                    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                    glDrawArrays(GL_TRIANGLES, 0, 36);
+                    addStatic(36);
 
-                    // 4. VOLVER a modo color sólido para el siguiente tronco
-                    glUniform1i(glGetUniformLocation(modelShader.Program, "useTexture"), 0);
+                    // 4. VOLVER a la variante de color sólido para el siguiente tronco
+                    useMaterial(0, 0.5f, 32.0f);
                 }
             }
         }
@@ -748,26 +1051,22 @@ int main() {
                     // Tronco
                     model = glm::translate(treeModel, glm::vec3(0.0f, 0.5f, 0.0f));
                     model = glm::scale(model, glm::vec3(1.0f, 3.0f, 1.0f));
-                    glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(treeTrunkColor));
-                    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                    glDrawArrays(GL_TRIANGLES, 0, 36);
+                    material.diffuse = treeTrunkColor;
+                    addStatic(36);
                     // --- Hojas (AHORA CON TEXTURA) ---
-                    // 1. Activar modo textura
-                    glUniform1i(glGetUniformLocation(modelShader.Program, "useTexture"), 1);
+                    // 1. Activar la variante con textura (opaca: no necesita recorte)
+                    useMaterial(SHADER_TEXTURED, 0.5f, 32.0f);
                     // 2. Vincular la textura de hojas
-                    glActiveTexture(GL_TEXTURE0);
-                    glBindTexture(GL_TEXTURE_2D, hojasTextureID);
-                    glUniform1i(glGetUniformLocation(modelShader.Program, "texture_diffuse1"), 0);
+                    material.texture = hojasTextureID;
 
                     // 3. Dibujar
                     model = glm::translate(treeModel, glm::vec3(0.0f, 4.0f, 0.0f));
                     model = glm::scale(model, glm::vec3(4.0f, 4.0f, 4.0f));
                     // (Ya no se usa glUniform3fv... para el color)
-                    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                    glDrawArrays(GL_TRIANGLES, 0, 36);
+                    addStatic(36);
 
-                    // 4. VOLVER a modo color sólido para el siguiente tronco
-                    glUniform1i(glGetUniformLocation(modelShader.Program, "useTexture"), 0);
+                    // 4. VOLVER a la variante de color sólido para el siguiente tronco
+                    useMaterial(0, 0.5f, 32.0f);
                 }
             }
         }
@@ -784,22 +1083,19 @@ int main() {
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, -0.5f, 0.0f));
             model = glm::scale(model, glm::vec3(20.0f, 0.1f, 20.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(floorColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = floorColor;
+            addStatic(36);
             // --- Alfombra Verde (borde blanco) ---
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, -0.45f, 0.0f));
             model = glm::scale(model, glm::vec3(12.5f, 0.1f, 8.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(whiteColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = whiteColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, -0.4f, 0.0f));
             model = glm::scale(model, glm::vec3(12.0f, 0.1f, 8.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(greenRugColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = greenRugColor;
+            addStatic(36);
             // --- Alfombra Roja (con marco negro) ---
             {
                 float centerX = 0.0f, centerY = -0.4f, centerZ = 8.0f;
@@ -809,31 +1105,26 @@ int main() {
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(centerX, centerY, centerZ));
                 model = glm::scale(model, glm::vec3(totalWidth - (frameThick * 2), 0.1f, totalDepth - (frameThick * 2)));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(redRugColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = redRugColor;
+                addStatic(36);
                 // 2. Marco Negro (4 piezas)
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(centerX, frameY, centerZ + (totalDepth / 2.0f) - (frameThick / 2.0f)));
                 model = glm::scale(model, glm::vec3(totalWidth, 0.1f, frameThick));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = blackColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(centerX, frameY, centerZ - (totalDepth / 2.0f) + (frameThick / 2.0f)));
                 model = glm::scale(model, glm::vec3(totalWidth, 0.1f, frameThick));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(centerX - (totalWidth / 2.0f) + (frameThick / 2.0f), frameY, centerZ));
                 model = glm::scale(model, glm::vec3(frameThick, 0.1f, totalDepth - (frameThick * 2)));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(centerX + (totalWidth / 2.0f) - (frameThick / 2.0f), frameY, centerZ));
                 model = glm::scale(model, glm::vec3(frameThick, 0.1f, totalDepth - (frameThick * 2)));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
             }
             // --- Mesa (con marco negro) ---
             {
@@ -844,31 +1135,26 @@ int main() {
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(yellow_X, yellow_Y, yellow_Z));
                 model = glm::scale(model, glm::vec3(yellow_W - (frameThick * 2), yellow_H, yellow_D - (frameThick * 2)));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(tableColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = tableColor;
+                addStatic(36);
                 // Marco Negro (Base)
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(yellow_X, yellow_Y, yellow_Z + (yellow_D / 2.0f) - (frameThick / 2.0f)));
                 model = glm::scale(model, glm::vec3(yellow_W, yellow_H, frameThick));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = blackColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(yellow_X, yellow_Y, yellow_Z - (yellow_D / 2.0f) + (frameThick / 2.0f)));
                 model = glm::scale(model, glm::vec3(yellow_W, yellow_H, frameThick));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(yellow_X - (yellow_W / 2.0f) + (frameThick / 2.0f), yellow_Y, yellow_Z));
                 model = glm::scale(model, glm::vec3(frameThick, yellow_H, yellow_D - (frameThick * 2)));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(yellow_X + (yellow_W / 2.0f) - (frameThick / 2.0f), yellow_Y, yellow_Z));
                 model = glm::scale(model, glm::vec3(frameThick, yellow_H, yellow_D - (frameThick * 2)));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 // 2. Mantel Azul
                 float blue_X = 0.0f, blue_Y = 0.61f, blue_Z = 0.0f;
                 float blue_W = 3.5f, blue_H = 0.02f, blue_D = 2.5f;
@@ -876,31 +1162,26 @@ int main() {
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(blue_X, blue_Y, blue_Z));
                 model = glm::scale(model, glm::vec3(blue_W - (frameThick * 2), blue_H, blue_D - (frameThick * 2)));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(tableTopColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = tableTopColor;
+                addStatic(36);
                 // Marco Negro (Mantel)
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(blue_X, frameY_Blue, blue_Z + (blue_D / 2.0f) - (frameThick / 2.0f)));
                 model = glm::scale(model, glm::vec3(blue_W, blue_H, frameThick));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = blackColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(blue_X, frameY_Blue, blue_Z - (blue_D / 2.0f) + (frameThick / 2.0f)));
                 model = glm::scale(model, glm::vec3(blue_W, blue_H, frameThick));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(blue_X - (blue_W / 2.0f) + (frameThick / 2.0f), frameY_Blue, blue_Z));
                 model = glm::scale(model, glm::vec3(frameThick, blue_H, blue_D - (frameThick * 2)));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(blue_X + (blue_W / 2.0f) - (frameThick / 2.0f), frameY_Blue, blue_Z));
                 model = glm::scale(model, glm::vec3(frameThick, blue_H, blue_D - (frameThick * 2)));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
             }
             // Patas de la Mesa
             float tableLegX = 1.8f, tableLegZ = 1.3f;
@@ -908,13 +1189,12 @@ int main() {
                 glm::vec3(tableLegX, 0.0f, tableLegZ), glm::vec3(tableLegX, 0.0f, -tableLegZ),
                 glm::vec3(-tableLegX, 0.0f, tableLegZ), glm::vec3(-tableLegX, 0.0f, -tableLegZ)
             };
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(tableColor));
+            material.diffuse = tableColor;
             for (int i = 0; i < 4; i++) {
                 model = houseBaseModel;
                 model = glm::translate(model, tableLegPos[i]);
                 model = glm::scale(model, glm::vec3(0.2f, 0.8f, 0.2f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
             }
             // Sillas (4)
             float chairPositions[4][3] = { {2.5f, 0.0f, 0.0f}, {-2.5f, 0.0f, 0.0f}, {0.0f, 0.0f, 2.0f}, {0.0f, 0.0f, -2.0f} };
@@ -927,15 +1207,13 @@ int main() {
                 model = chairBase;
                 model = glm::translate(model, glm::vec3(0.0f, 0.2f, 0.0f));
                 model = glm::scale(model, glm::vec3(1.0f, 0.2f, 1.0f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(chairColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = chairColor;
+                addStatic(36);
                 // Respaldo
                 model = chairBase;
                 model = glm::translate(model, glm::vec3(0.0f, 0.75f, -0.4f));
                 model = glm::scale(model, glm::vec3(1.0f, 1.0f, 0.2f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 // Patas de la Silla
                 float chairLegX = 0.4f, chairLegZ = 0.4f, legHeight = 0.5f, legCenterY = -0.15f;
                 glm::vec3 chairLegPos[] = {
@@ -946,45 +1224,39 @@ int main() {
                     model = chairBase;
                     model = glm::translate(model, chairLegPos[j]);
                     model = glm::scale(model, glm::vec3(0.1f, legHeight, 0.1f));
-                    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                    glDrawArrays(GL_TRIANGLES, 0, 36);
+                    addStatic(36);
                 }
             }
             // Plantas
-            
+        
             for (int i = 0; i < 2; i++) {
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(plantPositions[i][0], -0.325f, plantPositions[i][1]));
                 model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(potColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = potColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(plantPositions[i][0], 0.05f, plantPositions[i][1]));
                 model = glm::scale(model, glm::vec3(0.50f, 0.50f, 0.50f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(plantColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = plantColor;
+                addStatic(36);
             }
             // TV Planta Baja
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, -0.05f, -8.5f));
             model = glm::scale(model, glm::vec3(4.0f, 0.8f, 2.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(windowColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = windowColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, 1.2f, -8.5f));
             model = glm::scale(model, glm::vec3(4.0f, 1.7f, 2.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = blackColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, 1.2f, -7.49f));
             model = glm::scale(model, glm::vec3(3.6f, 1.5f, 0.02f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(lightGreyColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = lightGreyColor;
+            addStatic(36);
             // Alacena 
             {
                 float cabinetBaseX = -4.0f, cabinetBaseZ = -8.5f, cabinetDepth = 2.0f;
@@ -1000,52 +1272,44 @@ int main() {
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX, base_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth - (frameThick * 2), base_H, cabinetDepth));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(deskColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = deskColor;
+                addStatic(36);
                 // 2. Vidrio Azul
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX, glass_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth - (frameThick * 2), glass_H, cabinetDepth));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(windowColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = windowColor;
+                addStatic(36);
                 // 3. Marco Negro (Pilares)
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX - (totalWidth / 2.0f) + (frameThick / 2.0f), pillar_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, total_H, cabinetDepth + 0.01f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = blackColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX + (totalWidth / 2.0f) - (frameThick / 2.0f), pillar_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, total_H, cabinetDepth + 0.01f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 // 4. Marco Café (Vigas Horizontales)
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX, floorY + total_H - (frameThick / 2.0f), cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth, frameThick, cabinetDepth + 0.01f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(deskColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = deskColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX, mid_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth, mid_H, cabinetDepth + 0.01f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 // 5. Marco Negro (Vigas Verticales)
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX, glass_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, glass_H, cabinetDepth + 0.02f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = blackColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX, base_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, base_H, cabinetDepth + 0.02f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
             }
             // Lavabo (Estilo Pokémon)
             {
@@ -1063,59 +1327,50 @@ int main() {
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(sinkBaseX, top_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth - (frameThick * 2), top_H, sinkDepth));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(lightGreyColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = lightGreyColor;
+                addStatic(36);
                 // 2. Base Azul
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(left_X, bottom_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(left_W - (frameThick / 2.0f), bottom_H, sinkDepth));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(windowColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = windowColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(right_X, bottom_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(right_W - (frameThick / 2.0f), bottom_H, sinkDepth));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 // 3. Marco Negro
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
+                material.diffuse = blackColor;
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(sinkBaseX - (totalWidth / 2.0f) + (frameThick / 2.0f), pillar_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, total_H, sinkDepth + 0.01f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(sinkBaseX + (totalWidth / 2.0f) - (frameThick / 2.0f), pillar_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, total_H, sinkDepth + 0.01f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(sinkBaseX, floorY + total_H - (frameThick / 2.0f), sinkBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth, frameThick, sinkDepth + 0.01f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(sinkBaseX, mid_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth, mid_H, sinkDepth + 0.01f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(divider_X, bottom_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, bottom_H, sinkDepth + 0.02f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
             }
             // Escaleras
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(stairsColor));
+            material.diffuse = stairsColor;
             for (int i = 0; i < 7; i++) {
                 model = houseBaseModel;
                 float stepY = -0.2f + i * 0.25f;
                 float stepX = 5.0f + i * 0.75f;
                 model = glm::translate(model, glm::vec3(stepX, stepY, -8.0f));
                 model = glm::scale(model, glm::vec3(0.75f, 0.25f, 2.5f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
             }
             // --- SEGUNDO PISO ---
             float secondFloorY = 3.0f;
@@ -1123,119 +1378,100 @@ int main() {
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, secondFloorY, 0.0f));
             model = glm::scale(model, glm::vec3(20.0f, 0.1f, 20.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(floorColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = floorColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, secondFloorY + 4.0f, -10.0f));
             model = glm::scale(model, glm::vec3(20.0f, 8.0f, 0.1f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(wallColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = wallColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-10.0f, secondFloorY + 4.0f, 0.0f));
             model = glm::scale(model, glm::vec3(0.1f, 8.0f, 20.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             // Cama
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 0.5f, 2.0f));
             model = glm::scale(model, glm::vec3(3.0f, 1.0f, 5.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(whiteColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = whiteColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 1.05f, 2.0f));
             model = glm::scale(model, glm::vec3(3.0f, 0.1f, 3.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(bedBlanketColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = bedBlanketColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 1.2f, 2.0f - 2.0f));
             model = glm::scale(model, glm::vec3(2.5f, 0.4f, 1.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(whiteColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = whiteColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 2.0f, 2.0f - 2.6f));
             model = glm::scale(model, glm::vec3(3.0f, 2.0f, 0.2f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(deskColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = deskColor;
+            addStatic(36);
             // Escritorio
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-1.0f, secondFloorY + 1.5f, -9.0f));
             model = glm::scale(model, glm::vec3(18.0f, 0.2f, 2.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(deskColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = deskColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-1.0f - 8.8f, secondFloorY + 0.75f, -9.0f));
             model = glm::scale(model, glm::vec3(0.2f, 1.5f, 2.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-1.0f + 8.8f, secondFloorY + 0.75f, -9.0f));
             model = glm::scale(model, glm::vec3(0.2f, 1.5f, 2.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             // Estantería
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(2.0f, secondFloorY + 2.6f, -9.2f));
             model = glm::scale(model, glm::vec3(4.0f, 2.0f, 1.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(bookshelfColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = bookshelfColor;
+            addStatic(36);
             // Libros
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(1.5f, secondFloorY + 2.1f, -9.1f));
             model = glm::scale(model, glm::vec3(0.2f, 1.0f, 1.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(redRugColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = redRugColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(1.8f, secondFloorY + 2.1f, -9.1f));
             model = glm::scale(model, glm::vec3(0.2f, 1.0f, 1.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(plantColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = plantColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(2.1f, secondFloorY + 2.1f, -9.1f));
             model = glm::scale(model, glm::vec3(0.2f, 1.0f, 1.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(chairColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = chairColor;
+            addStatic(36);
             // PC
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 2.3f, -9.0f));
             model = glm::scale(model, glm::vec3(1.5f, 1.5f, 0.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(pcColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = pcColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-9.5f, secondFloorY + 2.2f, -9.0f));
             model = glm::scale(model, glm::vec3(1.0f, 1.4f, 1.8f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 1.6f, -9.0f + 0.6f));
             model = glm::scale(model, glm::vec3(1.2f, 0.05f, 0.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = blackColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-7.2f, secondFloorY + 1.6f, -9.0f + 0.6f));
             model = glm::scale(model, glm::vec3(0.25f, 0.05f, 0.4f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             //pantalla de la PC
             model = houseBaseModel;
             // Posicionada ligeramente al frente del monitor
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 2.3f, -8.74f));
             model = glm::scale(model, glm::vec3(1.4f, 1.4f, 0.05f)); // Plana
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = blackColor;
+            addStatic(36);
 
             // --- Silla de la pc ---
             glm::mat4 chairBaseModel = houseBaseModel;
@@ -1250,96 +1486,83 @@ int main() {
             model = chairBaseModel; // Empezar desde la base de la silla
             model = glm::translate(model, glm::vec3(0.0f, 0.5f, 0.0f)); // Posición Y relativa
             model = glm::scale(model, glm::vec3(0.2f, 1.0f, 0.2f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = blackColor;
+            addStatic(36);
 
             // Asiento (relativo a chairBaseModel)
             model = chairBaseModel; // Empezar desde la base de la silla
             model = glm::translate(model, glm::vec3(0.0f, 1.0f, 0.0f)); // Posición Y relativa
             model = glm::scale(model, glm::vec3(0.8f, 0.2f, 0.8f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(pcColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = pcColor;
+            addStatic(36);
 
             // Respaldo (relativo a chairBaseModel)
             model = chairBaseModel; // Empezar desde la base de la silla
             // Se dibuja en Z -0.3f (hacia "atrás" de la silla)
             model = glm::translate(model, glm::vec3(0.0f, 1.5f, -0.3f));
             model = glm::scale(model, glm::vec3(0.8f, 1.0f, 0.2f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(pcColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = pcColor;
+            addStatic(36);
             // TV (Segunda Planta)
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, secondFloorY + 0.5f, 0.0f));
             model = glm::scale(model, glm::vec3(3.5f, 1.0f, 2.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(electronicsColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = electronicsColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, secondFloorY + 1.8f, 0.0f));
             model = glm::scale(model, glm::vec3(2.5f, 1.5f, 0.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(lightGreyColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = lightGreyColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, secondFloorY + 1.8f, 0.0f + 0.26f));
             model = glm::scale(model, glm::vec3(2.2f, 1.3f, 0.05f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = blackColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, secondFloorY + 1.1f, 0.8f));
             model = glm::scale(model, glm::vec3(1.5f, 0.2f, 1.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(lightGreyColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = lightGreyColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-1.25f, secondFloorY + 0.5f, 0.0f + 0.9f));
             model = glm::scale(model, glm::vec3(0.5f, 0.5f, 0.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(windowColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = windowColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(1.25f, secondFloorY + 0.5f, 0.0f + 0.9f));
             model = glm::scale(model, glm::vec3(0.5f, 0.5f, 0.5f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             // Fachada y Techo
             model = houseBaseModel;
             // Pared Frontal (Z-)
             model = glm::translate(model, glm::vec3(0.0f, houseHeight / 2.0f - 0.5f, -10.0f));
             // CAMBIO: 0.1f -> 0.4f (Engrosar pared)
             model = glm::scale(model, glm::vec3(20.0f, houseHeight, 0.4f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(facadeColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = facadeColor;
+            addStatic(36);
 
             // Pared Izquierda (X-)
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-10.0f, houseHeight / 2.0f - 0.5f, 0.0f));
             // CAMBIO: 0.1f -> 0.4f (Engrosar pared)
             model = glm::scale(model, glm::vec3(0.4f, houseHeight, 20.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
 
             // Pared Derecha (X+)
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(10.0f, houseHeight / 2.0f - 0.5f, 0.0f));
             // CAMBIO: 0.1f -> 0.4f (Engrosar pared)
             model = glm::scale(model, glm::vec3(0.4f, houseHeight, 20.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, houseHeight / 2.0f - 0.5f, 10.0f));
             model = glm::scale(model, glm::vec3(20.0f, houseHeight, 0.1f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             // Relleno del Hueco del Techo (Triángulo)
             {
-                glBindVertexArray(VAO_gap); // <-- Usar el VAO del triángulo
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(facadeColor));
+                vao = VAO_gap; // <-- Usar el VAO del triángulo
+                material.diffuse = facadeColor;
                 float gapHeight = 6.46f;
                 float gapCenterY = 10.5f + (gapHeight / 2.0f);
                 float houseWidth = 20.0f, wallDepth = 0.1f;
@@ -1347,22 +1570,18 @@ int main() {
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(0.0f, gapCenterY, 10.0f));
                 model = glm::scale(model, glm::vec3(houseWidth, gapHeight, wallDepth));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 3); // Solo 3 vértices
+                addStatic(3); // Solo 3 vértices
                 // Relleno trasero
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(0.0f, gapCenterY, -10.0f));
                 model = glm::scale(model, glm::vec3(houseWidth, gapHeight, wallDepth));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 3); // Solo 3 vértices
-                glBindVertexArray(VAO); // <-- Volver al VAO del cubo
+                addStatic(3); // Solo 3 vértices
+                vao = VAO; // <-- Volver al VAO del cubo
             }
             // Techo
              // --- ACTIVAR TEXTURA DE TEJADO ---
-            glUniform1i(glGetUniformLocation(modelShader.Program, "useTexture"), 1);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, tejadoTextureID);
-            glUniform1i(glGetUniformLocation(modelShader.Program, "texture_diffuse1"), 0);
+            useMaterial(SHADER_TEXTURED, 0.5f, 32.0f);
+            material.texture = tejadoTextureID;
 
             float roofBaseY = houseHeight - 0.5f;
             model = houseBaseModel;
@@ -1370,43 +1589,37 @@ int main() {
             model = glm::rotate(model, glm::radians(30.0f), glm::vec3(0.0f, 0.0f, 1.0f));
             model = glm::scale(model, glm::vec3(12.5f, 0.2f, 22.0f));
             // La línea de glUniform3fv(roofColor) se elimina
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
 
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(5.2f, roofBaseY + 3.25f, 0.0f));
             model = glm::rotate(model, glm::radians(-30.0f), glm::vec3(0.0f, 0.0f, 1.0f));
             model = glm::scale(model, glm::vec3(12.5f, 0.2f, 22.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
 
             // --- VOLVER A MODO COLOR SÓLIDO ---
             // (Importante para que la puerta y ventanas se dibujen bien)
-            glUniform1i(glGetUniformLocation(modelShader.Program, "useTexture"), 0);
+            useMaterial(0, 0.5f, 32.0f);
             // Puerta y Ventanas
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-3.0f, 0.5f, 10.05f));
             model = glm::scale(model, glm::vec3(2.5f, 3.0f, 0.1f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(doorColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = doorColor;
+            addStatic(36);
             float windowZ = 10.05f;
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(4.5f, 1.5f, windowZ));
             model = glm::scale(model, glm::vec3(3.5f, 2.5f, 0.1f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(windowColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = windowColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-4.5f, secondFloorY + 2.0f, windowZ));
             model = glm::scale(model, glm::vec3(3.5f, 2.5f, 0.1f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(4.5f, secondFloorY + 2.0f, windowZ));
             model = glm::scale(model, glm::vec3(3.5f, 2.5f, 0.1f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
         }
 
         // ===============================================================
@@ -1420,22 +1633,19 @@ int main() {
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, -0.5f, 0.0f));
             model = glm::scale(model, glm::vec3(20.0f, 0.1f, 20.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(floorColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = floorColor;
+            addStatic(36);
             // --- Alfombra Verde (borde blanco) ---
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, -0.45f, 0.0f));
             model = glm::scale(model, glm::vec3(12.5f, 0.1f, 8.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(whiteColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = whiteColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, -0.4f, 0.0f));
             model = glm::scale(model, glm::vec3(12.0f, 0.1f, 8.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(greenRugColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = greenRugColor;
+            addStatic(36);
             // --- Alfombra Roja (con marco negro) ---
             {
                 float centerX = 0.0f, centerY = -0.4f, centerZ = 8.0f;
@@ -1444,30 +1654,25 @@ int main() {
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(centerX, centerY, centerZ));
                 model = glm::scale(model, glm::vec3(totalWidth - (frameThick * 2), 0.1f, totalDepth - (frameThick * 2)));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(redRugColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = redRugColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(centerX, frameY, centerZ + (totalDepth / 2.0f) - (frameThick / 2.0f)));
                 model = glm::scale(model, glm::vec3(totalWidth, 0.1f, frameThick));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = blackColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(centerX, frameY, centerZ - (totalDepth / 2.0f) + (frameThick / 2.0f)));
                 model = glm::scale(model, glm::vec3(totalWidth, 0.1f, frameThick));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(centerX - (totalWidth / 2.0f) + (frameThick / 2.0f), frameY, centerZ));
                 model = glm::scale(model, glm::vec3(frameThick, 0.1f, totalDepth - (frameThick * 2)));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(centerX + (totalWidth / 2.0f) - (frameThick / 2.0f), frameY, centerZ));
                 model = glm::scale(model, glm::vec3(frameThick, 0.1f, totalDepth - (frameThick * 2)));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
             }
             // --- Mesa (con marco negro) ---
             {
@@ -1477,60 +1682,50 @@ int main() {
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(yellow_X, yellow_Y, yellow_Z));
                 model = glm::scale(model, glm::vec3(yellow_W - (frameThick * 2), yellow_H, yellow_D - (frameThick * 2)));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(tableColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = tableColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(yellow_X, yellow_Y, yellow_Z + (yellow_D / 2.0f) - (frameThick / 2.0f)));
                 model = glm::scale(model, glm::vec3(yellow_W, yellow_H, frameThick));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = blackColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(yellow_X, yellow_Y, yellow_Z - (yellow_D / 2.0f) + (frameThick / 2.0f)));
                 model = glm::scale(model, glm::vec3(yellow_W, yellow_H, frameThick));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(yellow_X - (yellow_W / 2.0f) + (frameThick / 2.0f), yellow_Y, yellow_Z));
                 model = glm::scale(model, glm::vec3(frameThick, yellow_H, yellow_D - (frameThick * 2)));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(yellow_X + (yellow_W / 2.0f) - (frameThick / 2.0f), yellow_Y, yellow_Z));
                 model = glm::scale(model, glm::vec3(frameThick, yellow_H, yellow_D - (frameThick * 2)));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 float blue_X = 0.0f, blue_Y = 0.61f, blue_Z = 0.0f;
                 float blue_W = 3.5f, blue_H = 0.02f, blue_D = 2.5f;
                 float frameY_Blue = blue_Y + 0.01f;
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(blue_X, blue_Y, blue_Z));
                 model = glm::scale(model, glm::vec3(blue_W - (frameThick * 2), blue_H, blue_D - (frameThick * 2)));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(tableTopColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = tableTopColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(blue_X, frameY_Blue, blue_Z + (blue_D / 2.0f) - (frameThick / 2.0f)));
                 model = glm::scale(model, glm::vec3(blue_W, blue_H, frameThick));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = blackColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(blue_X, frameY_Blue, blue_Z - (blue_D / 2.0f) + (frameThick / 2.0f)));
                 model = glm::scale(model, glm::vec3(blue_W, blue_H, frameThick));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(blue_X - (blue_W / 2.0f) + (frameThick / 2.0f), frameY_Blue, blue_Z));
                 model = glm::scale(model, glm::vec3(frameThick, blue_H, blue_D - (frameThick * 2)));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(blue_X + (blue_W / 2.0f) - (frameThick / 2.0f), frameY_Blue, blue_Z));
                 model = glm::scale(model, glm::vec3(frameThick, blue_H, blue_D - (frameThick * 2)));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
             }
             // Patas de la Mesa
             float tableLegX = 1.8f, tableLegZ = 1.3f;
@@ -1538,13 +1733,12 @@ int main() {
                 glm::vec3(tableLegX, 0.0f, tableLegZ), glm::vec3(tableLegX, 0.0f, -tableLegZ),
                 glm::vec3(-tableLegX, 0.0f, tableLegZ), glm::vec3(-tableLegX, 0.0f, -tableLegZ)
             };
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(tableColor));
+            material.diffuse = tableColor;
             for (int i = 0; i < 4; i++) {
                 model = houseBaseModel;
                 model = glm::translate(model, tableLegPos[i]);
                 model = glm::scale(model, glm::vec3(0.2f, 0.8f, 0.2f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
             }
             // Sillas (4)
             for (int i = 0; i < 4; i++) {
@@ -1554,14 +1748,12 @@ int main() {
                 model = chairBase;
                 model = glm::translate(model, glm::vec3(0.0f, 0.2f, 0.0f));
                 model = glm::scale(model, glm::vec3(1.0f, 0.2f, 1.0f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(chairColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = chairColor;
+                addStatic(36);
                 model = chairBase;
                 model = glm::translate(model, glm::vec3(0.0f, 0.75f, -0.4f));
                 model = glm::scale(model, glm::vec3(1.0f, 1.0f, 0.2f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 float chairLegX = 0.4f, chairLegZ = 0.4f, legHeight = 0.5f, legCenterY = -0.15f;
                 glm::vec3 chairLegPos[] = {
                     glm::vec3(chairLegX, legCenterY, chairLegZ), glm::vec3(chairLegX, legCenterY, -chairLegZ),
@@ -1571,8 +1763,7 @@ int main() {
                     model = chairBase;
                     model = glm::translate(model, chairLegPos[j]);
                     model = glm::scale(model, glm::vec3(0.1f, legHeight, 0.1f));
-                    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                    glDrawArrays(GL_TRIANGLES, 0, 36);
+                    addStatic(36);
                 }
             }
             // Plantas
@@ -1580,35 +1771,30 @@ int main() {
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(plantPositions[i][0], -0.325f, plantPositions[i][1]));
                 model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(potColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = potColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(plantPositions[i][0], 0.05f, plantPositions[i][1]));
                 model = glm::scale(model, glm::vec3(0.50f, 0.50f, 0.50f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(plantColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = plantColor;
+                addStatic(36);
             }
             // TV Planta Baja
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, -0.05f, -8.5f));
             model = glm::scale(model, glm::vec3(4.0f, 0.8f, 2.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(windowColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = windowColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, 1.2f, -8.5f));
             model = glm::scale(model, glm::vec3(4.0f, 1.7f, 2.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = blackColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, 1.2f, -7.49f));
             model = glm::scale(model, glm::vec3(3.6f, 1.5f, 0.02f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(lightGreyColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = lightGreyColor;
+            addStatic(36);
             // Alacena (Estilo Pokémon)
             {
                 float cabinetBaseX = -4.0f, cabinetBaseZ = -8.5f, cabinetDepth = 2.0f;
@@ -1623,48 +1809,40 @@ int main() {
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX, base_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth - (frameThick * 2), base_H, cabinetDepth));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(deskColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = deskColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX, glass_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth - (frameThick * 2), glass_H, cabinetDepth));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(windowColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = windowColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX - (totalWidth / 2.0f) + (frameThick / 2.0f), pillar_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, total_H, cabinetDepth + 0.01f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = blackColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX + (totalWidth / 2.0f) - (frameThick / 2.0f), pillar_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, total_H, cabinetDepth + 0.01f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX, floorY + total_H - (frameThick / 2.0f), cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth, frameThick, cabinetDepth + 0.01f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(deskColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = deskColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX, mid_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth, mid_H, cabinetDepth + 0.01f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX, glass_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, glass_H, cabinetDepth + 0.02f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = blackColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(cabinetBaseX, base_Y, cabinetBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, base_H, cabinetDepth + 0.02f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
             }
             // Lavabo (Estilo Pokémon)
             {
@@ -1681,57 +1859,48 @@ int main() {
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(sinkBaseX, top_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth - (frameThick * 2), top_H, sinkDepth));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(lightGreyColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = lightGreyColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(left_X, bottom_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(left_W - (frameThick / 2.0f), bottom_H, sinkDepth));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(windowColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = windowColor;
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(right_X, bottom_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(right_W - (frameThick / 2.0f), bottom_H, sinkDepth));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
+                addStatic(36);
+                material.diffuse = blackColor;
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(sinkBaseX - (totalWidth / 2.0f) + (frameThick / 2.0f), pillar_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, total_H, sinkDepth + 0.01f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(sinkBaseX + (totalWidth / 2.0f) - (frameThick / 2.0f), pillar_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, total_H, sinkDepth + 0.01f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(sinkBaseX, floorY + total_H - (frameThick / 2.0f), sinkBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth, frameThick, sinkDepth + 0.01f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(sinkBaseX, mid_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(totalWidth, mid_H, sinkDepth + 0.01f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(divider_X, bottom_Y, sinkBaseZ));
                 model = glm::scale(model, glm::vec3(frameThick, bottom_H, sinkDepth + 0.02f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
             }
             // Escaleras
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(stairsColor));
+            material.diffuse = stairsColor;
             for (int i = 0; i < 7; i++) {
                 model = houseBaseModel;
                 float stepY = -0.2f + i * 0.25f;
                 float stepX = 5.0f + i * 0.75f;
                 model = glm::translate(model, glm::vec3(stepX, stepY, -8.0f));
                 model = glm::scale(model, glm::vec3(0.75f, 0.25f, 2.5f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
             }
             // --- SEGUNDO PISO ---
             float secondFloorY = 3.0f;
@@ -1739,119 +1908,100 @@ int main() {
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, secondFloorY, 0.0f));
             model = glm::scale(model, glm::vec3(20.0f, 0.1f, 20.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(floorColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = floorColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, secondFloorY + 4.0f, -10.0f));
             model = glm::scale(model, glm::vec3(20.0f, 8.0f, 0.1f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(wallColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = wallColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-10.0f, secondFloorY + 4.0f, 0.0f));
             model = glm::scale(model, glm::vec3(0.1f, 8.0f, 20.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             // Cama
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 0.5f, 2.0f));
             model = glm::scale(model, glm::vec3(3.0f, 1.0f, 5.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(whiteColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = whiteColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 1.05f, 2.0f));
             model = glm::scale(model, glm::vec3(3.0f, 0.1f, 3.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(bedBlanketColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = bedBlanketColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 1.2f, 2.0f - 2.0f));
             model = glm::scale(model, glm::vec3(2.5f, 0.4f, 1.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(whiteColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = whiteColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 2.0f, 2.0f - 2.6f));
             model = glm::scale(model, glm::vec3(3.0f, 2.0f, 0.2f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(deskColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = deskColor;
+            addStatic(36);
             // Escritorio
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-1.0f, secondFloorY + 1.5f, -9.0f));
             model = glm::scale(model, glm::vec3(18.0f, 0.2f, 2.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(deskColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = deskColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-1.0f - 8.8f, secondFloorY + 0.75f, -9.0f));
             model = glm::scale(model, glm::vec3(0.2f, 1.5f, 2.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-1.0f + 8.8f, secondFloorY + 0.75f, -9.0f));
             model = glm::scale(model, glm::vec3(0.2f, 1.5f, 2.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             // Estantería
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(2.0f, secondFloorY + 2.6f, -9.2f));
             model = glm::scale(model, glm::vec3(4.0f, 2.0f, 1.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(bookshelfColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = bookshelfColor;
+            addStatic(36);
             // Libros
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(1.5f, secondFloorY + 2.1f, -9.1f));
             model = glm::scale(model, glm::vec3(0.2f, 1.0f, 1.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(redRugColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = redRugColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(1.8f, secondFloorY + 2.1f, -9.1f));
             model = glm::scale(model, glm::vec3(0.2f, 1.0f, 1.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(plantColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = plantColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(2.1f, secondFloorY + 2.1f, -9.1f));
             model = glm::scale(model, glm::vec3(0.2f, 1.0f, 1.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(chairColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = chairColor;
+            addStatic(36);
             // PC
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 2.3f, -9.0f));
             model = glm::scale(model, glm::vec3(1.5f, 1.5f, 0.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(pcColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = pcColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-9.5f, secondFloorY + 2.2f, -9.0f));
             model = glm::scale(model, glm::vec3(1.0f, 1.4f, 1.8f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 1.6f, -9.0f + 0.6f));
             model = glm::scale(model, glm::vec3(1.2f, 0.05f, 0.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = blackColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-7.2f, secondFloorY + 1.6f, -9.0f + 0.6f));
             model = glm::scale(model, glm::vec3(0.25f, 0.05f, 0.4f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             //pantalla de la PC
             model = houseBaseModel;
             // Posicionada ligeramente al frente del monitor
             model = glm::translate(model, glm::vec3(-8.0f, secondFloorY + 2.3f, -8.74f));
             model = glm::scale(model, glm::vec3(1.4f, 1.4f, 0.05f)); // Plana
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = blackColor;
+            addStatic(36);
 
             // --- Silla de la pc ---
             glm::mat4 chairBaseModel = houseBaseModel;
@@ -1866,118 +2016,101 @@ int main() {
             model = chairBaseModel; // Empezar desde la base de la silla
             model = glm::translate(model, glm::vec3(0.0f, 0.5f, 0.0f)); // Posición Y relativa
             model = glm::scale(model, glm::vec3(0.2f, 1.0f, 0.2f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = blackColor;
+            addStatic(36);
 
             // Asiento
             model = chairBaseModel; // Empezar desde la base de la silla
             model = glm::translate(model, glm::vec3(0.0f, 1.0f, 0.0f)); // Posición Y relativa
             model = glm::scale(model, glm::vec3(0.8f, 0.2f, 0.8f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(pcColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = pcColor;
+            addStatic(36);
 
             // Respaldo (relativo a chairBaseModel)
             model = chairBaseModel; // Empezar desde la base de la silla
             // Se dibuja en Z -0.3f (hacia "atrás" de la silla)
             model = glm::translate(model, glm::vec3(0.0f, 1.5f, -0.3f));
             model = glm::scale(model, glm::vec3(0.8f, 1.0f, 0.2f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(pcColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = pcColor;
+            addStatic(36);
 
             // TV (Segunda Planta)
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, secondFloorY + 0.5f, 0.0f));
             model = glm::scale(model, glm::vec3(3.5f, 1.0f, 2.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(electronicsColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = electronicsColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, secondFloorY + 1.8f, 0.0f));
             model = glm::scale(model, glm::vec3(2.5f, 1.5f, 0.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(lightGreyColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = lightGreyColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, secondFloorY + 1.8f, 0.0f + 0.26f));
             model = glm::scale(model, glm::vec3(2.2f, 1.3f, 0.05f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(blackColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = blackColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, secondFloorY + 1.1f, 0.8f));
             model = glm::scale(model, glm::vec3(1.5f, 0.2f, 1.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(lightGreyColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = lightGreyColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-1.25f, secondFloorY + 0.5f, 0.0f + 0.9f));
             model = glm::scale(model, glm::vec3(0.5f, 0.5f, 0.5f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(windowColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = windowColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(1.25f, secondFloorY + 0.5f, 0.0f + 0.9f));
             model = glm::scale(model, glm::vec3(0.5f, 0.5f, 0.5f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             // Fachada y Techo
             model = houseBaseModel;
             // Pared Frontal (Z-)
             model = glm::translate(model, glm::vec3(0.0f, houseHeight / 2.0f - 0.5f, -10.0f));
             // CAMBIO: 0.1f -> 0.4f (Engrosar pared)
             model = glm::scale(model, glm::vec3(20.0f, houseHeight, 0.4f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(facadeColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = facadeColor;
+            addStatic(36);
 
             // Pared Izquierda (X-)
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-10.0f, houseHeight / 2.0f - 0.5f, 0.0f));
             // CAMBIO: 0.1f -> 0.4f (Engrosar pared)
             model = glm::scale(model, glm::vec3(0.4f, houseHeight, 20.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
 
             // Pared Derecha (X+)
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(10.0f, houseHeight / 2.0f - 0.5f, 0.0f));
             // CAMBIO: 0.1f -> 0.4f (Engrosar pared)
             model = glm::scale(model, glm::vec3(0.4f, houseHeight, 20.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, houseHeight / 2.0f - 0.5f, 10.0f));
             model = glm::scale(model, glm::vec3(20.0f, houseHeight, 0.1f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             // Relleno del Hueco del Techo (Triángulo)
             {
-                glBindVertexArray(VAO_gap); // <-- Usar el VAO del triángulo
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(facadeColor));
+                vao = VAO_gap; // <-- Usar el VAO del triángulo
+                material.diffuse = facadeColor;
                 float gapHeight = 6.46f;
                 float gapCenterY = 10.5f + (gapHeight / 2.0f);
                 float houseWidth = 20.0f, wallDepth = 0.1f;
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(0.0f, gapCenterY, 10.0f));
                 model = glm::scale(model, glm::vec3(houseWidth, gapHeight, wallDepth));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 3);
+                addStatic(3);
                 model = houseBaseModel;
                 model = glm::translate(model, glm::vec3(0.0f, gapCenterY, -10.0f));
                 model = glm::scale(model, glm::vec3(houseWidth, gapHeight, wallDepth));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 3);
-                glBindVertexArray(VAO); // <-- Volver al VAO del cubo
+                addStatic(3);
+                vao = VAO; // <-- Volver al VAO del cubo
             }
             // Techo
             // --- ACTIVAR TEXTURA DE TEJADO ---
-            glUniform1i(glGetUniformLocation(modelShader.Program, "useTexture"), 1);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, tejadoTextureID);
-            glUniform1i(glGetUniformLocation(modelShader.Program, "texture_diffuse1"), 0);
+            useMaterial(SHADER_TEXTURED, 0.5f, 32.0f);
+            material.texture = tejadoTextureID;
 
             float roofBaseY = houseHeight - 0.5f;
             model = houseBaseModel;
@@ -1985,43 +2118,37 @@ int main() {
             model = glm::rotate(model, glm::radians(30.0f), glm::vec3(0.0f, 0.0f, 1.0f));
             model = glm::scale(model, glm::vec3(12.5f, 0.2f, 22.0f));
             // La línea de glUniform3fv(roofColor) se elimina
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
 
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(5.2f, roofBaseY + 3.25f, 0.0f));
             model = glm::rotate(model, glm::radians(-30.0f), glm::vec3(0.0f, 0.0f, 1.0f));
             model = glm::scale(model, glm::vec3(12.5f, 0.2f, 22.0f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
 
             // --- VOLVER A MODO COLOR SÓLIDO ---
             // (Importante para que la puerta y ventanas se dibujen bien)
-            glUniform1i(glGetUniformLocation(modelShader.Program, "useTexture"), 0);
+            useMaterial(0, 0.5f, 32.0f);
             // Puerta y Ventanas
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-3.0f, 0.5f, 10.05f));
             model = glm::scale(model, glm::vec3(2.5f, 3.0f, 0.1f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(doorColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = doorColor;
+            addStatic(36);
             float windowZ = 10.05f;
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(4.5f, 1.5f, windowZ));
             model = glm::scale(model, glm::vec3(3.5f, 2.5f, 0.1f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(windowColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = windowColor;
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(-4.5f, secondFloorY + 2.0f, windowZ));
             model = glm::scale(model, glm::vec3(3.5f, 2.5f, 0.1f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
             model = houseBaseModel;
             model = glm::translate(model, glm::vec3(4.5f, secondFloorY + 2.0f, windowZ));
             model = glm::scale(model, glm::vec3(3.5f, 2.5f, 0.1f));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            addStatic(36);
         }
 
         // --- Laboratorio ---
@@ -2031,57 +2158,46 @@ int main() {
             model = labBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, 2.0f, 0.0f));
             model = glm::scale(model, glm::vec3(30.0f, 5.0f, 15.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(labWallColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = labWallColor;
+            addStatic(36);
             // Techo
             model = labBaseModel;
             model = glm::translate(model, glm::vec3(0.0f, 4.5f, 0.0f));
             model = glm::scale(model, glm::vec3(32.0f, 0.5f, 16.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(labRoofColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = labRoofColor;
+            addStatic(36);
             // Estructura roja lateral
             model = labBaseModel;
             model = glm::translate(model, glm::vec3(12.0f, 6.0f, 0.0f));
             model = glm::scale(model, glm::vec3(4.0f, 3.0f, 8.0f));
-            glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(labAccentColor));
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            material.diffuse = labAccentColor;
+            addStatic(36);
         }
 
         // ===============================================================
         //						POSTES DE LUZ
         // ===============================================================
         {
-            glm::vec3 postPositions[] = {
-                glm::vec3(30.0f, 0.0f, 2.0f),  // Poste derecha
-                glm::vec3(-9.5f, 0.0f, 2.0f)   // Poste izquierda
-            };
-
-            for (int i = 0; i < 2; i++)
+            for (size_t i = 0; i < postPositions.size(); i++)
             {
                 glm::mat4 basePoste = glm::translate(glm::mat4(1.0f), postPositions[i]);
                 // 1. Poste vertical
                 model = basePoste;
                 model = glm::translate(model, glm::vec3(0.0f, 3.5f, 0.0f));
                 model = glm::scale(model, glm::vec3(0.35f, 7.0f, 0.35f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(postColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = postColor;
+                addStatic(36);
                 // 2. Brazo horizontal
                 model = basePoste;
                 model = glm::translate(model, glm::vec3(0.0f, 6.8f, 0.5f));
                 model = glm::scale(model, glm::vec3(0.3f, 0.3f, 1.0f));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                addStatic(36);
                 // 3. "Luz" (bombilla)
                 model = basePoste;
                 model = glm::translate(model, glm::vec3(0.010f, 6.5f, 0.9f));
                 model = glm::scale(model, glm::vec3(0.9f, 0.9f, 0.9f));
-                glUniform3fv(glGetUniformLocation(modelShader.Program, "material.diffuse"), 1, glm::value_ptr(lightColor));
-                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+                material.diffuse = lightColor;
+                addStatic(36);
             }
         }
 
@@ -2089,148 +2205,598 @@ int main() {
         //      PASO 2: DIBUJAR EL CÉSPED Y AGUA (CON TEXTURA)
         // ===============================================================
 
-        // Configura el shader para objetos CON textura
-        glUniform1i(glGetUniformLocation(modelShader.Program, "useTexture"), 1); // 1 = SÍ usar textura
-        glUniform3f(glGetUniformLocation(modelShader.Program, "material.specular"), 0.1f, 0.1f, 0.1f); // Poco brillo
-        glUniform1f(glGetUniformLocation(modelShader.Program, "material.shininess"), 16.0f);
+        // Configura el shader para objetos CON textura (pasto y agua son opacos: sin recorte)
+        useMaterial(SHADER_TEXTURED, 0.1f, 16.0f); // Poco brillo
 
-        // **NOTA**: Ya no declaramos 'modelLoc' aquí, usamos la que definimos
-        // en la sección de objetos sólidos (línea 622).
 
         // --- Dibujar Césped ---
-        glBindVertexArray(VAO); // VAO del Cubo
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, grassTextureID);
-        glUniform1i(glGetUniformLocation(modelShader.Program, "texture_diffuse1"), 0);
+        vao = VAO; // VAO del Cubo
+        material.texture = grassTextureID;
 
         model = glm::mat4(1.0f);
         model = glm::translate(model, glm::vec3(0.0f, -1.0f, 0.0f));
         model = glm::scale(model, glm::vec3(100.0f, 0.1f, 100.0f));
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        addStatic(36);
 
 
         // --- Dibujar Estanque de Agua ---
-        glBindVertexArray(VAO_water); // VAO del Agua (con coords. 2x2)
-        glActiveTexture(GL_TEXTURE0);
+        vao = VAO_water; // VAO del Agua (con coords. 2x2)
         // --- Lógica de Animación del Agua ---
-    // (Reemplaza la línea 'glBindTexture(GL_TEXTURE_2D, waterTextureID);')
+        // La pista agua.cuadro alterna entre las dos texturas (ver la línea de tiempo); el
+        // dibujo escoge una con FrameCommands::waterFrame
+        material.texture = waterTextureID;
+        material.alternateTexture = waterTextureID_2;
+
+    
+        model = glm::mat4(1.0f);
+        model = glm::translate(model, glm::vec3(-30.0f, -0.9f, 38.0f));
+        model = glm::scale(model, glm::vec3(15.0f, 0.1f, 23.5f));
+        addStatic(36);
+    }
+    scene->SortForDrawing();
+    std::cout << "ESCENA: " << scene->meshes.Size() << " entidades estáticas, " << scene->creatures.Size() << " criaturas" << std::endl;
 
-    // fmod(tiempo, 1.0) crea un ciclo que va de 0.0 a 1.0 cada segundo
-        float waterFrameTime = fmod(glfwGetTime(), 1.0f);
+    // Dibuja lo estático con las variantes que se pasen. Recorre los arreglos densos de la escena
+    // (ordenados por material: la variante y la textura solo cambian entre grupos). Con
+    // viewProjection solo va lo que toca ese frustum; sin ella (sombras y al grabar el lightmap) todo.
+    auto drawStaticScene = [&](ShaderVariants& shaders, const FrameCommands& frame, const glm::mat4* viewProjection)
+    {
+        // Con lightmaps (Tecla B) todo lo estático usa la luz horneada (solo en forward)
+        GLuint staticLighting = (frame.lightmapsEnabled && lightmap->IsReady()) ? SHADER_LIGHTMAP : 0;
 
-        if (waterFrameTime < 0.5f)
+        // Lugares visibles, en la arena del cuadro
+        FrameVector<GLuint> visible(viewProjection != nullptr ? FrameAllocator<GLuint>(*frame.arena, ARENA_RENDER) : FrameAllocator<GLuint>());
+        GLuint count = scene->meshes.Size();
+        if (viewProjection != nullptr)
         {
-            // Primera mitad del segundo: usa la textura 1
-            glBindTexture(GL_TEXTURE_2D, waterTextureID);
+            scene->FindVisible(*viewProjection, visible);
+            count = (GLuint)visible.size();
         }
-        else
+
+        Shader* shader = nullptr;
+        const Material* current = nullptr;
+        GLint modelLoc = -1;
+        GLint diffuseLoc = -1;
+        GLuint boundVAO = 0;
+        GLuint boundTexture = 0;
+        for (GLuint k = 0; k < count; k++)
         {
-            // Segunda mitad del segundo: usa la textura 2
-            glBindTexture(GL_TEXTURE_2D, waterTextureID_2);
-        }
-        glUniform1i(glGetUniformLocation(modelShader.Program, "texture_diffuse1"), 0);
+            GLuint i = viewProjection != nullptr ? visible[k] : k;
+            const Material& material = scene->materials[i];
+            const RenderMesh& mesh = scene->meshes[i];
 
-        
-        model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(-30.0f, -0.9f, 38.0f));
-        model = glm::scale(model, glm::vec3(15.0f, 0.1f, 23.5f));
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+            // Cada programa guarda sus propios uniforms: al cambiar de variante se vuelven a pedir
+            if (current == nullptr || material.flags != current->flags || material.specular != current->specular || material.shininess != current->shininess)
+            {
+                shader = &useVariant(shaders, material.flags | staticLighting, material.specular, material.shininess);
+                modelLoc = glGetUniformLocation(shader->Program, "model");
+                diffuseLoc = glGetUniformLocation(shader->Program, "material.diffuse");
+                glUniform1i(glGetUniformLocation(shader->Program, "texture_diffuse1"), 0);
+                boundTexture = 0;
+            }
+            current = &material;
+
+            if (material.flags & SHADER_TEXTURED)
+            {
+                // La pista agua.cuadro escoge el cuadro de las texturas animadas
+                GLuint texture = (material.alternateTexture != 0 && frame.waterFrame >= 0.5f) ? material.alternateTexture : material.texture;
+                if (texture != boundTexture)
+                {
+                    glActiveTexture(GL_TEXTURE0);
+                    glBindTexture(GL_TEXTURE_2D, texture);
+                    boundTexture = texture;
+                }
+            }
+            else
+            {
+                glUniform3fv(diffuseLoc, 1, glm::value_ptr(material.diffuse));
+            }
+            if (mesh.vao != boundVAO)
+            {
+                glBindVertexArray(mesh.vao);
+                boundVAO = mesh.vao;
+            }
+            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(scene->transforms[i].model));
 
+            // Cada dibujo es una superficie del lightmap
+            lightmap->Surface(shader->Program, mesh.surface, mesh.count);
+            glDrawArrays(GL_TRIANGLES, 0, mesh.count);
+        }
+    };
 
+    auto drawDynamicScene = [&](ShaderVariants& shaders, const FrameCommands& frame)
+    {
         // ===============================================================
         //      PASO 3: DIBUJAR LOS MODELOS 3D CARGADOS
         // ===============================================================
 
-        // (modelShader ya está activo y la cámara configurada)
+        // (la cámara ya está configurada en cada variante)
+        // Las matrices, los huesos y las instancias ya vienen en la lista del cuadro; la variante
+        // solo se cambia cuando cambia el material
+        const RenderCommand* previous = nullptr;
+        Shader* shader = nullptr;
+        for (const RenderCommand& command : frame.dynamicScene.GetCommands())
+        {
+            if (previous == nullptr || previous->flags != command.flags || previous->specular != command.specular || previous->shininess != command.shininess)
+                shader = &useVariant(shaders, command.flags, command.specular, command.shininess);
+            previous = &command;
 
-        // Configuración de material para los modelos (brillantes)
-        glUniform1i(glGetUniformLocation(modelShader.Program, "useTexture"), 1); // SÍ usan textura
-        glUniform3f(glGetUniformLocation(modelShader.Program, "material.specular"), 1.0f, 1.0f, 1.0f); // Muy brillante
-        glUniform1f(glGetUniformLocation(modelShader.Program, "material.shininess"), 64.0f);
+            // --- Multitud de Ho-oh (Tecla V) ---
+            // Las instancias ya están subidas; cada una toma su cuadro de la textura de vértices
+            if (command.type == RENDER_DRAW_INSTANCED)
+            {
+                hoohVertexAnimation->Draw(*shader, *frame.crowd, frame.time);
+                continue;
+            }
 
-        // --- Dibujar Mew ---
-        glm::mat4 modelMew = glm::mat4(1.0f);
+            // Sin huesos subidos este cuadro no se dibujan las criaturas con skinning
+            if (command.firstBone >= 0 && !frame.palette->IsUploaded())
+                continue;
+            glUniformMatrix4fv(glGetUniformLocation(shader->Program, "model"), 1, GL_FALSE, glm::value_ptr(command.model));
+            if (command.firstBone >= 0)
+                frame.palette->Bind(shader->Program, command.firstBone);
+            if (command.object == OBJECT_MEW)
+                mewModel.Draw(*shader);
+            else
+                hoohModel->Draw(*shader);
+        }
+    };
 
-        // 1. Traslación (Mover a Mew a su posición)
-        modelMew = glm::translate(modelMew, mewPos);
+    auto drawScene = [&](ShaderVariants& shaders, const FrameCommands& frame, const glm::mat4& viewProjection)
+    {
+        drawStaticScene(shaders, frame, &viewProjection);
+        drawDynamicScene(shaders, frame);
+    };
 
-        // 2. Rotación (Hacer que Mew mire hacia 'mewDirection')
-        //    (Evita un error matemático si la dirección es (0,0,0))
-        if (glm::length(mewDirection) > 0.0001f)
+    // Se graba la escena estática una vez y se hornea su luz: el sol en sus tres posiciones y
+    // los postes, con sombras y un rebote. Si nada cambió se carga de escena.lightmap.
+    FrameCommands recordingFrame = {};
+    lightmap->BeginRecording();
+    modelShaders->Begin(nullptr);
+    drawStaticScene(*modelShaders, recordingFrame, nullptr);
+    lightmap->EndRecording();
+    {
+        double bakeStartTime = glfwGetTime();
+        LightmapLighting bakedLighting;
+        bakedLighting.lights = postLights;
+        bakedLighting.sunDirections.push_back(dayLightDirection);
+        bakedLighting.sunDirections.push_back(sunsetLightDirection);
+        bakedLighting.sunDirections.push_back(nightLightDirection);
+        bakedLighting.sunDiffuse = LIGHTMAP_SUN_DIFFUSE; // En el cuadro se escala al color de dirLight
+        bakedLighting.bounceSamples = LIGHTMAP_BOUNCE_SAMPLES;
+        lightmap->Build(bakedLighting);
+        std::cout << "LIGHTMAP: " << (glfwGetTime() - bakeStartTime) * 1000.0 << " ms al inicio" << std::endl;
+    }
+
+    // --- Uniforms de cada paso ---
+    // ShaderVariants solo guarda un puntero al setup, así que se crean aquí una vez y no en
+    // cada cuadro (cada std::function con capturas pediría memoria). Lo que cambia por cuadro
+    // lo leen de lightingFrame y shadowCascade.
+    const FrameCommands* lightingFrame = nullptr; // El cuadro que se está dibujando
+    GLuint shadowCascade = 0;                      // La cascada que se está dibujando
+
+    // Enlaza el bloque FrameData del programa al del cuadro
+    std::function<void(Shader&)> bindFrameUniforms = [](Shader& shader)
+    {
+        GLuint block = glGetUniformBlockIndex(shader.Program, "FrameData");
+        if (block != GL_INVALID_INDEX)
+            glUniformBlockBinding(shader.Program, block, FRAME_UNIFORMS_BINDING);
+    };
+
+    std::function<void(Shader&)> setupShadows = [&](Shader& shader)
+    {
+        glUniformMatrix4fv(glGetUniformLocation(shader.Program, "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(shadowCascades->GetMatrix(shadowCascade)));
+    };
+
+    // Uniforms de los shaders que calculan la iluminación: las variantes de modelShaders en
+    // forward, o deferredShaders en deferred (ahí la escena se dibuja al G-buffer y se
+    // ilumina después en pantalla). Se ponen una vez por cuadro en cada variante que se use.
+    std::function<void(Shader&)> setupLighting = [&](Shader& shader)
+    {
+        // --- Cámara y ☀️ sol (Luz Direccional): ya están en el bloque del cuadro ---
+        bindFrameUniforms(shader);
+
+        clusteredLights->Bind(shader.Program);
+        if (lightingFrame->shadowsEnabled)
+            shadowCascades->Bind(shader.Program);
+        if (lightmap->IsReady())
+            lightmap->Bind(shader.Program, lightDirection, atmosphere->GetDiffuse());
+    };
+
+    // ===============================================================
+    //     DIBUJO DE UN CUADRO (en el hilo de render, o aquí sin él)
+    // ===============================================================
+    // Todo lo que llama a GL; lo que cambia de un cuadro a otro sale de FrameCommands
+    auto renderFrame = [&](FrameCommands& frame)
+    {
+        lightingFrame = &frame;
+
+        // Lo que los trabajos dejaron para GL desde el cuadro anterior (este hilo tiene el contexto)
+        jobs->SetMainThread();
+        jobs->RunMainThreadJobs();
+
+        // --- Recarga de shaders (no bloquea: solo se cambian los que ya enlazaron) ---
+        std::vector<std::string> changedShaders = shaderWatcher->Poll(frame.deltaTime);
+        for (const std::string& path : changedShaders)
         {
-            // Esta matriz 'lookAt' calcula la rotación necesaria
-            glm::mat4 rotationMatrixMew = glm::inverse(glm::lookAt(glm::vec3(0.0f), -mewDirection, glm::vec3(0.0f, 1.0f, 0.0f)));
-            modelMew = modelMew * rotationMatrixMew;
+            for (Shader* shader : watchedShaders)
+                if (shader->Uses(path))
+                    shader->Reload();
+            for (ShaderVariants* variants : watchedVariants)
+                variants->Reload(path);
+            atmosphere->Reload(path);
         }
+        for (Shader* shader : watchedShaders)
+            shader->PollReload();
+        for (ShaderVariants* variants : watchedVariants)
+            variants->Poll();
+        atmosphere->Poll();
 
-        // 3. Escala (Hacer el modelo más pequeño)
-        modelMew = glm::scale(modelMew, glm::vec3(0.15f, 0.15f, 0.15f));
-
-        // 4. Enviar la matriz final al shader y dibujar
-        glUniformMatrix4fv(glGetUniformLocation(modelShader.Program, "model"), 1, GL_FALSE, glm::value_ptr(modelMew));
-        mewModel.Draw(modelShader);
-
-        // --- Dibujar Ho-oh ---
-        glm::mat4 modelHoOh = glm::mat4(1.0f);
-        // 1. Traslación
-        modelHoOh = glm::translate(modelHoOh, hoohPos);
-        // 2. Rotación Dinámica (hacia donde vuela)
-        glm::mat4 rotationMatrix = glm::inverse(glm::lookAt(glm::vec3(0.0f), -hoohDirection, glm::vec3(0.0f, 1.0f, 0.0f)));
-        modelHoOh = modelHoOh * rotationMatrix;
-        // 3. Rotación Estática (inclinación)
-        modelHoOh = glm::rotate(modelHoOh, glm::radians(75.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        // 4. Aleteo (Balanceo)
-        float flapFactor = sin(glfwGetTime() * 4.0f); // Oscila
-        modelHoOh = glm::rotate(modelHoOh, glm::radians(flapFactor * 15.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-        // 5. Escala
-        modelHoOh = glm::scale(modelHoOh, glm::vec3(0.25f, 0.25f, 0.25f));
-        glUniformMatrix4fv(glGetUniformLocation(modelShader.Program, "model"), 1, GL_FALSE, glm::value_ptr(modelHoOh));
-        hoohModel.Draw(modelShader);
+        // El sol de este momento: color y dirección de la luz (la tabla del cielo solo se rehace si se movió)
+        atmosphere->Update(Atmosphere::SunDirection(frame.sunElevation), -nightLightDirection);
+        lightDirection = atmosphere->GetLightDirection();
 
         // ===============================================================
-        //      PASO 5: DIBUJAR EL SOL VISUAL (SIN LUZ)
+        //     PASO 1: CONFIGURAR LA ILUMINACIÓN GLOBAL
         // ===============================================================
 
-        // Usamos el shader de color simple (ourShader)
-        ourShader.Use();
+        profiler->BeginFrame(frame.deltaTime);
+        for (const std::pair<const char*, double>& section : frame.cpuSections)
+            profiler->Record(section.first, section.second);
+#ifdef FRAME_ARENA_CENSUS
+        profiler->RecordCount("memoria del heap (new)", (double)frame.heapAllocations);
+#endif
+        const char* frameSection = frame.deferredShading ? "cuadro (deferred)" : "cuadro (forward)";
+        profiler->Begin(frameSection);
+
+        // --- Matrices de Cámara ---
+        glm::mat4 projection = glm::perspective(frame.camera.GetZoom(), (GLfloat)screenWidth / (GLfloat)screenHeight, NEAR_PLANE, FAR_PLANE);
+        glm::mat4 view = frame.camera.GetViewMatrix();
+        glm::mat4 viewProjection = projection * view;
+
+        // --- Datos del cuadro: se copian a su región del buffer antes de dibujar ---
+        // Huesos e instancias que se grabaron con el cuadro, uniforms de cámara y sol y la
+        // rejilla de luces. Solo se espera si la GPU aún lee la región de hace tres cuadros.
+        profiler->Begin("subidas");
+        frameStream->BeginFrame();
+        frame.palette->Upload();
+        frame.crowd->Upload();
+
+        FrameUniforms uniforms;
+        uniforms.projection = projection;
+        uniforms.view = view;
+        uniforms.inverseViewProjection = glm::inverse(viewProjection);
+        uniforms.viewPos = glm::vec4(frame.camera.Position, 1.0f);
+        uniforms.sunDirection = glm::vec4(lightDirection, 0.0f);
+        uniforms.sunAmbient = glm::vec4(atmosphere->GetAmbient(), 0.0f);
+        uniforms.sunDiffuse = glm::vec4(atmosphere->GetDiffuse(), 0.0f);
+        uniforms.sunSpecular = glm::vec4(atmosphere->GetDiffuse(), 0.0f);
+        StreamAllocation uniformData = frameStream->Allocate(sizeof(FrameUniforms), frameStream->GetUniformAlignment());
+        if (uniformData.data != NULL)
+        {
+            memcpy(uniformData.data, &uniforms, sizeof(FrameUniforms));
+            glBindBufferRange(GL_UNIFORM_BUFFER, FRAME_UNIFORMS_BINDING, frameStream->GetBuffer(), uniformData.offset, sizeof(FrameUniforms));
+        }
+
+        // --- 💡 LUCES DE POSTE (Punto) ---
+        // Se reparten en los clusters del frustum de este cuadro; cada fragmento solo
+        // evalúa las luces de su cluster (ver ClusteredLights.h)
+        clusteredLights->Update(view, projection, NEAR_PLANE, FAR_PLANE, screenWidth, screenHeight);
+        frameStream->Flush();
+        profiler->End("subidas");
+        profiler->Record("subidas: espera a la GPU", frameStream->GetWaitMs());
+
+        // --- ☀️ SOMBRAS DEL SOL (Cascadas) ---
+        // La parte estática de cada cascada solo se vuelve a dibujar cuando cambia su matriz
+        // (el sol se mueve en una transición o la cámara cruza una celda); los modelos
+        // dinámicos se dibujan encima cada cuadro.
+        if (frame.shadowsEnabled)
+        {
+            profiler->Begin("sombras");
+            shadowCascades->Update(view, projection, NEAR_PLANE, lightDirection);
+            for (GLuint i = 0; i < SHADOW_CASCADES; i++)
+            {
+                shadowCascade = i;
+                shadowShaders->Begin(&setupShadows);
+                if (shadowCascades->BeginStatic(i))
+                    drawStaticScene(*shadowShaders, frame, nullptr);
+                shadowCascades->BeginDynamic(i);
+                drawDynamicScene(*shadowShaders, frame);
+            }
+            shadowCascades->End();
+            glViewport(0, 0, screenWidth, screenHeight);
+            profiler->End("sombras");
+        }
 
-        // Pasamos las matrices (este shader sí las necesita)
-        glUniformMatrix4fv(glGetUniformLocation(ourShader.Program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glUniformMatrix4fv(glGetUniformLocation(ourShader.Program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+        // Variantes de iluminación del cuadro (Teclas K y L)
+        // Si la rejilla no se pudo subir este cuadro se recorren todas las luces
+        GLuint lightingFlags = (frame.shadowsEnabled ? SHADER_SHADOWS : 0) | (frame.clusteredLighting && clusteredLights->HasGrid() ? SHADER_CLUSTERED : 0);
 
-        // Desactivamos la prueba de profundidad (para que se vea siempre)
-        //glDisable(GL_DEPTH_TEST);
+        // --- Limpiar pantalla (el cielo se dibuja al final, donde no quedó nada) ---
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glm::mat4 modelSun = glm::mat4(1.0f);
-        modelSun = glm::translate(modelSun, glm::vec3(80.0f, 80.0f, 0.0f)); // Posición lejana
-        modelSun = glm::scale(modelSun, glm::vec3(10.0f, 10.0f, 10.0f));
-        glUniformMatrix4fv(glGetUniformLocation(ourShader.Program, "model"), 1, GL_FALSE, glm::value_ptr(modelSun));
 
-        // Color naranja
-        if (isNight)
+        // ===============================================================
+        //     DIBUJO DE LA ESCENA (FORWARD O DEFERRED)
+        // ===============================================================
+        if (frame.deferredShading)
         {
-            // Es de noche: Dibuja una Luna (azul/blanca)
-            glUniform3f(ourShader.uniformColor, 0.8f, 0.9f, 1.0f);
+            // Paso de geometría: las superficies van al G-buffer, sin iluminar
+            profiler->Begin("deferred: G-buffer");
+            gBuffer->BindForWriting();
+            gBufferShaders->Begin(&bindFrameUniforms);
+            drawScene(*gBufferShaders, frame, viewProjection);
+            profiler->End("deferred: G-buffer");
+
+            // Paso de iluminación: un triángulo de pantalla completa, cada pixel una sola vez
+            profiler->Begin("deferred: iluminacion");
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(0, 0, screenWidth, screenHeight);
+            deferredShaders->Begin(&setupLighting, lightingFlags);
+            gBuffer->BindForReading(deferredShaders->Use(0).Program);
+            glDisable(GL_DEPTH_TEST);
+            glBindVertexArray(VAO_fullscreen);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+            glEnable(GL_DEPTH_TEST);
+            gBuffer->UnbindTextures();
+            profiler->End("deferred: iluminacion");
+
+            // La profundidad del G-buffer pasa a la pantalla para dibujar el sol encima
+            gBuffer->BlitDepth();
         }
         else
         {
-            // Es de día o atardecer: Dibuja un Sol (naranja)
-            glUniform3f(ourShader.uniformColor, 1.0f, 0.5f, 0.0f);
+            profiler->Begin("forward: escena");
+            modelShaders->Begin(&setupLighting, lightingFlags);
+            drawScene(*modelShaders, frame, viewProjection);
+            profiler->End("forward: escena");
         }
 
-        glBindVertexArray(VAO); // Usamos el VAO del cubo
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        // ===============================================================
+        //      PASO 5: EL CIELO (CON EL SOL Y LA LUNA)
+        // ===============================================================
 
-        // Reactivamos la prueba de profundidad
-        glEnable(GL_DEPTH_TEST);
+        // Una lectura de la tabla por pixel; la tabla se rehace solo si el sol se movió
+        profiler->Begin("cielo");
+        atmosphere->Draw(view, projection, frame.camera.Position);
+        profiler->End("cielo");
 
         // --- Terminar el frame ---
         glBindVertexArray(0); // Desenlaza el VAO
+
+        profiler->End(frameSection);
+        frameStream->EndFrame(); // La región de este cuadro queda libre cuando la GPU pase por aquí
+
+        // --- Captura de cuadros (no bloquea, lee el cuadro con PBOs) ---
+        if (frame.captureRequested != frameCapture->IsCapturing())
+        {
+            if (frame.captureRequested)
+            {
+                if (!frameCapture->Start())
+                    captureRequested = false; // Sin esto se reintenta (y se reporta) cada cuadro
+            }
+            else
+                frameCapture->Stop();
+        }
+        frameCapture->Capture();
+
         glfwSwapBuffers(window);
+    };
+
+    // --- Hilo de render (Tecla R) ---
+    // Cada cuadro tiene su paleta de huesos y sus instancias: el hilo principal llena unas
+    // mientras el de render sube y dibuja las otras
+    RenderThread<FrameCommands>* renderThread = new RenderThread<FrameCommands>(renderFrame, [window](bool current)
+    {
+        glfwMakeContextCurrent(current ? window : nullptr);
+    });
+    for (GLuint i = 0; i < 2; i++)
+    {
+        renderThread->GetFrame(i).palette = new SkinningPalette(*frameStream);
+        renderThread->GetFrame(i).crowd = new VertexAnimationInstances(*frameStream);
+        renderThread->GetFrame(i).arena = new FrameArena();
+    }
+    renderThreadRequested = std::thread::hardware_concurrency() > 1;
+#ifdef FRAME_ARENA_CENSUS
+    unsigned long long lastHeapAllocations = AllocationCensus::Get().allocations; // Para el censo por cuadro
+#endif
+    auto sinceMs = [](std::chrono::high_resolution_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+
+    // --- Bucle principal ---
+    // Entrada, simulación y animación; el cuadro que resulta se entrega al render
+    while (!glfwWindowShouldClose(window))
+    {
+        // Calcular delta time (tiempo entre frames)
+        GLfloat currentFrame = (GLfloat)glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // Revisar eventos (teclado, mouse)
+        glfwPollEvents();
+
+        if (renderThreadRequested != renderThread->IsThreaded())
+        {
+            if (renderThreadRequested)
+                renderThread->Start();
+            else
+                renderThread->Stop();
+        }
+
+        // --- Simulación a paso fijo ---
+        // La vista (teclado y transición del sol) en este hilo; las criaturas aquí o en su hilo (Tecla T)
+        viewSimulation->Advance(deltaTime);
+        camera.Position = viewSimulation->GetState().cameraPosition;
+        sunElevation = viewSimulation->GetState().sunElevation;
+        if (simulationThreadRequested != creatureSimulation->IsThreaded())
+        {
+            if (simulationThreadRequested)
+                creatureSimulation->StartThread();
+            else
+                creatureSimulation->StopThread();
+        }
+        for (const std::string& path : timelineWatcher->Poll(deltaTime))
+            if (path == sceneTimelinePath)
+                sceneTimeline->Load(sceneTimelinePath);
+
+        // El cuadro que toca grabar (con hilo de render, el otro se está dibujando)
+        double renderWaitMs = renderThread->GetWaitMs();
+        FrameCommands& frame = renderThread->BeginFrame();
+        frame.arena->Reset(); // El render ya soltó este cuadro: lo de su arena ya no se usa
+#ifdef FRAME_ARENA_CENSUS
+        frame.heapAllocations = AllocationCensus::Get().TakeAllocations(lastHeapAllocations);
+#endif
+        frame.cpuSections = FrameVector<std::pair<const char*, double>>(FrameAllocator<std::pair<const char*, double>>(*frame.arena, ARENA_PROFILER));
+        frame.cpuSections.reserve(8);
+        frame.cpuSections.push_back(std::make_pair("espera al render", renderWaitMs));
+        std::chrono::high_resolution_clock::time_point sectionStart = std::chrono::high_resolution_clock::now();
+
+        // --- Línea de tiempo de la escena ---
+        sceneTimeline->Evaluate(currentFrame);
+        sceneTimeline->Apply();
+        frame.cpuSections.push_back(std::make_pair("timeline", sinceMs(sectionStart)));
+
+        // --- Simulación de criaturas (paso fijo) ---
+        // Se dibuja la mezcla de sus dos últimos pasos; con su propio hilo aquí solo se toma
+        sectionStart = std::chrono::high_resolution_clock::now();
+        creatureSimulation->Advance(deltaTime);
+        const CreatureState& creatureState = creatureSimulation->GetState();
+        Transform& hoohTransform = scene->transforms.Get(hooh);
+        hoohTransform.position = creatureState.hoohPos;
+        hoohTransform.direction = creatureState.hoohDirection;
+        Transform& mewTransform = scene->transforms.Get(mew);
+        mewTransform.position = creatureState.mewPos;
+        mewTransform.direction = creatureState.mewDirection;
+        frame.cpuSections.push_back(std::make_pair("simulacion", sinceMs(sectionStart)));
+
+        frame.time = currentFrame;
+        frame.deltaTime = deltaTime;
+        frame.camera = camera;
+        frame.sunElevation = sunElevation;
+        frame.deferredShading = deferredShading;
+        frame.shadowsEnabled = shadowsEnabled;
+        frame.clusteredLighting = clusteredLighting;
+        frame.lightmapsEnabled = lightmapsEnabled;
+        frame.captureRequested = captureRequested;
+        frame.waterFrame = waterFrame;
+        frame.dynamicScene.Clear(*frame.arena);
+        frame.palette->Begin();
+        frame.crowd->Begin();
+
+        // --- Dibujar Mew ---
+        // Textura opaca; material brillante
+        glm::mat4& modelMew = mewTransform.model; // Queda en su entidad
+        modelMew = glm::mat4(1.0f);
+
+        // 1. Traslación (Mover a Mew a su posición, flotando sobre ella)
+        modelMew = glm::translate(modelMew, mewTransform.position + mewHover);
+
+        // 2. Rotación (Hacer que Mew mire hacia su dirección)
+        //    (Evita un error matemático si la dirección es (0,0,0))
+        if (glm::length(mewTransform.direction) > 0.0001f)
+        {
+            // Esta matriz 'lookAt' calcula la rotación necesaria
+            glm::mat4 rotationMatrixMew = glm::inverse(glm::lookAt(glm::vec3(0.0f), -mewTransform.direction, glm::vec3(0.0f, 1.0f, 0.0f)));
+            modelMew = modelMew * rotationMatrixMew;
+        }
+        modelMew = modelMew * glm::mat4_cast(mewSway);
+
+        // 3. Escala (Hacer el modelo más pequeño)
+        modelMew = glm::scale(modelMew, glm::vec3(0.15f, 0.15f, 0.15f));
+        frame.dynamicScene.Draw(OBJECT_MEW, SHADER_TEXTURED, 1.0f, 64.0f, modelMew);
+
+        // --- Multitud de Ho-oh (Tecla V) ---
+        // Solo se calculan sus matrices: la pose de cada una sale de la textura de vértices en la GPU
+        if (hoohCrowdEnabled && hoohVertexAnimation != nullptr)
+        {
+            sectionStart = std::chrono::high_resolution_clock::now();
+            for (GLuint i = 0; i < creatureState.crowdPositions.size(); i++)
+            {
+                // Orientación hacia donde vuela, como lookAt (el modelo ve hacia +Z con +Y arriba)
+                const glm::vec3& direction = creatureState.crowdDirections[i];
+                glm::vec3 right = glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), direction);
+                right = glm::length(right) > 1e-4f ? glm::normalize(right) : glm::vec3(1.0f, 0.0f, 0.0f);
+                glm::mat4 crowdModel(1.0f);
+                crowdModel[0] = glm::vec4(right * creatureState.crowdScale, 0.0f);
+                crowdModel[1] = glm::vec4(glm::cross(direction, right) * creatureState.crowdScale, 0.0f);
+                crowdModel[2] = glm::vec4(direction * creatureState.crowdScale, 0.0f);
+                crowdModel[3] = glm::vec4(creatureState.crowdPositions[i], 1.0f);
+                frame.crowd->Add(crowdModel, i * 0.61f, 0.9f + 0.2f * glm::fract(i * 0.618f));
+            }
+            frame.dynamicScene.DrawInstanced(OBJECT_HOOH_CROWD, SHADER_TEXTURED | SHADER_ALPHA_TEST | SHADER_VERTEX_ANIMATION, 1.0f, 64.0f);
+            frame.cpuSections.push_back(std::make_pair("multitud", sinceMs(sectionStart)));
+        }
+
+        // --- Animación esquelética de Ho-oh (y su bandada, Tecla H) ---
+        // Las poses se evalúan en CPU sobre arreglos por componente y los huesos de todos
+        // se suben juntos una vez por cuadro (sombras, G-buffer y forward usan la misma paleta).
+        // Algunas plumas tienen transparencia: es la variante con recorte
+        if (hoohSkinned)
+        {
+            sectionStart = std::chrono::high_resolution_clock::now();
+            GLuint hoohCount = hoohFlockEnabled ? 1 + HOOH_FLOCK_SIZE : 1;
+            FrameVector<glm::mat4> hoohMatrices(hoohCount, FrameAllocator<glm::mat4>(*frame.arena, ARENA_ANIMATION)); // Matriz model de cada Ho-oh (el primero es el líder)
+            FrameVector<GLint> hoohBones(hoohCount, FrameAllocator<GLint>(*frame.arena, ARENA_ANIMATION));           // Su primer hueso en la paleta del cuadro
+            hoohCursors.resize(hoohCount);
+
+            // Orientación hacia donde vuela (el modelo ve hacia +Z con +Y arriba)
+            glm::mat4 hoohFlight = glm::translate(glm::mat4(1.0f), hoohTransform.position);
+            hoohFlight = hoohFlight * glm::inverse(glm::lookAt(glm::vec3(0.0f), -hoohTransform.direction, glm::vec3(0.0f, 1.0f, 0.0f)));
+
+            // Los huesos se apartan aquí; cada Ho-oh se muestrea y se llena en paralelo
+            SkinningPalette* palette = frame.palette;
+            for (GLuint i = 0; i < hoohCount; i++)
+                hoohBones[i] = palette->Allocate(hoohModel->GetSkeleton());
+            jobs->ParallelFor(hoohCount, 4, [&](GLuint begin, GLuint end)
+            {
+                thread_local JointPose hoohPose;
+                thread_local std::vector<glm::mat4> globals, skins;
+                for (GLuint i = begin; i < end; i++)
+                {
+                    // Las escoltas van en V detrás del líder, cada una con su propia fase y ritmo
+                    GLfloat rank = (GLfloat)((i + 1) / 2);
+                    GLfloat side = (i % 2 == 0) ? 1.0f : -1.0f;
+                    GLfloat phase = i * 0.37f;
+                    GLfloat rate = 1.0f + 0.08f * sin(i * 1.7f);
+                    glm::vec3 offset(side * rank * 6.0f, sin(currentFrame * 0.8f + phase) * 1.5f * rank / (rank + 1.0f), -rank * 5.0f);
+
+                    hoohFlightClip->Sample(currentFrame * rate + phase, hoohCursors[i], hoohPose);
+                    palette->Fill(hoohBones[i], hoohModel->GetSkeleton(), hoohPose, globals, skins);
+                    hoohBones[i] = std::max(hoohBones[i], 0); // Paleta llena: como Add(), el hueso 0
+                    hoohMatrices[i] = glm::scale(glm::translate(hoohFlight, offset), glm::vec3(0.02f));
+                }
+            });
+            for (GLuint i = 0; i < hoohCount; i++)
+                frame.dynamicScene.Draw(OBJECT_HOOH, SHADER_TEXTURED | SHADER_ALPHA_TEST | SHADER_SKINNED, 1.0f, 64.0f, hoohMatrices[i], hoohBones[i]);
+            hoohTransform.model = hoohMatrices[0]; // El líder es la entidad
+            frame.cpuSections.push_back(std::make_pair("animacion", sinceMs(sectionStart)));
+        }
+        else
+        {
+            // --- Dibujar Ho-oh (rígido) ---
+            glm::mat4& modelHoOh = hoohTransform.model; // Queda en su entidad
+            modelHoOh = glm::mat4(1.0f);
+            // 1. Traslación
+            modelHoOh = glm::translate(modelHoOh, hoohTransform.position);
+            // 2. Rotación Dinámica (hacia donde vuela)
+            glm::mat4 rotationMatrix = glm::inverse(glm::lookAt(glm::vec3(0.0f), -hoohTransform.direction, glm::vec3(0.0f, 1.0f, 0.0f)));
+            modelHoOh = modelHoOh * rotationMatrix;
+            // 3. Rotación Estática (inclinación)
+            modelHoOh = glm::rotate(modelHoOh, glm::radians(75.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+            // 4. Aleteo (Balanceo)
+            modelHoOh = glm::rotate(modelHoOh, glm::radians(hoohFlapAngle), glm::vec3(0.0f, 0.0f, 1.0f));
+            // 5. Escala
+            modelHoOh = glm::scale(modelHoOh, glm::vec3(0.25f, 0.25f, 0.25f));
+            frame.dynamicScene.Draw(OBJECT_HOOH, SHADER_TEXTURED | SHADER_ALPHA_TEST, 1.0f, 64.0f, modelHoOh);
+        }
+
+        // Con hilo de render se encola y se sigue con el siguiente cuadro; sin él se dibuja aquí
+        renderThread->Submit();
     }
     // --- Fin del bucle principal (while) ---
+    renderThread->Stop(); // Termina el último cuadro y regresa el contexto a este hilo
 
 
     // --- Limpieza de Recursos ---
@@ -2240,6 +2806,43 @@ int main() {
     glDeleteBuffers(1, &VBO_water);
     glDeleteVertexArrays(1, &VAO_gap);
     glDeleteBuffers(1, &VBO_gap);
+    glDeleteVertexArrays(1, &VAO_fullscreen);
+    delete frameCapture; // Termina de escribir los cuadros pendientes
+    delete clusteredLights;
+    delete gBuffer;
+    delete shadowCascades;
+    delete lightmap;
+    delete atmosphere;
+    for (GLuint i = 0; i < 2; i++)
+    {
+        delete renderThread->GetFrame(i).palette;
+        delete renderThread->GetFrame(i).crowd;
+    }
+    for (GLuint i = 0; i < 2; i++)
+    {
+        renderThread->GetFrame(i).arena->PrintPeaks("ARENA DEL CUADRO"); // Lo más que usó cada subsistema
+        delete renderThread->GetFrame(i).arena;
+    }
+    delete renderThread;
+    delete frameStream;
+    delete hoohFlightClip;
+    delete hoohVertexAnimation;
+    // Las simulaciones primero: sus destructores detienen el hilo que usa a la multitud y a la escena
+    delete creatureSimulation;
+    delete viewSimulation;
+    delete scene;
+    delete jobs;
+    delete crowdWanderers;
+    delete crowdFlock;
+    delete hoohModel;
+    delete modelShaders;
+    delete gBufferShaders;
+    delete deferredShaders;
+    delete shadowShaders;
+    delete shaderWatcher;
+    delete timelineWatcher;
+    delete sceneTimeline;
+    delete profiler; // Imprime el promedio de toda la corrida
 
     glfwTerminate();
     return EXIT_SUCCESS;
@@ -2248,20 +2851,20 @@ int main() {
 
 // --- Definición de Funciones de Control ---
 
-void DoMovement() {
+void DoMovement(GLfloat step) {
     // Movimiento de Cámara
     if (keys[GLFW_KEY_W] || keys[GLFW_KEY_UP])
-        camera.ProcessKeyboard(FORWARD, deltaTime);
+        camera.ProcessKeyboard(FORWARD, step);
     if (keys[GLFW_KEY_S] || keys[GLFW_KEY_DOWN])
-        camera.ProcessKeyboard(BACKWARD, deltaTime);
+        camera.ProcessKeyboard(BACKWARD, step);
     if (keys[GLFW_KEY_A] || keys[GLFW_KEY_LEFT])
-        camera.ProcessKeyboard(LEFT, deltaTime);
+        camera.ProcessKeyboard(LEFT, step);
     if (keys[GLFW_KEY_D] || keys[GLFW_KEY_RIGHT])
-        camera.ProcessKeyboard(RIGHT, deltaTime);
+        camera.ProcessKeyboard(RIGHT, step);
     if (keys[GLFW_KEY_SPACE])
-        camera.ProcessKeyboard(UP, deltaTime);
+        camera.ProcessKeyboard(UP, step);
     if (keys[GLFW_KEY_C])
-        camera.ProcessKeyboard(DOWN, deltaTime);
+        camera.ProcessKeyboard(DOWN, step);
 }
 
 void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mode) {
@@ -2276,8 +2879,8 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mode
         {
             isTransitioning = true;
             transitionFactor = 0.0f;
-            startTransitionColor = currentColor;
-            targetColor = isNight ? dayColor : nightColor; // Alterna
+            startTransitionSunElevation = sunElevation;
+            targetSunElevation = isNight ? daySunElevation : nightSunElevation; // Alterna (pasa por el atardecer)
             isSunset = false;
         }
     }
@@ -2289,12 +2892,80 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mode
         {
             isTransitioning = true;
             transitionFactor = 0.0f;
-            startTransitionColor = currentColor;
-            targetColor = isSunset ? dayColor : sunsetColor; // Alterna
+            startTransitionSunElevation = sunElevation;
+            targetSunElevation = isSunset ? daySunElevation : sunsetSunElevation; // Alterna
             isNight = false;
         }
     }
 
+    // Alterna la iluminación por clusters contra recorrer todas las luces (Tecla L)
+    if (key == GLFW_KEY_L && action == GLFW_PRESS)
+    {
+        clusteredLighting = !clusteredLighting;
+        std::cout << "LUCES: " << (clusteredLighting ? "por clusters" : "todas por fragmento") << std::endl;
+    }
+
+    // Alterna entre render forward y deferred (Tecla G)
+    if (key == GLFW_KEY_G && action == GLFW_PRESS)
+    {
+        deferredShading = !deferredShading;
+        std::cout << "RENDER: " << (deferredShading ? "deferred" : "forward") << std::endl;
+    }
+
+    // Activa/desactiva las sombras del sol (Tecla K)
+    if (key == GLFW_KEY_K && action == GLFW_PRESS)
+    {
+        shadowsEnabled = !shadowsEnabled;
+        std::cout << "SOMBRAS: " << (shadowsEnabled ? "activadas" : "desactivadas") << std::endl;
+    }
+
+    // Activa/desactiva la luz horneada de la parte estática (Tecla B)
+    if (key == GLFW_KEY_B && action == GLFW_PRESS)
+    {
+        lightmapsEnabled = !lightmapsEnabled;
+        std::cout << "LIGHTMAPS: " << (lightmapsEnabled ? "activados" : "desactivados") << std::endl;
+    }
+
+    // Muestra/oculta la bandada de Ho-oh (Tecla H)
+    if (key == GLFW_KEY_H && action == GLFW_PRESS)
+    {
+        hoohFlockEnabled = !hoohFlockEnabled;
+        std::cout << "BANDADA DE HO-OH: " << (hoohFlockEnabled ? "activada" : "desactivada") << std::endl;
+    }
+
+    // Muestra/oculta la multitud de Ho-oh (Tecla V)
+    if (key == GLFW_KEY_V && action == GLFW_PRESS)
+    {
+        hoohCrowdEnabled = !hoohCrowdEnabled;
+        std::cout << "MULTITUD DE HO-OH: " << (hoohCrowdEnabled ? "activada" : "desactivada") << " (" << HOOH_CROWD_SIZE << ")" << std::endl;
+    }
+
+    // Cambia cómo vuela la multitud: anillos, vagando o en bandada (Tecla J)
+    if (key == GLFW_KEY_J && action == GLFW_PRESS)
+    {
+        const char* crowdModeNames[CROWD_MODES] = { "en sus anillos", "vagando", "en bandada con Ho-oh" };
+        hoohCrowdMode = (hoohCrowdMode + 1) % CROWD_MODES;
+        std::cout << "MULTITUD DE HO-OH: " << crowdModeNames[hoohCrowdMode] << std::endl;
+    }
+
+    // Pasa la simulación de criaturas a su propio hilo y de regreso (Tecla T)
+    if (key == GLFW_KEY_T && action == GLFW_PRESS)
+    {
+        simulationThreadRequested = !simulationThreadRequested;
+        std::cout << "SIMULACIÓN: " << (simulationThreadRequested ? "en su propio hilo" : "en el hilo principal") << std::endl;
+    }
+
+    // Pasa el dibujo a su propio hilo y de regreso (Tecla R)
+    if (key == GLFW_KEY_R && action == GLFW_PRESS)
+    {
+        renderThreadRequested = !renderThreadRequested;
+        std::cout << "HILO DE RENDER: " << (renderThreadRequested ? "activado" : "desactivado") << std::endl;
+    }
+
+    // Inicia/detiene la captura de cuadros (Tecla F12)
+    if (key == GLFW_KEY_F12 && action == GLFW_PRESS)
+        captureRequested = !captureRequested;
+
     // Registro de teclas presionadas
     if (key >= 0 && key < 1024) {
         if (action == GLFW_PRESS)
@@ -2319,48 +2990,3 @@ void MouseCallback(GLFWwindow* window, double xPos, double yPos) {
 
     camera.ProcessMouseMovement(xOffset, yOffset);
 }
-
-void Animacion()
-{
-    // 1. Comprobar si Ho-oh llegó al objetivo
-    float dist = glm::distance(hoohPos, hoohTargetPos);
-    if (dist < 2.0f)
-    {
-        // 2. Generar nuevo objetivo aleatorio
-        float targetX = (rand() % 120) - 60.0f; // Rango -60 a 60
-        float targetZ = (rand() % 120) - 60.0f; // Rango -60 a 60
-        float targetY = (rand() % 20) + hoohMinY; // Rango [hoohMinY] a [hoohMinY + 20]
-        hoohTargetPos = glm::vec3(targetX, targetY, targetZ);
-    }
-
-    // 3. Calcular dirección de vuelo (con curvas)
-    glm::vec3 linearDirection = glm::normalize(hoohTargetPos - hoohPos);
-    glm::vec3 rightVector = glm::normalize(glm::cross(linearDirection, glm::vec3(0.0f, 1.0f, 0.0f)));
-    float curveFactor = sin(glfwGetTime() * hoohCurveSpeed);
-
-    // 4. Actualizar dirección y posición
-    hoohDirection = glm::normalize(linearDirection + (rightVector * curveFactor * hoohCurveAmount));
-    hoohPos += hoohDirection * hoohSpeed * deltaTime;
-
-    // --- ANIMACIÓN DE MEW (AGREGAR ESTO) ---
-    // 1. Comprobar si Mew llegó al objetivo
-    float distMew = glm::distance(mewPos, mewTargetPos);
-    if (distMew < 1.0f) // Radio más pequeño para cambiar de objetivo con más frecuencia
-    {
-        // 2. Generar nuevo objetivo aleatorio
-        float targetX = (rand() % 40) - 20.0f; // Rango -20 a 20 (más centrado)
-        float targetZ = (rand() % 40) - 20.0f; // Rango -20 a 20
-        float targetY = (rand() % 3) + mewMinY; // Rango [mewMinY] a [mewMinY + 3]
-        mewTargetPos = glm::vec3(targetX, targetY, targetZ);
-    }
-
-    // 3. Calcular dirección de vuelo (con curvas pronunciadas)
-    glm::vec3 linearDirectionMew = glm::normalize(mewTargetPos - mewPos);
-    glm::vec3 rightVectorMew = glm::normalize(glm::cross(linearDirectionMew, glm::vec3(0.0f, 1.0f, 0.0f)));
-    float curveFactorMew = sin(glfwGetTime() * mewCurveSpeed); // Oscilación de la curva
-
-    // 4. Actualizar dirección y posición
-    mewDirection = glm::normalize(linearDirectionMew + (rightVectorMew * curveFactorMew * mewCurveAmount));
-    mewPos += mewDirection * mewSpeed * deltaTime;
-}
-
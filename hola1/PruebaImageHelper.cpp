@@ -0,0 +1,201 @@
+// Prueba de los kernels SSE2/AVX2 de SOIL2/image_helper.c contra el codigo escalar
+// Cada funcion corre primero con IMAGE_HELPER_SIMD_NONE (la referencia) y luego forzando SSE2 y AVX2
+// (image_helper_set_simd_level); la salida tiene que ser identica byte por byte (memcmp):
+//   up_scale_image                 1 a 4 canales, anchos nones y destinos de varios tamanos
+//   scale_image_RGB_to_NTSC_safe   1 a 4 canales (los bloques de 16 bytes cortan pixeles)
+//   convert_RGB_to_YCoCg / convert_YCoCg_to_RGB   3 y 4 canales
+//   RGBE_to_RGBdivA / RGBE_to_RGBdivA2            con y sin rescale_to_max
+// Los datos son aleatorios (semilla fija) y casos limite: negro, saturado y exponente cero.
+// Los anchos nones dejan pixeles sueltos al final que hace el codigo escalar.
+//
+// Uso: PruebaImageHelper [--semilla N]
+// Regresa EXIT_FAILURE si algun nivel no coincide. Se compila junto con SOIL2/image_helper.c.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+#include "SOIL2/image_helper.h"
+
+enum Pattern
+{
+	PATTERN_RANDOM,
+	PATTERN_BLACK,		// Color en cero (en RGBE el exponente sigue aleatorio)
+	PATTERN_SATURATED,	// Todo en 255
+	PATTERN_ZERO_EXPONENT,	// Solo RGBE: color aleatorio con exponente 0
+	PATTERN_MIXED,		// Pixeles de los casos anteriores revueltos
+	PATTERN_COUNT
+};
+
+const char* const PATTERN_NAMES[PATTERN_COUNT] = { "aleatorio", "negro", "saturado", "exponente_cero", "mezcla" };
+
+const int LEVELS[] = { IMAGE_HELPER_SIMD_SSE2, IMAGE_HELPER_SIMD_AVX2 };
+const char* const LEVEL_NAMES[] = { "escalar", "sse2", "avx2" };
+
+static unsigned int randomState = 12345u;
+
+unsigned char RandomByte()
+{
+	randomState = randomState * 1664525u + 1013904223u;
+	return (unsigned char)(randomState >> 24);
+}
+
+// Llena width*height pixeles de channels bytes; en RGBE (channels 4) el cuarto byte es el exponente
+std::vector<unsigned char> MakeImage(int width, int height, int channels, Pattern pattern, bool rgbe)
+{
+	std::vector<unsigned char> image(width * height * channels);
+	for (int p = 0; p < width * height; p++)
+	{
+		Pattern kind = pattern;
+		if (kind == PATTERN_MIXED)
+		{
+			kind = (Pattern)(RandomByte() % PATTERN_MIXED);
+		}
+		unsigned char* pixel = &image[p * channels];
+		for (int c = 0; c < channels; c++)
+		{
+			bool exponent = rgbe && c == 3;
+			switch (kind)
+			{
+			case PATTERN_BLACK:
+				pixel[c] = exponent ? RandomByte() : 0;
+				break;
+			case PATTERN_SATURATED:
+				pixel[c] = 255;
+				break;
+			case PATTERN_ZERO_EXPONENT:
+				pixel[c] = exponent ? 0 : RandomByte();
+				break;
+			default:
+				pixel[c] = RandomByte();
+				break;
+			}
+		}
+	}
+	return image;
+}
+
+int checks = 0;
+int failures = 0;
+
+// Corre kernel sobre una copia de input en cada nivel y compara contra el escalar
+template <typename Kernel>
+void Check(const std::string& name, const std::vector<unsigned char>& input, size_t outputSize, const Kernel& kernel)
+{
+	std::vector<unsigned char> reference(input);
+	std::vector<unsigned char> referenceOutput(outputSize, 0xCD);
+	image_helper_set_simd_level(IMAGE_HELPER_SIMD_NONE);
+	int referenceResult = kernel(reference, referenceOutput);
+
+	for (int level : LEVELS)
+	{
+		if (image_helper_set_simd_level(level) != level)
+		{
+			continue;	// El CPU no lo tiene: ya se probo con el nivel de abajo
+		}
+		std::vector<unsigned char> image(input);
+		std::vector<unsigned char> output(outputSize, 0xCD);
+		int result = kernel(image, output);
+		checks++;
+		if (result != referenceResult || memcmp(&image[0], &reference[0], image.size()) != 0
+			|| (outputSize > 0 && memcmp(&output[0], &referenceOutput[0], outputSize) != 0))
+		{
+			failures++;
+			std::cout << "ERROR::IMAGE_HELPER::MISMATCH " << name << " (" << LEVEL_NAMES[level] << ")" << std::endl;
+		}
+	}
+}
+
+std::string CaseName(const char* kernel, int width, int height, int channels, Pattern pattern)
+{
+	return std::string(kernel) + " " + std::to_string(width) + "x" + std::to_string(height) + "x" + std::to_string(channels)
+		+ " " + PATTERN_NAMES[pattern];
+}
+
+int main(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--semilla" && i + 1 < argc)
+			randomState = (unsigned int)strtoul(argv[++i], NULL, 10);
+	}
+
+	int supported = image_helper_set_simd_level(IMAGE_HELPER_SIMD_AVX2);
+	std::cout << "Nivel SIMD del CPU: " << LEVEL_NAMES[supported] << std::endl;
+
+	const int widths[] = { 1, 2, 3, 5, 7, 8, 9, 15, 17, 31, 33, 64 };
+	const int heights[] = { 1, 3 };
+	const Pattern bytePatterns[] = { PATTERN_RANDOM, PATTERN_BLACK, PATTERN_SATURATED, PATTERN_MIXED };
+
+	// --- Escalado hacia arriba (el origen necesita al menos 2x2 para interpolar) ---
+	const int sizes[][2] = { { 2, 2 }, { 3, 5 }, { 7, 3 }, { 17, 9 }, { 33, 31 } };
+	const int resampledSizes[][2] = { { 2, 2 }, { 5, 7 }, { 37, 19 }, { 64, 64 }, { 129, 65 } };
+	for (int channels = 1; channels <= 4; channels++)
+	for (const int* size : sizes)
+	for (const int* resampled : resampledSizes)
+	for (Pattern pattern : bytePatterns)
+	{
+		int width = size[0], height = size[1];
+		int resampledWidth = resampled[0], resampledHeight = resampled[1];
+		Check(CaseName("up_scale_image", width, height, channels, pattern) + " -> " + std::to_string(resampledWidth) + "x" + std::to_string(resampledHeight),
+			MakeImage(width, height, channels, pattern, false), resampledWidth * resampledHeight * channels,
+			[&](std::vector<unsigned char>& image, std::vector<unsigned char>& output)
+			{
+				return up_scale_image(&image[0], width, height, channels, &output[0], resampledWidth, resampledHeight);
+			});
+	}
+
+	// --- Kernels en el lugar sobre bytes ---
+	for (int width : widths)
+	for (int height : heights)
+	for (Pattern pattern : bytePatterns)
+	{
+		for (int channels = 1; channels <= 4; channels++)
+		{
+			Check(CaseName("scale_image_RGB_to_NTSC_safe", width, height, channels, pattern), MakeImage(width, height, channels, pattern, false), 0,
+				[&](std::vector<unsigned char>& image, std::vector<unsigned char>&)
+				{
+					return scale_image_RGB_to_NTSC_safe(&image[0], width, height, channels);
+				});
+		}
+		for (int channels = 3; channels <= 4; channels++)
+		{
+			Check(CaseName("convert_RGB_to_YCoCg", width, height, channels, pattern), MakeImage(width, height, channels, pattern, false), 0,
+				[&](std::vector<unsigned char>& image, std::vector<unsigned char>&)
+				{
+					return convert_RGB_to_YCoCg(&image[0], width, height, channels);
+				});
+			Check(CaseName("convert_YCoCg_to_RGB", width, height, channels, pattern), MakeImage(width, height, channels, pattern, false), 0,
+				[&](std::vector<unsigned char>& image, std::vector<unsigned char>&)
+				{
+					return convert_YCoCg_to_RGB(&image[0], width, height, channels);
+				});
+		}
+	}
+
+	// --- RGBE (siempre 4 bytes por pixel) ---
+	for (int width : widths)
+	for (int height : heights)
+	for (int pattern = 0; pattern < PATTERN_COUNT; pattern++)
+	for (int rescale = 0; rescale < 2; rescale++)
+	{
+		std::vector<unsigned char> image = MakeImage(width, height, 4, (Pattern)pattern, true);
+		std::string suffix = rescale ? " rescale" : "";
+		Check(CaseName("RGBE_to_RGBdivA", width, height, 4, (Pattern)pattern) + suffix, image, 0,
+			[&](std::vector<unsigned char>& image, std::vector<unsigned char>&)
+			{
+				return RGBE_to_RGBdivA(&image[0], width, height, rescale);
+			});
+		Check(CaseName("RGBE_to_RGBdivA2", width, height, 4, (Pattern)pattern) + suffix, image, 0,
+			[&](std::vector<unsigned char>& image, std::vector<unsigned char>&)
+			{
+				return RGBE_to_RGBdivA2(&image[0], width, height, rescale);
+			});
+	}
+
+	std::cout << checks << " comparaciones, " << failures << " diferentes" << std::endl;
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
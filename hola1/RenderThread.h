@@ -0,0 +1,202 @@
+#pragma once
+
+// Std. Includes
+#include <functional>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// Other Includes
+#include "FrameArena.h"
+
+// Lo que se puede pedir en una lista de comandos
+enum Render_Command_Type
+{
+	RENDER_DRAW,			// Un objeto con su matriz (y su primer hueso si tiene esqueleto)
+	RENDER_DRAW_INSTANCED	// Un grupo de instancias ya subido por quien lo dibuja
+};
+
+// Un dibujo. Solo datos: el objeto y el material se nombran con numeros que entiende quien
+// ejecuta la lista, asi quien la graba no toca GL
+struct RenderCommand
+{
+	GLuint type;
+	GLuint object;		// Que dibujar
+	GLuint flags;		// Variante del shader
+	GLfloat specular;
+	GLfloat shininess;
+	GLint firstBone;	// -1 sin esqueleto
+	glm::mat4 model;
+};
+
+// Comandos que se apartan de una vez al empezar la lista (crecer deja el arreglo viejo en la arena)
+const GLuint RENDER_COMMANDS_RESERVE = 64;
+
+// Lista de dibujos de un cuadro: se graba en un hilo y se ejecuta las veces que haga falta
+// (sombras, G-buffer o forward) en el que tiene el contexto.
+// Los comandos viven en la arena del cuadro: Clear() la recibe ya vaciada
+class RenderCommandList
+{
+public:
+	void Clear(FrameArena& arena)
+	{
+		this->commands = FrameVector<RenderCommand>(FrameAllocator<RenderCommand>(arena, ARENA_RENDER));
+		this->commands.reserve(RENDER_COMMANDS_RESERVE);
+	}
+
+	void Draw(GLuint object, GLuint flags, GLfloat specular, GLfloat shininess, const glm::mat4& model, GLint firstBone = -1)
+	{
+		RenderCommand command = { RENDER_DRAW, object, flags, specular, shininess, firstBone, model };
+		this->commands.push_back(command);
+	}
+
+	void DrawInstanced(GLuint object, GLuint flags, GLfloat specular, GLfloat shininess)
+	{
+		RenderCommand command = { RENDER_DRAW_INSTANCED, object, flags, specular, shininess, -1, glm::mat4(1.0f) };
+		this->commands.push_back(command);
+	}
+
+	const FrameVector<RenderCommand>& GetCommands() const { return this->commands; }
+
+private:
+	FrameVector<RenderCommand> commands;
+};
+
+// Hilo de render con doble buffer de cuadros.
+// El hilo principal graba el cuadro N + 1 (BeginFrame() / Submit()) mientras el de render dibuja
+// el N con su propio contexto; cada uno tiene su Frame y solo se esperan si uno va un cuadro
+// completo adelante. Sin Start() todo corre en el hilo que llama a Submit(), igual que antes.
+// makeCurrent(true) toma el contexto en el hilo que llama y makeCurrent(false) lo suelta.
+template <typename Frame>
+class RenderThread
+{
+public:
+	typedef std::function<void(Frame& frame)> RenderFunction;
+	typedef std::function<void(bool current)> ContextFunction;
+
+	RenderThread(RenderFunction render, ContextFunction makeCurrent)
+		: render(render), makeCurrent(makeCurrent), recording(0), pending(-1), rendering(-1), running(false), waitMs(0.0)
+	{
+	}
+
+	~RenderThread()
+	{
+		this->Stop();
+	}
+
+	// El cuadro que toca grabar; con hilo espera a que el de render lo haya soltado
+	Frame& BeginFrame()
+	{
+		if (this->running)
+		{
+			std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->condition.wait(lock, [this]() { return this->rendering != this->recording && this->pending != this->recording; });
+			this->waitMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+		return this->frames[this->recording];
+	}
+
+	// Entrega el cuadro grabado: con hilo se encola (si el anterior aun no se toma, espera), sin hilo se dibuja ya
+	void Submit()
+	{
+		if (!this->running)
+		{
+			this->waitMs = 0.0;
+			this->render(this->frames[this->recording]);
+			this->recording = 1 - this->recording;
+			return;
+		}
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->condition.wait(lock, [this]() { return this->pending < 0; });
+			this->pending = this->recording;
+			this->recording = 1 - this->recording;
+		}
+		this->condition.notify_all();
+		this->waitMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	// Pasa el contexto y el dibujo a un hilo propio
+	void Start()
+	{
+		if (this->running)
+		{
+			return;
+		}
+		this->makeCurrent(false);
+		this->running = true;
+		this->worker = std::thread(&RenderThread::workerLoop, this);
+	}
+
+	// Dibuja lo que quede pendiente y regresa el contexto al hilo que llama
+	void Stop()
+	{
+		if (!this->running)
+		{
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->running = false;
+		}
+		this->condition.notify_all();
+		this->worker.join();
+		this->makeCurrent(true);
+	}
+
+	// Para preparar o liberar los dos cuadros (solo sin hilo)
+	Frame& GetFrame(GLuint index) { return this->frames[index]; }
+
+	bool IsThreaded() const { return this->running; }
+	double GetWaitMs() const { return this->waitMs; }	// Lo que espero el hilo principal en el ultimo BeginFrame() y Submit()
+
+private:
+	RenderFunction render;
+	ContextFunction makeCurrent;
+	Frame frames[2];
+	GLint recording;	// Lo toca solo el hilo principal
+	GLint pending;		// Grabado y esperando al hilo de render (-1 ninguno)
+	GLint rendering;	// El que se esta dibujando (-1 ninguno)
+	bool running;
+	double waitMs;
+
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable condition;
+
+	void workerLoop()
+	{
+		this->makeCurrent(true);
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->condition.wait(lock, [this]() { return this->pending >= 0 || !this->running; });
+				if (this->pending < 0)
+				{
+					break;
+				}
+				this->rendering = this->pending;
+				this->pending = -1;
+			}
+			this->condition.notify_all();
+
+			this->render(this->frames[this->rendering]);
+
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->rendering = -1;
+			}
+			this->condition.notify_all();
+		}
+		this->makeCurrent(false);
+	}
+};
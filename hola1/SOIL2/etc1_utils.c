@@ -16,6 +16,13 @@
 
 #include <string.h>
 
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 /* From http://www.khronos.org/registry/gles/extensions/OES/OES_compressed_ETC1_RGB8_texture.txt
 
  The number of bits that represent a 4x4 texel block is 64 bits if
@@ -505,33 +512,205 @@ void etc1_encode_block(const etc1_byte* pIn, etc1_uint32 inMask,
     writeBigEndian(pOut + 4, a.low);
 }
 
+// Fast encoder.
+//
+// For a sub-block with base colour (r, g, b), the modifier m that minimises the
+// weighted error 3 * dR^2 + 6 * dG^2 + dB^2 used by chooseModifier is (ignoring
+// clamping) the weighted luminance offset of the pixel:
+//     m = (3 * (pR - r) + 6 * (pG - g) + (pB - b)) / 10
+// so every pixel can pick its modifier with two compares, and a table can be
+// rated in one dimension without touching the colour channels.
+
+// A block whose unflipped encoding scores below this (about one level of error
+// per channel and pixel) is not worth trying flipped.
+#define ETC1_FAST_GOOD_ENOUGH_SCORE 160
+
+static
+inline int etc_luma_delta(const etc1_byte* pIn, const etc1_byte* pBaseColors) {
+    int d = 3 * (pIn[0] - pBaseColors[0]) + 6 * (pIn[1] - pBaseColors[1])
+            + (pIn[2] - pBaseColors[2]);
+    return d >= 0 ? (d + 5) / 10 : -((5 - d) / 10);
+}
+
+// Index into a kModifierTable row (a, b, -a, -b) closest to a luminance offset.
+static
+inline int etc_nearest_modifier(int delta, const int* pModifierTable) {
+    int threshold = (pModifierTable[0] + pModifierTable[1]) >> 1;
+    if (delta >= 0) {
+        return delta > threshold ? 1 : 0;
+    }
+    return -delta > threshold ? 3 : 2;
+}
+
+// Lists the pixels of a sub-block as indices i = x + 4 * y.
+static
+int etc_subblock_pixels(etc1_uint32 inMask, etc1_bool flipped, etc1_bool second,
+        int* pPixels) {
+    int count = 0;
+    int y, x;
+    if (flipped) {
+        int by = second ? 2 : 0;
+        for (y = by; y < by + 2; y++) {
+            for (x = 0; x < 4; x++) {
+                if (inMask & (1 << (x + 4 * y))) {
+                    pPixels[count++] = x + 4 * y;
+                }
+            }
+        }
+    } else {
+        int bx = second ? 2 : 0;
+        for (y = 0; y < 4; y++) {
+            for (x = bx; x < bx + 2; x++) {
+                if (inMask & (1 << (x + 4 * y))) {
+                    pPixels[count++] = x + 4 * y;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// Encodes one sub-block, writing its pixel indices into pCompressed->low.
+// Returns the modifier table index and stores the real (clamped, weighted)
+// error in *pScore. Gives up early once the error reaches bound.
+static
+int etc_encode_subblock_fast(const etc1_byte* pIn, etc1_uint32 inMask,
+        etc_compressed* pCompressed, etc1_bool flipped, etc1_bool second,
+        const etc1_byte* pBaseColors, etc1_uint32 bound, etc1_uint32* pScore) {
+    int pixels[8];
+    int deltas[8];
+    int count = etc_subblock_pixels(inMask, flipped, second, pixels);
+    int maxDelta = 0;
+    int i, t;
+
+    for (i = 0; i < count; i++) {
+        deltas[i] = etc_luma_delta(pIn + pixels[i] * 3, pBaseColors);
+        if (deltas[i] > maxDelta) {
+            maxDelta = deltas[i];
+        } else if (-deltas[i] > maxDelta) {
+            maxDelta = -deltas[i];
+        }
+    }
+
+    // Start at the smallest table whose large modifier covers most of the
+    // spread, and only look at its neighbours.
+    int center = 0;
+    while (center < 7 && kModifierTable[center * 4 + 1] * 4 < maxDelta * 3) {
+        center++;
+    }
+    int first = center > 0 ? center - 1 : 0;
+    int last = center < 7 ? center + 1 : 7;
+
+    int bestTable = center;
+    etc1_uint32 bestError = ~0;
+    for (t = first; t <= last; t++) {
+        const int* pModifierTable = kModifierTable + t * 4;
+        etc1_uint32 error = 0;
+        for (i = 0; i < count && error < bestError; i++) {
+            error += (etc1_uint32) square(deltas[i]
+                    - pModifierTable[etc_nearest_modifier(deltas[i], pModifierTable)]);
+        }
+        if (error < bestError) {
+            bestError = error;
+            bestTable = t;
+        }
+    }
+
+    const int* pModifierTable = kModifierTable + bestTable * 4;
+    etc1_uint32 score = 0;
+    for (i = 0; i < count; i++) {
+        int index = etc_nearest_modifier(deltas[i], pModifierTable);
+        int modifier = pModifierTable[index];
+        int bitIndex = (pixels[i] >> 2) + ((pixels[i] & 3) << 2);
+        const etc1_byte* p = pIn + pixels[i] * 3;
+        pCompressed->low |= (((index >> 1) << 16) | (index & 1)) << bitIndex;
+        if (score < bound) {
+            score += (etc1_uint32) (3 * square(clamp(pBaseColors[0] + modifier) - p[0])
+                    + 6 * square(clamp(pBaseColors[1] + modifier) - p[1])
+                    + square(clamp(pBaseColors[2] + modifier) - p[2]));
+        }
+    }
+    *pScore = score;
+    return bestTable;
+}
+
+static
+void etc_encode_block_fast_helper(const etc1_byte* pIn, etc1_uint32 inMask,
+        const etc1_byte* pColors, etc_compressed* pCompressed, etc1_bool flipped,
+        etc1_uint32 bound) {
+    etc1_byte pBaseColors[6];
+    etc1_uint32 score1, score2 = 0;
+
+    pCompressed->high = (flipped ? 1 : 0);
+    pCompressed->low = 0;
+
+    etc_encodeBaseColors(pBaseColors, pColors, pCompressed);
+
+    int table1 = etc_encode_subblock_fast(pIn, inMask, pCompressed, flipped, 0,
+            pBaseColors, bound, &score1);
+    int table2 = 0;
+    if (score1 < bound) {
+        table2 = etc_encode_subblock_fast(pIn, inMask, pCompressed, flipped, 1,
+                pBaseColors + 3, bound - score1, &score2);
+    }
+    pCompressed->high |= (table1 << 5) | (table2 << 2);
+    pCompressed->score = score1 + score2;
+}
+
+void etc1_encode_block_fast(const etc1_byte* pIn, etc1_uint32 inMask,
+        etc1_byte* pOut) {
+    etc1_byte colors[6];
+    etc_compressed a, b;
+
+	etc_average_colors_subblock(pIn, inMask, colors, 0, 0);
+	etc_average_colors_subblock(pIn, inMask, colors + 3, 0, 1);
+	etc_encode_block_fast_helper(pIn, inMask, colors, &a, 0, ~0u);
+
+    if (a.score > ETC1_FAST_GOOD_ENOUGH_SCORE) {
+        etc1_byte flippedColors[6];
+	    etc_average_colors_subblock(pIn, inMask, flippedColors, 1, 0);
+	    etc_average_colors_subblock(pIn, inMask, flippedColors + 3, 1, 1);
+	    etc_encode_block_fast_helper(pIn, inMask, flippedColors, &b, 1, a.score);
+        take_best(&a, &b);
+    }
+    writeBigEndian(pOut, a.high);
+    writeBigEndian(pOut + 4, a.low);
+}
+
 // Return the size of the encoded image data (does not include size of PKM header).
 
 etc1_uint32 etc1_get_encoded_data_size(etc1_uint32 width, etc1_uint32 height) {
     return (((width + 3) & ~3) * ((height + 3) & ~3)) >> 1;
 }
 
-// Encode an entire image.
-// pIn - pointer to the image data. Formatted such that the Red component of
-//       pixel (x,y) is at pIn + pixelSize * x + stride * y + redOffset;
-// pOut - pointer to encoded data. Must be large enough to store entire encoded image.
+// Encodes the rows of blocks [firstRow, lastRow) of an image.
 
-int etc1_encode_image(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 height,
-        etc1_uint32 pixelSize, etc1_uint32 stride, etc1_byte* pOut) {
-    if (pixelSize < 2 || pixelSize > 3) {
-        return -1;
-    }
+typedef struct {
+    const etc1_byte* pIn;
+    etc1_uint32 width;
+    etc1_uint32 height;
+    etc1_uint32 pixelSize;
+    etc1_uint32 stride;
+    etc1_byte* pOut;
+    int quality;
+    etc1_uint32 firstRow;
+    etc1_uint32 lastRow;
+} etc_encode_job;
+
+static void etc_encode_rows(const etc_encode_job* pJob) {
     static const unsigned short kYMask[] = { 0x0, 0xf, 0xff, 0xfff, 0xffff };
     static const unsigned short kXMask[] = { 0x0, 0x1111, 0x3333, 0x7777,
             0xffff };
     etc1_byte block[ETC1_DECODED_BLOCK_SIZE];
-    etc1_byte encoded[ETC1_ENCODED_BLOCK_SIZE];
-	etc1_uint32 y, x, cy, cx;
+    etc1_uint32 y, x, cy, cx;
 
+    etc1_uint32 width = pJob->width;
+    etc1_uint32 height = pJob->height;
+    etc1_uint32 pixelSize = pJob->pixelSize;
     etc1_uint32 encodedWidth = (width + 3) & ~3;
-    etc1_uint32 encodedHeight = (height + 3) & ~3;
+    etc1_byte* pOut = pJob->pOut + pJob->firstRow * (encodedWidth >> 2) * ETC1_ENCODED_BLOCK_SIZE;
 
-	for ( y = 0; y < encodedHeight; y += 4) {
+	for ( y = pJob->firstRow * 4; y < pJob->lastRow * 4; y += 4) {
         etc1_uint32 yEnd = height - y;
         if (yEnd > 4) {
             yEnd = 4;
@@ -545,7 +724,7 @@ int etc1_encode_image(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 heigh
             int mask = ymask & kXMask[xEnd];
 			for ( cy = 0; cy < yEnd; cy++) {
                 etc1_byte* q = block + (cy * 4) * 3;
-                const etc1_byte* p = pIn + pixelSize * x + stride * (y + cy);
+                const etc1_byte* p = pJob->pIn + pixelSize * x + pJob->stride * (y + cy);
                 if (pixelSize == 3) {
                     memcpy(q, p, xEnd * 3);
                 } else {
@@ -558,11 +737,127 @@ int etc1_encode_image(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 heigh
                     }
                 }
             }
-            etc1_encode_block(block, mask, encoded);
-            memcpy(pOut, encoded, sizeof(encoded));
-            pOut += sizeof(encoded);
+            if (pJob->quality == ETC1_ENCODE_QUALITY_FAST) {
+                etc1_encode_block_fast(block, mask, pOut);
+            } else {
+                etc1_encode_block(block, mask, pOut);
+            }
+            pOut += ETC1_ENCODED_BLOCK_SIZE;
+        }
+    }
+}
+
+#define ETC1_MAX_THREADS 64
+
+#if defined(_WIN32)
+static DWORD WINAPI etc_encode_thread(LPVOID pJob) {
+    etc_encode_rows((const etc_encode_job*) pJob);
+    return 0;
+}
+#else
+static void* etc_encode_thread(void* pJob) {
+    etc_encode_rows((const etc_encode_job*) pJob);
+    return NULL;
+}
+#endif
+
+static int etc_get_num_cores(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int) info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int) count : 1;
+#else
+    return 1;
+#endif
+}
+
+// Encode an entire image.
+// pIn - pointer to the image data. Formatted such that the Red component of
+//       pixel (x,y) is at pIn + pixelSize * x + stride * y + redOffset;
+// pOut - pointer to encoded data. Must be large enough to store entire encoded image.
+
+int etc1_encode_image(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 height,
+        etc1_uint32 pixelSize, etc1_uint32 stride, etc1_byte* pOut) {
+    return etc1_encode_image_ex(pIn, width, height, pixelSize, stride, pOut,
+            ETC1_ENCODE_QUALITY_HIGH, 1);
+}
+
+// Encode an entire image with the given encoder mode, splitting the rows of
+// blocks between numThreads threads (0 = one per core).
+
+int etc1_encode_image_ex(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 height,
+        etc1_uint32 pixelSize, etc1_uint32 stride, etc1_byte* pOut,
+        int quality, int numThreads) {
+    if (pixelSize < 2 || pixelSize > 3) {
+        return -1;
+    }
+    etc1_uint32 blockRows = ((height + 3) & ~3) >> 2;
+    etc_encode_job jobs[ETC1_MAX_THREADS];
+	int i;
+
+    if (numThreads <= 0) {
+        numThreads = etc_get_num_cores();
+    }
+    if (numThreads > ETC1_MAX_THREADS) {
+        numThreads = ETC1_MAX_THREADS;
+    }
+    if ((etc1_uint32) numThreads > blockRows) {
+        numThreads = blockRows > 0 ? (int) blockRows : 1;
+    }
+
+	for ( i = 0; i < numThreads; i++) {
+        jobs[i].pIn = pIn;
+        jobs[i].width = width;
+        jobs[i].height = height;
+        jobs[i].pixelSize = pixelSize;
+        jobs[i].stride = stride;
+        jobs[i].pOut = pOut;
+        jobs[i].quality = quality;
+        jobs[i].firstRow = (etc1_uint32) (((unsigned long long) blockRows * i) / numThreads);
+        jobs[i].lastRow = (etc1_uint32) (((unsigned long long) blockRows * (i + 1)) / numThreads);
+    }
+
+    if (numThreads == 1) {
+        etc_encode_rows(&jobs[0]);
+        return 0;
+    }
+
+    // The calling thread takes the first slice, the others get a thread each.
+    // If a thread cannot be started its slice is encoded here instead.
+#if defined(_WIN32)
+    HANDLE threads[ETC1_MAX_THREADS];
+	for ( i = 1; i < numThreads; i++) {
+        threads[i] = CreateThread(NULL, 0, etc_encode_thread, &jobs[i], 0, NULL);
+        if (threads[i] == NULL) {
+            etc_encode_rows(&jobs[i]);
+        }
+    }
+    etc_encode_rows(&jobs[0]);
+	for ( i = 1; i < numThreads; i++) {
+        if (threads[i] != NULL) {
+            WaitForSingleObject(threads[i], INFINITE);
+            CloseHandle(threads[i]);
+        }
+    }
+#else
+    pthread_t threads[ETC1_MAX_THREADS];
+    int started[ETC1_MAX_THREADS];
+	for ( i = 1; i < numThreads; i++) {
+        started[i] = pthread_create(&threads[i], NULL, etc_encode_thread, &jobs[i]) == 0;
+        if (!started[i]) {
+            etc_encode_rows(&jobs[i]);
+        }
+    }
+    etc_encode_rows(&jobs[0]);
+	for ( i = 1; i < numThreads; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
         }
     }
+#endif
     return 0;
 }
 
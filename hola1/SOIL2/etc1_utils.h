@@ -43,6 +43,16 @@ extern "C" {
 
 void etc1_encode_block(const etc1_byte* pIn, etc1_uint32 validPixelMask, etc1_byte* pOut);
 
+// Encode a block of pixels with the fast heuristic encoder.
+//
+// Same input and output as etc1_encode_block. Instead of scoring every modifier
+// table against every pixel in R, G and B, the modifier for each pixel is taken
+// from its weighted luminance offset to the sub-block base colour, only the
+// modifier tables around the sub-block's luminance spread are tried, and the
+// flipped orientation is skipped when the unflipped one is already good enough.
+
+void etc1_encode_block_fast(const etc1_byte* pIn, etc1_uint32 validPixelMask, etc1_byte* pOut);
+
 // Decode a block of pixels.
 //
 // pIn is an ETC1 compressed version of the data.
@@ -67,6 +77,23 @@ etc1_uint32 etc1_get_encoded_data_size(etc1_uint32 width, etc1_uint32 height);
 int etc1_encode_image(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 height,
         etc1_uint32 pixelSize, etc1_uint32 stride, etc1_byte* pOut);
 
+// Encoder modes for etc1_encode_image_ex.
+
+#define ETC1_ENCODE_QUALITY_HIGH 0
+#define ETC1_ENCODE_QUALITY_FAST 1
+
+// Encode an entire image choosing the encoder mode and the number of threads.
+// quality - ETC1_ENCODE_QUALITY_HIGH (exhaustive search, same output as
+//           etc1_encode_image) or ETC1_ENCODE_QUALITY_FAST.
+// numThreads - rows of blocks are split between this many threads. 0 uses one
+//              thread per available core, 1 encodes on the calling thread.
+// Other parameters as etc1_encode_image.
+// returns non-zero if there is an error.
+
+int etc1_encode_image_ex(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 height,
+        etc1_uint32 pixelSize, etc1_uint32 stride, etc1_byte* pOut,
+        int quality, int numThreads);
+
 // Decode an entire image.
 // pIn - pointer to encoded data.
 // pOut - pointer to the image data. Will be written such that
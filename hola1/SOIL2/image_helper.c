@@ -8,8 +8,597 @@
 
 #include "image_helper.h"
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
+/*
+	SIMD kernels.
+	SSE2 is the baseline on x86 / x64 builds, AVX2 is picked at runtime
+	if the CPU (and the OS) support it.  Every kernel reproduces the
+	scalar code bit for bit (same float operations in the same order),
+	so the scalar loops below are still the reference, and the fallback
+	for other platforms and for the leftover pixels of each image.
+*/
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define IMAGE_HELPER_SSE2
+	#include <emmintrin.h>
+	#if defined(_MSC_VER) && (_MSC_VER >= 1700)
+		#define IMAGE_HELPER_AVX2
+		#define IMAGE_HELPER_TARGET_AVX2
+		#include <immintrin.h>
+		#include <intrin.h>
+	#elif defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9))))
+		#define IMAGE_HELPER_AVX2
+		#define IMAGE_HELPER_TARGET_AVX2 __attribute__((target("avx2")))
+		#include <immintrin.h>
+	#endif
+#endif
+
+static int image_helper_simd = -1;
+
+static int
+	image_helper_detect_simd( void )
+{
+	int level = IMAGE_HELPER_SIMD_NONE;
+#ifdef IMAGE_HELPER_SSE2
+	level = IMAGE_HELPER_SIMD_SSE2;
+	#ifdef IMAGE_HELPER_AVX2
+		#ifdef _MSC_VER
+	{
+		/*	AVX2 in CPUID leaf 7, plus the OS saving the YMM registers	*/
+		int info[4];
+		__cpuid( info, 0 );
+		if( info[0] >= 7 )
+		{
+			int has_avx2, os_ymm = 0;
+			__cpuidex( info, 7, 0 );
+			has_avx2 = (info[1] & (1 << 5)) != 0;
+			__cpuid( info, 1 );
+			if( (info[2] & (1 << 27)) && (info[2] & (1 << 28)) )
+			{
+				os_ymm = (_xgetbv( 0 ) & 6) == 6;
+			}
+			if( has_avx2 && os_ymm )
+			{
+				level = IMAGE_HELPER_SIMD_AVX2;
+			}
+		}
+	}
+		#else
+	/*	libgcc also checks XCR0 for the AVX state	*/
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "avx2" ) )
+	{
+		level = IMAGE_HELPER_SIMD_AVX2;
+	}
+		#endif
+	#endif
+#endif
+	return level;
+}
+
+int
+	image_helper_get_simd_level( void )
+{
+	/*	the detection always gives the same answer, so racing here is harmless	*/
+	if( image_helper_simd < 0 )
+	{
+		image_helper_simd = image_helper_detect_simd();
+	}
+	return image_helper_simd;
+}
+
+int
+	image_helper_set_simd_level( int level )
+{
+	int supported = image_helper_detect_simd();
+	if( level < IMAGE_HELPER_SIMD_NONE )
+	{
+		level = IMAGE_HELPER_SIMD_NONE;
+	}
+	image_helper_simd = (level > supported) ? supported : level;
+	return image_helper_simd;
+}
+
+#ifdef IMAGE_HELPER_SSE2
+
+/*	x < lo ? lo : x, and x > hi ? hi : x, on 32 bit lanes (SSE2 has no pmaxsd)	*/
+static __m128i sse2_max_epi32( __m128i x, __m128i lo )
+{
+	__m128i lt = _mm_cmplt_epi32( x, lo );
+	return _mm_or_si128( _mm_and_si128( lt, lo ), _mm_andnot_si128( lt, x ) );
+}
+
+static __m128i sse2_min_epi32( __m128i x, __m128i hi )
+{
+	__m128i gt = _mm_cmpgt_epi32( x, hi );
+	return _mm_or_si128( _mm_and_si128( gt, hi ), _mm_andnot_si128( gt, x ) );
+}
+
+static __m128i sse2_clamp_byte( __m128i x )
+{
+	return sse2_min_epi32( sse2_max_epi32( x, _mm_setzero_si128() ), _mm_set1_epi32( 255 ) );
+}
+
+/*	up to 4 bytes of a pixel into float lanes	*/
+static __m128 sse2_load_pixel( const unsigned char* p, int channels )
+{
+	int v = p[0] | (p[1] << 8) | (p[2] << 16);
+	__m128i z = _mm_setzero_si128();
+	__m128i x;
+	if( channels == 4 )
+	{
+		v |= p[3] << 24;
+	}
+	x = _mm_unpacklo_epi8( _mm_cvtsi32_si128( v ), z );
+	return _mm_cvtepi32_ps( _mm_unpacklo_epi16( x, z ) );
+}
+
+static void
+	up_scale_image_sse2
+	(
+		const unsigned char* const orig,
+		int width, int height, int channels,
+		unsigned char* resampled,
+		int resampled_width, int resampled_height,
+		float dx, float dy
+	)
+{
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 half = _mm_set1_ps( 0.5f );
+	int x, y, c;
+	for ( y = 0; y < resampled_height; ++y )
+	{
+		float sampley = y * dy;
+		int inty = (int)sampley;
+		__m128 sy, syi;
+		unsigned char* out = resampled + y*resampled_width*channels;
+		if( inty > height - 2 ) { inty = height - 2; }
+		sampley -= inty;
+		sy = _mm_set1_ps( sampley );
+		syi = _mm_sub_ps( one, sy );
+		for ( x = 0; x < resampled_width; ++x )
+		{
+			float samplex = x * dx;
+			int intx = (int)samplex;
+			const unsigned char* p;
+			__m128 sx, sxi, value;
+			int iv;
+			if( intx > width - 2 ) { intx = width - 2; }
+			samplex -= intx;
+			sx = _mm_set1_ps( samplex );
+			sxi = _mm_sub_ps( one, sx );
+			p = orig + (inty * width + intx) * channels;
+			/*	one channel per lane, same sums as the scalar loop	*/
+			value = _mm_add_ps( half, _mm_mul_ps( _mm_mul_ps( sse2_load_pixel( p, channels ), sxi ), syi ) );
+			value = _mm_add_ps( value, _mm_mul_ps( _mm_mul_ps( sse2_load_pixel( p + channels, channels ), sx ), syi ) );
+			value = _mm_add_ps( value, _mm_mul_ps( _mm_mul_ps( sse2_load_pixel( p + width*channels, channels ), sxi ), sy ) );
+			value = _mm_add_ps( value, _mm_mul_ps( _mm_mul_ps( sse2_load_pixel( p + width*channels + channels, channels ), sx ), sy ) );
+			iv = _mm_cvtsi128_si32( _mm_packus_epi16( _mm_packs_epi32( _mm_cvttps_epi32( value ), _mm_setzero_si128() ), _mm_setzero_si128() ) );
+			for( c = 0; c < channels; ++c )
+			{
+				out[x*channels+c] = (unsigned char)(iv >> (8 * c));
+			}
+		}
+	}
+}
+
+/*	returns how many bytes were done, the caller finishes the rest	*/
+static int
+	scale_image_RGB_to_NTSC_safe_sse2
+	(
+		unsigned char* orig, int size, int channels,
+		float scale_lo, float scale_hi
+	)
+{
+	const __m128 range = _mm_set1_ps( scale_hi - scale_lo );
+	const __m128 lo = _mm_set1_ps( scale_lo );
+	const __m128 div = _mm_set1_ps( 255.0f );
+	const __m128i z = _mm_setzero_si128();
+	/*	for channels = 2 or 4 the alpha bytes are put back untouched	*/
+	__m128i alpha = _mm_setzero_si128();
+	int i, k;
+	if( channels == 2 ) { alpha = _mm_set1_epi16( (short)0xFF00 ); }
+	if( channels == 4 ) { alpha = _mm_set1_epi32( (int)0xFF000000 ); }
+	for( i = 0; i + 16 <= size; i += 16 )
+	{
+		__m128i src = _mm_loadu_si128( (const __m128i*)(orig + i) );
+		__m128i half[2], quad[4];
+		half[0] = _mm_unpacklo_epi8( src, z );
+		half[1] = _mm_unpackhi_epi8( src, z );
+		for( k = 0; k < 4; ++k )
+		{
+			__m128i w = (k & 1) ? _mm_unpackhi_epi16( half[k >> 1], z ) : _mm_unpacklo_epi16( half[k >> 1], z );
+			__m128 f = _mm_div_ps( _mm_mul_ps( range, _mm_cvtepi32_ps( w ) ), div );
+			quad[k] = _mm_cvttps_epi32( _mm_add_ps( f, lo ) );
+		}
+		half[0] = _mm_packs_epi32( quad[0], quad[1] );
+		half[1] = _mm_packs_epi32( quad[2], quad[3] );
+		src = _mm_or_si128( _mm_and_si128( alpha, src ),
+			_mm_andnot_si128( alpha, _mm_packus_epi16( half[0], half[1] ) ) );
+		_mm_storeu_si128( (__m128i*)(orig + i), src );
+	}
+	return i;
+}
+
+/*	4 channel pixels, 4 at a time, one channel per register	*/
+static int
+	convert_RGB_to_YCoCg_sse2( unsigned char* orig, int pixels )
+{
+	const __m128i mask = _mm_set1_epi32( 0xFF );
+	int i;
+	for( i = 0; i + 4 <= pixels; i += 4 )
+	{
+		__m128i v = _mm_loadu_si128( (const __m128i*)(orig + i*4) );
+		__m128i r = _mm_and_si128( v, mask );
+		__m128i g = _mm_srli_epi32( _mm_add_epi32( _mm_and_si128( _mm_srli_epi32( v, 8 ), mask ), _mm_set1_epi32( 1 ) ), 1 );
+		__m128i b = _mm_and_si128( _mm_srli_epi32( v, 16 ), mask );
+		__m128i a = _mm_srli_epi32( v, 24 );
+		__m128i tmp = _mm_srli_epi32( _mm_add_epi32( _mm_add_epi32( r, b ), _mm_set1_epi32( 2 ) ), 2 );
+		__m128i co = _mm_srai_epi32( _mm_add_epi32( _mm_sub_epi32( r, b ), _mm_set1_epi32( 1 ) ), 1 );
+		co = sse2_clamp_byte( _mm_add_epi32( co, _mm_set1_epi32( 128 ) ) );
+		r = sse2_clamp_byte( _mm_sub_epi32( _mm_add_epi32( g, _mm_set1_epi32( 128 ) ), tmp ) );
+		b = sse2_clamp_byte( _mm_add_epi32( g, tmp ) );
+		/*	Co Cg A Y	*/
+		v = _mm_or_si128( _mm_or_si128( co, _mm_slli_epi32( r, 8 ) ),
+			_mm_or_si128( _mm_slli_epi32( a, 16 ), _mm_slli_epi32( b, 24 ) ) );
+		_mm_storeu_si128( (__m128i*)(orig + i*4), v );
+	}
+	return i;
+}
+
+static int
+	convert_YCoCg_to_RGB_sse2( unsigned char* orig, int pixels )
+{
+	const __m128i mask = _mm_set1_epi32( 0xFF );
+	const __m128i bias = _mm_set1_epi32( 128 );
+	int i;
+	for( i = 0; i + 4 <= pixels; i += 4 )
+	{
+		__m128i v = _mm_loadu_si128( (const __m128i*)(orig + i*4) );
+		__m128i co = _mm_sub_epi32( _mm_and_si128( v, mask ), bias );
+		__m128i cg = _mm_sub_epi32( _mm_and_si128( _mm_srli_epi32( v, 8 ), mask ), bias );
+		__m128i a = _mm_and_si128( _mm_srli_epi32( v, 16 ), mask );
+		__m128i y = _mm_srli_epi32( v, 24 );
+		__m128i r = sse2_clamp_byte( _mm_sub_epi32( _mm_add_epi32( y, co ), cg ) );
+		__m128i g = sse2_clamp_byte( _mm_add_epi32( y, cg ) );
+		__m128i b = sse2_clamp_byte( _mm_sub_epi32( _mm_sub_epi32( y, co ), cg ) );
+		v = _mm_or_si128( _mm_or_si128( r, _mm_slli_epi32( g, 8 ) ),
+			_mm_or_si128( _mm_slli_epi32( b, 16 ), _mm_slli_epi32( a, 24 ) ) );
+		_mm_storeu_si128( (__m128i*)(orig + i*4), v );
+	}
+	return i;
+}
+
+/*	e_LUT[E] holds the same float the scalar code gets from ldexp	*/
+static float
+	find_max_RGBE_sse2( const unsigned char *image, int pixels, const float* e_LUT, int *done )
+{
+	const __m128i mask = _mm_set1_epi32( 0xFF );
+	__m128 max_val = _mm_setzero_ps();
+	float m[4];
+	int i;
+	for( i = 0; i + 4 <= pixels; i += 4 )
+	{
+		const unsigned char *img = image + i*4;
+		__m128i v = _mm_loadu_si128( (const __m128i*)img );
+		__m128 e = _mm_setr_ps( e_LUT[img[3]], e_LUT[img[7]], e_LUT[img[11]], e_LUT[img[15]] );
+		max_val = _mm_max_ps( max_val, _mm_mul_ps( _mm_cvtepi32_ps( _mm_and_si128( v, mask ) ), e ) );
+		max_val = _mm_max_ps( max_val, _mm_mul_ps( _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( v, 8 ), mask ) ), e ) );
+		max_val = _mm_max_ps( max_val, _mm_mul_ps( _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( v, 16 ), mask ) ), e ) );
+	}
+	_mm_storeu_ps( m, max_val );
+	*done = i;
+	m[0] = (m[1] > m[0]) ? m[1] : m[0];
+	m[2] = (m[3] > m[2]) ? m[3] : m[2];
+	return (m[2] > m[0]) ? m[2] : m[0];
+}
+
+/*	square_root != 0 selects RGBdivA2	*/
+static int
+	RGBE_to_RGBdivA_sse2( unsigned char *image, int pixels, const float* e_LUT, int square_root )
+{
+	const __m128i mask = _mm_set1_epi32( 0xFF );
+	const __m128i one = _mm_set1_epi32( 1 );
+	const __m128i max_byte = _mm_set1_epi32( 255 );
+	const __m128 half = _mm_set1_ps( 0.5f );
+	const __m128 f255 = _mm_set1_ps( 255.0f );
+	int i, k;
+	for( i = 0; i + 4 <= pixels; i += 4 )
+	{
+		unsigned char *img = image + i*4;
+		__m128i v = _mm_loadu_si128( (const __m128i*)img );
+		__m128 e = _mm_setr_ps( e_LUT[img[3]], e_LUT[img[7]], e_LUT[img[11]], e_LUT[img[15]] );
+		__m128 rgb[3], m, a;
+		__m128i iv, out;
+		rgb[0] = _mm_mul_ps( e, _mm_cvtepi32_ps( _mm_and_si128( v, mask ) ) );
+		rgb[1] = _mm_mul_ps( e, _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( v, 8 ), mask ) ) );
+		rgb[2] = _mm_mul_ps( e, _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( v, 16 ), mask ) ) );
+		/*	maxps is (a > b) ? a : b, exactly like the scalar code (NaNs included)	*/
+		m = _mm_max_ps( rgb[0], rgb[1] );
+		m = _mm_max_ps( rgb[2], m );
+		if( square_root )
+		{
+			iv = _mm_cvttps_epi32( _mm_sqrt_ps( _mm_div_ps( _mm_set1_ps( 255.0f * 255.0f ), m ) ) );
+		} else
+		{
+			iv = _mm_cvttps_epi32( _mm_div_ps( f255, m ) );
+		}
+		/*	m == 0 gives 1	*/
+		{
+			__m128i zero = _mm_castps_si128( _mm_cmpeq_ps( m, _mm_setzero_ps() ) );
+			iv = _mm_or_si128( _mm_and_si128( zero, one ), _mm_andnot_si128( zero, iv ) );
+		}
+		iv = sse2_min_epi32( sse2_max_epi32( iv, one ), max_byte );
+		a = _mm_cvtepi32_ps( iv );
+		if( square_root )
+		{
+			a = _mm_mul_ps( a, a );
+		}
+		out = _mm_slli_epi32( iv, 24 );
+		for( k = 0; k < 3; ++k )
+		{
+			__m128 f = _mm_mul_ps( a, rgb[k] );
+			__m128i c;
+			if( square_root )
+			{
+				f = _mm_div_ps( f, f255 );
+			}
+			c = sse2_min_epi32( _mm_cvttps_epi32( _mm_add_ps( f, half ) ), max_byte );
+			out = _mm_or_si128( out, _mm_slli_epi32( _mm_and_si128( c, mask ), 8 * k ) );
+		}
+		_mm_storeu_si128( (__m128i*)img, out );
+	}
+	return i;
+}
+
+#endif /* IMAGE_HELPER_SSE2	*/
+
+#ifdef IMAGE_HELPER_AVX2
+
+/*	two 4 channel pixels into 8 float lanes	*/
+static IMAGE_HELPER_TARGET_AVX2 __m256 avx2_load_pixels( const unsigned char* p0, const unsigned char* p1 )
+{
+	int v0, v1;
+	memcpy( &v0, p0, 4 );
+	memcpy( &v1, p1, 4 );
+	return _mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( _mm_unpacklo_epi32( _mm_cvtsi32_si128( v0 ), _mm_cvtsi32_si128( v1 ) ) ) );
+}
+
+static IMAGE_HELPER_TARGET_AVX2 __m256i avx2_clamp_byte( __m256i x )
+{
+	return _mm256_min_epi32( _mm256_max_epi32( x, _mm256_setzero_si256() ), _mm256_set1_epi32( 255 ) );
+}
+
+/*	4 channels only, two output pixels per iteration	*/
+static IMAGE_HELPER_TARGET_AVX2 void
+	up_scale_image_avx2
+	(
+		const unsigned char* const orig,
+		int width, int height,
+		unsigned char* resampled,
+		int resampled_width, int resampled_height,
+		float dx, float dy
+	)
+{
+	const __m256 one = _mm256_set1_ps( 1.0f );
+	const __m256 half = _mm256_set1_ps( 0.5f );
+	const int row = width * 4;
+	int x, y;
+	for ( y = 0; y < resampled_height; ++y )
+	{
+		float sampley = y * dy;
+		int inty = (int)sampley;
+		__m256 sy, syi;
+		unsigned char* out = resampled + y*resampled_width*4;
+		if( inty > height - 2 ) { inty = height - 2; }
+		sampley -= inty;
+		sy = _mm256_set1_ps( sampley );
+		syi = _mm256_sub_ps( one, sy );
+		for ( x = 0; x < resampled_width; x += 2 )
+		{
+			/*	an odd width repeats the last pixel, which just gets written twice	*/
+			int x1 = (x + 1 < resampled_width) ? x + 1 : x;
+			float samplex0 = x * dx, samplex1 = x1 * dx;
+			int intx0 = (int)samplex0, intx1 = (int)samplex1;
+			const unsigned char *p0, *p1;
+			__m256 sx, sxi, value;
+			__m256i iv;
+			int px0, px1;
+			if( intx0 > width - 2 ) { intx0 = width - 2; }
+			if( intx1 > width - 2 ) { intx1 = width - 2; }
+			samplex0 -= intx0;
+			samplex1 -= intx1;
+			sx = _mm256_setr_ps( samplex0, samplex0, samplex0, samplex0, samplex1, samplex1, samplex1, samplex1 );
+			sxi = _mm256_sub_ps( one, sx );
+			p0 = orig + (inty * width + intx0) * 4;
+			p1 = orig + (inty * width + intx1) * 4;
+			value = _mm256_add_ps( half, _mm256_mul_ps( _mm256_mul_ps( avx2_load_pixels( p0, p1 ), sxi ), syi ) );
+			value = _mm256_add_ps( value, _mm256_mul_ps( _mm256_mul_ps( avx2_load_pixels( p0 + 4, p1 + 4 ), sx ), syi ) );
+			value = _mm256_add_ps( value, _mm256_mul_ps( _mm256_mul_ps( avx2_load_pixels( p0 + row, p1 + row ), sxi ), sy ) );
+			value = _mm256_add_ps( value, _mm256_mul_ps( _mm256_mul_ps( avx2_load_pixels( p0 + row + 4, p1 + row + 4 ), sx ), sy ) );
+			iv = _mm256_cvttps_epi32( value );
+			iv = _mm256_packus_epi16( _mm256_packs_epi32( iv, iv ), _mm256_setzero_si256() );
+			px0 = _mm_cvtsi128_si32( _mm256_castsi256_si128( iv ) );
+			px1 = _mm_cvtsi128_si32( _mm256_extracti128_si256( iv, 1 ) );
+			memcpy( out + x*4, &px0, 4 );
+			memcpy( out + x1*4, &px1, 4 );
+		}
+	}
+}
+
+static IMAGE_HELPER_TARGET_AVX2 int
+	scale_image_RGB_to_NTSC_safe_avx2
+	(
+		unsigned char* orig, int size, int channels,
+		float scale_lo, float scale_hi
+	)
+{
+	const __m256 range = _mm256_set1_ps( scale_hi - scale_lo );
+	const __m256 lo = _mm256_set1_ps( scale_lo );
+	const __m256 div = _mm256_set1_ps( 255.0f );
+	__m128i alpha = _mm_setzero_si128();
+	int i, k;
+	if( channels == 2 ) { alpha = _mm_set1_epi16( (short)0xFF00 ); }
+	if( channels == 4 ) { alpha = _mm_set1_epi32( (int)0xFF000000 ); }
+	for( i = 0; i + 16 <= size; i += 16 )
+	{
+		__m128i src = _mm_loadu_si128( (const __m128i*)(orig + i) );
+		__m256i oct[2];
+		__m128i packed;
+		for( k = 0; k < 2; ++k )
+		{
+			__m256i w = _mm256_cvtepu8_epi32( k ? _mm_srli_si128( src, 8 ) : src );
+			__m256 f = _mm256_div_ps( _mm256_mul_ps( range, _mm256_cvtepi32_ps( w ) ), div );
+			oct[k] = _mm256_cvttps_epi32( _mm256_add_ps( f, lo ) );
+		}
+		/*	packs works per 128 bit lane, so put the lanes back in order	*/
+		oct[0] = _mm256_permute4x64_epi64( _mm256_packs_epi32( oct[0], oct[1] ), 0xD8 );
+		packed = _mm_packus_epi16( _mm256_castsi256_si128( oct[0] ), _mm256_extracti128_si256( oct[0], 1 ) );
+		packed = _mm_or_si128( _mm_and_si128( alpha, src ), _mm_andnot_si128( alpha, packed ) );
+		_mm_storeu_si128( (__m128i*)(orig + i), packed );
+	}
+	return i;
+}
+
+static IMAGE_HELPER_TARGET_AVX2 int
+	convert_RGB_to_YCoCg_avx2( unsigned char* orig, int pixels )
+{
+	const __m256i mask = _mm256_set1_epi32( 0xFF );
+	int i;
+	for( i = 0; i + 8 <= pixels; i += 8 )
+	{
+		__m256i v = _mm256_loadu_si256( (const __m256i*)(orig + i*4) );
+		__m256i r = _mm256_and_si256( v, mask );
+		__m256i g = _mm256_srli_epi32( _mm256_add_epi32( _mm256_and_si256( _mm256_srli_epi32( v, 8 ), mask ), _mm256_set1_epi32( 1 ) ), 1 );
+		__m256i b = _mm256_and_si256( _mm256_srli_epi32( v, 16 ), mask );
+		__m256i a = _mm256_srli_epi32( v, 24 );
+		__m256i tmp = _mm256_srli_epi32( _mm256_add_epi32( _mm256_add_epi32( r, b ), _mm256_set1_epi32( 2 ) ), 2 );
+		__m256i co = _mm256_srai_epi32( _mm256_add_epi32( _mm256_sub_epi32( r, b ), _mm256_set1_epi32( 1 ) ), 1 );
+		co = avx2_clamp_byte( _mm256_add_epi32( co, _mm256_set1_epi32( 128 ) ) );
+		r = avx2_clamp_byte( _mm256_sub_epi32( _mm256_add_epi32( g, _mm256_set1_epi32( 128 ) ), tmp ) );
+		b = avx2_clamp_byte( _mm256_add_epi32( g, tmp ) );
+		v = _mm256_or_si256( _mm256_or_si256( co, _mm256_slli_epi32( r, 8 ) ),
+			_mm256_or_si256( _mm256_slli_epi32( a, 16 ), _mm256_slli_epi32( b, 24 ) ) );
+		_mm256_storeu_si256( (__m256i*)(orig + i*4), v );
+	}
+	return i;
+}
+
+static IMAGE_HELPER_TARGET_AVX2 int
+	convert_YCoCg_to_RGB_avx2( unsigned char* orig, int pixels )
+{
+	const __m256i mask = _mm256_set1_epi32( 0xFF );
+	const __m256i bias = _mm256_set1_epi32( 128 );
+	int i;
+	for( i = 0; i + 8 <= pixels; i += 8 )
+	{
+		__m256i v = _mm256_loadu_si256( (const __m256i*)(orig + i*4) );
+		__m256i co = _mm256_sub_epi32( _mm256_and_si256( v, mask ), bias );
+		__m256i cg = _mm256_sub_epi32( _mm256_and_si256( _mm256_srli_epi32( v, 8 ), mask ), bias );
+		__m256i a = _mm256_and_si256( _mm256_srli_epi32( v, 16 ), mask );
+		__m256i y = _mm256_srli_epi32( v, 24 );
+		__m256i r = avx2_clamp_byte( _mm256_sub_epi32( _mm256_add_epi32( y, co ), cg ) );
+		__m256i g = avx2_clamp_byte( _mm256_add_epi32( y, cg ) );
+		__m256i b = avx2_clamp_byte( _mm256_sub_epi32( _mm256_sub_epi32( y, co ), cg ) );
+		v = _mm256_or_si256( _mm256_or_si256( r, _mm256_slli_epi32( g, 8 ) ),
+			_mm256_or_si256( _mm256_slli_epi32( b, 16 ), _mm256_slli_epi32( a, 24 ) ) );
+		_mm256_storeu_si256( (__m256i*)(orig + i*4), v );
+	}
+	return i;
+}
+
+static IMAGE_HELPER_TARGET_AVX2 float
+	find_max_RGBE_avx2( const unsigned char *image, int pixels, const float* e_LUT, int *done )
+{
+	const __m256i mask = _mm256_set1_epi32( 0xFF );
+	__m256 max_val = _mm256_setzero_ps();
+	float m[8], best;
+	int i;
+	for( i = 0; i + 8 <= pixels; i += 8 )
+	{
+		__m256i v = _mm256_loadu_si256( (const __m256i*)(image + i*4) );
+		__m256 e = _mm256_i32gather_ps( e_LUT, _mm256_srli_epi32( v, 24 ), 4 );
+		max_val = _mm256_max_ps( max_val, _mm256_mul_ps( _mm256_cvtepi32_ps( _mm256_and_si256( v, mask ) ), e ) );
+		max_val = _mm256_max_ps( max_val, _mm256_mul_ps( _mm256_cvtepi32_ps( _mm256_and_si256( _mm256_srli_epi32( v, 8 ), mask ) ), e ) );
+		max_val = _mm256_max_ps( max_val, _mm256_mul_ps( _mm256_cvtepi32_ps( _mm256_and_si256( _mm256_srli_epi32( v, 16 ), mask ) ), e ) );
+	}
+	_mm256_storeu_ps( m, max_val );
+	*done = i;
+	best = m[0];
+	for( i = 1; i < 8; ++i )
+	{
+		best = (m[i] > best) ? m[i] : best;
+	}
+	return best;
+}
+
+static IMAGE_HELPER_TARGET_AVX2 int
+	RGBE_to_RGBdivA_avx2( unsigned char *image, int pixels, const float* e_LUT, int square_root )
+{
+	const __m256i mask = _mm256_set1_epi32( 0xFF );
+	const __m256i one = _mm256_set1_epi32( 1 );
+	const __m256i max_byte = _mm256_set1_epi32( 255 );
+	const __m256 half = _mm256_set1_ps( 0.5f );
+	const __m256 f255 = _mm256_set1_ps( 255.0f );
+	int i, k;
+	for( i = 0; i + 8 <= pixels; i += 8 )
+	{
+		unsigned char *img = image + i*4;
+		__m256i v = _mm256_loadu_si256( (const __m256i*)img );
+		__m256 e = _mm256_i32gather_ps( e_LUT, _mm256_srli_epi32( v, 24 ), 4 );
+		__m256 rgb[3], m, a, zero;
+		__m256i iv, out;
+		rgb[0] = _mm256_mul_ps( e, _mm256_cvtepi32_ps( _mm256_and_si256( v, mask ) ) );
+		rgb[1] = _mm256_mul_ps( e, _mm256_cvtepi32_ps( _mm256_and_si256( _mm256_srli_epi32( v, 8 ), mask ) ) );
+		rgb[2] = _mm256_mul_ps( e, _mm256_cvtepi32_ps( _mm256_and_si256( _mm256_srli_epi32( v, 16 ), mask ) ) );
+		m = _mm256_max_ps( rgb[0], rgb[1] );
+		m = _mm256_max_ps( rgb[2], m );
+		if( square_root )
+		{
+			iv = _mm256_cvttps_epi32( _mm256_sqrt_ps( _mm256_div_ps( _mm256_set1_ps( 255.0f * 255.0f ), m ) ) );
+		} else
+		{
+			iv = _mm256_cvttps_epi32( _mm256_div_ps( f255, m ) );
+		}
+		zero = _mm256_cmp_ps( m, _mm256_setzero_ps(), _CMP_EQ_OQ );
+		iv = _mm256_blendv_epi8( iv, one, _mm256_castps_si256( zero ) );
+		iv = _mm256_min_epi32( _mm256_max_epi32( iv, one ), max_byte );
+		a = _mm256_cvtepi32_ps( iv );
+		if( square_root )
+		{
+			a = _mm256_mul_ps( a, a );
+		}
+		out = _mm256_slli_epi32( iv, 24 );
+		for( k = 0; k < 3; ++k )
+		{
+			__m256 f = _mm256_mul_ps( a, rgb[k] );
+			__m256i c;
+			if( square_root )
+			{
+				f = _mm256_div_ps( f, f255 );
+			}
+			c = _mm256_min_epi32( _mm256_cvttps_epi32( _mm256_add_ps( f, half ) ), max_byte );
+			out = _mm256_or_si256( out, _mm256_slli_epi32( _mm256_and_si256( c, mask ), 8 * k ) );
+		}
+		_mm256_storeu_si256( (__m256i*)img, out );
+	}
+	return i;
+}
+
+#endif /* IMAGE_HELPER_AVX2	*/
+
+/*	the float RGBE scale of every exponent byte, as the scalar code computes it	*/
+static void
+	build_RGBE_LUT( float* e_LUT, float scale )
+{
+	int i;
+	for( i = 0; i < 256; ++i )
+	{
+		e_LUT[i] = scale * (float)ldexp( 1.0f / 255.0f, i - 128 );
+	}
+}
+
 /*	Upscaling the image uses simple bilinear interpolation	*/
 int
 	up_scale_image
@@ -38,6 +627,20 @@ int
 	*/
     dx = (width - 1.0f) / (resampled_width - 1.0f);
     dy = (height - 1.0f) / (resampled_height - 1.0f);
+#ifdef IMAGE_HELPER_AVX2
+	if( (channels == 4) && (image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_AVX2) )
+	{
+		up_scale_image_avx2( orig, width, height, resampled, resampled_width, resampled_height, dx, dy );
+		return 1;
+	}
+#endif
+#ifdef IMAGE_HELPER_SSE2
+	if( ((channels == 3) || (channels == 4)) && (image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_SSE2) )
+	{
+		up_scale_image_sse2( orig, width, height, channels, resampled, resampled_width, resampled_height, dx, dy );
+		return 1;
+	}
+#endif
     for ( y = 0; y < resampled_height; ++y )
     {
     	/* find the base y index and fractional offset from that	*/
@@ -177,8 +780,32 @@ int
 	}
 	/*	for channels = 2 or 4, ignore the alpha component	*/
 	nc -= 1 - (channels & 1);
+	i = 0;
+#ifdef IMAGE_HELPER_SSE2
+	if( channels <= 4 )
+	{
+	#ifdef IMAGE_HELPER_AVX2
+		if( image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_AVX2 )
+		{
+			i = scale_image_RGB_to_NTSC_safe_avx2( orig, width*height*channels, channels, scale_lo, scale_hi );
+		} else
+	#endif
+		if( image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_SSE2 )
+		{
+			i = scale_image_RGB_to_NTSC_safe_sse2( orig, width*height*channels, channels, scale_lo, scale_hi );
+		}
+		/*	the 16 byte blocks can stop in the middle of a pixel	*/
+		for( ; (i < width*height*channels) && (i % channels); ++i )
+		{
+			if( i % channels < nc )
+			{
+				orig[i] = scale_LUT[orig[i]];
+			}
+		}
+	}
+#endif
 	/*	OK, go through the image and scale any non-alpha components	*/
-	for( i = 0; i < width*height*channels; i += channels )
+	for( ; i < width*height*channels; i += channels )
 	{
 		for( j = 0; j < nc; ++j )
 		{
@@ -231,7 +858,20 @@ int
 		}
 	} else
 	{
-		for( i = 0; i < width*height*4; i += 4 )
+		i = 0;
+#ifdef IMAGE_HELPER_AVX2
+		if( image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_AVX2 )
+		{
+			i = convert_RGB_to_YCoCg_avx2( orig, width*height ) * 4;
+		} else
+#endif
+#ifdef IMAGE_HELPER_SSE2
+		if( image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_SSE2 )
+		{
+			i = convert_RGB_to_YCoCg_sse2( orig, width*height ) * 4;
+		}
+#endif
+		for( ; i < width*height*4; i += 4 )
 		{
 			int r = orig[i+0];
 			int g = (orig[i+1] + 1) >> 1;
@@ -289,7 +929,20 @@ int
 		}
 	} else
 	{
-		for( i = 0; i < width*height*4; i += 4 )
+		i = 0;
+#ifdef IMAGE_HELPER_AVX2
+		if( image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_AVX2 )
+		{
+			i = convert_YCoCg_to_RGB_avx2( orig, width*height ) * 4;
+		} else
+#endif
+#ifdef IMAGE_HELPER_SSE2
+		if( image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_SSE2 )
+		{
+			i = convert_YCoCg_to_RGB_sse2( orig, width*height ) * 4;
+		}
+#endif
+		for( ; i < width*height*4; i += 4 )
 		{
 			int co = orig[i+0] - 128;
 			int cg = orig[i+1] - 128;
@@ -319,7 +972,27 @@ find_max_RGBE
 	float max_val = 0.0f;
 	unsigned char *img = image;
 	int i, j;
-	for( i = width * height; i > 0; --i )
+	i = width * height;
+#ifdef IMAGE_HELPER_SSE2
+	if( image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_SSE2 )
+	{
+		float e_LUT[256];
+		int done = 0;
+		build_RGBE_LUT( e_LUT, 1.0f );
+	#ifdef IMAGE_HELPER_AVX2
+		if( image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_AVX2 )
+		{
+			max_val = find_max_RGBE_avx2( image, width * height, e_LUT, &done );
+		} else
+	#endif
+		{
+			max_val = find_max_RGBE_sse2( image, width * height, e_LUT, &done );
+		}
+		img += done * 4;
+		i -= done;
+	}
+#endif
+	for( ; i > 0; --i )
 	{
 		/* float scale = powf( 2.0f, img[3] - 128.0f ) / 255.0f; */
 		float scale = (float)ldexp( 1.0f / 255.0f, (int)(img[3]) - 128 );
@@ -358,7 +1031,27 @@ RGBE_to_RGBdivA
 	{
 		scale = 255.0f / find_max_RGBE( image, width, height );
 	}
-	for( i = width * height; i > 0; --i )
+	i = width * height;
+#ifdef IMAGE_HELPER_SSE2
+	if( image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_SSE2 )
+	{
+		float e_LUT[256];
+		int done;
+		build_RGBE_LUT( e_LUT, scale );
+	#ifdef IMAGE_HELPER_AVX2
+		if( image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_AVX2 )
+		{
+			done = RGBE_to_RGBdivA_avx2( image, width * height, e_LUT, 0 );
+		} else
+	#endif
+		{
+			done = RGBE_to_RGBdivA_sse2( image, width * height, e_LUT, 0 );
+		}
+		img += done * 4;
+		i -= done;
+	}
+#endif
+	for( ; i > 0; --i )
 	{
 		/* decode this pixel, and find the max */
 		float r,g,b,e, m;
@@ -407,7 +1100,27 @@ RGBE_to_RGBdivA2
 	{
 		scale = 255.0f * 255.0f / find_max_RGBE( image, width, height );
 	}
-	for( i = width * height; i > 0; --i )
+	i = width * height;
+#ifdef IMAGE_HELPER_SSE2
+	if( image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_SSE2 )
+	{
+		float e_LUT[256];
+		int done;
+		build_RGBE_LUT( e_LUT, scale );
+	#ifdef IMAGE_HELPER_AVX2
+		if( image_helper_get_simd_level() >= IMAGE_HELPER_SIMD_AVX2 )
+		{
+			done = RGBE_to_RGBdivA_avx2( image, width * height, e_LUT, 1 );
+		} else
+	#endif
+		{
+			done = RGBE_to_RGBdivA_sse2( image, width * height, e_LUT, 1 );
+		}
+		img += done * 4;
+		i -= done;
+	}
+#endif
+	for( ; i > 0; --i )
 	{
 		/* decode this pixel, and find the max */
 		float r,g,b,e, m;
@@ -13,6 +13,26 @@
 extern "C" {
 #endif
 
+/**
+	SIMD level used by the pixel kernels below.
+	SSE2 is the baseline on x86 / x64, AVX2 is detected at runtime.
+	Every level gives exactly the same bytes as the scalar code.
+**/
+#define IMAGE_HELPER_SIMD_NONE	0
+#define IMAGE_HELPER_SIMD_SSE2	1
+#define IMAGE_HELPER_SIMD_AVX2	2
+
+int
+	image_helper_get_simd_level( void );
+
+/**
+	Forces a SIMD level (IMAGE_HELPER_SIMD_NONE runs the scalar
+	reference code).  Levels the CPU can't run are lowered.
+	\return the level now in use
+**/
+int
+	image_helper_set_simd_level( int level );
+
 /**
 	This function upscales an image.
 	Not to be used to create MIPmaps,
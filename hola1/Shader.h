@@ -2,23 +2,204 @@
 #define SHADER_H
 
 #include <string>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <iomanip>
+#include <chrono>
+
+#ifdef _WIN32
+#include <direct.h>
+#define SHADER_MKDIR(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define SHADER_MKDIR(path) mkdir(path, 0755)
+#endif
 
 #include <GL/glew.h>
 
+// Linked program binaries are cached here (glGetProgramBinary / glProgramBinary)
+const char* const SHADER_CACHE_DIR = "ShaderCache";
+
+// Startup instrumentation: how many programs came from the cache and how long everything took
+struct ShaderCacheStats
+{
+	GLuint loaded;
+	GLuint compiled;
+	double loadMs;
+	double compileMs;
+	double savedMs; // Compile + link time the cached programs originally took, minus the load time
+};
+
+// Without KHR_parallel_shader_compile a reloaded program's status is queried this many frames later
+const GLuint SHADER_RELOAD_DELAY_FRAMES = 3;
+
 class Shader
 {
 public:
 	GLuint Program;
 	GLuint uniformColor;
 	// Constructor generates the shader on the fly
-	Shader(const GLchar *vertexPath, const GLchar *fragmentPath)
+	// (defines, if any, are inserted right after the #version line of both sources)
+	Shader(const GLchar *vertexPath, const GLchar *fragmentPath, const std::string &defines = "")
+		: vertexPath(vertexPath), fragmentPath(fragmentPath), defines(defines), pendingProgram(0)
 	{
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
 		// 1. Retrieve the vertex/fragment source code from filePath
 		std::string vertexCode;
 		std::string fragmentCode;
+		this->readSources(vertexCode, fragmentCode);
+		// Try the binary cache first (keyed by both sources, defines included, and the driver)
+		std::string cachePath = CachePath(vertexCode, fragmentCode);
+		if (this->loadBinary(cachePath, start))
+		{
+			uniformColor = glGetUniformLocation(this->Program, "color");
+			return;
+		}
+		// 2. Compile shaders
+		GLuint vertex, fragment;
+		this->Program = this->createProgram(vertexCode, fragmentCode, vertex, fragment);
+		// Print compile and linking errors if any
+		GLint success = this->checkProgram(this->Program, vertex, fragment);
+		//le damos la localidad de color
+		uniformColor = glGetUniformLocation(this->Program, "color");
+
+		double compileMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		CacheStats().compiled++;
+		CacheStats().compileMs += compileMs;
+		if (success)
+			this->saveBinary(cachePath, (float)compileMs);
+
+	}
+	~Shader()
+	{
+		this->discardReload();
+	}
+	// Uses the current shader
+	void Use()
+	{
+		glUseProgram(this->Program);
+	}
+
+	GLuint getColorLocation()
+	{
+		return uniformColor;
+	}
+
+	// True if the program is built from that file (e.g. "Shader/modelLoading.frag")
+	bool Uses(const std::string &path) const
+	{
+		return path == this->vertexPath || path == this->fragmentPath;
+	}
+
+	// Starts rebuilding the program from its files without waiting for the driver.
+	// Program keeps the previous version until PollReload reports the new one linked;
+	// if it fails to compile the previous one stays.
+	void Reload()
+	{
+		this->discardReload();
+		std::string vertexCode;
+		std::string fragmentCode;
+		if (!this->readSources(vertexCode, fragmentCode))
+			return;
+		ParallelCompileSupported(); // First call raises the driver's compiler thread count
+		this->reloadStart = std::chrono::high_resolution_clock::now();
+		this->pendingCachePath = CachePath(vertexCode, fragmentCode);
+		this->pendingProgram = this->createProgram(vertexCode, fragmentCode, this->pendingVertex, this->pendingFragment);
+		this->pendingFrames = 0;
+	}
+
+	// Call once per frame while a reload is pending; returns true the frame the new program is swapped in.
+	// With KHR_parallel_shader_compile the driver says when the link is done (GL_COMPLETION_STATUS_KHR);
+	// without it the status is only queried SHADER_RELOAD_DELAY_FRAMES frames later, by then the
+	// driver has usually finished and the query doesn't block.
+	bool PollReload()
+	{
+		if (this->pendingProgram == 0)
+			return false;
+		this->pendingFrames++;
+		if (ParallelCompileSupported())
+		{
+			GLint completed = GL_FALSE;
+			glGetProgramiv(this->pendingProgram, GL_COMPLETION_STATUS_KHR, &completed);
+			if (!completed)
+				return false;
+		}
+		else if (this->pendingFrames < SHADER_RELOAD_DELAY_FRAMES)
+		{
+			return false;
+		}
+
+		GLuint program = this->pendingProgram;
+		this->pendingProgram = 0;
+		if (!this->checkProgram(program, this->pendingVertex, this->pendingFragment))
+		{
+			std::cout << "SHADER::RELOAD::FAILED " << this->fragmentPath << " (keeping the previous program)" << std::endl;
+			glDeleteProgram(program);
+			return false;
+		}
+
+		// The old program is freed by the driver once nothing is using it
+		glDeleteProgram(this->Program);
+		this->Program = program;
+		uniformColor = glGetUniformLocation(this->Program, "color");
+
+		double reloadMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - this->reloadStart).count();
+		this->saveBinary(this->pendingCachePath, (float)reloadMs);
+		std::cout << std::fixed << std::setprecision(1) << "SHADER::RELOADED " << this->vertexPath << " + " << this->fragmentPath
+			<< " (" << this->pendingFrames << " frames, " << reloadMs << " ms)" << std::endl;
+		return true;
+	}
+
+	bool IsReloading() const
+	{
+		return this->pendingProgram != 0;
+	}
+
+	// Totals since the start of the program (see PrintCacheStats)
+	static ShaderCacheStats& CacheStats()
+	{
+		static ShaderCacheStats stats = { 0, 0, 0.0, 0.0, 0.0 };
+		return stats;
+	}
+
+	static void PrintCacheStats()
+	{
+		ShaderCacheStats& stats = CacheStats();
+		std::cout << std::fixed << std::setprecision(1)
+			<< "SHADER::CACHE " << stats.loaded << " programs loaded (" << stats.loadMs << " ms), "
+			<< stats.compiled << " compiled (" << stats.compileMs << " ms), "
+			<< stats.savedMs << " ms saved" << std::endl;
+	}
+
+	// Inserts the defines after the #version line (which must stay first)
+	static std::string InsertDefines(const std::string &code, const std::string &defines)
+	{
+		std::string::size_type version = code.find("#version");
+		if (version == std::string::npos)
+			return defines + code;
+		std::string::size_type lineEnd = code.find('\n', version);
+		if (lineEnd == std::string::npos)
+			return code + "\n" + defines;
+		return code.substr(0, lineEnd + 1) + defines + code.substr(lineEnd + 1);
+	}
+
+private:
+	std::string vertexPath;
+	std::string fragmentPath;
+	std::string defines;
+	// Program being rebuilt by Reload (0 = none)
+	GLuint pendingProgram;
+	GLuint pendingVertex;
+	GLuint pendingFragment;
+	GLuint pendingFrames;
+	std::string pendingCachePath;
+	std::chrono::high_resolution_clock::time_point reloadStart;
+
+	// Reads both files and inserts the defines; false if either one came back empty
+	bool readSources(std::string &vertexCode, std::string &fragmentCode)
+	{
 		std::ifstream vShaderFile;
 		std::ifstream fShaderFile;
 		// ensures ifstream objects can throw exceptions:
@@ -27,8 +208,8 @@ public:
 		try
 		{
 			// Open files
-			vShaderFile.open(vertexPath);
-			fShaderFile.open(fragmentPath);
+			vShaderFile.open(this->vertexPath.c_str());
+			fShaderFile.open(this->fragmentPath.c_str());
 			std::stringstream vShaderStream, fShaderStream;
 			// Read file's buffer contents into streams
 			vShaderStream << vShaderFile.rdbuf();
@@ -44,62 +225,219 @@ public:
 		{
 			std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
 		}
+		if (vertexCode.empty() || fragmentCode.empty())
+			return false;
+		if (!this->defines.empty())
+		{
+			vertexCode = InsertDefines(vertexCode, this->defines);
+			fragmentCode = InsertDefines(fragmentCode, this->defines);
+		}
+		return true;
+	}
+
+	// Submits compile + link without asking for any status, so the driver can do it in the background
+	GLuint createProgram(const std::string &vertexCode, const std::string &fragmentCode, GLuint &vertex, GLuint &fragment)
+	{
 		const GLchar *vShaderCode = vertexCode.c_str();
 		const GLchar *fShaderCode = fragmentCode.c_str();
-		// 2. Compile shaders
-		GLuint vertex, fragment;
-		GLint success;
-		GLchar infoLog[512];
 		// Vertex Shader
 		vertex = glCreateShader(GL_VERTEX_SHADER);
 		glShaderSource(vertex, 1, &vShaderCode, NULL);
 		glCompileShader(vertex);
-		// Print compile errors if any
+		// Fragment Shader
+		fragment = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(fragment, 1, &fShaderCode, NULL);
+		glCompileShader(fragment);
+		// Shader Program
+		GLuint program = glCreateProgram();
+		glAttachShader(program, vertex);
+		glAttachShader(program, fragment);
+		if (BinaryCacheSupported())
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(program);
+		return program;
+	}
+
+	// Prints compile/link errors if any (this waits for the driver) and deletes the shader objects
+	bool checkProgram(GLuint program, GLuint vertex, GLuint fragment)
+	{
+		GLint success;
+		GLchar infoLog[512];
 		glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
 		if (!success)
 		{
 			glGetShaderInfoLog(vertex, 512, NULL, infoLog);
 			std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
 		}
-		// Fragment Shader
-		fragment = glCreateShader(GL_FRAGMENT_SHADER);
-		glShaderSource(fragment, 1, &fShaderCode, NULL);
-		glCompileShader(fragment);
-		// Print compile errors if any
 		glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
 		if (!success)
 		{
 			glGetShaderInfoLog(fragment, 512, NULL, infoLog);
 			std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
 		}
-		// Shader Program
-		this->Program = glCreateProgram();
-		glAttachShader(this->Program, vertex);
-		glAttachShader(this->Program, fragment);
-		glLinkProgram(this->Program);
-		// Print linking errors if any
-		glGetProgramiv(this->Program, GL_LINK_STATUS, &success);
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
 		if (!success)
 		{
-			glGetProgramInfoLog(this->Program, 512, NULL, infoLog);
+			glGetProgramInfoLog(program, 512, NULL, infoLog);
 			std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
 		}
-		//le damos la localidad de color
-		uniformColor = glGetUniformLocation(this->Program, "color");
 		// Delete the shaders as they're linked into our program now and no longer necessery
 		glDeleteShader(vertex);
 		glDeleteShader(fragment);
+		return success == GL_TRUE;
+	}
 
+	void discardReload()
+	{
+		if (this->pendingProgram == 0)
+			return;
+		glDeleteShader(this->pendingVertex);
+		glDeleteShader(this->pendingFragment);
+		glDeleteProgram(this->pendingProgram);
+		this->pendingProgram = 0;
 	}
-	// Uses the current shader
-	void Use()
+
+	// KHR (or ARB) parallel_shader_compile; asks the driver for as many compiler threads as it wants
+	static bool ParallelCompileSupported()
 	{
-		glUseProgram(this->Program);
+		static int supported = -1;
+		if (supported < 0)
+		{
+			supported = 0;
+			if (GLEW_KHR_parallel_shader_compile && glMaxShaderCompilerThreadsKHR != NULL)
+			{
+				glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+				supported = 1;
+			}
+			else if (GLEW_ARB_parallel_shader_compile && glMaxShaderCompilerThreadsARB != NULL)
+			{
+				glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+				supported = 1;
+			}
+		}
+		return supported == 1;
 	}
 
-	GLuint getColorLocation()
+	// Cache file header
+	struct BinaryHeader
 	{
-		return uniformColor;
+		char magic[4];
+		GLenum format;
+		float compileMs;
+	};
+
+	// The driver must expose at least one binary format (GL 4.1 or ARB_get_program_binary)
+	static bool BinaryCacheSupported()
+	{
+		static int supported = -1;
+		if (supported < 0)
+		{
+			GLint formats = 0;
+			if (glGetProgramBinary != NULL && glProgramBinary != NULL && glProgramParameteri != NULL)
+				glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+			supported = formats > 0 ? 1 : 0;
+		}
+		return supported == 1;
+	}
+
+	// 64-bit FNV-1a
+	static unsigned long long Hash(unsigned long long hash, const std::string &data)
+	{
+		for (size_t i = 0; i < data.size(); i++)
+		{
+			hash ^= (unsigned char)data[i];
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	// A binary is only valid for the exact same driver, so vendor/renderer/version are part of the key
+	static std::string CachePath(const std::string &vertexCode, const std::string &fragmentCode)
+	{
+		const GLchar *vendor = (const GLchar*)glGetString(GL_VENDOR);
+		const GLchar *renderer = (const GLchar*)glGetString(GL_RENDERER);
+		const GLchar *version = (const GLchar*)glGetString(GL_VERSION);
+		unsigned long long hash = 14695981039346656037ULL;
+		hash = Hash(hash, std::string(vendor ? vendor : "") + "|" + (renderer ? renderer : "") + "|" + (version ? version : "") + "|");
+		hash = Hash(hash, vertexCode);
+		hash = Hash(hash, std::string(1, '\0'));
+		hash = Hash(hash, fragmentCode);
+
+		std::stringstream path;
+		path << SHADER_CACHE_DIR << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+		return path.str();
+	}
+
+	bool loadBinary(const std::string &path, std::chrono::high_resolution_clock::time_point start)
+	{
+		if (!BinaryCacheSupported())
+			return false;
+		std::ifstream file(path.c_str(), std::ios::binary);
+		if (!file)
+			return false;
+
+		BinaryHeader header;
+		std::vector<char> binary;
+		file.read((char*)&header, sizeof(header));
+		if (file && std::string(header.magic, 4) == "GLPB")
+		{
+			file.seekg(0, std::ios::end);
+			std::streamoff size = (std::streamoff)file.tellg() - (std::streamoff)sizeof(header);
+			if (size > 0)
+			{
+				binary.resize((size_t)size);
+				file.seekg(sizeof(header), std::ios::beg);
+				file.read(&binary[0], size);
+			}
+		}
+		if (binary.empty() || !file)
+		{
+			std::cout << "ERROR::SHADER::CACHE::CORRUPT " << path << std::endl;
+			return false;
+		}
+
+		// The driver may reject the binary (e.g. after an update): fall back to compiling
+		this->Program = glCreateProgram();
+		glProgramBinary(this->Program, header.format, &binary[0], (GLsizei)binary.size());
+		GLint success;
+		glGetProgramiv(this->Program, GL_LINK_STATUS, &success);
+		if (!success)
+		{
+			std::cout << "SHADER::CACHE::STALE " << path << " (recompiling)" << std::endl;
+			glDeleteProgram(this->Program);
+			this->Program = 0;
+			return false;
+		}
+
+		double loadMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		CacheStats().loaded++;
+		CacheStats().loadMs += loadMs;
+		CacheStats().savedMs += header.compileMs - loadMs;
+		return true;
+	}
+
+	void saveBinary(const std::string &path, float compileMs)
+	{
+		if (!BinaryCacheSupported())
+			return;
+		GLint length = 0;
+		glGetProgramiv(this->Program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0)
+			return;
+
+		BinaryHeader header = { { 'G', 'L', 'P', 'B' }, 0, compileMs };
+		std::vector<char> binary(length);
+		glGetProgramBinary(this->Program, length, NULL, &header.format, &binary[0]);
+
+		SHADER_MKDIR(SHADER_CACHE_DIR);
+		std::ofstream file(path.c_str(), std::ios::binary);
+		if (!file)
+		{
+			std::cout << "ERROR::SHADER::CACHE::NOT_WRITTEN " << path << std::endl;
+			return;
+		}
+		file.write((const char*)&header, sizeof(header));
+		file.write(&binary[0], length);
 	}
 };
 
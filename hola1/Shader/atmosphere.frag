@@ -0,0 +1,268 @@
+#version 330 core
+// --- CIELO FÍSICO (ver Atmosphere.h) ---
+// Dispersión de Rayleigh (aire) y Mie (polvo) con absorción del ozono. Las partes caras se
+// guardan en tablas; cada paso lee solo las anteriores y se compila con su #define:
+//   TRANSMITTANCE_LUT:    luz que llega al techo de la atmósfera (altura x ángulo), una vez
+//   MULTI_SCATTERING_LUT: luz que rebota muchas veces (altura x sol), una vez
+//   SKY_VIEW_LUT:         color del cielo en cada dirección, solo cuando el sol se mueve
+//   (ninguno):            el cielo en pantalla, una lectura de la tabla por pixel
+// Las distancias van en km.
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+const float PI = 3.14159265;
+
+// --- MODELO DE LA ATMÓSFERA (mismos valores que en C++) ---
+uniform float groundRadius;
+uniform float topRadius;
+uniform vec3 rayleighScattering;
+uniform float rayleighHeight;
+uniform float mieScattering;
+uniform float mieExtinction;
+uniform float mieHeight;
+uniform float mieG;
+uniform vec3 ozoneAbsorption;
+uniform float ozoneCenter;
+uniform float ozoneWidth;
+uniform vec3 groundAlbedo;
+
+uniform vec3 sunDirection;   // Hacia el sol
+uniform float sunIlluminance;
+uniform float cameraHeight;  // Sobre el suelo
+
+uniform sampler2D transmittanceLut;
+uniform sampler2D multiScatteringLut;
+uniform sampler2D skyViewLut;
+
+// --- Funciones ---
+vec3 Scattering(float height, out float mie);
+vec3 Extinction(float height);
+float RaySphere(vec3 origin, vec3 dir, float radius);
+vec3 SampleTransmittance(float height, float cosZenith);
+vec3 SampleMultiScattering(float height, float cosSunZenith);
+vec3 Integrate(vec3 origin, vec3 dir, vec3 sun, int steps);
+
+#ifdef TRANSMITTANCE_LUT
+void main()
+{
+    // x: coseno respecto a la vertical (-1..1), y: altura (más texeles cerca del suelo)
+    float cosZenith = TexCoords.x * 2.0 - 1.0;
+    float height = TexCoords.y * TexCoords.y * (topRadius - groundRadius);
+    vec3 origin = vec3(0.0, groundRadius + height, 0.0);
+    vec3 dir = vec3(sqrt(max(1.0 - cosZenith * cosZenith, 0.0)), cosZenith, 0.0);
+    if(RaySphere(origin, dir, groundRadius) > 0.0)
+    {
+        FragColor = vec4(0.0, 0.0, 0.0, 1.0); // El planeta tapa al sol
+        return;
+    }
+
+    const int STEPS = 40;
+    float distance = RaySphere(origin, dir, topRadius);
+    vec3 depth = vec3(0.0);
+    for(int i = 0; i < STEPS; i++)
+    {
+        float t = (float(i) + 0.5) / float(STEPS) * distance;
+        depth += Extinction(length(origin + dir * t) - groundRadius);
+    }
+    FragColor = vec4(exp(-depth * distance / float(STEPS)), 1.0);
+}
+#endif
+
+#ifdef MULTI_SCATTERING_LUT
+void main()
+{
+    // Aproximación de Hillaire: la luz de segundo orden en todas direcciones (fase isotrópica)
+    // y la fracción que se vuelve a dispersar; la suma de todos los órdenes es una serie geométrica
+    float cosSunZenith = TexCoords.x * 2.0 - 1.0;
+    float height = max(TexCoords.y * (topRadius - groundRadius), 0.01);
+    vec3 origin = vec3(0.0, groundRadius + height, 0.0);
+    vec3 sun = vec3(sqrt(max(1.0 - cosSunZenith * cosSunZenith, 0.0)), cosSunZenith, 0.0);
+
+    const int SQRT_SAMPLES = 8;
+    const int STEPS = 20;
+    vec3 secondOrder = vec3(0.0);
+    vec3 transfer = vec3(0.0);
+    for(int i = 0; i < SQRT_SAMPLES; i++)
+    {
+        for(int j = 0; j < SQRT_SAMPLES; j++)
+        {
+            // Direcciones repartidas de forma uniforme en la esfera
+            float cosTheta = 1.0 - 2.0 * (float(i) + 0.5) / float(SQRT_SAMPLES);
+            float phi = 2.0 * PI * (float(j) + 0.5) / float(SQRT_SAMPLES);
+            float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+            vec3 dir = vec3(sinTheta * cos(phi), cosTheta, sinTheta * sin(phi));
+
+            float ground = RaySphere(origin, dir, groundRadius);
+            float distance = ground > 0.0 ? ground : RaySphere(origin, dir, topRadius);
+            float step = distance / float(STEPS);
+            vec3 viewTransmittance = vec3(1.0);
+            for(int s = 0; s < STEPS; s++)
+            {
+                vec3 position = origin + dir * ((float(s) + 0.5) * step);
+                float sampleRadius = length(position);
+                float sampleHeight = sampleRadius - groundRadius;
+                float mie;
+                vec3 scattering = Scattering(sampleHeight, mie);
+                scattering += mie;
+                vec3 extinction = Extinction(sampleHeight);
+                vec3 stepTransmittance = exp(-extinction * step);
+                vec3 sunLight = SampleTransmittance(sampleHeight, dot(position / sampleRadius, sun));
+                vec3 integral = (1.0 - stepTransmittance) / extinction;
+                secondOrder += viewTransmittance * scattering * sunLight / (4.0 * PI) * integral;
+                transfer += viewTransmittance * scattering * integral;
+                viewTransmittance *= stepTransmittance;
+            }
+            if(ground > 0.0)
+            {
+                vec3 hit = origin + dir * ground;
+                float cosGround = max(dot(normalize(hit), sun), 0.0);
+                secondOrder += viewTransmittance * SampleTransmittance(0.0, cosGround) * cosGround * groundAlbedo / PI;
+            }
+        }
+    }
+    float samples = float(SQRT_SAMPLES * SQRT_SAMPLES);
+    secondOrder /= samples;
+    transfer /= samples;
+    FragColor = vec4(secondOrder / (1.0 - transfer), 1.0);
+}
+#endif
+
+#ifdef SKY_VIEW_LUT
+void main()
+{
+    // x: azimut respecto al sol (0..pi, el cielo es simétrico), y: elevación (más texeles cerca del horizonte)
+    float azimuth = TexCoords.x * PI;
+    float v = TexCoords.y * 2.0 - 1.0;
+    float elevation = sign(v) * v * v * PI * 0.5;
+    vec3 dir = vec3(cos(elevation) * cos(azimuth), sin(elevation), cos(elevation) * sin(azimuth));
+
+    // El sol va en el azimut 0 de la tabla, con su altura real
+    vec3 origin = vec3(0.0, groundRadius + cameraHeight, 0.0);
+    vec3 sun = vec3(sqrt(max(1.0 - sunDirection.y * sunDirection.y, 0.0)), sunDirection.y, 0.0);
+    FragColor = vec4(Integrate(origin, dir, sun, 30), 1.0);
+}
+#endif
+
+#if !defined(TRANSMITTANCE_LUT) && !defined(MULTI_SCATTERING_LUT) && !defined(SKY_VIEW_LUT)
+uniform mat4 inverseViewProjection;
+uniform vec3 viewPos;
+uniform vec3 moonDirection;
+uniform float sunRadius;
+uniform float moonRadius;
+uniform vec3 moonColor;
+uniform vec3 nightSky;
+uniform float sunFade;
+uniform float moonFade;
+uniform float exposure;
+
+void main()
+{
+    // Dirección de la vista desde la cámara hacia el plano lejano
+    vec4 far = inverseViewProjection * vec4(TexCoords * 2.0 - 1.0, 1.0, 1.0);
+    vec3 dir = normalize(far.xyz / far.w - viewPos);
+
+    // Coordenadas de la tabla: el azimut se mide desde el sol
+    vec2 horizontal = dir.xz;
+    vec2 sunHorizontal = sunDirection.xz;
+    float cosAzimuth = 1.0;
+    if(dot(horizontal, horizontal) > 1e-8 && dot(sunHorizontal, sunHorizontal) > 1e-8)
+        cosAzimuth = dot(normalize(horizontal), normalize(sunHorizontal));
+    float elevation = asin(clamp(dir.y, -1.0, 1.0));
+    float v = sign(elevation) * sqrt(abs(elevation) / (PI * 0.5));
+    vec3 sky = texture(skyViewLut, vec2(acos(clamp(cosAzimuth, -1.0, 1.0)) / PI, v * 0.5 + 0.5)).rgb * sunIlluminance;
+
+    // Disco del sol (atenuado por la atmósfera) y de la luna, solo sobre el horizonte
+    vec3 transmittance = SampleTransmittance(cameraHeight, dir.y);
+    float sunDisk = smoothstep(cos(sunRadius), cos(sunRadius * 0.8), dot(dir, sunDirection));
+    sky += sunDisk * transmittance * sunIlluminance / (PI * sunRadius * sunRadius) * sunFade;
+    float above = smoothstep(-0.02, 0.02, dir.y);
+    sky += nightSky * moonFade * above / exposure;
+    float moonDisk = smoothstep(cos(moonRadius), cos(moonRadius * 0.8), dot(dir, moonDirection));
+    sky += moonDisk * moonColor * moonFade * above * 4.0 / exposure;
+
+    // Sin HDR en el resto de la escena: se comprime aquí para que el sol no se corte de golpe
+    FragColor = vec4(1.0 - exp(-sky * exposure), 1.0);
+}
+#endif
+
+// --- Densidad del aire ---
+vec3 Scattering(float height, out float mie)
+{
+    mie = mieScattering * exp(-height / mieHeight);
+    return rayleighScattering * exp(-height / rayleighHeight);
+}
+
+vec3 Extinction(float height)
+{
+    float ozone = max(0.0, 1.0 - abs(height - ozoneCenter) / ozoneWidth);
+    return rayleighScattering * exp(-height / rayleighHeight) + mieExtinction * exp(-height / mieHeight) + ozoneAbsorption * ozone;
+}
+
+// Distancia hasta una esfera centrada en el planeta (la salida si el origen está dentro); -1 si no la toca
+float RaySphere(vec3 origin, vec3 dir, float radius)
+{
+    float b = dot(origin, dir);
+    float c = dot(origin, origin) - radius * radius;
+    float discriminant = b * b - c;
+    if(discriminant < 0.0)
+        return -1.0;
+    float root = sqrt(discriminant);
+    if(-b - root > 0.0)
+        return -b - root;
+    return -b + root > 0.0 ? -b + root : -1.0;
+}
+
+vec3 SampleTransmittance(float height, float cosZenith)
+{
+    vec2 uv = vec2(cosZenith * 0.5 + 0.5, sqrt(clamp(height / (topRadius - groundRadius), 0.0, 1.0)));
+    return texture(transmittanceLut, uv).rgb;
+}
+
+vec3 SampleMultiScattering(float height, float cosSunZenith)
+{
+    vec2 uv = vec2(cosSunZenith * 0.5 + 0.5, clamp(height / (topRadius - groundRadius), 0.0, 1.0));
+    return texture(multiScatteringLut, uv).rgb;
+}
+
+// Luz dispersada hacia el origen a lo largo del rayo (con un sol de intensidad 1 en esa
+// dirección), hasta el techo de la atmósfera o el suelo
+vec3 Integrate(vec3 origin, vec3 dir, vec3 sun, int steps)
+{
+    float ground = RaySphere(origin, dir, groundRadius);
+    float distance = ground > 0.0 ? ground : RaySphere(origin, dir, topRadius);
+    float step = distance / float(steps);
+
+    float cosTheta = dot(dir, sun);
+    float rayleighPhase = 3.0 / (16.0 * PI) * (1.0 + cosTheta * cosTheta);
+    float g2 = mieG * mieG;
+    float miePhase = 3.0 / (8.0 * PI) * ((1.0 - g2) * (1.0 + cosTheta * cosTheta)) / ((2.0 + g2) * pow(1.0 + g2 - 2.0 * mieG * cosTheta, 1.5));
+
+    vec3 radiance = vec3(0.0);
+    vec3 transmittance = vec3(1.0);
+    for(int i = 0; i < steps; i++)
+    {
+        vec3 position = origin + dir * ((float(i) + 0.5) * step);
+        float sampleRadius = length(position);
+        float height = sampleRadius - groundRadius;
+        float cosSunZenith = dot(position / sampleRadius, sun);
+        float mie;
+        vec3 rayleigh = Scattering(height, mie);
+        vec3 extinction = Extinction(height);
+        vec3 stepTransmittance = exp(-extinction * step);
+
+        vec3 single = (rayleigh * rayleighPhase + mie * miePhase) * SampleTransmittance(height, cosSunZenith);
+        vec3 multiple = (rayleigh + mie) * SampleMultiScattering(height, cosSunZenith);
+        // Integral exacta a lo largo del paso (extinción constante dentro de él)
+        radiance += transmittance * (single + multiple) * (1.0 - stepTransmittance) / extinction;
+        transmittance *= stepTransmittance;
+    }
+    if(ground > 0.0)
+    {
+        // El suelo más allá de la escena, iluminado por el sol
+        vec3 hit = origin + dir * ground;
+        float cosGround = max(dot(normalize(hit), sun), 0.0);
+        radiance += transmittance * SampleTransmittance(0.0, cosGround) * cosGround * groundAlbedo / PI;
+    }
+    return radiance;
+}
\ No newline at end of file
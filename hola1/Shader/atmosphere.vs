@@ -0,0 +1,11 @@
+#version 330 core
+// Triángulo que cubre toda la pantalla (sin VBO, sale de gl_VertexID), en el plano lejano:
+// el cielo solo queda donde la escena no dibujó nada
+out vec2 TexCoords;
+
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    TexCoords = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 1.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+#version 330 core
+// --- PASO DE ILUMINACIÓN DEL RENDER DEFERRED ---
+// Lee el G-buffer y aplica la luz direccional y las luces de punto una sola vez por pixel.
+// Las luces se toman de la misma rejilla de clusters que usa forward: el cluster sale
+// del pixel y de la profundidad guardada, así que cada pixel solo recorre sus luces.
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+// --- ESTRUCTURAS DE LUZ ---
+struct DirLight {
+    vec3 direction;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+struct PointLight {
+    vec3 position;
+    float radius;   // Más allá de este radio la luz ya no aporta (se usa para los clusters)
+    float constant;
+    float linear;
+    float quadratic;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+// --- G-BUFFER ---
+uniform sampler2D gAlbedo;
+uniform sampler2D gNormal;
+uniform sampler2D gSpecular;
+uniform sampler2D gDepth;
+
+// --- DATOS DEL CUADRO: cámara y sol (el mismo bloque que modelLoading) ---
+layout (std140) uniform FrameData
+{
+    mat4 projection;
+    mat4 view;
+    mat4 inverseViewProjection; // Para reconstruir la posición desde la profundidad (deferred)
+    vec3 viewPos;
+    DirLight dirLight;
+};
+
+// --- LUCES DE PUNTO AGRUPADAS (mismos clusters que en forward) ---
+// Las luces ya no son un arreglo fijo: viven en texture buffers que llena ClusteredLights.h
+uniform samplerBuffer lightData;     // 4 texeles por luz
+uniform usamplerBuffer clusterGrid;  // (inicio, cantidad) de cada cluster
+uniform int clusterGridOffset;       // Primer cluster de este cuadro en clusterGrid
+uniform usamplerBuffer lightIndices; // Índices de luz de todos los clusters
+uniform uvec3 clusterDims;
+uniform vec2 clusterTileSize;        // Pixeles por cluster en X y Y
+uniform float clusterScale;          // Rebanada = log(profundidad) * clusterScale - clusterBias
+uniform float clusterBias;
+uniform int lightCount;
+
+// --- VARIANTES (ShaderVariants.h): SHADOWS y CLUSTERED_LIGHTS, igual que modelLoading.frag ---
+
+#ifdef SHADOWS
+// --- SOMBRAS DEL SOL (cascadas, ver ShadowCascades.h) ---
+const int SHADOW_CASCADES = 3;                    // Igual que SHADOW_CASCADES en C++
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 cascadeMatrices[SHADOW_CASCADES];
+uniform float cascadeSplits[SHADOW_CASCADES];     // Profundidad de vista donde termina cada cascada
+uniform float cascadeTexelSizes[SHADOW_CASCADES]; // Tamaño de un texel en el mundo
+#endif
+
+// Prototipos de funciones
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess, float shadow);
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess);
+PointLight FetchPointLight(int index);
+#ifdef SHADOWS
+float CalcShadow(vec3 fragPos, vec3 normal, float viewDepth);
+#endif
+
+void main()
+{
+    float depth = texture(gDepth, TexCoords).r;
+    if(depth == 1.0) // Cielo: se queda el color de fondo
+        discard;
+
+    // Posición en el mundo a partir de la profundidad
+    vec4 ndc = vec4(TexCoords * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 worldPos = inverseViewProjection * ndc;
+    vec3 fragPos = worldPos.xyz / worldPos.w;
+    float viewDepth = -(view * vec4(fragPos, 1.0)).z;
+
+    // Propiedades de la superficie
+    vec3 diffuseColor = texture(gAlbedo, TexCoords).rgb;
+    vec3 norm = normalize(texture(gNormal, TexCoords).xyz);
+    vec4 specular = texture(gSpecular, TexCoords);
+    float shininess = specular.a * 256.0;
+    vec3 viewDir = normalize(viewPos - fragPos);
+
+    // Fase 1: Luz Direccional (Sol o Luna)
+#ifdef SHADOWS
+    float shadow = CalcShadow(fragPos, norm, viewDepth);
+#else
+    float shadow = 1.0;
+#endif
+    vec3 result = CalcDirLight(dirLight, norm, viewDir, diffuseColor, specular.rgb, shininess, shadow);
+
+    // Fase 2: Luces de Punto (Postes)
+#ifdef CLUSTERED_LIGHTS
+    {
+        uvec3 cluster;
+        cluster.xy = min(uvec2(gl_FragCoord.xy / clusterTileSize), clusterDims.xy - 1u);
+        cluster.z = min(uint(max(log(viewDepth) * clusterScale - clusterBias, 0.0)), clusterDims.z - 1u);
+        int clusterIndex = int(cluster.x + cluster.y * clusterDims.x + cluster.z * clusterDims.x * clusterDims.y);
+
+        uvec2 range = texelFetch(clusterGrid, clusterGridOffset + clusterIndex).xy;
+        for(uint i = 0u; i < range.y; i++)
+        {
+            int lightIndex = int(texelFetch(lightIndices, int(range.x + i)).x);
+            result += CalcPointLight(FetchPointLight(lightIndex), norm, fragPos, viewDir, diffuseColor, specular.rgb, shininess);
+        }
+    }
+#else
+    for(int i = 0; i < lightCount; i++)
+        result += CalcPointLight(FetchPointLight(i), norm, fragPos, viewDir, diffuseColor, specular.rgb, shininess);
+#endif
+
+    FragColor = vec4(result, 1.0);
+}
+
+// --- Función para la Luz Direccional ---
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess, float shadow)
+{
+    vec3 lightDir = normalize(-light.direction);
+    // Luz Ambiente
+    vec3 ambient = light.ambient * diffuseColor;
+    // Luz Difusa
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 diffuse = light.diffuse * diff * diffuseColor;
+    // Luz Especular
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+    vec3 specular = light.specular * spec * specularColor;
+		
+    return (ambient + shadow * (diffuse + specular)); // La sombra no quita la luz ambiente
+}
+
+// --- Función para las Luces de Punto ---
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess)
+{
+    vec3 lightDir = normalize(light.position - fragPos);
+    // Luz Ambiente
+    vec3 ambient = light.ambient * diffuseColor;
+    // Luz Difusa
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 diffuse = light.diffuse * diff * diffuseColor;
+    // Luz Especular
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+    vec3 specular = light.specular * spec * specularColor;
+    // Atenuación
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    // Ventana suave hasta el radio, para que el corte del cluster no se note
+    float falloff = clamp(1.0 - pow(distance / light.radius, 4.0), 0.0, 1.0);
+    attenuation *= falloff * falloff;
+    
+    ambient *= attenuation;
+    diffuse *= attenuation;
+    specular *= attenuation;
+		
+    return (ambient + diffuse + specular);
+}
+
+// --- Lee una luz de punto del texture buffer (mismo orden que ClusterLight) ---
+PointLight FetchPointLight(int index)
+{
+    vec4 t0 = texelFetch(lightData, index * 4 + 0);
+    vec4 t1 = texelFetch(lightData, index * 4 + 1);
+    vec4 t2 = texelFetch(lightData, index * 4 + 2);
+    vec4 t3 = texelFetch(lightData, index * 4 + 3);
+
+    PointLight light;
+    light.position = t0.xyz;
+    light.radius = t0.w;
+    light.ambient = t1.xyz;
+    light.constant = t1.w;
+    light.diffuse = t2.xyz;
+    light.linear = t2.w;
+    light.specular = t3.xyz;
+    light.quadratic = t3.w;
+    return light;
+}
+
+#ifdef SHADOWS
+// --- Sombra del sol: 1 = iluminado, 0 = en sombra (PCF 3x3) ---
+float CalcShadow(vec3 fragPos, vec3 normal, float viewDepth)
+{
+    int cascade = 0;
+    while(cascade < SHADOW_CASCADES && viewDepth > cascadeSplits[cascade])
+        cascade++;
+    if(cascade == SHADOW_CASCADES) // Más allá de la distancia de sombras
+        return 1.0;
+
+    // Se empuja el punto sobre la normal (un poco más de un texel) para evitar el acné de sombra
+    vec3 offsetPos = fragPos + normal * cascadeTexelSizes[cascade] * 1.5;
+    vec3 coords = (cascadeMatrices[cascade] * vec4(offsetPos, 1.0)).xyz * 0.5 + 0.5;
+    if(coords.z > 1.0)
+        return 1.0;
+
+    // Cada muestra ya compara y filtra 2x2 en hardware
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    float shadow = 0.0;
+    for(int x = -1; x <= 1; x++)
+    {
+        for(int y = -1; y <= 1; y++)
+            shadow += texture(shadowMap, vec4(coords.xy + vec2(x, y) * texelSize, float(cascade), coords.z));
+    }
+    return shadow / 9.0;
+}
+#endif
\ No newline at end of file
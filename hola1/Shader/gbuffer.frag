@@ -0,0 +1,42 @@
+#version 330 core
+// --- PASO DE GEOMETRÍA DEL RENDER DEFERRED ---
+// Mismos uniforms de material que modelLoading.frag, pero en lugar de iluminar
+// guarda los datos de la superficie en el G-buffer.
+layout (location = 0) out vec4 gAlbedo;   // rgb = color difuso
+layout (location = 1) out vec4 gNormal;   // xyz = normal en espacio de mundo
+layout (location = 2) out vec4 gSpecular; // rgb = especular, a = brillo / 256
+
+struct Material {
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+    float shininess;
+};
+
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoords;
+
+uniform Material material;
+#ifdef TEXTURED
+uniform sampler2D texture_diffuse1;
+#endif
+
+void main()
+{
+    // Mismas variantes TEXTURED / ALPHA_TEST que modelLoading.frag
+#ifdef TEXTURED
+    vec4 texColor = texture(texture_diffuse1, TexCoords);
+#ifdef ALPHA_TEST
+    if(texColor.a < 0.1)
+        discard;
+#endif
+    vec3 diffuseColor = texColor.rgb;
+#else
+    vec3 diffuseColor = material.diffuse;
+#endif
+
+    gAlbedo = vec4(diffuseColor, 1.0);
+    gNormal = vec4(normalize(Normal), 0.0);
+    gSpecular = vec4(material.specular, material.shininess / 256.0);
+}
\ No newline at end of file
@@ -11,6 +11,7 @@ struct DirLight {
 
 struct PointLight {
     vec3 position;
+    float radius;   // Más allá de este radio la luz ya no aporta (se usa para los clusters)
     float constant;
     float linear;
     float quadratic;
@@ -30,19 +31,69 @@ struct Material {
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords; // (¡Ahora sí lo usaremos!)
+in float ViewDepth;
+
+// --- DATOS DEL CUADRO: cámara y sol (igual que en modelLoading.vs) ---
+layout (std140) uniform FrameData
+{
+    mat4 projection;
+    mat4 view;
+    mat4 inverseViewProjection; // Para reconstruir la posición desde la profundidad (deferred)
+    vec3 viewPos;
+    DirLight dirLight;
+};
 
-uniform vec3 viewPos;
-uniform DirLight dirLight;
-uniform PointLight pointLights[2];
 uniform Material material;
 
-// --- ¡¡NUEVAS LÍNEAS!! ---
+// --- LUCES DE PUNTO AGRUPADAS (Clustered Forward) ---
+// Las luces ya no son un arreglo fijo: viven en texture buffers que llena ClusteredLights.h
+uniform samplerBuffer lightData;     // 4 texeles por luz
+uniform usamplerBuffer clusterGrid;  // (inicio, cantidad) de cada cluster
+uniform int clusterGridOffset;       // Primer cluster de este cuadro en clusterGrid
+uniform usamplerBuffer lightIndices; // Índices de luz de todos los clusters
+uniform uvec3 clusterDims;
+uniform vec2 clusterTileSize;        // Pixeles por cluster en X y Y
+uniform float clusterScale;          // Rebanada = log(profundidad) * clusterScale - clusterBias
+uniform float clusterBias;
+uniform int lightCount;
+
+// --- VARIANTES (ShaderVariants.h agrega los #define después de #version) ---
+// TEXTURED: color de la textura, ALPHA_TEST: recorte por transparencia,
+// SHADOWS: sombras del sol, CLUSTERED_LIGHTS: solo las luces del cluster (si no, todas)
+// LIGHTMAP: la luz difusa viene horneada (escena estática), sin sombras ni luces en tiempo real
+
+#ifdef LIGHTMAP
+// --- LUZ HORNEADA (ver Lightmap.h) ---
+const int LIGHTMAP_SUN_LAYERS = 3;         // Igual que LIGHTMAP_SUN_LAYERS en C++
+const float LIGHTMAP_RGBM_RANGE = 8.0;     // Igual que LIGHTMAP_RGBM_RANGE en C++
+in vec2 LightmapUV;
+uniform sampler2DArray lightmap;           // Capa 0: postes, 1..3: el sol (día, atardecer, noche)
+uniform vec3 lightmapSunWeights[LIGHTMAP_SUN_LAYERS]; // Peso de cada capa por el color del sol en este cuadro
+#endif
+
+#ifdef SHADOWS
+// --- SOMBRAS DEL SOL (cascadas, ver ShadowCascades.h) ---
+const int SHADOW_CASCADES = 3;                    // Igual que SHADOW_CASCADES en C++
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 cascadeMatrices[SHADOW_CASCADES];
+uniform float cascadeSplits[SHADOW_CASCADES];     // Profundidad de vista donde termina cada cascada
+uniform float cascadeTexelSizes[SHADOW_CASCADES]; // Tamaño de un texel en el mundo
+#endif
+
+#ifdef TEXTURED
 uniform sampler2D texture_diffuse1; // Sampler para el pasto, agua Y modelos
-uniform bool useTexture;            // El "interruptor"
+#endif
 
 // Prototipos de funciones
-vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, vec3 diffuseColor);
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, vec3 diffuseColor, float shadow);
 vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 diffuseColor);
+PointLight FetchPointLight(int index);
+#ifdef SHADOWS
+float CalcShadow(vec3 fragPos, vec3 normal, float viewDepth);
+#endif
+#ifdef LIGHTMAP
+vec3 SampleLightmap(int layer);
+#endif
 
 void main()
 {
@@ -50,37 +101,67 @@ void main()
     vec3 norm = normalize(Normal);
     vec3 viewDir = normalize(viewPos - FragPos);
     
-    // --- ¡¡LÓGICA MODIFICADA!! ---
     // Determinamos el color difuso base (de textura o de material)
-    vec3 diffuseColor;
-    if(useTexture)
-    {
-        // 1. Es un objeto con textura (pasto, agua, Pokémon)
-        vec4 texColor = texture(texture_diffuse1, TexCoords);
-        if(texColor.a < 0.1) // Mantenemos el descarte por transparencia
-            discard;
-        diffuseColor = texColor.rgb;
-    }
-    else
-    {
-        // 2. Es un objeto de color sólido (casas, árboles)
-        diffuseColor = material.diffuse;
-    }
-    // --- FIN DE LÓGICA MODIFICADA ---
+#ifdef TEXTURED
+    // 1. Es un objeto con textura (pasto, agua, Pokémon)
+    vec4 texColor = texture(texture_diffuse1, TexCoords);
+#ifdef ALPHA_TEST
+    if(texColor.a < 0.1) // Descarte por transparencia (solo en esta variante: apaga el early-Z)
+        discard;
+#endif
+    vec3 diffuseColor = texColor.rgb;
+#else
+    // 2. Es un objeto de color sólido (casas, árboles)
+    vec3 diffuseColor = material.diffuse;
+#endif
 
     
+#ifdef LIGHTMAP
+    // Superficie estática: la luz difusa del sol (mezcla de las direcciones horneadas), de los
+    // postes y el ambiente del cielo (ese cambia con la hora y no se hornea)
+    vec3 irradiance = SampleLightmap(0) + dirLight.ambient;
+    for(int i = 0; i < LIGHTMAP_SUN_LAYERS; i++)
+    {
+        if(lightmapSunWeights[i] != vec3(0.0))
+            irradiance += lightmapSunWeights[i] * SampleLightmap(i + 1);
+    }
+    vec3 result = diffuseColor * irradiance;
+#else
     // Fase 1: Luz Direccional (Sol o Luna)
-    vec3 result = CalcDirLight(dirLight, norm, viewDir, diffuseColor);
+#ifdef SHADOWS
+    float shadow = CalcShadow(FragPos, norm, ViewDepth);
+#else
+    float shadow = 1.0;
+#endif
+    vec3 result = CalcDirLight(dirLight, norm, viewDir, diffuseColor, shadow);
     
     // Fase 2: Luces de Punto (Postes)
-    result += CalcPointLight(pointLights[0], norm, FragPos, viewDir, diffuseColor);
-    result += CalcPointLight(pointLights[1], norm, FragPos, viewDir, diffuseColor);
+#ifdef CLUSTERED_LIGHTS
+    {
+        // Solo las luces del cluster de este fragmento
+        uvec3 cluster;
+        cluster.xy = min(uvec2(gl_FragCoord.xy / clusterTileSize), clusterDims.xy - 1u);
+        cluster.z = min(uint(max(log(ViewDepth) * clusterScale - clusterBias, 0.0)), clusterDims.z - 1u);
+        int clusterIndex = int(cluster.x + cluster.y * clusterDims.x + cluster.z * clusterDims.x * clusterDims.y);
+
+        uvec2 range = texelFetch(clusterGrid, clusterGridOffset + clusterIndex).xy;
+        for(uint i = 0u; i < range.y; i++)
+        {
+            int lightIndex = int(texelFetch(lightIndices, int(range.x + i)).x);
+            result += CalcPointLight(FetchPointLight(lightIndex), norm, FragPos, viewDir, diffuseColor);
+        }
+    }
+#else
+    for(int i = 0; i < lightCount; i++)
+        result += CalcPointLight(FetchPointLight(i), norm, FragPos, viewDir, diffuseColor);
+#endif
+#endif
     
     FragColor = vec4(result, 1.0);
 }
 
 // --- Función para la Luz Direccional (MODIFICADA) ---
-vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, vec3 diffuseColor)
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, vec3 diffuseColor, float shadow)
 {
     vec3 lightDir = normalize(-light.direction);
     // Luz Ambiente
@@ -93,7 +174,7 @@ vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, vec3 diffuseColor)
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
     vec3 specular = light.specular * spec * material.specular;
 		
-    return (ambient + diffuse + specular);
+    return (ambient + shadow * (diffuse + specular)); // La sombra no quita la luz ambiente
 }
 
 // --- Función para las Luces de Punto (MODIFICADA) ---
@@ -112,10 +193,70 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, v
     // Atenuación
     float distance = length(light.position - fragPos);
     float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    // Ventana suave hasta el radio, para que el corte del cluster no se note
+    float falloff = clamp(1.0 - pow(distance / light.radius, 4.0), 0.0, 1.0);
+    attenuation *= falloff * falloff;
     
     ambient *= attenuation;
     diffuse *= attenuation;
     specular *= attenuation;
 		
     return (ambient + diffuse + specular);
-}
\ No newline at end of file
+}
+
+// --- Lee una luz de punto del texture buffer (mismo orden que ClusterLight) ---
+PointLight FetchPointLight(int index)
+{
+    vec4 t0 = texelFetch(lightData, index * 4 + 0);
+    vec4 t1 = texelFetch(lightData, index * 4 + 1);
+    vec4 t2 = texelFetch(lightData, index * 4 + 2);
+    vec4 t3 = texelFetch(lightData, index * 4 + 3);
+
+    PointLight light;
+    light.position = t0.xyz;
+    light.radius = t0.w;
+    light.ambient = t1.xyz;
+    light.constant = t1.w;
+    light.diffuse = t2.xyz;
+    light.linear = t2.w;
+    light.specular = t3.xyz;
+    light.quadratic = t3.w;
+    return light;
+}
+
+#ifdef SHADOWS
+// --- Sombra del sol: 1 = iluminado, 0 = en sombra (PCF 3x3) ---
+float CalcShadow(vec3 fragPos, vec3 normal, float viewDepth)
+{
+    int cascade = 0;
+    while(cascade < SHADOW_CASCADES && viewDepth > cascadeSplits[cascade])
+        cascade++;
+    if(cascade == SHADOW_CASCADES) // Más allá de la distancia de sombras
+        return 1.0;
+
+    // Se empuja el punto sobre la normal (un poco más de un texel) para evitar el acné de sombra
+    vec3 offsetPos = fragPos + normal * cascadeTexelSizes[cascade] * 1.5;
+    vec3 coords = (cascadeMatrices[cascade] * vec4(offsetPos, 1.0)).xyz * 0.5 + 0.5;
+    if(coords.z > 1.0)
+        return 1.0;
+
+    // Cada muestra ya compara y filtra 2x2 en hardware
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    float shadow = 0.0;
+    for(int x = -1; x <= 1; x++)
+    {
+        for(int y = -1; y <= 1; y++)
+            shadow += texture(shadowMap, vec4(coords.xy + vec2(x, y) * texelSize, float(cascade), coords.z));
+    }
+    return shadow / 9.0;
+}
+#endif
+
+#ifdef LIGHTMAP
+// --- Irradiancia horneada, guardada en RGBM ---
+vec3 SampleLightmap(int layer)
+{
+    vec4 rgbm = texture(lightmap, vec3(LightmapUV, float(layer)));
+    return rgbm.rgb * rgbm.a * LIGHTMAP_RGBM_RANGE;
+}
+#endif
\ No newline at end of file
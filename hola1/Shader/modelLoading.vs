@@ -6,15 +6,136 @@ layout (location = 2) in vec2 texCoords;
 out vec3 Normal;
 out vec3 FragPos;
 out vec2 TexCoords;
+out float ViewDepth; // Distancia a la cámara (para elegir el cluster de luces)
+
+#ifdef LIGHTMAP
+// --- LIGHTMAP: coordenada del atlas de cada vértice (ver Lightmap.h) ---
+// Los VAOs son compartidos, así que las coordenadas vienen de un texture buffer
+uniform samplerBuffer lightmapUVs;
+uniform int lightmapOffset; // Primer vértice de este dibujo en lightmapUVs
+out vec2 LightmapUV;
+#endif
+
+#ifdef SKINNED
+// --- SKINNED: vértices deformados por el esqueleto (ver Animation.h) ---
+// Cada hueso son 3 texeles (filas de su matriz) en bonePalette, a partir de boneOffset
+layout (location = 3) in ivec4 boneIds;
+layout (location = 4) in vec4 boneWeights;
+uniform samplerBuffer bonePalette;
+uniform int boneOffset;
+
+// Mezcla de los huesos del vértice (se mezclan las filas y se arma la matriz una vez)
+mat4 SkinMatrix()
+{
+    vec4 row0 = vec4(0.0f);
+    vec4 row1 = vec4(0.0f);
+    vec4 row2 = vec4(0.0f);
+    for (int i = 0; i < 4; i++)
+    {
+        int texel = (boneOffset + boneIds[i]) * 3;
+        row0 += boneWeights[i] * texelFetch(bonePalette, texel);
+        row1 += boneWeights[i] * texelFetch(bonePalette, texel + 1);
+        row2 += boneWeights[i] * texelFetch(bonePalette, texel + 2);
+    }
+    return transpose(mat4(row0, row1, row2, vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+}
+#endif
+
+#ifdef VERTEX_ANIMATION
+// --- VERTEX_ANIMATION: vértices horneados de un clip, para multitudes (ver VertexAnimation.h) ---
+// animationFrames: un texel por vértice y cuadro, xyz la posición cuantizada en la caja del
+// clip y w la normal octaédrica (8:8). animationInstances: 4 texeles por instancia a partir
+// de instanceOffset, las 3 filas de su matriz model y su reloj (desfase, ritmo).
+uniform usamplerBuffer animationFrames;
+uniform samplerBuffer animationInstances;
+uniform int instanceOffset; // Primera instancia de este dibujo en animationInstances
+uniform int vertexOffset; // Primer vértice de esta malla en cada cuadro
+uniform int vertexCount;  // Vértices de un cuadro (todo el modelo)
+uniform int frameCount;
+uniform float frameRate;
+uniform vec3 boundsMin;
+uniform vec3 boundsSize;
+uniform float animationTime;
+
+// Matriz model de la instancia
+mat4 InstanceMatrix()
+{
+    int texel = (instanceOffset + gl_InstanceID) * 4;
+    return transpose(mat4(texelFetch(animationInstances, texel), texelFetch(animationInstances, texel + 1),
+                          texelFetch(animationInstances, texel + 2), vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+}
+
+// Los dos cuadros entre los que va la instancia (texeles del vértice) y cuánto se mezclan
+void AnimationFrames(out uvec4 a, out uvec4 b, out float t)
+{
+    vec4 clock = texelFetch(animationInstances, (instanceOffset + gl_InstanceID) * 4 + 3);
+    float frame = mod((animationTime * clock.y + clock.x) * frameRate, float(frameCount - 1));
+    int f0 = min(int(frame), frameCount - 2);
+    t = frame - float(f0);
+    int vertex = vertexOffset + gl_VertexID;
+    a = texelFetch(animationFrames, f0 * vertexCount + vertex);
+    b = texelFetch(animationFrames, (f0 + 1) * vertexCount + vertex);
+}
+
+vec3 DecodePosition(uvec4 texel)
+{
+    return boundsMin + vec3(texel.xyz) / 65535.0f * boundsSize;
+}
+
+vec3 DecodeNormal(uint octahedral)
+{
+    vec2 e = vec2(float(octahedral >> 8u), float(octahedral & 255u)) / 127.5f - 1.0f;
+    vec3 n = vec3(e, 1.0f - abs(e.x) - abs(e.y));
+    if (n.z < 0.0f)
+        n.xy = (1.0f - abs(n.yx)) * vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+    return normalize(n);
+}
+#endif
+
+// --- DATOS DEL CUADRO: cámara y sol, iguales en todos los dibujos (FrameUniforms en ProyectoFinal.cpp) ---
+// El bloque debe ser idéntico en los dos shaders del programa
+struct DirLight {
+    vec3 direction;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+layout (std140) uniform FrameData
+{
+    mat4 projection;
+    mat4 view;
+    mat4 inverseViewProjection; // Para reconstruir la posición desde la profundidad (deferred)
+    vec3 viewPos;
+    DirLight dirLight;
+};
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
-    gl_Position = projection * view *  model * vec4(position, 1.0f);
-    FragPos = vec3(model * vec4(position, 1.0f));
-    Normal = mat3(transpose(inverse(model))) * normal;
+    vec4 localPosition = vec4(position, 1.0f);
+    vec3 localNormal = normal;
+#ifdef SKINNED
+    mat4 skin = SkinMatrix();
+    localPosition = skin * localPosition;
+    localNormal = mat3(skin) * normal;
+#endif
+    mat4 modelMatrix = model;
+#ifdef VERTEX_ANIMATION
+    modelMatrix = InstanceMatrix();
+    uvec4 frameA, frameB;
+    float frameMix;
+    AnimationFrames(frameA, frameB, frameMix);
+    localPosition = vec4(mix(DecodePosition(frameA), DecodePosition(frameB), frameMix), 1.0f);
+    localNormal = mix(DecodeNormal(frameA.w), DecodeNormal(frameB.w), frameMix);
+#endif
+    gl_Position = projection * view *  modelMatrix * localPosition;
+    FragPos = vec3(modelMatrix * localPosition);
+    Normal = mat3(transpose(inverse(modelMatrix))) * localNormal;
     TexCoords = texCoords;
+    ViewDepth = -(view * modelMatrix * localPosition).z;
+#ifdef LIGHTMAP
+    LightmapUV = texelFetch(lightmapUVs, lightmapOffset + gl_VertexID).xy;
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,16 @@
+#version 330 core
+// Solo escribe profundidad; la variante ALPHA_TEST recorta las texturas con transparencia
+// igual que al dibujarlas (sin ella el fragment shader no hace nada)
+in vec2 TexCoords;
+
+#ifdef ALPHA_TEST
+uniform sampler2D texture_diffuse1;
+#endif
+
+void main()
+{
+#ifdef ALPHA_TEST
+    if(texture(texture_diffuse1, TexCoords).a < 0.1)
+        discard;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,169 @@
+#pragma once
+
+// Std. Includes
+#include <string>
+#include <map>
+#include <fstream>
+#include <iostream>
+#include <functional>
+
+// GL Includes
+#include <GL/glew.h>
+
+#include "Shader.h"
+
+// Permutaciones de los shaders. Cada bit es un #define en el codigo del shader;
+// un programa solo hace el trabajo de las opciones que tiene encendidas.
+enum Shader_Variant
+{
+	SHADER_TEXTURED = 1,	// TEXTURED: color de texture_diffuse1 (si no, de material.diffuse)
+	SHADER_ALPHA_TEST = 2,	// ALPHA_TEST: descarta alfa < 0.1 (apaga el early-Z, solo para texturas recortadas)
+	SHADER_SHADOWS = 4,		// SHADOWS: sombras del sol con cascadas
+	SHADER_CLUSTERED = 8,	// CLUSTERED_LIGHTS: luces por cluster (si no, recorre todas)
+	SHADER_LIGHTMAP = 16,	// LIGHTMAP: luz difusa horneada (escena estatica, ignora SHADOWS y CLUSTERED_LIGHTS)
+	SHADER_SKINNED = 32,	// SKINNED: vertices deformados por la paleta de huesos (ver Animation.h)
+	SHADER_VERTEX_ANIMATION = 64,	// VERTEX_ANIMATION: instancias con vertices horneados por cuadro (ver VertexAnimation.h)
+	SHADER_VARIANT_COUNT = 7
+};
+
+const GLchar* const SHADER_VARIANT_DEFINES[SHADER_VARIANT_COUNT] = { "TEXTURED", "ALPHA_TEST", "SHADOWS", "CLUSTERED_LIGHTS", "LIGHTMAP", "SKINNED", "VERTEX_ANIMATION" };
+
+// Conjunto de variantes de un par de shaders (vertex + fragment).
+// Las variantes se compilan la primera vez que se piden y se quedan en memoria.
+// La lista de variantes usadas se guarda junto al fragment shader ("<archivo>.variants"),
+// asi en la siguiente corrida se compilan todas al inicio y no a media animacion.
+class ShaderVariants
+{
+public:
+	// Constructor, recibe los shaders y las opciones que entiende (las demas se ignoran)
+	ShaderVariants(const GLchar* vertexPath, const GLchar* fragmentPath, GLuint supported)
+		: vertexPath(vertexPath), fragmentPath(fragmentPath), supported(supported), baseFlags(0), pass(0), setup(nullptr)
+	{
+		this->cachePath = this->fragmentPath + ".variants";
+
+		std::ifstream cache(this->cachePath.c_str());
+		GLuint flags;
+		while (cache >> flags)
+		{
+			this->compile(flags & this->supported);
+		}
+	}
+
+	~ShaderVariants()
+	{
+		for (std::map<GLuint, Variant>::iterator it = this->variants.begin(); it != this->variants.end(); ++it)
+		{
+			glDeleteProgram(it->second.shader->Program);
+			delete it->second.shader;
+		}
+	}
+
+	// Inicia un paso de dibujo: setup pone los uniforms comunes (camara, luces...) y se llama
+	// una vez por variante, cuando esta se usa por primera vez en el paso.
+	// baseFlags se suman a las opciones de cada dibujo (ej. sombras o clusters del cuadro).
+	// Solo se guarda el puntero (copiar el std::function pediria memoria en cada paso): setup debe
+	// vivir hasta el siguiente Begin, o ser nullptr si el paso no pone nada.
+	void Begin(const std::function<void(Shader&)>* setup, GLuint baseFlags = 0)
+	{
+		this->setup = setup;
+		this->baseFlags = baseFlags;
+		this->pass++;
+	}
+
+	// Activa la variante con esas opciones (y las del paso) y la regresa
+	Shader& Use(GLuint flags)
+	{
+		Variant& variant = this->get((flags | this->baseFlags) & this->supported);
+		variant.shader->Use();
+		if (variant.pass != this->pass)
+		{
+			variant.pass = this->pass;
+			if (this->setup != nullptr && *this->setup)
+			{
+				(*this->setup)(*variant.shader);
+			}
+		}
+		return *variant.shader;
+	}
+
+	GLuint GetVariantCount() const
+	{
+		return (GLuint)this->variants.size();
+	}
+
+	// Recompila en segundo plano todas las variantes si usan ese archivo (ver Shader::Reload)
+	bool Reload(const std::string& path)
+	{
+		if (path != this->vertexPath && path != this->fragmentPath)
+		{
+			return false;
+		}
+		for (std::map<GLuint, Variant>::iterator it = this->variants.begin(); it != this->variants.end(); ++it)
+		{
+			it->second.shader->Reload();
+		}
+		return true;
+	}
+
+	// Llamar cada cuadro: cambia las variantes que ya terminaron de enlazar.
+	// El programa nuevo no tiene uniforms, asi que el setup se vuelve a correr en el siguiente Use.
+	void Poll()
+	{
+		for (std::map<GLuint, Variant>::iterator it = this->variants.begin(); it != this->variants.end(); ++it)
+		{
+			if (it->second.shader->PollReload())
+			{
+				it->second.pass = 0;
+			}
+		}
+	}
+
+private:
+	struct Variant
+	{
+		Shader* shader;
+		GLuint pass;
+	};
+
+	std::string vertexPath;
+	std::string fragmentPath;
+	std::string cachePath;
+	GLuint supported;
+	GLuint baseFlags;
+	GLuint pass;
+	const std::function<void(Shader&)>* setup;
+	std::map<GLuint, Variant> variants;
+
+	Variant& get(GLuint flags)
+	{
+		std::map<GLuint, Variant>::iterator it = this->variants.find(flags);
+		if (it != this->variants.end())
+		{
+			return it->second;
+		}
+
+		// Variante nueva: se anota en el archivo para compilarla al inicio la proxima vez
+		std::ofstream cache(this->cachePath.c_str(), std::ios::app);
+		cache << flags << std::endl;
+		return this->compile(flags);
+	}
+
+	Variant& compile(GLuint flags)
+	{
+		Variant& variant = this->variants[flags];
+		if (variant.shader == NULL)
+		{
+			std::string defines;
+			for (GLuint i = 0; i < SHADER_VARIANT_COUNT; i++)
+			{
+				if (flags & (1u << i))
+				{
+					defines += std::string("#define ") + SHADER_VARIANT_DEFINES[i] + "\n";
+				}
+			}
+			variant.shader = new Shader(this->vertexPath.c_str(), this->fragmentPath.c_str(), defines);
+			variant.pass = 0;
+		}
+		return variant;
+	}
+};
@@ -0,0 +1,173 @@
+#pragma once
+
+// Std. Includes
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#elif defined(_WIN32)
+#include <io.h>
+#endif
+
+// En Windows no hay inotify: se revisa la fecha de modificacion de los archivos cada tanto
+const float SHADER_WATCH_INTERVAL = 0.5f;
+
+// Vigila una carpeta de shaders y avisa que archivos cambiaron, sin bloquear el cuadro.
+// En Linux usa inotify (no bloqueante); en Windows compara las fechas de modificacion.
+// Las rutas se regresan como "<carpeta>/<archivo>", igual que se le pasan a Shader.
+class ShaderWatcher
+{
+public:
+	// Constructor, recibe la carpeta a vigilar (ej. "Shader")
+	ShaderWatcher(const std::string& directory)
+		: directory(directory), fd(-1), watch(-1), elapsed(0.0f), scanCount(0)
+	{
+#ifdef __linux__
+		this->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (this->fd >= 0)
+		{
+			// Los editores guardan escribiendo el archivo (CLOSE_WRITE) o renombrando uno temporal (MOVED_TO)
+			this->watch = inotify_add_watch(this->fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+		}
+		if (this->watch < 0)
+		{
+			std::cout << "ERROR::SHADER_WATCHER::INOTIFY " << directory << std::endl;
+		}
+#elif defined(_WIN32)
+		this->scan(nullptr);
+#endif
+	}
+
+	~ShaderWatcher()
+	{
+#ifdef __linux__
+		if (this->fd >= 0)
+		{
+			close(this->fd);
+		}
+#endif
+	}
+
+	// Llamar cada cuadro; regresa los archivos que cambiaron desde la ultima llamada (sin repetir)
+	std::vector<std::string> Poll(float deltaTime)
+	{
+		std::vector<std::string> changed;
+#ifdef __linux__
+		(void)deltaTime; // inotify avisa solo, no hace falta el intervalo
+		if (this->fd < 0)
+		{
+			return changed;
+		}
+		char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+		for (;;)
+		{
+			ssize_t length = read(this->fd, buffer, sizeof(buffer));
+			if (length <= 0)
+			{
+				break; // EAGAIN: no hay mas eventos
+			}
+			for (char* ptr = buffer; ptr < buffer + length; ptr += sizeof(struct inotify_event) + ((struct inotify_event*)ptr)->len)
+			{
+				const struct inotify_event* event = (const struct inotify_event*)ptr;
+				if (event->len > 0 && !(event->mask & IN_ISDIR))
+				{
+					this->add(changed, this->directory + "/" + event->name);
+				}
+			}
+		}
+#elif defined(_WIN32)
+		this->elapsed += deltaTime;
+		if (this->elapsed < SHADER_WATCH_INTERVAL)
+		{
+			return changed;
+		}
+		this->elapsed = 0.0f;
+		this->scan(&changed);
+#endif
+		return changed;
+	}
+
+private:
+	std::string directory;
+	int fd;
+	int watch;
+	float elapsed;
+
+	// Fecha de cada archivo y la ultima revision que lo vio (los que no aparecen se borraron)
+	struct FileStamp
+	{
+		long long time;
+		unsigned int scan;
+	};
+	std::map<std::string, FileStamp> times;
+	std::string path;	// Se reusa en cada revision: sin cambios no se pide memoria
+	unsigned int scanCount;
+
+	void add(std::vector<std::string>& changed, const std::string& path)
+	{
+		if (std::find(changed.begin(), changed.end(), path) == changed.end())
+		{
+			changed.push_back(path);
+		}
+	}
+
+#ifdef _WIN32
+	// Actualiza times en su lugar y anota en changed (si no es nullptr) los nuevos o modificados
+	void scan(std::vector<std::string>* changed)
+	{
+		this->scanCount++;
+		struct _finddata_t data;
+		this->path.assign(this->directory).append("/*");
+		intptr_t handle = _findfirst(this->path.c_str(), &data);
+		if (handle != -1)
+		{
+			do
+			{
+				if (data.attrib & _A_SUBDIR)
+				{
+					continue;
+				}
+				this->path.assign(this->directory).append("/").append(data.name);
+				long long time = (long long)data.time_write;
+				std::map<std::string, FileStamp>::iterator it = this->times.find(this->path);
+				if (it == this->times.end())
+				{
+					FileStamp stamp = { time, this->scanCount };
+					this->times.insert(std::make_pair(this->path, stamp));
+				}
+				else
+				{
+					it->second.scan = this->scanCount;
+					if (it->second.time == time)
+					{
+						continue;
+					}
+					it->second.time = time;
+				}
+				if (changed != nullptr)
+				{
+					this->add(*changed, this->path);
+				}
+			} while (_findnext(handle, &data) == 0);
+			_findclose(handle);
+		}
+		for (std::map<std::string, FileStamp>::iterator it = this->times.begin(); it != this->times.end();)
+		{
+			if (it->second.scan != this->scanCount)
+			{
+				it = this->times.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+#endif
+};
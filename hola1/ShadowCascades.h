@@ -0,0 +1,246 @@
+#pragma once
+
+// Std. Includes
+#include <iostream>
+#include <cmath>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+// Numero de cascadas (debe coincidir con SHADOW_CASCADES de los shaders de iluminacion)
+const GLuint SHADOW_CASCADES = 3;
+
+// Resolucion de cada cascada
+const GLint SHADOW_MAP_SIZE = 2048;
+
+// Hasta donde llegan las sombras desde la camara
+const GLfloat SHADOW_DISTANCE = 120.0f;
+
+// Reparto de las cascadas: 0 = lineal, 1 = logaritmico
+const GLfloat SHADOW_SPLIT_LAMBDA = 0.8f;
+
+// Margen de cada cascada (fraccion del radio). El centro se ajusta a una rejilla de celdas de
+// 2 * margen * radio, asi la parte estatica solo se vuelve a dibujar al cruzar una celda.
+const GLfloat SHADOW_CACHE_MARGIN = 0.25f;
+
+// Unidad de textura del arreglo de sombras (0..3 G-buffer y Mesh::Draw, 10..12 clusters)
+const GLuint SHADOW_TEXTURE_UNIT = 13;
+
+// Sombras de la luz direccional con cascadas (Cascaded Shadow Maps).
+// Cada cascada es una proyeccion ortografica que cubre una rebanada del frustum de la camara;
+// el tamano depende solo de la forma del frustum y el centro se ajusta a la rejilla de texeles,
+// asi los bordes de las sombras no tiemblan al mover la camara.
+// La geometria estatica (casas, laboratorio, arboles, postes, piso) se guarda en un arreglo aparte
+// y solo se vuelve a dibujar cuando cambia la matriz de su cascada (el sol se mueve o la camara
+// sale de la celda). Cada cuadro se copia al arreglo final y encima se dibujan los objetos
+// dinamicos (Mew y Ho-oh).
+class ShadowCascades
+{
+public:
+	// Constructor, recibe la caja que contiene toda la escena (de ella sale el rango de profundidad)
+	// y crea los dos arreglos de profundidad con un framebuffer por capa
+	ShadowCascades(const glm::vec3& sceneMin, const glm::vec3& sceneMax, GLint resolution = SHADOW_MAP_SIZE)
+		: resolution(resolution), sceneMin(sceneMin), sceneMax(sceneMax)
+	{
+		glGenTextures(2, this->textures);
+		for (GLuint t = 0; t < 2; t++)
+		{
+			glBindTexture(GL_TEXTURE_2D_ARRAY, this->textures[t]);
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, resolution, resolution, SHADOW_CASCADES, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+			GLfloat border[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+			glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border);
+			// Comparacion en hardware: el sampler2DArrayShadow regresa 0..1 con filtro bilineal
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+		}
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+		glGenFramebuffers(SHADOW_CASCADES, this->staticFbos);
+		glGenFramebuffers(SHADOW_CASCADES, this->finalFbos);
+		for (GLuint i = 0; i < SHADOW_CASCADES; i++)
+		{
+			this->attachLayer(this->staticFbos[i], this->textures[0], i);
+			this->attachLayer(this->finalFbos[i], this->textures[1], i);
+			this->matrices[i] = glm::mat4(1.0f);
+			this->staticMatrices[i] = glm::mat4(0.0f); // Ninguna cascada en cache todavia
+			this->splits[i] = 0.0f;
+			this->texelSizes[i] = 0.0f;
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	~ShadowCascades()
+	{
+		glDeleteFramebuffers(SHADOW_CASCADES, this->staticFbos);
+		glDeleteFramebuffers(SHADOW_CASCADES, this->finalFbos);
+		glDeleteTextures(2, this->textures);
+	}
+
+	// Calcula las matrices de las cascadas para la camara y la direccion de la luz de este cuadro
+	void Update(const glm::mat4& view, const glm::mat4& projection, GLfloat zNear, const glm::vec3& lightDirection)
+	{
+		// Orientacion de la luz (sin traslacion: el centro se ajusta despues en espacio de luz)
+		glm::vec3 direction = glm::normalize(lightDirection);
+		glm::vec3 up = (fabs(direction.y) > 0.99f) ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), direction, up);
+
+		// Rango de profundidad: la escena completa, para que los objetos fuera de la rebanada proyecten sombra
+		GLfloat minZ = 1e30f, maxZ = -1e30f;
+		for (GLuint c = 0; c < 8; c++)
+		{
+			glm::vec3 corner((c & 1) ? this->sceneMax.x : this->sceneMin.x,
+				(c & 2) ? this->sceneMax.y : this->sceneMin.y,
+				(c & 4) ? this->sceneMax.z : this->sceneMin.z);
+			GLfloat z = (lightView * glm::vec4(corner, 1.0f)).z;
+			minZ = glm::min(minZ, z);
+			maxZ = glm::max(maxZ, z);
+		}
+
+		// Tamano del frustum (de la matriz de proyeccion) y base de la camara en el mundo
+		glm::mat4 inverseView = glm::inverse(view);
+		GLfloat tanX = 1.0f / projection[0][0];
+		GLfloat tanY = 1.0f / projection[1][1];
+
+		GLfloat splitNear = zNear;
+		for (GLuint i = 0; i < SHADOW_CASCADES; i++)
+		{
+			GLfloat p = (GLfloat)(i + 1) / SHADOW_CASCADES;
+			GLfloat logSplit = zNear * pow(SHADOW_DISTANCE / zNear, p);
+			GLfloat linearSplit = zNear + (SHADOW_DISTANCE - zNear) * p;
+			GLfloat splitFar = SHADOW_SPLIT_LAMBDA * logSplit + (1.0f - SHADOW_SPLIT_LAMBDA) * linearSplit;
+			this->splits[i] = splitFar;
+
+			// Esfera que envuelve la rebanada: no cambia al girar la camara, asi el tamano es estable
+			glm::vec3 corners[8];
+			glm::vec3 center(0.0f);
+			for (GLuint c = 0; c < 8; c++)
+			{
+				GLfloat d = (c & 4) ? splitFar : splitNear;
+				glm::vec4 viewCorner(((c & 1) ? 1.0f : -1.0f) * tanX * d, ((c & 2) ? 1.0f : -1.0f) * tanY * d, -d, 1.0f);
+				corners[c] = glm::vec3(inverseView * viewCorner);
+				center += corners[c];
+			}
+			center /= 8.0f;
+			GLfloat radius = 0.0f;
+			for (GLuint c = 0; c < 8; c++)
+			{
+				radius = glm::max(radius, glm::length(corners[c] - center));
+			}
+			radius = ceil(radius * 4.0f) / 4.0f;
+
+			// Ajuste del centro a la rejilla de la cache (multiplo de un texel)
+			GLfloat halfSize = radius * (1.0f + SHADOW_CACHE_MARGIN);
+			GLfloat texel = 2.0f * halfSize / this->resolution;
+			GLfloat step = glm::max(glm::floor(2.0f * SHADOW_CACHE_MARGIN * radius / texel), 1.0f) * texel;
+			glm::vec3 lightCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+			lightCenter.x = floor(lightCenter.x / step + 0.5f) * step;
+			lightCenter.y = floor(lightCenter.y / step + 0.5f) * step;
+
+			glm::mat4 lightProjection = glm::ortho(lightCenter.x - halfSize, lightCenter.x + halfSize,
+				lightCenter.y - halfSize, lightCenter.y + halfSize, -maxZ - 1.0f, -minZ + 1.0f);
+			this->matrices[i] = lightProjection * lightView;
+			this->texelSizes[i] = texel;
+
+			splitNear = splitFar;
+		}
+	}
+
+	// Prepara la capa estatica de la cascada. Regresa false si sigue en cache (no hay que dibujar nada)
+	// El shader de profundidad recibe GetMatrix(cascade) como lightSpaceMatrix
+	bool BeginStatic(GLuint cascade)
+	{
+		if (this->staticMatrices[cascade] == this->matrices[cascade])
+		{
+			return false;
+		}
+		this->staticMatrices[cascade] = this->matrices[cascade];
+
+		this->beginPass(this->staticFbos[cascade]);
+		glClear(GL_DEPTH_BUFFER_BIT);
+		return true;
+	}
+
+	// Copia la capa estatica a la final y la deja lista para dibujar los objetos dinamicos encima
+	void BeginDynamic(GLuint cascade)
+	{
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, this->staticFbos[cascade]);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->finalFbos[cascade]);
+		glBlitFramebuffer(0, 0, this->resolution, this->resolution, 0, 0, this->resolution, this->resolution, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+		this->beginPass(this->finalFbos[cascade]);
+	}
+
+	// Termina el paso de sombras y regresa al framebuffer por defecto
+	void End()
+	{
+		glDisable(GL_POLYGON_OFFSET_FILL);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	// Olvida la cache (la siguiente llamada a BeginStatic vuelve a dibujar todas las cascadas)
+	void Invalidate()
+	{
+		for (GLuint i = 0; i < SHADOW_CASCADES; i++)
+		{
+			this->staticMatrices[i] = glm::mat4(0.0f);
+		}
+	}
+
+	// Enlaza el arreglo de sombras y pone los uniforms de las cascadas (el programa debe estar activo)
+	void Bind(GLuint program)
+	{
+		glActiveTexture(GL_TEXTURE0 + SHADOW_TEXTURE_UNIT);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, this->textures[1]);
+		glActiveTexture(GL_TEXTURE0);
+
+		glUniform1i(glGetUniformLocation(program, "shadowMap"), SHADOW_TEXTURE_UNIT);
+		glUniformMatrix4fv(glGetUniformLocation(program, "cascadeMatrices"), SHADOW_CASCADES, GL_FALSE, glm::value_ptr(this->matrices[0]));
+		glUniform1fv(glGetUniformLocation(program, "cascadeSplits"), SHADOW_CASCADES, this->splits);
+		glUniform1fv(glGetUniformLocation(program, "cascadeTexelSizes"), SHADOW_CASCADES, this->texelSizes);
+	}
+
+	const glm::mat4& GetMatrix(GLuint cascade) const
+	{
+		return this->matrices[cascade];
+	}
+
+private:
+	GLint resolution;
+	glm::vec3 sceneMin;
+	glm::vec3 sceneMax;
+	GLuint textures[2]; // 0 = solo geometria estatica (cache), 1 = final con los objetos dinamicos
+	GLuint staticFbos[SHADOW_CASCADES];
+	GLuint finalFbos[SHADOW_CASCADES];
+	glm::mat4 matrices[SHADOW_CASCADES];
+	glm::mat4 staticMatrices[SHADOW_CASCADES];
+	GLfloat splits[SHADOW_CASCADES];
+	GLfloat texelSizes[SHADOW_CASCADES];
+
+	void attachLayer(GLuint fbo, GLuint texture, GLuint layer)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, layer);
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cout << "ERROR::SHADOW::FRAMEBUFFER_NOT_COMPLETE" << std::endl;
+		}
+	}
+
+	void beginPass(GLuint fbo)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		glViewport(0, 0, this->resolution, this->resolution);
+		// Pendiente + constante, contra el acne de sombra en superficies inclinadas
+		glEnable(GL_POLYGON_OFFSET_FILL);
+		glPolygonOffset(2.0f, 4.0f);
+	}
+};
@@ -0,0 +1,252 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// Distancia entre muestras de la tabla por longitud de arco (unidades del mundo)
+const GLfloat SPLINE_SAMPLE_SPACING = 0.25f;
+
+// Subdivisiones de cada tramo al medir su longitud
+const GLuint SPLINE_LENGTH_SUBDIVISIONS = 128;
+
+// Punto de un camino ya evaluado: posicion, direccion de avance (unitaria) y derecha horizontal
+struct SplinePoint
+{
+	glm::vec3 position;
+	glm::vec3 tangent;
+	glm::vec3 right;
+};
+
+// Camino Catmull-Rom centripeto (alfa = 0.5: no hace bucles ni picos aunque los puntos esten
+// disparejos) parametrizado por longitud de arco.
+// Al construirlo se mide la curva y se guarda una tabla de puntos separados SPLINE_SAMPLE_SPACING
+// a lo largo del camino, asi Evaluate(distancia) es O(1): un indice y una mezcla entre dos
+// muestras, sin raices ni normalize. Quien lo sigue solo avanza su distancia a velocidad constante.
+class SplinePath
+{
+public:
+	SplinePath()
+		: closed(true), length(0.0f), spacing(SPLINE_SAMPLE_SPACING), inverseSpacing(1.0f / SPLINE_SAMPLE_SPACING)
+	{
+	}
+
+	// Construye el camino por los puntos de control (cerrado: el ultimo se une con el primero)
+	bool Build(const std::vector<glm::vec3>& controlPoints, bool closed = true, GLfloat sampleSpacing = SPLINE_SAMPLE_SPACING)
+	{
+		this->samples.clear();
+		this->length = 0.0f;
+		if (controlPoints.size() < 2 || sampleSpacing <= 0.0f)
+		{
+			std::cout << "ERROR::SPLINE::NOT_ENOUGH_POINTS" << std::endl;
+			return false;
+		}
+		this->points = controlPoints;
+		this->closed = closed;
+
+		// Polinomios de cada tramo y su longitud acumulada en subdivisiones finas
+		GLuint segmentCount = closed ? (GLuint)controlPoints.size() : (GLuint)controlPoints.size() - 1;
+		this->segments.resize(segmentCount);
+		std::vector<GLfloat> arcLengths(segmentCount * SPLINE_LENGTH_SUBDIVISIONS + 1, 0.0f);
+		for (GLuint s = 0; s < segmentCount; s++)
+		{
+			this->buildSegment(s);
+			glm::vec3 previous = this->segmentPosition(s, 0.0f);
+			for (GLuint k = 1; k <= SPLINE_LENGTH_SUBDIVISIONS; k++)
+			{
+				glm::vec3 position = this->segmentPosition(s, (GLfloat)k / SPLINE_LENGTH_SUBDIVISIONS);
+				GLuint index = s * SPLINE_LENGTH_SUBDIVISIONS + k;
+				arcLengths[index] = arcLengths[index - 1] + glm::distance(previous, position);
+				previous = position;
+			}
+		}
+		this->length = arcLengths.back();
+		if (this->length <= 0.0f)
+		{
+			std::cout << "ERROR::SPLINE::ZERO_LENGTH" << std::endl;
+			return false;
+		}
+
+		// Tabla uniforme por distancia: se busca hacia adelante en las subdivisiones y se
+		// interpola el parametro dentro de la que contiene cada distancia
+		GLuint sampleCount = std::max(2u, (GLuint)ceil(this->length / sampleSpacing) + 1);
+		this->spacing = this->length / (sampleCount - 1);
+		this->inverseSpacing = 1.0f / this->spacing;
+		this->samples.resize(sampleCount);
+		GLuint fine = 0;
+		GLuint fineCount = (GLuint)arcLengths.size() - 1;
+		for (GLuint i = 0; i < sampleCount; i++)
+		{
+			GLfloat distance = std::min(i * this->spacing, this->length);
+			while (fine + 1 < fineCount && arcLengths[fine + 1] < distance)
+			{
+				fine++;
+			}
+			GLfloat span = arcLengths[fine + 1] - arcLengths[fine];
+			GLfloat blend = span > 0.0f ? glm::clamp((distance - arcLengths[fine]) / span, 0.0f, 1.0f) : 0.0f;
+			GLuint segment = fine / SPLINE_LENGTH_SUBDIVISIONS;
+			GLfloat t = ((fine % SPLINE_LENGTH_SUBDIVISIONS) + blend) / SPLINE_LENGTH_SUBDIVISIONS;
+
+			SplinePoint& sample = this->samples[i];
+			sample.position = this->segmentPosition(segment, t);
+			glm::vec3 derivative = this->segmentDerivative(segment, t);
+			sample.tangent = glm::length(derivative) > 1e-6f ? glm::normalize(derivative) : glm::vec3(0.0f, 0.0f, 1.0f);
+			glm::vec3 right = glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), sample.tangent);
+			sample.right = glm::length(right) > 1e-6f ? glm::normalize(right) : glm::vec3(1.0f, 0.0f, 0.0f);
+		}
+		if (closed)
+		{
+			this->samples.back() = this->samples.front();
+		}
+		return true;
+	}
+
+	// Camino cerrado al azar alrededor de un centro: un anillo de puntos con el radio y la altura
+	// movidos por la semilla (mismo camino con la misma semilla, sin tocar rand())
+	bool Generate(GLuint seed, const glm::vec3& center, GLfloat radius, GLfloat radiusJitter, GLfloat minY, GLfloat heightRange,
+		GLuint pointCount = 8, GLfloat sampleSpacing = SPLINE_SAMPLE_SPACING)
+	{
+		pointCount = std::max(3u, pointCount);
+		GLuint state = seed * 747796405u + 2891336453u;
+		std::vector<glm::vec3> controlPoints(pointCount);
+		for (GLuint i = 0; i < pointCount; i++)
+		{
+			GLfloat angle = (i + 0.6f * (nextRandom(state) - 0.5f)) * 6.28318531f / pointCount;
+			GLfloat pointRadius = radius * (1.0f + radiusJitter * (2.0f * nextRandom(state) - 1.0f));
+			controlPoints[i] = glm::vec3(center.x + pointRadius * cos(angle), minY + heightRange * nextRandom(state), center.z + pointRadius * sin(angle));
+		}
+		return this->Build(controlPoints, true, sampleSpacing);
+	}
+
+	// Punto a cierta distancia desde el inicio (los caminos cerrados dan la vuelta, los abiertos se detienen)
+	SplinePoint Evaluate(GLfloat distance) const
+	{
+		SplinePoint point;
+		this->evaluate(distance, point);
+		return point;
+	}
+
+	// Evalua muchos seguidores de este camino de una vez
+	void Evaluate(const GLfloat* distances, GLuint count, SplinePoint* points) const
+	{
+		for (GLuint i = 0; i < count; i++)
+		{
+			this->evaluate(distances[i], points[i]);
+		}
+	}
+
+	// Distancia dentro de [0, longitud) para que no pierda precision al acumularse
+	GLfloat Wrap(GLfloat distance) const
+	{
+		if (!this->closed || this->length <= 0.0f)
+		{
+			return glm::clamp(distance, 0.0f, this->length);
+		}
+		distance -= (GLfloat)(int)(distance / this->length) * this->length;
+		return distance < 0.0f ? distance + this->length : distance;
+	}
+
+	bool IsValid() const { return !this->samples.empty(); }
+	bool IsClosed() const { return this->closed; }
+	GLfloat GetLength() const { return this->length; }
+	GLuint GetSampleCount() const { return (GLuint)this->samples.size(); }
+	const std::vector<glm::vec3>& GetControlPoints() const { return this->points; }
+
+private:
+	// Tramo cubico entre dos puntos de control: p(t) = ((a t + b) t + c) t + d, t en [0, 1]
+	struct Segment
+	{
+		glm::vec3 a, b, c, d;
+	};
+
+	std::vector<glm::vec3> points;
+	std::vector<Segment> segments;
+	std::vector<SplinePoint> samples;
+	bool closed;
+	GLfloat length;
+	GLfloat spacing;
+	GLfloat inverseSpacing;
+
+	static GLfloat nextRandom(GLuint& state)
+	{
+		state = state * 1664525u + 1013904223u;
+		return (state >> 8) * (1.0f / 16777216.0f);
+	}
+
+	glm::vec3 controlPoint(int index) const
+	{
+		int count = (int)this->points.size();
+		if (this->closed)
+		{
+			return this->points[(index % count + count) % count];
+		}
+		// Caminos abiertos: se reflejan los extremos para tener vecinos
+		if (index < 0)
+		{
+			return 2.0f * this->points[0] - this->points[1];
+		}
+		if (index >= count)
+		{
+			return 2.0f * this->points[count - 1] - this->points[count - 2];
+		}
+		return this->points[index];
+	}
+
+	// Catmull-Rom centripeto como Hermite: tangentes con los nudos t_i+1 = t_i + |P_i+1 - P_i|^0.5
+	void buildSegment(GLuint s)
+	{
+		glm::vec3 p0 = this->controlPoint((int)s - 1);
+		glm::vec3 p1 = this->controlPoint((int)s);
+		glm::vec3 p2 = this->controlPoint((int)s + 1);
+		glm::vec3 p3 = this->controlPoint((int)s + 2);
+		GLfloat dt0 = std::max((GLfloat)sqrt(glm::distance(p0, p1)), 1e-4f);
+		GLfloat dt1 = std::max((GLfloat)sqrt(glm::distance(p1, p2)), 1e-4f);
+		GLfloat dt2 = std::max((GLfloat)sqrt(glm::distance(p2, p3)), 1e-4f);
+		glm::vec3 m1 = ((p1 - p0) / dt0 - (p2 - p0) / (dt0 + dt1) + (p2 - p1) / dt1) * dt1;
+		glm::vec3 m2 = ((p2 - p1) / dt1 - (p3 - p1) / (dt1 + dt2) + (p3 - p2) / dt2) * dt1;
+
+		Segment& segment = this->segments[s];
+		segment.a = 2.0f * p1 - 2.0f * p2 + m1 + m2;
+		segment.b = -3.0f * p1 + 3.0f * p2 - 2.0f * m1 - m2;
+		segment.c = m1;
+		segment.d = p1;
+	}
+
+	glm::vec3 segmentPosition(GLuint s, GLfloat t) const
+	{
+		const Segment& segment = this->segments[s];
+		return ((segment.a * t + segment.b) * t + segment.c) * t + segment.d;
+	}
+
+	glm::vec3 segmentDerivative(GLuint s, GLfloat t) const
+	{
+		const Segment& segment = this->segments[s];
+		return (3.0f * segment.a * t + 2.0f * segment.b) * t + segment.c;
+	}
+
+	void evaluate(GLfloat distance, SplinePoint& point) const
+	{
+		if (this->samples.size() < 2)
+		{
+			point.position = this->points.empty() ? glm::vec3(0.0f) : this->points[0];
+			point.tangent = glm::vec3(0.0f, 0.0f, 1.0f);
+			point.right = glm::vec3(1.0f, 0.0f, 0.0f);
+			return;
+		}
+		GLfloat f = this->Wrap(distance) * this->inverseSpacing;
+		GLuint last = (GLuint)this->samples.size() - 1;
+		GLuint index = std::min((GLuint)f, last - 1);
+		GLfloat blend = f - index;
+		const SplinePoint& a = this->samples[index];
+		const SplinePoint& b = this->samples[index + 1];
+		point.position = a.position + (b.position - a.position) * blend;
+		point.tangent = a.tangent + (b.tangent - a.tangent) * blend;
+		point.right = a.right + (b.right - a.right) * blend;
+	}
+};
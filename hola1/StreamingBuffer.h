@@ -0,0 +1,225 @@
+#pragma once
+
+// Std. Includes
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+// GL Includes
+#include <GL/glew.h>
+
+// Cuadros que el CPU puede ir adelante de la GPU (una region del anillo por cuadro)
+const GLuint STREAMING_BUFFER_FRAMES = 3;
+
+// Bytes por cuadro del buffer de la escena (huesos, instancias, clusters y uniforms del cuadro)
+const GLsizeiptr STREAMING_BUFFER_FRAME_SIZE = 1024 * 1024;
+
+// Un pedazo del cuadro: donde escribir y en que offset del buffer quedo (data es NULL si no cupo)
+struct StreamAllocation
+{
+	GLvoid* data;
+	GLintptr offset;
+	GLsizeiptr size;
+};
+
+// Buffer de datos que cambian cada cuadro.
+// Un solo buffer partido en STREAMING_BUFFER_FRAMES regiones; cada cuadro se escribe en la
+// siguiente y se deja un fence al terminar de dibujar, asi la region solo se vuelve a tocar
+// cuando la GPU ya la leyo. Con GL_ARB_buffer_storage el buffer queda mapeado para siempre
+// (persistente y coherente) y subir es un memcpy; si no, cada cuadro se mapea su region con
+// GL_MAP_UNSYNCHRONIZED_BIT (el fence ya hace la espera que el driver haria por su cuenta).
+// Cada cuadro: BeginFrame(), Allocate() por cada dato, Flush() antes de dibujar con ellos y
+// EndFrame() despues del ultimo dibujo que los lea. Los datos se enlazan por offset:
+// glBindBufferRange para uniform blocks, o un texel inicial con GetTexture() para texture buffers.
+class StreamingBuffer
+{
+public:
+	// allowPersistent = false obliga al mapeo por cuadro aunque haya GL_ARB_buffer_storage (para comparar)
+	StreamingBuffer(GLsizeiptr frameSize = STREAMING_BUFFER_FRAME_SIZE, bool allowPersistent = true)
+		: buffer(0), frameSize(frameSize), persistent(false), mapped(NULL), mappedOffset(0), frame(0), cursor(0), peak(0), uniformAlignment(256), maxTexels(0), texelLimitReported(false), waitMs(0.0)
+	{
+		for (GLuint i = 0; i < STREAMING_BUFFER_FRAMES; i++)
+		{
+			this->fences[i] = 0;
+		}
+		GLsizeiptr size = this->frameSize * STREAMING_BUFFER_FRAMES;
+
+		// GL_COPY_WRITE_BUFFER para no mover lo que este enlazado en los demas targets
+		glGenBuffers(1, &this->buffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, this->buffer);
+		if (allowPersistent && GLEW_ARB_buffer_storage)
+		{
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_COPY_WRITE_BUFFER, size, NULL, flags);
+			this->mapped = (GLubyte*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags);
+			this->persistent = this->mapped != NULL;
+		}
+		if (!this->persistent)
+		{
+			glBufferData(GL_COPY_WRITE_BUFFER, size, NULL, GL_STREAM_DRAW);
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &this->uniformAlignment);
+		glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &this->maxTexels);
+	}
+
+	~StreamingBuffer()
+	{
+		for (GLuint i = 0; i < STREAMING_BUFFER_FRAMES; i++)
+		{
+			if (this->fences[i] != 0)
+			{
+				glDeleteSync(this->fences[i]);
+			}
+		}
+		for (std::map<GLenum, GLuint>::iterator it = this->textures.begin(); it != this->textures.end(); ++it)
+		{
+			glDeleteTextures(1, &it->second);
+		}
+		if (this->mapped != NULL)
+		{
+			glBindBuffer(GL_COPY_WRITE_BUFFER, this->buffer);
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		}
+		glDeleteBuffers(1, &this->buffer);
+	}
+
+	// Pasa a la siguiente region; si la GPU todavia lee lo de hace STREAMING_BUFFER_FRAMES cuadros, espera
+	void BeginFrame()
+	{
+		this->frame = (this->frame + 1) % STREAMING_BUFFER_FRAMES;
+		this->cursor = 0;
+		this->waitMs = 0.0;
+		GLsync& fence = this->fences[this->frame];
+		if (fence == 0)
+		{
+			return;
+		}
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		while (true)
+		{
+			GLenum result = glClientWaitSync(fence, flags, 1000000);	// 1 ms por intento
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+			{
+				break;
+			}
+			flags = 0;
+		}
+		glDeleteSync(fence);
+		fence = 0;
+		this->waitMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	// Aparta size bytes del cuadro con el offset (en todo el buffer) multiplo de alignment.
+	// Si se va a leer con GetTexture(), texelSize es el tamano de su texel: los texture buffers solo
+	// ven los primeros GL_MAX_TEXTURE_BUFFER_SIZE texeles del buffer (contando desde el inicio, no
+	// desde la region) y lo que quede mas alla no se aparta
+	StreamAllocation Allocate(GLsizeiptr size, GLsizeiptr alignment = 16, GLsizeiptr texelSize = 0)
+	{
+		StreamAllocation allocation = { NULL, 0, size };
+		GLintptr base = this->frame * this->frameSize;
+		GLintptr offset = (base + this->cursor + alignment - 1) / alignment * alignment;
+		if (offset + size > base + this->frameSize)
+		{
+			std::cout << "ERROR::STREAMING_BUFFER::FULL " << size << " bytes" << std::endl;
+			return allocation;
+		}
+		if (texelSize > 0 && (offset + size + texelSize - 1) / texelSize > (GLintptr)this->maxTexels)
+		{
+			if (!this->texelLimitReported)
+			{
+				std::cout << "ERROR::STREAMING_BUFFER::TEXEL_LIMIT " << this->maxTexels << " texeles, el cuadro usa hasta "
+					<< (offset + size + texelSize - 1) / texelSize << std::endl;
+				this->texelLimitReported = true;
+			}
+			return allocation;
+		}
+		if (!this->persistent && this->mapped == NULL)
+		{
+			// Sin almacenamiento persistente se mapea lo que queda de la region, sin esperar al driver
+			this->mappedOffset = base + this->cursor;
+			glBindBuffer(GL_COPY_WRITE_BUFFER, this->buffer);
+			this->mapped = (GLubyte*)glMapBufferRange(GL_COPY_WRITE_BUFFER, this->mappedOffset, base + this->frameSize - this->mappedOffset,
+				GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+			if (this->mapped == NULL)
+			{
+				std::cout << "ERROR::STREAMING_BUFFER::MAP_FAILED" << std::endl;
+				return allocation;
+			}
+		}
+		allocation.data = this->mapped + (offset - this->mappedOffset);
+		allocation.offset = offset;
+		this->cursor = offset + size - base;
+		this->peak = std::max(this->peak, this->cursor);
+		return allocation;
+	}
+
+	// Lo escrito queda listo para dibujar (sin almacenamiento persistente se desmapea; lo
+	// siguiente que se aparte vuelve a mapear el resto de la region)
+	void Flush()
+	{
+		if (this->persistent || this->mapped == NULL)
+		{
+			return;
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, this->buffer);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		this->mapped = NULL;
+	}
+
+	// Despues del ultimo dibujo del cuadro: la region queda protegida hasta que la GPU pase por aqui
+	void EndFrame()
+	{
+		this->Flush();
+		this->fences[this->frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	// Texture buffer sobre todo el buffer con ese formato (uno por formato, se crea la primera vez).
+	// Quien lo usa pasa al shader su primer texel: offset / tamano del texel
+	GLuint GetTexture(GLenum format)
+	{
+		std::map<GLenum, GLuint>::iterator it = this->textures.find(format);
+		if (it != this->textures.end())
+		{
+			return it->second;
+		}
+		GLuint texture;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_BUFFER, texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, format, this->buffer);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+		this->textures[format] = texture;
+		return texture;
+	}
+
+	GLuint GetBuffer() const { return this->buffer; }
+	GLsizeiptr GetFrameSize() const { return this->frameSize; }
+	GLsizeiptr GetUniformAlignment() const { return this->uniformAlignment; }
+	GLint GetMaxTexels() const { return this->maxTexels; }	// Los texture buffers solo ven los primeros (ver Allocate())
+	bool IsPersistent() const { return this->persistent; }
+	GLsizeiptr GetUsed() const { return this->cursor; }		// Bytes apartados en el cuadro
+	GLsizeiptr GetPeak() const { return this->peak; }		// Lo mas que se ha apartado en un cuadro
+	double GetWaitMs() const { return this->waitMs; }		// Lo que espero BeginFrame() a la GPU
+
+private:
+	GLuint buffer;
+	GLsizeiptr frameSize;
+	bool persistent;
+	GLubyte* mapped;		// Persistente: todo el buffer; si no, desde mappedOffset hasta el fin de la region
+	GLintptr mappedOffset;
+	GLuint frame;
+	GLsizeiptr cursor;		// Bytes usados de la region del cuadro
+	GLsizeiptr peak;
+	GLsync fences[STREAMING_BUFFER_FRAMES];
+	GLint uniformAlignment;
+	GLint maxTexels;
+	bool texelLimitReported;	// El error de Allocate() sale una vez, no cada cuadro
+	double waitMs;
+	std::map<GLenum, GLuint> textures;
+};
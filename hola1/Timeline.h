@@ -0,0 +1,702 @@
+#pragma once
+
+// Std. Includes
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <map>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Tipo de valor de una pista (el numero es cuantos floats tiene cada llave)
+enum Timeline_Value
+{
+	TIMELINE_FLOAT = 1,
+	TIMELINE_VEC3 = 3,
+	TIMELINE_QUAT = 4	// x, y, z, w (el orden de glm::quat)
+};
+
+// Como se pasa de una llave a la siguiente
+enum Timeline_Interpolation
+{
+	TIMELINE_STEP,		// Se queda en la llave hasta la siguiente
+	TIMELINE_LINEAR,	// Lineal (nlerp en los cuaterniones)
+	TIMELINE_SMOOTH		// Entra y sale despacio (smoothstep entre llaves)
+};
+
+// Encabezado del formato binario
+const char TIMELINE_MAGIC[4] = { 'T', 'L', 'N', '1' };
+
+// Pista de una propiedad animada. Sus llaves van seguidas en los arreglos de la Timeline
+// (tiempos en times, valores en values) y su valor del cuadro en outputs.
+struct TimelineTrack
+{
+	GLuint components;		// Timeline_Value
+	GLuint interpolation;	// Timeline_Interpolation
+	bool loop;				// Se repite cada 'duration' (si no, se queda en la ultima llave)
+	GLuint firstKey;
+	GLuint keyCount;
+	GLuint firstValue;
+	GLuint output;
+	GLuint segment;			// Su tramo actual en los segmentos de su tipo
+	GLuint key;				// Llave con la que empieza ese tramo
+};
+
+// Cursor de una pista: el tramo entre dos llaves en el que va, con los dos valores ya
+// copiados (y el cuaternion b del mismo lado que a). Mientras el tiempo siga en el tramo
+// Evaluate solo lee esta estructura (64 bytes la de cuaterniones) y escribe el valor;
+// al salir se carga el siguiente desde las llaves.
+template <GLuint COMPONENTS>
+struct TimelineSegment
+{
+	GLfloat start;			// Tiempo de la llave a (-infinito antes de la primera llave)
+	GLfloat end;			// Tiempo de la llave b (infinito despues de la ultima)
+	GLfloat inverseSpan;	// 1 / (end - start), 0 si el valor es fijo en el tramo
+	GLfloat duration;		// Ciclo de la pista
+	GLfloat inverseDuration;	// 1 / duration si se repite (si no, 0)
+	GLuint smooth;
+	GLuint track;
+	GLuint output;
+	GLfloat a[COMPONENTS];
+	GLfloat b[COMPONENTS];
+};
+
+// Linea de tiempo con llaves de muchas propiedades (float, vec3 o cuaternion).
+// Todas las pistas se evaluan juntas en Evaluate() sobre arreglos seguidos, sin llamadas
+// virtuales: cada pista guarda su llave actual (cursor), asi mientras el tiempo avanza solo
+// se compara con la siguiente llave; si regresa (o da la vuelta) se busca en binario.
+// Los valores se copian a variables del programa con Bind()/Apply() o a uniforms con
+// BindUniform()/ApplyUniforms().
+//
+// Formato de texto (Load lo distingue del binario por el encabezado):
+//   # comentario
+//   track <nombre> <float|vec3|quat> <step|linear|smooth> <loop|clamp>
+//   <tiempo> <valores...>      una llave por linea; quat es eje x y z y angulo en grados
+class Timeline
+{
+public:
+	Timeline() : keyCount(0), bindingsDirty(false) {}
+
+	void Clear()
+	{
+		this->tracks.clear();
+		this->names.clear();
+		this->times.clear();
+		this->values.clear();
+		this->outputs.clear();
+		this->floatSegments.clear();
+		this->vec3Segments.clear();
+		this->quatSegments.clear();
+		this->indices.clear();
+		this->keyCount = 0;
+		this->bindingsDirty = true;
+	}
+
+	// Agrega una pista con sus llaves (tiempos crecientes, components floats por llave); regresa su indice
+	GLint AddTrack(const std::string& name, Timeline_Value type, Timeline_Interpolation interpolation, bool loop,
+		const std::vector<GLfloat>& keyTimes, const std::vector<GLfloat>& keyValues)
+	{
+		GLuint components = (GLuint)type;
+		if (keyTimes.empty() || keyValues.size() != keyTimes.size() * components)
+		{
+			std::cout << "ERROR::TIMELINE::TRACK_INVALID " << name << std::endl;
+			return -1;
+		}
+		for (size_t i = 1; i < keyTimes.size(); i++)
+		{
+			if (keyTimes[i] < keyTimes[i - 1])
+			{
+				std::cout << "ERROR::TIMELINE::KEYS_OUT_OF_ORDER " << name << std::endl;
+				return -1;
+			}
+		}
+
+		GLint index = (GLint)this->tracks.size();
+		TimelineTrack track;
+		track.components = components;
+		track.interpolation = interpolation;
+		track.loop = loop;
+		track.firstKey = (GLuint)this->times.size();
+		track.keyCount = (GLuint)keyTimes.size();
+		track.firstValue = (GLuint)this->values.size();
+		track.output = (GLuint)this->outputs.size();
+		track.key = 0;
+		this->times.insert(this->times.end(), keyTimes.begin(), keyTimes.end());
+		this->values.insert(this->values.end(), keyValues.begin(), keyValues.end());
+		this->outputs.insert(this->outputs.end(), keyValues.begin(), keyValues.begin() + components);
+		if (components == TIMELINE_FLOAT)
+		{
+			track.segment = this->addSegment(this->floatSegments, track, index);
+		}
+		else if (components == TIMELINE_VEC3)
+		{
+			track.segment = this->addSegment(this->vec3Segments, track, index);
+		}
+		else
+		{
+			track.segment = this->addSegment(this->quatSegments, track, index);
+		}
+		this->tracks.push_back(track);
+		this->names.push_back(name);
+		this->keyCount += track.keyCount;
+		this->indices[name] = index;
+
+		// Los enlaces se resuelven en el siguiente Apply (puede haber variables esperando este nombre)
+		this->bindingsDirty = true;
+		return index;
+	}
+
+	// Carga un archivo de texto o binario (reemplaza las pistas; los enlaces se conservan por nombre)
+	bool Load(const std::string& path)
+	{
+		std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			std::cout << "ERROR::TIMELINE::FILE_NOT_SUCCESFULLY_READ " << path << std::endl;
+			return false;
+		}
+		std::string data((size_t)file.tellg(), '\0');
+		file.seekg(0);
+		file.read(&data[0], data.size());
+		this->Clear();
+		bool loaded = data.size() >= sizeof(TIMELINE_MAGIC) && 0 == memcmp(data.data(), TIMELINE_MAGIC, sizeof(TIMELINE_MAGIC))
+			? this->parseBinary(data) : this->parseText(data);
+		if (!loaded)
+		{
+			std::cout << "ERROR::TIMELINE::PARSE " << path << std::endl;
+			this->Clear();
+		}
+		return loaded;
+	}
+
+	// Guarda en binario: encabezado, numero de pistas y por pista su nombre, tipo y llaves tal cual
+	bool SaveBinary(const std::string& path) const
+	{
+		std::ofstream file(path.c_str(), std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+		file.write(TIMELINE_MAGIC, sizeof(TIMELINE_MAGIC));
+		writeValue(file, (GLuint)this->tracks.size());
+		for (GLuint t = 0; t < this->tracks.size(); t++)
+		{
+			const TimelineTrack& track = this->tracks[t];
+			writeValue(file, (GLuint)this->names[t].size());
+			file.write(this->names[t].data(), this->names[t].size());
+			GLubyte info[4] = { (GLubyte)track.components, (GLubyte)track.interpolation, (GLubyte)track.loop, 0 };
+			file.write((const char*)info, sizeof(info));
+			writeValue(file, track.keyCount);
+			file.write((const char*)&this->times[track.firstKey], track.keyCount * sizeof(GLfloat));
+			file.write((const char*)&this->values[track.firstValue], track.keyCount * track.components * sizeof(GLfloat));
+		}
+		return (bool)file;
+	}
+
+	// Guarda en el formato de texto (los cuaterniones como eje y angulo)
+	bool SaveText(const std::string& path) const
+	{
+		std::ofstream file(path.c_str());
+		if (!file)
+		{
+			return false;
+		}
+		const char* typeNames[] = { "", "float", "", "vec3", "quat" };
+		const char* interpolationNames[] = { "step", "linear", "smooth" };
+		file.precision(9);
+		for (GLuint t = 0; t < this->tracks.size(); t++)
+		{
+			const TimelineTrack& track = this->tracks[t];
+			file << "track " << this->names[t] << " " << typeNames[track.components] << " " << interpolationNames[track.interpolation]
+				<< " " << (track.loop ? "loop" : "clamp") << "\n";
+			for (GLuint k = 0; k < track.keyCount; k++)
+			{
+				const GLfloat* value = &this->values[track.firstValue + k * track.components];
+				file << this->times[track.firstKey + k];
+				if (track.components == TIMELINE_QUAT)
+				{
+					glm::quat q(value[3], value[0], value[1], value[2]);
+					glm::vec3 axis = glm::axis(q);
+					file << " " << axis.x << " " << axis.y << " " << axis.z << " " << glm::degrees(glm::angle(q));
+				}
+				else
+				{
+					for (GLuint c = 0; c < track.components; c++)
+					{
+						file << " " << value[c];
+					}
+				}
+				file << "\n";
+			}
+		}
+		return (bool)file;
+	}
+
+	// Evalua todas las pistas en ese tiempo (segundos), un recorrido por tipo de valor
+	void Evaluate(GLfloat time)
+	{
+		this->evaluateSegments(this->floatSegments, time);
+		this->evaluateSegments(this->vec3Segments, time);
+		this->evaluateSegments(this->quatSegments, time);
+	}
+
+	// Enlaza una variable a la pista con ese nombre (del mismo tipo); Apply() le copia su valor
+	void Bind(const std::string& track, GLfloat* target)
+	{
+		this->addBinding(track, TIMELINE_FLOAT, target);
+	}
+
+	void Bind(const std::string& track, glm::vec3* target)
+	{
+		this->addBinding(track, TIMELINE_VEC3, &(*target)[0]);
+	}
+
+	void Bind(const std::string& track, glm::quat* target)
+	{
+		this->addBinding(track, TIMELINE_QUAT, &(*target)[0]);
+	}
+
+	// Enlaza un uniform (float, vec3 o vec4) a la pista; ApplyUniforms() lo pone en un programa
+	void BindUniform(const std::string& track, const std::string& uniform)
+	{
+		Binding binding = { track, uniform, 0, nullptr };
+		this->uniformBindings.push_back(binding);
+		this->bindingsDirty = true;
+	}
+
+	// Copia los valores del cuadro a las variables enlazadas
+	void Apply()
+	{
+		this->resolveBindings();
+		for (const Target& target : this->targets)
+		{
+			const GLfloat* value = &this->outputs[target.output];
+			target.value[0] = value[0];
+			if (target.components > 1)
+			{
+				target.value[1] = value[1];
+				target.value[2] = value[2];
+				if (target.components > 3)
+				{
+					target.value[3] = value[3];
+				}
+			}
+		}
+	}
+
+	// Pone los uniforms enlazados en el programa activo
+	void ApplyUniforms(GLuint program)
+	{
+		this->resolveBindings();
+		for (const Target& target : this->uniformTargets)
+		{
+			const Binding& binding = this->uniformBindings[target.binding];
+			GLint location = glGetUniformLocation(program, binding.uniform.c_str());
+			const GLfloat* value = &this->outputs[target.output];
+			if (target.components == TIMELINE_FLOAT)
+			{
+				glUniform1fv(location, 1, value);
+			}
+			else if (target.components == TIMELINE_VEC3)
+			{
+				glUniform3fv(location, 1, value);
+			}
+			else
+			{
+				glUniform4fv(location, 1, value);
+			}
+		}
+	}
+
+	// Indice de la pista con ese nombre (-1 si no existe)
+	GLint Find(const std::string& name) const
+	{
+		std::map<std::string, GLint>::const_iterator it = this->indices.find(name);
+		return it != this->indices.end() ? it->second : -1;
+	}
+
+	// Valor del ultimo Evaluate
+	const GLfloat* GetValue(GLuint track) const
+	{
+		return &this->outputs[this->tracks[track].output];
+	}
+
+	GLuint GetTrackCount() const
+	{
+		return (GLuint)this->tracks.size();
+	}
+
+	GLuint GetKeyCount() const
+	{
+		return this->keyCount;
+	}
+
+	const TimelineTrack& GetTrack(GLuint track) const
+	{
+		return this->tracks[track];
+	}
+
+	const std::string& GetTrackName(GLuint track) const
+	{
+		return this->names[track];
+	}
+
+private:
+	struct Binding
+	{
+		std::string track;
+		std::string uniform;
+		GLuint components;	// 0 en los uniforms (toman el tipo de la pista)
+		GLfloat* target;
+	};
+
+	// Enlace resuelto: solo lo que Apply necesita
+	struct Target
+	{
+		GLuint output;
+		GLuint components;
+		GLfloat* value;
+		GLuint binding;
+	};
+
+	std::vector<TimelineTrack> tracks;
+	std::vector<std::string> names;
+	std::vector<GLfloat> times;		// Tiempos de las llaves de todas las pistas
+	std::vector<GLfloat> values;	// Valores de las llaves de todas las pistas
+	std::vector<GLfloat> outputs;	// Valor actual de todas las pistas
+	std::vector<TimelineSegment<TIMELINE_FLOAT> > floatSegments;
+	std::vector<TimelineSegment<TIMELINE_VEC3> > vec3Segments;
+	std::vector<TimelineSegment<TIMELINE_QUAT> > quatSegments;
+	std::vector<Binding> bindings;
+	std::vector<Binding> uniformBindings;
+	std::vector<Target> targets;
+	std::vector<Target> uniformTargets;
+	std::map<std::string, GLint> indices;
+	GLuint keyCount;
+	bool bindingsDirty;
+
+	void addBinding(const std::string& track, Timeline_Value type, GLfloat* target)
+	{
+		Binding binding = { track, "", (GLuint)type, target };
+		this->bindings.push_back(binding);
+		this->bindingsDirty = true;
+	}
+
+	// Busca la pista de cada enlace (al cargar cambian los indices); las que no existen o
+	// son de otro tipo se ignoran
+	void resolveBindings()
+	{
+		if (!this->bindingsDirty)
+		{
+			return;
+		}
+		this->bindingsDirty = false;
+		this->targets.clear();
+		this->uniformTargets.clear();
+		for (GLuint b = 0; b < this->bindings.size(); b++)
+		{
+			GLint index = this->Find(this->bindings[b].track);
+			if (index >= 0 && this->tracks[index].components == this->bindings[b].components)
+			{
+				Target target = { this->tracks[index].output, this->tracks[index].components, this->bindings[b].target, b };
+				this->targets.push_back(target);
+			}
+		}
+		for (GLuint b = 0; b < this->uniformBindings.size(); b++)
+		{
+			GLint index = this->Find(this->uniformBindings[b].track);
+			if (index >= 0)
+			{
+				Target target = { this->tracks[index].output, this->tracks[index].components, nullptr, b };
+				this->uniformTargets.push_back(target);
+			}
+		}
+	}
+
+	template <GLuint COMPONENTS>
+	GLuint addSegment(std::vector<TimelineSegment<COMPONENTS> >& segments, TimelineTrack& track, GLint index)
+	{
+		TimelineSegment<COMPONENTS> segment;
+		segment.duration = this->times[track.firstKey + track.keyCount - 1];
+		segment.inverseDuration = track.loop && segment.duration > 0.0f ? 1.0f / segment.duration : 0.0f;
+		segment.smooth = track.interpolation == TIMELINE_SMOOTH;
+		segment.track = index;
+		segment.output = track.output;
+		this->loadSegment(segment, track, -1e30f);
+		segments.push_back(segment);
+		return (GLuint)segments.size() - 1;
+	}
+
+	// Busca el tramo de la pista que contiene local (desde la llave del cursor) y copia sus valores
+	template <GLuint COMPONENTS>
+	void loadSegment(TimelineSegment<COMPONENTS>& segment, TimelineTrack& track, GLfloat local) const
+	{
+		const GLfloat* keyTimes = &this->times[track.firstKey];
+		GLuint last = track.keyCount - 1;
+		GLuint key = track.key;
+		if (local < keyTimes[key])
+		{
+			key = (GLuint)(std::upper_bound(keyTimes, keyTimes + track.keyCount, local) - keyTimes);
+			key = key > 0 ? key - 1 : 0;
+		}
+		else
+		{
+			while (key < last && keyTimes[key + 1] <= local)
+			{
+				key++;
+			}
+		}
+		track.key = key;
+
+		const GLfloat* a = &this->values[track.firstValue + key * COMPONENTS];
+		const GLfloat* b = a;
+		segment.inverseSpan = 0.0f;
+		if (local < keyTimes[0])
+		{
+			// Antes de la primera llave se queda en ella
+			segment.start = -1e30f;
+			segment.end = keyTimes[0];
+		}
+		else if (key == last)
+		{
+			segment.start = keyTimes[last];
+			segment.end = 1e30f;
+		}
+		else
+		{
+			segment.start = keyTimes[key];
+			segment.end = keyTimes[key + 1];
+			if (track.interpolation != TIMELINE_STEP && segment.end > segment.start)
+			{
+				b = a + COMPONENTS;
+				segment.inverseSpan = 1.0f / (segment.end - segment.start);
+			}
+		}
+
+		// Cuaterniones por el camino corto (q y -q son la misma rotacion)
+		GLfloat sign = 1.0f;
+		if (COMPONENTS == TIMELINE_QUAT && a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] < 0.0f)
+		{
+			sign = -1.0f;
+		}
+		for (GLuint c = 0; c < COMPONENTS; c++)
+		{
+			segment.a[c] = a[c];
+			segment.b[c] = b[c] * sign;
+		}
+	}
+
+	// Evalua las pistas de un tipo (COMPONENTS fijo: el compilador desenrolla las mezclas)
+	template <GLuint COMPONENTS>
+	void evaluateSegments(std::vector<TimelineSegment<COMPONENTS> >& segments, GLfloat time)
+	{
+		for (TimelineSegment<COMPONENTS>& segment : segments)
+		{
+			GLfloat local = time;
+			if (segment.inverseDuration > 0.0f)
+			{
+				// Vueltas completas truncando a entero (std::floor es una llamada sin SSE4.1)
+				local = time - segment.duration * (GLfloat)(GLint)(time * segment.inverseDuration);
+				if (local < 0.0f)
+				{
+					local += segment.duration;
+				}
+			}
+			if (local < segment.start || local >= segment.end)
+			{
+				this->loadSegment(segment, this->tracks[segment.track], local);
+			}
+
+			GLfloat weight = std::min(std::max((local - segment.start) * segment.inverseSpan, 0.0f), 1.0f);
+			if (segment.smooth)
+			{
+				weight = weight * weight * (3.0f - 2.0f * weight);
+			}
+			GLfloat* out = &this->outputs[segment.output];
+			for (GLuint c = 0; c < COMPONENTS; c++)
+			{
+				out[c] = segment.a[c] + (segment.b[c] - segment.a[c]) * weight;
+			}
+			if (COMPONENTS == TIMELINE_QUAT)
+			{
+				// nlerp
+				GLfloat inverseLength = 1.0f / std::sqrt(out[0] * out[0] + out[1] * out[1] + out[2] * out[2] + out[3] * out[3]);
+				for (GLuint c = 0; c < COMPONENTS; c++)
+				{
+					out[c] *= inverseLength;
+				}
+			}
+		}
+	}
+
+	template <typename T>
+	static void writeValue(std::ofstream& file, T value)
+	{
+		file.write((const char*)&value, sizeof(T));
+	}
+
+	template <typename T>
+	static bool readValue(const std::string& data, size_t& offset, T& value)
+	{
+		if (offset + sizeof(T) > data.size())
+		{
+			return false;
+		}
+		memcpy(&value, data.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+
+	bool parseBinary(const std::string& data)
+	{
+		size_t offset = sizeof(TIMELINE_MAGIC);
+		GLuint trackCount = 0;
+		if (!readValue(data, offset, trackCount))
+		{
+			return false;
+		}
+		std::vector<GLfloat> keyTimes, keyValues;
+		for (GLuint t = 0; t < trackCount; t++)
+		{
+			GLuint nameLength = 0, keys = 0;
+			GLubyte info[4];
+			if (!readValue(data, offset, nameLength) || offset + nameLength > data.size())
+			{
+				return false;
+			}
+			std::string name = data.substr(offset, nameLength);
+			offset += nameLength;
+			if (!readValue(data, offset, info) || !readValue(data, offset, keys))
+			{
+				return false;
+			}
+			GLuint components = info[0];
+			if ((components != TIMELINE_FLOAT && components != TIMELINE_VEC3 && components != TIMELINE_QUAT) || info[1] > TIMELINE_SMOOTH
+				|| offset + (size_t)keys * (1 + components) * sizeof(GLfloat) > data.size())
+			{
+				return false;
+			}
+			keyTimes.resize(keys);
+			keyValues.resize(keys * components);
+			memcpy(keyTimes.data(), data.data() + offset, keys * sizeof(GLfloat));
+			offset += keys * sizeof(GLfloat);
+			memcpy(keyValues.data(), data.data() + offset, keys * components * sizeof(GLfloat));
+			offset += keys * components * sizeof(GLfloat);
+			if (this->AddTrack(name, (Timeline_Value)components, (Timeline_Interpolation)info[1], info[2] != 0, keyTimes, keyValues) < 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool parseText(const std::string& data)
+	{
+		std::string name;
+		GLuint components = 0, interpolation = TIMELINE_LINEAR;
+		bool loop = false, inTrack = false;
+		std::vector<GLfloat> keyTimes, keyValues;
+		GLuint lineNumber = 0;
+
+		auto flush = [&]() -> bool
+		{
+			if (!inTrack)
+			{
+				return true;
+			}
+			inTrack = false;
+			return this->AddTrack(name, (Timeline_Value)components, (Timeline_Interpolation)interpolation, loop, keyTimes, keyValues) >= 0;
+		};
+
+		// Linea por linea sobre el mismo buffer (las llaves se leen con strtof, sin streams)
+		size_t start = 0;
+		while (start < data.size())
+		{
+			size_t end = data.find('\n', start);
+			if (end == std::string::npos)
+			{
+				end = data.size();
+			}
+			std::string line = data.substr(start, end - start);
+			start = end + 1;
+			lineNumber++;
+
+			size_t comment = line.find('#');
+			if (comment != std::string::npos)
+			{
+				line.erase(comment);
+			}
+			size_t first = line.find_first_not_of(" \t\r");
+			if (first == std::string::npos)
+			{
+				continue;
+			}
+
+			if (line.compare(first, 5, "track") == 0)
+			{
+				if (!flush())
+				{
+					return false;
+				}
+				std::istringstream words(line.substr(first + 5));
+				std::string type, interpolationName, loopName;
+				words >> name >> type >> interpolationName >> loopName;
+				components = type == "float" ? TIMELINE_FLOAT : type == "vec3" ? TIMELINE_VEC3 : type == "quat" ? TIMELINE_QUAT : 0;
+				interpolation = interpolationName == "step" ? TIMELINE_STEP : interpolationName == "smooth" ? TIMELINE_SMOOTH : TIMELINE_LINEAR;
+				loop = loopName == "loop";
+				if (components == 0 || name.empty())
+				{
+					std::cout << "ERROR::TIMELINE::TRACK line " << lineNumber << std::endl;
+					return false;
+				}
+				keyTimes.clear();
+				keyValues.clear();
+				inTrack = true;
+				continue;
+			}
+
+			// Llave: tiempo y valores
+			GLfloat numbers[5];
+			GLuint expected = 1 + (components == TIMELINE_QUAT ? 4 : components);
+			GLuint read = 0;
+			const char* cursor = line.c_str() + first;
+			while (read < expected)
+			{
+				char* next = nullptr;
+				numbers[read] = strtof(cursor, &next);
+				if (next == cursor)
+				{
+					break;
+				}
+				cursor = next;
+				read++;
+			}
+			if (!inTrack || read != expected)
+			{
+				std::cout << "ERROR::TIMELINE::KEY line " << lineNumber << std::endl;
+				return false;
+			}
+			GLfloat* value = numbers + 1;
+			if (components == TIMELINE_QUAT)
+			{
+				glm::quat q = glm::angleAxis(glm::radians(value[3]), glm::normalize(glm::vec3(value[0], value[1], value[2])));
+				value[0] = q.x;
+				value[1] = q.y;
+				value[2] = q.z;
+				value[3] = q.w;
+			}
+			keyTimes.push_back(numbers[0]);
+			keyValues.insert(keyValues.end(), value, value + components);
+		}
+		return flush();
+	}
+};
@@ -0,0 +1,282 @@
+#pragma once
+
+// Std. Includes
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "Animation.h"
+#include "Model.h"
+#include "StreamingBuffer.h"
+
+// Unidades de textura de los cuadros horneados y de las instancias (libres entre las de Mesh::Draw y la paleta de huesos)
+const GLuint VERTEX_ANIMATION_TEXTURE_UNIT = 4;
+const GLuint VERTEX_ANIMATION_INSTANCE_UNIT = 5;
+
+// Instancias de una multitud animada con VertexAnimationTexture.
+// Cada cuadro: Begin(), Add() por instancia, Upload(); el vertex shader (#define VERTEX_ANIMATION)
+// lee 4 texeles RGBA32F por instancia (a partir de instanceOffset + gl_InstanceID): las 3 primeras
+// filas de su matriz model y su reloj (desfase en segundos y ritmo), asi cada una va en otro
+// momento del clip. Los texeles se copian al StreamingBuffer del cuadro.
+class VertexAnimationInstances
+{
+public:
+	// El buffer debe vivir mas que las instancias
+	VertexAnimationInstances(StreamingBuffer& stream)
+		: stream(&stream), firstUploaded(-1)
+	{
+	}
+
+	void Begin()
+	{
+		this->texels.clear();
+	}
+
+	// Agrega una instancia (la matriz debe ser afin); regresa su indice
+	GLuint Add(const glm::mat4& model, GLfloat timeOffset, GLfloat rate = 1.0f)
+	{
+		GLuint index = (GLuint)(this->texels.size() / 4);
+		this->texels.push_back(glm::vec4(model[0][0], model[1][0], model[2][0], model[3][0]));
+		this->texels.push_back(glm::vec4(model[0][1], model[1][1], model[2][1], model[3][1]));
+		this->texels.push_back(glm::vec4(model[0][2], model[1][2], model[2][2], model[3][2]));
+		this->texels.push_back(glm::vec4(timeOffset, rate, 0.0f, 0.0f));
+		return index;
+	}
+
+	// Copia las instancias del cuadro al buffer (un memcpy; el StreamingBuffer ya va en su BeginFrame()).
+	// Si no cupieron IsUploaded() es false y no se dibujan
+	void Upload()
+	{
+		this->firstUploaded = -1;
+		if (this->texels.empty())
+		{
+			return;
+		}
+		GLsizeiptr size = this->texels.size() * sizeof(glm::vec4);
+		StreamAllocation allocation = this->stream->Allocate(size, 4 * sizeof(glm::vec4), sizeof(glm::vec4));
+		if (allocation.data == NULL)
+		{
+			return;
+		}
+		memcpy(allocation.data, &this->texels[0], size);
+		this->firstUploaded = (GLint)(allocation.offset / (4 * sizeof(glm::vec4)));
+	}
+
+	// Enlaza las instancias al programa activo
+	void Bind(GLuint program) const
+	{
+		glActiveTexture(GL_TEXTURE0 + VERTEX_ANIMATION_INSTANCE_UNIT);
+		glBindTexture(GL_TEXTURE_BUFFER, this->stream->GetTexture(GL_RGBA32F));
+		glActiveTexture(GL_TEXTURE0);
+		glUniform1i(glGetUniformLocation(program, "animationInstances"), VERTEX_ANIMATION_INSTANCE_UNIT);
+		glUniform1i(glGetUniformLocation(program, "instanceOffset"), this->firstUploaded);
+	}
+
+	GLuint GetCount() const
+	{
+		return (GLuint)(this->texels.size() / 4);
+	}
+
+	bool IsUploaded() const { return this->firstUploaded >= 0; }
+
+private:
+	StreamingBuffer* stream;
+	GLint firstUploaded;	// Primera instancia dentro del buffer en el ultimo Upload() (-1 si fallo)
+	std::vector<glm::vec4> texels;
+};
+
+// Clip horneado a una textura de vertices (vertex animation texture): en la carga se deforma
+// el modelo con el esqueleto en cada cuadro del clip y se guarda la posicion y normal de cada
+// vertice, asi en el cuadro no hay poses ni paleta de huesos y toda una multitud se dibuja con
+// una llamada instanciada por malla, casi al costo de instancias estaticas.
+// Un texel RGBA16UI por vertice y cuadro (8 bytes): xyz es la posicion cuantizada en la caja
+// del clip y w la normal octaedrica en 8:8 bits. Los vertices de todas las mallas van seguidos
+// (vertexOffset es el primero de cada malla) y los cuadros uno tras otro.
+class VertexAnimationTexture
+{
+public:
+	// Hornea el clip de ese modelo (que debe tener esqueleto); el modelo debe vivir mas que la textura
+	VertexAnimationTexture(Model& model, const AnimationClip& clip)
+		: model(&model), name(clip.name), buffer(0), texture(0), vertexCount(0), frameCount(0), frameRate(clip.frameRate),
+		boundsMin(0.0f), boundsSize(1.0f)
+	{
+		for (GLuint m = 0; m < model.GetMeshCount(); m++)
+		{
+			this->meshOffsets.push_back((GLint)this->vertexCount);
+			this->vertexCount += (GLuint)model.GetMesh(m).vertices.size();
+		}
+		this->frameCount = clip.frameCount;
+
+		GLint maxTexels = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+		if (!model.HasSkeleton() || clip.jointCount != model.GetSkeleton().Count() || this->vertexCount == 0 || this->frameCount < 2)
+		{
+			std::cout << "ERROR::VERTEX_ANIMATION::NOT_SKINNED: " << clip.name << std::endl;
+			this->frameCount = 0;
+			return;
+		}
+		if ((double)this->vertexCount * this->frameCount > (double)maxTexels)
+		{
+			std::cout << "ERROR::VERTEX_ANIMATION::TOO_LARGE: " << clip.name << " (" << this->vertexCount << " vertices x " << this->frameCount << " cuadros)" << std::endl;
+			this->frameCount = 0;
+			return;
+		}
+
+		// Vertices deformados de cada cuadro (la pose es el cuadro tal cual, sin mezclar)
+		size_t texelCount = (size_t)this->vertexCount * this->frameCount;
+		std::vector<glm::vec3> positions(texelCount);
+		std::vector<glm::vec3> normals(texelCount);
+		glm::vec3 low(1e30f), high(-1e30f);
+		JointPose pose;
+		pose.Resize(clip.jointCount);
+		std::vector<glm::mat4> globals, skin;
+		for (GLuint f = 0; f < this->frameCount; f++)
+		{
+			std::copy(clip.Frame(f), clip.Frame(f) + JOINT_CHANNELS * clip.stride, pose.data.begin());
+			ComputeSkinMatrices(model.GetSkeleton(), pose, globals, skin);
+
+			size_t texel = (size_t)f * this->vertexCount;
+			for (GLuint m = 0; m < model.GetMeshCount(); m++)
+			{
+				const Mesh& mesh = model.GetMesh(m);
+				for (GLuint v = 0; v < mesh.vertices.size(); v++, texel++)
+				{
+					glm::vec3 position = mesh.vertices[v].Position;
+					glm::vec3 normal = mesh.vertices[v].Normal;
+					// Las mallas sin huesos se quedan en su pose de reposo
+					if (!mesh.bones.empty())
+					{
+						glm::mat4 blend(0.0f);
+						for (GLuint i = 0; i < MAX_BONE_INFLUENCE; i++)
+						{
+							blend += mesh.bones[v].Weights[i] * skin[mesh.bones[v].IDs[i]];
+						}
+						position = glm::vec3(blend * glm::vec4(position, 1.0f));
+						normal = glm::mat3(blend) * normal;
+					}
+					GLfloat length = glm::length(normal);
+					positions[texel] = position;
+					normals[texel] = length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+					low = glm::min(low, position);
+					high = glm::max(high, position);
+				}
+			}
+		}
+		this->boundsMin = low;
+		this->boundsSize = glm::max(high - low, glm::vec3(1e-6f));
+
+		// Cuantizacion
+		std::vector<GLushort> texels(texelCount * 4);
+		for (size_t i = 0; i < texelCount; i++)
+		{
+			glm::vec3 unit = (positions[i] - this->boundsMin) / this->boundsSize;
+			texels[i * 4 + 0] = (GLushort)std::floor(glm::clamp(unit.x, 0.0f, 1.0f) * 65535.0f + 0.5f);
+			texels[i * 4 + 1] = (GLushort)std::floor(glm::clamp(unit.y, 0.0f, 1.0f) * 65535.0f + 0.5f);
+			texels[i * 4 + 2] = (GLushort)std::floor(glm::clamp(unit.z, 0.0f, 1.0f) * 65535.0f + 0.5f);
+			texels[i * 4 + 3] = EncodeNormal(normals[i]);
+		}
+
+		glGenBuffers(1, &this->buffer);
+		glBindBuffer(GL_TEXTURE_BUFFER, this->buffer);
+		glBufferData(GL_TEXTURE_BUFFER, texels.size() * sizeof(GLushort), &texels[0], GL_STATIC_DRAW);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+		glGenTextures(1, &this->texture);
+		glBindTexture(GL_TEXTURE_BUFFER, this->texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA16UI, this->buffer);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+	}
+
+	~VertexAnimationTexture()
+	{
+		glDeleteTextures(1, &this->texture);
+		glDeleteBuffers(1, &this->buffer);
+	}
+
+	// Dibuja todas las instancias con el programa activo (una variante con VERTEX_ANIMATION).
+	// time es el reloj comun en segundos; cada instancia lo ajusta con su desfase y ritmo.
+	void Draw(Shader& shader, const VertexAnimationInstances& instances, GLfloat time)
+	{
+		if (!this->IsValid() || instances.GetCount() == 0 || !instances.IsUploaded())
+		{
+			return;
+		}
+		GLuint program = shader.Program;
+		glActiveTexture(GL_TEXTURE0 + VERTEX_ANIMATION_TEXTURE_UNIT);
+		glBindTexture(GL_TEXTURE_BUFFER, this->texture);
+		glActiveTexture(GL_TEXTURE0);
+		instances.Bind(program);
+		glUniform1i(glGetUniformLocation(program, "animationFrames"), VERTEX_ANIMATION_TEXTURE_UNIT);
+		glUniform1i(glGetUniformLocation(program, "vertexCount"), (GLint)this->vertexCount);
+		glUniform1i(glGetUniformLocation(program, "frameCount"), (GLint)this->frameCount);
+		glUniform1f(glGetUniformLocation(program, "frameRate"), this->frameRate);
+		glUniform3fv(glGetUniformLocation(program, "boundsMin"), 1, &this->boundsMin[0]);
+		glUniform3fv(glGetUniformLocation(program, "boundsSize"), 1, &this->boundsSize[0]);
+		glUniform1f(glGetUniformLocation(program, "animationTime"), time);
+
+		GLint offsetLoc = glGetUniformLocation(program, "vertexOffset");
+		for (GLuint m = 0; m < this->model->GetMeshCount(); m++)
+		{
+			glUniform1i(offsetLoc, this->meshOffsets[m]);
+			this->model->GetMesh(m).Draw(shader, (GLsizei)instances.GetCount());
+		}
+	}
+
+	bool IsValid() const
+	{
+		return this->frameCount > 0;
+	}
+
+	const std::string& GetName() const
+	{
+		return this->name;
+	}
+
+	GLuint GetVertexCount() const
+	{
+		return this->vertexCount;
+	}
+
+	GLuint GetFrameCount() const
+	{
+		return this->frameCount;
+	}
+
+	// Memoria de la textura en GPU
+	size_t GetMemoryBytes() const
+	{
+		return (size_t)this->vertexCount * this->frameCount * 4 * sizeof(GLushort);
+	}
+
+	// Normal en octaedro, 8 bits por componente (el vertex shader la decodifica con DecodeNormal)
+	static GLushort EncodeNormal(const glm::vec3& normal)
+	{
+		glm::vec2 e = glm::vec2(normal.x, normal.y) / (std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z));
+		if (normal.z < 0.0f)
+		{
+			glm::vec2 folded((1.0f - std::fabs(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f), (1.0f - std::fabs(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f));
+			e = folded;
+		}
+		GLuint x = (GLuint)std::floor(glm::clamp(e.x * 0.5f + 0.5f, 0.0f, 1.0f) * 255.0f + 0.5f);
+		GLuint y = (GLuint)std::floor(glm::clamp(e.y * 0.5f + 0.5f, 0.0f, 1.0f) * 255.0f + 0.5f);
+		return (GLushort)((x << 8) | y);
+	}
+
+private:
+	Model* model;
+	std::string name;
+	GLuint buffer;
+	GLuint texture;
+	GLuint vertexCount;				// Vertices de un cuadro (todas las mallas)
+	GLuint frameCount;
+	GLfloat frameRate;
+	glm::vec3 boundsMin;			// Caja de todas las posiciones del clip
+	glm::vec3 boundsSize;
+	std::vector<GLint> meshOffsets;	// Primer vertice de cada malla
+};
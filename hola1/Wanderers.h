@@ -0,0 +1,301 @@
+#pragma once
+
+// Std. Includes
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+
+// GL Includes
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// SSE2 para mover 4 criaturas a la vez (mismo criterio que Animation.h)
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define WANDERERS_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+// Menos criaturas por hilo que esto no compensa lanzar hilos (quedan en el hilo que llama)
+const GLuint WANDERERS_MIN_PER_THREAD = 16384;
+
+// Criaturas que vagan de un objetivo al azar a otro, como Ho-oh y Mew en Animacion():
+// vuelan hacia su objetivo con una curva lateral sin(tiempo * curveSpeed) y al llegar eligen otro
+// dentro de su region. El estado va en estructura de arreglos (SoA), un arreglo por componente,
+// con 'stride' redondeado a multiplo de 4 para recorrerlo de 4 en 4 con SSE; los carriles de
+// relleno son criaturas quietas. Cada criatura tiene su propio generador xorshift32, asi los
+// objetivos no dependen de rand() ni del orden ni de cuantos hilos se usen.
+class WandererSimulation
+{
+public:
+	WandererSimulation()
+		: count(0), stride(0)
+	{
+	}
+
+	void Clear()
+	{
+		this->count = 0;
+		this->resize(0);
+	}
+
+	// Agrega una criatura; la region es la caja donde elige sus objetivos. Regresa su indice
+	GLuint Add(const glm::vec3& position, const glm::vec3& regionMin, const glm::vec3& regionMax, GLfloat speed,
+		GLfloat curveSpeed = 0.5f, GLfloat curveAmount = 1.0f, GLfloat arrivalRadius = 2.0f, GLuint seed = 0)
+	{
+		GLuint i = this->count++;
+		this->resize((this->count + 3) & ~3u);
+
+		this->data[WANDERER_PX][i] = position.x;
+		this->data[WANDERER_PY][i] = position.y;
+		this->data[WANDERER_PZ][i] = position.z;
+		this->data[WANDERER_DX][i] = 0.0f;
+		this->data[WANDERER_DY][i] = 0.0f;
+		this->data[WANDERER_DZ][i] = 1.0f;
+		this->data[WANDERER_MINX][i] = regionMin.x;
+		this->data[WANDERER_MINY][i] = regionMin.y;
+		this->data[WANDERER_MINZ][i] = regionMin.z;
+		this->data[WANDERER_SIZEX][i] = regionMax.x - regionMin.x;
+		this->data[WANDERER_SIZEY][i] = regionMax.y - regionMin.y;
+		this->data[WANDERER_SIZEZ][i] = regionMax.z - regionMin.z;
+		this->data[WANDERER_SPEED][i] = speed;
+		this->data[WANDERER_CURVE_SPEED][i] = curveSpeed;
+		this->data[WANDERER_CURVE_AMOUNT][i] = curveAmount;
+		this->data[WANDERER_ARRIVAL][i] = arrivalRadius * arrivalRadius;
+
+		// Semilla distinta de 0 (xorshift se queda en 0) y revuelta para que indices seguidos no se parezcan
+		GLuint state = (seed != 0 ? seed : i + 1) * 2654435761u;
+		this->seeds[i] = state != 0 ? state : 0x9E3779B9u;
+
+		// El primer objetivo es la posicion inicial: en el primer Update elige uno al azar
+		this->data[WANDERER_TX][i] = position.x;
+		this->data[WANDERER_TY][i] = position.y;
+		this->data[WANDERER_TZ][i] = position.z;
+		return i;
+	}
+
+	// Avanza todas las criaturas; con threadCount > 1 reparte bloques entre hilos si hay suficientes
+	void Update(GLfloat time, GLfloat deltaTime, GLuint threadCount = 1, bool simd = true)
+	{
+		if (this->stride == 0)
+		{
+			return;
+		}
+		GLuint threads = std::max(1u, std::min(threadCount, this->stride / WANDERERS_MIN_PER_THREAD));
+		if (threads == 1)
+		{
+			this->updateRange(0, this->stride, time, deltaTime, simd);
+			return;
+		}
+
+		// Bloques multiplos de 4; el hilo que llama se queda con el ultimo
+		GLuint block = ((this->stride / threads) + 3) & ~3u;
+		std::vector<std::thread> workers;
+		for (GLuint t = 0; t + 1 < threads; t++)
+		{
+			GLuint begin = t * block;
+			workers.push_back(std::thread(&WandererSimulation::updateRange, this, begin, std::min(begin + block, this->stride), time, deltaTime, simd));
+		}
+		this->updateRange(std::min((threads - 1) * block, this->stride), this->stride, time, deltaTime, simd);
+		for (size_t t = 0; t < workers.size(); t++)
+		{
+			workers[t].join();
+		}
+	}
+
+	GLuint GetCount() const { return this->count; }
+	glm::vec3 GetPosition(GLuint i) const { return glm::vec3(this->data[WANDERER_PX][i], this->data[WANDERER_PY][i], this->data[WANDERER_PZ][i]); }
+	glm::vec3 GetDirection(GLuint i) const { return glm::vec3(this->data[WANDERER_DX][i], this->data[WANDERER_DY][i], this->data[WANDERER_DZ][i]); }
+	glm::vec3 GetTarget(GLuint i) const { return glm::vec3(this->data[WANDERER_TX][i], this->data[WANDERER_TY][i], this->data[WANDERER_TZ][i]); }
+
+private:
+	// Componentes del estado, cada una un arreglo de 'stride' floats
+	enum Wanderer_Channel
+	{
+		WANDERER_PX, WANDERER_PY, WANDERER_PZ,			// Posicion
+		WANDERER_DX, WANDERER_DY, WANDERER_DZ,			// Direccion de vuelo (unitaria)
+		WANDERER_TX, WANDERER_TY, WANDERER_TZ,			// Objetivo actual
+		WANDERER_MINX, WANDERER_MINY, WANDERER_MINZ,	// Region de objetivos
+		WANDERER_SIZEX, WANDERER_SIZEY, WANDERER_SIZEZ,
+		WANDERER_SPEED,
+		WANDERER_CURVE_SPEED,
+		WANDERER_CURVE_AMOUNT,
+		WANDERER_ARRIVAL,								// Radio de llegada al cuadrado
+		WANDERER_CHANNELS
+	};
+
+	std::vector<GLfloat> data[WANDERER_CHANNELS];
+	std::vector<GLuint> seeds;
+	GLuint count;
+	GLuint stride;
+
+	void resize(GLuint newStride)
+	{
+		if (newStride == this->stride)
+		{
+			return;
+		}
+		// El relleno son criaturas quietas (velocidad 0) con una region valida
+		for (GLuint c = 0; c < WANDERER_CHANNELS; c++)
+		{
+			this->data[c].resize(newStride, c == WANDERER_SIZEX || c == WANDERER_SIZEY || c == WANDERER_SIZEZ || c == WANDERER_DZ ? 1.0f : 0.0f);
+		}
+		this->seeds.resize(newStride, 0x9E3779B9u);
+		this->stride = newStride;
+	}
+
+	static GLuint nextRandom(GLuint& state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	// Seno aproximado con dos parabolas (error < 0.001), igual en escalar y en SSE
+	static GLfloat fastSin(GLfloat x)
+	{
+		x -= 6.28318531f * std::floor(x * 0.159154943f + 0.5f);
+		GLfloat y = 1.27323954f * x - 0.405284735f * x * std::fabs(x);
+		return 0.225f * (y * std::fabs(y) - y) + y;
+	}
+
+	void updateRange(GLuint begin, GLuint end, GLfloat time, GLfloat deltaTime, bool simd)
+	{
+		GLfloat* px = &this->data[WANDERER_PX][0];
+		GLfloat* py = &this->data[WANDERER_PY][0];
+		GLfloat* pz = &this->data[WANDERER_PZ][0];
+		GLfloat* dx = &this->data[WANDERER_DX][0];
+		GLfloat* dy = &this->data[WANDERER_DY][0];
+		GLfloat* dz = &this->data[WANDERER_DZ][0];
+		GLfloat* tx = &this->data[WANDERER_TX][0];
+		GLfloat* ty = &this->data[WANDERER_TY][0];
+		GLfloat* tz = &this->data[WANDERER_TZ][0];
+		const GLfloat* minX = &this->data[WANDERER_MINX][0];
+		const GLfloat* minY = &this->data[WANDERER_MINY][0];
+		const GLfloat* minZ = &this->data[WANDERER_MINZ][0];
+		const GLfloat* sizeX = &this->data[WANDERER_SIZEX][0];
+		const GLfloat* sizeY = &this->data[WANDERER_SIZEY][0];
+		const GLfloat* sizeZ = &this->data[WANDERER_SIZEZ][0];
+		const GLfloat* speed = &this->data[WANDERER_SPEED][0];
+		const GLfloat* curveSpeed = &this->data[WANDERER_CURVE_SPEED][0];
+		const GLfloat* curveAmount = &this->data[WANDERER_CURVE_AMOUNT][0];
+		const GLfloat* arrival = &this->data[WANDERER_ARRIVAL][0];
+		GLuint* seed = &this->seeds[0];
+		GLuint i = begin;
+
+#ifdef WANDERERS_USE_SSE2
+		if (simd)
+		{
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 epsilon = _mm_set1_ps(1e-12f);
+			const __m128 toUnit = _mm_set1_ps(1.0f / 16777216.0f);
+			const __m128 sign = _mm_set1_ps(-0.0f);
+			const __m128 time4 = _mm_set1_ps(time);
+			const __m128 delta4 = _mm_set1_ps(deltaTime);
+			for (; i + 4 <= end; i += 4)
+			{
+				__m128 x = _mm_loadu_ps(px + i), y = _mm_loadu_ps(py + i), z = _mm_loadu_ps(pz + i);
+				__m128 targetX = _mm_loadu_ps(tx + i), targetY = _mm_loadu_ps(ty + i), targetZ = _mm_loadu_ps(tz + i);
+
+				// 1. Las que llegaron eligen otro objetivo (solo esas avanzan su generador)
+				__m128 toX = _mm_sub_ps(targetX, x), toY = _mm_sub_ps(targetY, y), toZ = _mm_sub_ps(targetZ, z);
+				__m128 distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(toX, toX), _mm_mul_ps(toY, toY)), _mm_mul_ps(toZ, toZ));
+				__m128 arrived = _mm_cmplt_ps(distance2, _mm_loadu_ps(arrival + i));
+				if (_mm_movemask_ps(arrived))
+				{
+					__m128i state = _mm_loadu_si128((const __m128i*)(seed + i));
+					__m128 random[3];
+					for (GLuint r = 0; r < 3; r++)
+					{
+						state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+						state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+						state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+						random[r] = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(state, 8)), toUnit);
+					}
+					__m128i keep = _mm_castps_si128(arrived);
+					__m128i oldState = _mm_loadu_si128((const __m128i*)(seed + i));
+					_mm_storeu_si128((__m128i*)(seed + i), _mm_or_si128(_mm_and_si128(keep, state), _mm_andnot_si128(keep, oldState)));
+
+					__m128 newX = _mm_add_ps(_mm_loadu_ps(minX + i), _mm_mul_ps(_mm_loadu_ps(sizeX + i), random[0]));
+					__m128 newY = _mm_add_ps(_mm_loadu_ps(minY + i), _mm_mul_ps(_mm_loadu_ps(sizeY + i), random[1]));
+					__m128 newZ = _mm_add_ps(_mm_loadu_ps(minZ + i), _mm_mul_ps(_mm_loadu_ps(sizeZ + i), random[2]));
+					targetX = _mm_or_ps(_mm_and_ps(arrived, newX), _mm_andnot_ps(arrived, targetX));
+					targetY = _mm_or_ps(_mm_and_ps(arrived, newY), _mm_andnot_ps(arrived, targetY));
+					targetZ = _mm_or_ps(_mm_and_ps(arrived, newZ), _mm_andnot_ps(arrived, targetZ));
+					_mm_storeu_ps(tx + i, targetX);
+					_mm_storeu_ps(ty + i, targetY);
+					_mm_storeu_ps(tz + i, targetZ);
+					toX = _mm_sub_ps(targetX, x);
+					toY = _mm_sub_ps(targetY, y);
+					toZ = _mm_sub_ps(targetZ, z);
+					distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(toX, toX), _mm_mul_ps(toY, toY)), _mm_mul_ps(toZ, toZ));
+				}
+
+				// 2. Direccion hacia el objetivo y su derecha horizontal: cross(l, arriba) = (-lz, 0, lx)
+				__m128 inverse = _mm_div_ps(one, _mm_sqrt_ps(_mm_max_ps(distance2, epsilon)));
+				__m128 lx = _mm_mul_ps(toX, inverse), ly = _mm_mul_ps(toY, inverse), lz = _mm_mul_ps(toZ, inverse);
+				__m128 inverseRight = _mm_div_ps(one, _mm_sqrt_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(lx, lx), _mm_mul_ps(lz, lz)), epsilon)));
+
+				// 3. Curva lateral: sin(tiempo * curveSpeed) por la cantidad de cada una
+				__m128 angle = _mm_mul_ps(time4, _mm_loadu_ps(curveSpeed + i));
+				angle = _mm_sub_ps(angle, _mm_mul_ps(_mm_set1_ps(6.28318531f), _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(angle, _mm_set1_ps(0.159154943f))))));
+				__m128 sine = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1.27323954f), angle), _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.405284735f), angle), _mm_andnot_ps(sign, angle)));
+				sine = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.225f), _mm_sub_ps(_mm_mul_ps(sine, _mm_andnot_ps(sign, sine)), sine)), sine);
+				__m128 curve = _mm_mul_ps(_mm_mul_ps(sine, _mm_loadu_ps(curveAmount + i)), inverseRight);
+
+				// 4. Direccion con la curva (normalizada) y posicion
+				__m128 ux = _mm_sub_ps(lx, _mm_mul_ps(lz, curve));
+				__m128 uz = _mm_add_ps(lz, _mm_mul_ps(lx, curve));
+				__m128 inverseDirection = _mm_div_ps(one, _mm_sqrt_ps(_mm_max_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ux, ux), _mm_mul_ps(ly, ly)), _mm_mul_ps(uz, uz)), epsilon)));
+				ux = _mm_mul_ps(ux, inverseDirection);
+				__m128 uy = _mm_mul_ps(ly, inverseDirection);
+				uz = _mm_mul_ps(uz, inverseDirection);
+				_mm_storeu_ps(dx + i, ux);
+				_mm_storeu_ps(dy + i, uy);
+				_mm_storeu_ps(dz + i, uz);
+
+				__m128 step = _mm_mul_ps(_mm_loadu_ps(speed + i), delta4);
+				_mm_storeu_ps(px + i, _mm_add_ps(x, _mm_mul_ps(ux, step)));
+				_mm_storeu_ps(py + i, _mm_add_ps(y, _mm_mul_ps(uy, step)));
+				_mm_storeu_ps(pz + i, _mm_add_ps(z, _mm_mul_ps(uz, step)));
+			}
+		}
+#endif
+
+		// Escalar (sin SSE2 o si se pide): los mismos pasos, una criatura a la vez
+		for (; i < end; i++)
+		{
+			GLfloat toX = tx[i] - px[i], toY = ty[i] - py[i], toZ = tz[i] - pz[i];
+			GLfloat distance2 = toX * toX + toY * toY + toZ * toZ;
+			if (distance2 < arrival[i])
+			{
+				GLuint state = seed[i];
+				tx[i] = minX[i] + sizeX[i] * ((nextRandom(state) >> 8) * (1.0f / 16777216.0f));
+				ty[i] = minY[i] + sizeY[i] * ((nextRandom(state) >> 8) * (1.0f / 16777216.0f));
+				tz[i] = minZ[i] + sizeZ[i] * ((nextRandom(state) >> 8) * (1.0f / 16777216.0f));
+				seed[i] = state;
+				toX = tx[i] - px[i];
+				toY = ty[i] - py[i];
+				toZ = tz[i] - pz[i];
+				distance2 = toX * toX + toY * toY + toZ * toZ;
+			}
+
+			GLfloat inverse = 1.0f / std::sqrt(std::max(distance2, 1e-12f));
+			GLfloat lx = toX * inverse, ly = toY * inverse, lz = toZ * inverse;
+			GLfloat inverseRight = 1.0f / std::sqrt(std::max(lx * lx + lz * lz, 1e-12f));
+			GLfloat curve = fastSin(time * curveSpeed[i]) * curveAmount[i] * inverseRight;
+
+			GLfloat ux = lx - lz * curve, uz = lz + lx * curve;
+			GLfloat inverseDirection = 1.0f / std::sqrt(std::max(ux * ux + ly * ly + uz * uz, 1e-12f));
+			dx[i] = ux * inverseDirection;
+			dy[i] = ly * inverseDirection;
+			dz[i] = uz * inverseDirection;
+
+			GLfloat step = speed[i] * deltaTime;
+			px[i] += dx[i] * step;
+			py[i] += dy[i] * step;
+			pz[i] += dz[i] * step;
+		}
+	}
+};